@@ -72,7 +72,7 @@ void Physics::createPhysicsTriangleMeshes(
     {
       _INTR_LOG_WARNING(
           "Failed to cook physics triangle mesh for mesh \"%s\"!",
-          CResources::MeshManager::_name(meshRef).getString().c_str());
+          CResources::MeshManager::_name(meshRef).getCString());
       std::remove(meshFilePath.c_str());
     }
   }
@@ -114,7 +114,7 @@ void Physics::createPhysicsConvexMeshes(
       _INTR_LOG_WARNING(
           "Failed to cook physics convex mesh for mesh \"%s\"! Trying to "
           "generate a convex hull from the AABB...",
-          CResources::MeshManager::_name(meshRef).getString().c_str());
+          CResources::MeshManager::_name(meshRef).getCString());
       std::remove(convexMeshFilePath.c_str());
 
       CResources::AABBPerSubMeshArray& aabbs =
@@ -144,7 +144,7 @@ void Physics::createPhysicsConvexMeshes(
       {
         _INTR_LOG_WARNING(
             "Failed to cook physics convex mesh from AABB for mesh \"%s\"!",
-            CResources::MeshManager::_name(meshRef).getString().c_str());
+            CResources::MeshManager::_name(meshRef).getCString());
         std::remove(convexMeshFilePath.c_str());
       }
     }
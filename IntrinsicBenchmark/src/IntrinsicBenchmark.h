@@ -0,0 +1,59 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+// Returns false if the results of the benchmarked code don't match the
+// reference implementation
+typedef bool (*BenchmarkFunction)();
+
+struct BenchmarkEntry
+{
+  const char* name;
+  BenchmarkFunction function;
+};
+
+// <-
+
+// Executes the given function p_Iterations times (after a single warm up run)
+// and returns the average duration in microseconds
+template <class Function>
+_INTR_INLINE float measure(Function p_Function, uint32_t p_Iterations)
+{
+  p_Function();
+
+  const uint64_t start = TimingHelper::getMicroseconds();
+  for (uint32_t i = 0u; i < p_Iterations; ++i)
+  {
+    p_Function();
+  }
+
+  return (TimingHelper::getMicroseconds() - start) / (float)p_Iterations;
+}
+
+// <-
+
+// Benchmarks
+bool runTransformBenchmark();
+bool runCullingBenchmark();
+bool runPreFilterBenchmark();
+bool runSHProjectionBenchmark();
+bool runEventBenchmark();
+bool runClusteringBenchmark();
+}
+}
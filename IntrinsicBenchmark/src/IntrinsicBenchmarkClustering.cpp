@@ -0,0 +1,98 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+namespace
+{
+const uint32_t _lightCounts[] = {1024u, 10240u};
+const uint32_t _iterationCount = 20u;
+const float _nearPlane = 1.0f;
+const float _farPlane = 10000.0f;
+
+float measureBinning(uint32_t p_LightCount, const glm::mat4& p_ViewMatrix,
+                     const glm::mat4& p_ProjectionMatrix, bool p_BruteForce,
+                     bool p_LightBitmasks, uint32_t& p_AssignedLightCount)
+{
+  return measure(
+      [&]() {
+        p_AssignedLightCount = Renderer::RenderPass::Clustering::binTestLights(
+            p_LightCount, p_ViewMatrix, p_ProjectionMatrix, _nearPlane,
+            _farPlane, p_BruteForce, p_LightBitmasks);
+      },
+      _iterationCount);
+}
+}
+
+// <-
+
+bool runClusteringBenchmark()
+{
+  // Camera looking down on the test lights from above
+  const glm::mat4 viewMatrix =
+      glm::lookAt(glm::vec3(0.0f, 500.0f, 2000.0f), glm::vec3(0.0f),
+                  glm::vec3(0.0f, 1.0f, 0.0f));
+
+  // Matches the projection of the camera component
+  const glm::mat4 projectionMatrix =
+      glm::scale(glm::vec3(1.0f, -1.0f, 1.0f)) *
+      glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, _nearPlane,
+                       _farPlane);
+
+  bool matchesBruteForce = true;
+
+  for (uint32_t countIdx = 0u;
+       countIdx < sizeof(_lightCounts) / sizeof(uint32_t); ++countIdx)
+  {
+    const uint32_t lightCount = _lightCounts[countIdx];
+
+    // Index lists are limited per cluster, bitmasks store all lights
+    for (uint32_t bitmasks = 0u; bitmasks < 2u; ++bitmasks)
+    {
+      uint32_t bruteForceCount = 0u;
+      const float bruteForceTime =
+          measureBinning(lightCount, viewMatrix, projectionMatrix, true,
+                         bitmasks != 0u, bruteForceCount);
+
+      uint32_t binnedCount = 0u;
+      const float binnedTime =
+          measureBinning(lightCount, viewMatrix, projectionMatrix, false,
+                         bitmasks != 0u, binnedCount);
+
+      _INTR_LOG_INFO("%u lights (%s): brute force %.2f us, binned %.2f us "
+                     "(%.2fx), %u lights assigned",
+                     lightCount, bitmasks != 0u ? "bitmasks" : "index lists",
+                     bruteForceTime, binnedTime, bruteForceTime / binnedTime,
+                     binnedCount);
+
+      if (bruteForceCount != binnedCount)
+      {
+        _INTR_LOG_ERROR("Binned clusters don't match the brute force results "
+                        "(%u != %u lights assigned)",
+                        binnedCount, bruteForceCount);
+        matchesBruteForce = false;
+      }
+    }
+  }
+
+  return matchesBruteForce;
+}
+}
+}
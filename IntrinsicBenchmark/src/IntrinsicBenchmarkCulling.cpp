@@ -0,0 +1,152 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+namespace
+{
+const uint32_t _sphereCount = 1024u * 1024u;
+const uint32_t _iterationCount = 20u;
+const uint32_t _spheresPerCall = 32u;
+
+struct SphereData
+{
+  void init(uint32_t p_Count)
+  {
+    // Padding required by the kernels
+    const uint32_t paddedCount = p_Count + 8u;
+    x.resize(paddedCount, 0.0f);
+    y.resize(paddedCount, 0.0f);
+    z.resize(paddedCount, 0.0f);
+    radius.resize(paddedCount, 0.0f);
+
+    for (uint32_t i = 0u; i < p_Count; ++i)
+    {
+      x[i] = Math::calcRandomFloatMinMax(-1000.0f, 1000.0f);
+      y[i] = Math::calcRandomFloatMinMax(-1000.0f, 1000.0f);
+      z[i] = Math::calcRandomFloatMinMax(-1000.0f, 1000.0f);
+      radius[i] = Math::calcRandomFloatMinMax(0.5f, 10.0f);
+    }
+  }
+
+  Culling::SphereStreams getStreams() const
+  {
+    return {x.data(), y.data(), z.data(), radius.data()};
+  }
+
+  _INTR_ARRAY(float) x;
+  _INTR_ARRAY(float) y;
+  _INTR_ARRAY(float) z;
+  _INTR_ARRAY(float) radius;
+};
+
+// <-
+
+// Volume is either the frustum planes or an AABB
+template <class Volume>
+uint32_t cullAllSpheres(const SphereData& p_Data, const Volume& p_Volume,
+                        uint32_t (*p_Function)(const Culling::SphereStreams&,
+                                               uint32_t, uint32_t,
+                                               const Volume&))
+{
+  const Culling::SphereStreams streams = p_Data.getStreams();
+
+  uint32_t visibleCount = 0u;
+  for (uint32_t i = 0u; i < _sphereCount; i += _spheresPerCall)
+  {
+    const uint32_t count = std::min(_spheresPerCall, _sphereCount - i);
+    visibleCount +=
+        Math::calcBitCount(p_Function(streams, i, count, p_Volume));
+  }
+
+  return visibleCount;
+}
+
+// <-
+
+template <class Volume>
+void measureCullingFunction(
+    const char* p_Name, const SphereData& p_Data, const Volume& p_Volume,
+    uint32_t (*p_Function)(const Culling::SphereStreams&, uint32_t, uint32_t,
+                           const Volume&))
+{
+  uint32_t visibleCount = 0u;
+  const float time = measure(
+      [&]() {
+        visibleCount = cullAllSpheres(p_Data, p_Volume, p_Function);
+      },
+      _iterationCount);
+
+  _INTR_LOG_INFO("%s: %.1f us, %.1f M spheres/s, %u visible", p_Name, time,
+                 _sphereCount / time, visibleCount);
+}
+}
+
+// <-
+
+bool runCullingBenchmark()
+{
+  _INTR_LOG_INFO("Frustum vs. bounding sphere culling of %u spheres (avg. of "
+                 "%u runs, AVX2: %s)",
+                 _sphereCount, _iterationCount,
+                 Simd::isAvx2Supported() ? "true" : "false");
+
+  SphereData data;
+  data.init(_sphereCount);
+
+  const glm::mat4 viewMatrix =
+      glm::lookAt(glm::vec3(0.0f), glm::vec3(0.0f, 0.0f, 1.0f),
+                  glm::vec3(0.0f, 1.0f, 0.0f));
+  const glm::mat4 projMatrix =
+      glm::perspective(glm::radians(60.0f), 16.0f / 9.0f, 1.0f, 2000.0f);
+
+  Math::FrustumPlanes planes;
+  Math::extractFrustumPlanes(planes, projMatrix * viewMatrix);
+
+  measureCullingFunction("Scalar", data, planes,
+                         Culling::cullSpheresScalar);
+  measureCullingFunction("SSE", data, planes, Culling::cullSpheresSse);
+
+  if (Simd::isAvx2Supported())
+  {
+    measureCullingFunction("AVX2", data, planes,
+                           Culling::cullSpheresAvx2);
+  }
+
+  // Sphere vs. AABB tests as used for clustered shading
+  _INTR_LOG_INFO("AABB vs. bounding sphere tests of %u spheres", _sphereCount);
+
+  const Math::AABB2 aabb = Math::AABB2(glm::vec3(0.0f), glm::vec3(250.0f));
+
+  measureCullingFunction("Scalar", data, aabb,
+                         Culling::intersectSpheresAABBScalar);
+  measureCullingFunction("SSE", data, aabb,
+                         Culling::intersectSpheresAABBSse);
+
+  if (Simd::isAvx2Supported())
+  {
+    measureCullingFunction("AVX2", data, aabb,
+                           Culling::intersectSpheresAABBAvx2);
+  }
+
+  return true;
+}
+}
+}
@@ -0,0 +1,225 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+namespace
+{
+const uint32_t _eventCounts[] = {64u, 512u};
+const uint32_t _eventTypeCount = 32u;
+const uint32_t _iterationCount = 1000u;
+const uint32_t _eventsPerTask = 32u;
+
+uint32_t _firedEventCount = 0u;
+
+// Reference implementation: events are resources and queueing an event
+// without duplicates scans all queued events
+struct ReferenceEventData : Dod::Resources::ResourceDataBase
+{
+  ReferenceEventData() : Dod::Resources::ResourceDataBase(_INTR_MAX_EVENT_COUNT)
+  {
+    queuedEventData.resize(_INTR_MAX_EVENT_COUNT);
+  }
+
+  _INTR_ARRAY(Resources::QueuedEventData) queuedEventData;
+};
+
+struct ReferenceEventManager
+    : Dod::Resources::ResourceManagerBase<ReferenceEventData,
+                                          _INTR_MAX_EVENT_COUNT>
+{
+  static void init()
+  {
+    Dod::Resources::ResourceManagerBase<
+        ReferenceEventData, _INTR_MAX_EVENT_COUNT>::_initResourceManager();
+  }
+
+  static Dod::Ref queueEventIfNotExisting(const Name& p_EventName)
+  {
+    for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+    {
+      if (_name(_activeRefs[i]) == p_EventName)
+      {
+        return Dod::Ref();
+      }
+    }
+
+    return queueEvent(p_EventName);
+  }
+
+  static Dod::Ref queueEvent(const Name& p_EventName)
+  {
+    return Dod::Resources::ResourceManagerBase<
+        ReferenceEventData,
+        _INTR_MAX_EVENT_COUNT>::_createResource(p_EventName);
+  }
+
+  static void fireEvents()
+  {
+    for (int32_t eventIdx = 0u; eventIdx < (int32_t)_activeRefs.size();
+         ++eventIdx)
+    {
+      Dod::Ref eventRef = _activeRefs[eventIdx];
+
+      _INTR_ARRAY(Resources::EventCallbackFunction)& callbacks =
+          _listenerMapping[_name(eventRef)];
+      for (uint32_t i = 0u; i < callbacks.size(); ++i)
+      {
+        callbacks[i](eventRef);
+      }
+    }
+
+    for (int32_t eventIdx = (uint32_t)_activeRefs.size() - 1u; eventIdx >= 0;
+         --eventIdx)
+    {
+      Dod::Resources::ResourceManagerBase<ReferenceEventData,
+                                          _INTR_MAX_EVENT_COUNT>::
+          _destroyResource(_activeRefs[eventIdx]);
+    }
+  }
+
+  static _INTR_HASH_MAP(Name, _INTR_ARRAY(Resources::EventCallbackFunction))
+      _listenerMapping;
+};
+
+_INTR_HASH_MAP(Name, _INTR_ARRAY(Resources::EventCallbackFunction))
+ReferenceEventManager::_listenerMapping;
+
+// <-
+
+struct QueueEventsTaskSet : enki::ITaskSet
+{
+  virtual ~QueueEventsTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    const uint32_t start = p_Range.start * _eventsPerTask;
+    const uint32_t end = std::min(p_Range.end * _eventsPerTask, _eventCount);
+
+    for (uint32_t i = start; i < end; ++i)
+    {
+      Resources::EventManager::queueEventIfNotExisting(
+          (*_eventNames)[i % _eventTypeCount]);
+    }
+  }
+
+  const _INTR_ARRAY(Name) * _eventNames;
+  uint32_t _eventCount;
+};
+}
+
+// <-
+
+bool runEventBenchmark()
+{
+  Resources::EventListenerManager::init();
+  Resources::EventManager::init();
+  ReferenceEventManager::init();
+
+  _INTR_ARRAY(Name) eventNames;
+  _INTR_ARRAY(Resources::EventListenerRef) eventListeners;
+  for (uint32_t i = 0u; i < _eventTypeCount; ++i)
+  {
+    const Name eventName = ("BenchmarkEvent" + StringUtil::toString(i)).c_str();
+    eventNames.push_back(eventName);
+
+    Resources::EventCallbackFunction callback = [](Dod::Ref p_EventRef) {
+      ++_firedEventCount;
+    };
+    eventListeners.push_back(
+        Resources::EventManager::connect(eventName, callback));
+    ReferenceEventManager::_listenerMapping[eventName].push_back(callback);
+  }
+
+  // Half of the events are queued without duplicates, like the input events
+  for (uint32_t countIdx = 0u;
+       countIdx < sizeof(_eventCounts) / sizeof(uint32_t); ++countIdx)
+  {
+    const uint32_t eventCount = _eventCounts[countIdx];
+
+    const float referenceTime = measure(
+        [&]() {
+          for (uint32_t i = 0u; i < eventCount; ++i)
+          {
+            const Name& eventName = eventNames[i % _eventTypeCount];
+            if ((i & 1u) == 0u)
+            {
+              ReferenceEventManager::queueEvent(eventName);
+            }
+            else
+            {
+              ReferenceEventManager::queueEventIfNotExisting(eventName);
+            }
+          }
+          ReferenceEventManager::fireEvents();
+        },
+        _iterationCount);
+
+    _firedEventCount = 0u;
+    const float ringTime = measure(
+        [&]() {
+          for (uint32_t i = 0u; i < eventCount; ++i)
+          {
+            const Name& eventName = eventNames[i % _eventTypeCount];
+            if ((i & 1u) == 0u)
+            {
+              Resources::EventManager::queueEvent(eventName);
+            }
+            else
+            {
+              Resources::EventManager::queueEventIfNotExisting(eventName);
+            }
+          }
+          Resources::EventManager::fireEvents();
+        },
+        _iterationCount);
+    const uint32_t firedEventsPerFrame =
+        _firedEventCount / (_iterationCount + 1u);
+
+    // Queue from multiple worker threads at once
+    QueueEventsTaskSet taskSet;
+    taskSet._eventNames = &eventNames;
+    taskSet._eventCount = eventCount;
+    taskSet.m_SetSize = (eventCount + _eventsPerTask - 1u) / _eventsPerTask;
+
+    const float threadedTime = measure(
+        [&]() {
+          Application::_scheduler.AddTaskSetToPipe(&taskSet);
+          Application::_scheduler.WaitforTaskSet(&taskSet);
+          Resources::EventManager::fireEvents();
+        },
+        _iterationCount);
+
+    _INTR_LOG_INFO("%u events (%u fired): reference %.2f us, ring buffer "
+                   "%.2f us (%.2fx), ring buffer multithreaded %.2f us",
+                   eventCount, firedEventsPerFrame, referenceTime, ringTime,
+                   referenceTime / ringTime, threadedTime);
+  }
+
+  for (uint32_t i = 0u; i < eventListeners.size(); ++i)
+  {
+    Resources::EventManager::disconnect(eventListeners[i]);
+  }
+
+  return true;
+}
+}
+}
@@ -0,0 +1,367 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+namespace
+{
+const uint32_t _cubeMapExtent = 256u;
+const uint32_t _iterationCount = 3u;
+const uint32_t _referenceMipIdx = 4u;
+const uint32_t _sampleCounts[] = {16u,  256u, 256u, 256u, 256u,
+                                  256u, 256u, 256u, 256u};
+const float _minRoughness = 0.05f;
+const uint32_t _probeCount = 32u;
+const float _maxSHError = 0.001f;
+
+// Procedural HDR environment with a bright sun and a sky gradient
+glm::vec3 calcEnvironment(const glm::vec3& p_Direction,
+                          const glm::vec3& p_SunDirection)
+{
+  const float sun =
+      std::pow(std::max(glm::dot(p_Direction, p_SunDirection), 0.0f), 256.0f);
+  const float sky = glm::clamp(p_Direction.y * 0.5f + 0.5f, 0.0f, 1.0f);
+
+  return glm::mix(glm::vec3(0.1f, 0.08f, 0.05f), glm::vec3(0.4f, 0.6f, 1.0f),
+                  sky) +
+         glm::vec3(50.0f, 45.0f, 40.0f) * sun;
+}
+
+void initEnvironmentCube(gli::texture_cube& p_Cube,
+                         const glm::vec3& p_SunDirection)
+{
+  for (uint32_t mipIdx = 0u; mipIdx < p_Cube.levels(); ++mipIdx)
+  {
+    const glm::uvec2 extent = glm::uvec2(p_Cube.extent(mipIdx));
+
+    for (uint32_t faceIdx = 0u; faceIdx < 6u; ++faceIdx)
+    {
+      glm::vec4* texels = (glm::vec4*)p_Cube.data(0u, faceIdx, mipIdx);
+
+      for (uint32_t y = 0u; y < extent.y; ++y)
+      {
+        for (uint32_t x = 0u; x < extent.x; ++x)
+        {
+          const glm::vec3 dir = Rendering::IBL::mapXYSToDirection(
+              glm::uvec3(x, y, faceIdx), extent);
+          texels[y * extent.x + x] =
+              glm::vec4(calcEnvironment(dir, p_SunDirection), 1.0f);
+        }
+      }
+    }
+  }
+}
+
+// <-
+
+// The pre filtering as it was done before the filtering engine, sampling the
+// input via gli for each sample
+void preFilterGGXReference(const gli::texture_cube& p_Input,
+                           gli::texture_cube& p_Output, uint32_t p_MipIdx)
+{
+  using namespace Rendering::IBL;
+
+  gli::fsamplerCube sourceSamplerTrilinear = gli::fsamplerCube(
+      p_Input, gli::WRAP_CLAMP_TO_EDGE, gli::FILTER_LINEAR, gli::FILTER_LINEAR);
+  gli::fsamplerCube targetSampler =
+      gli::fsamplerCube(p_Output, gli::WRAP_CLAMP_TO_EDGE);
+
+  const glm::uvec2 extent = p_Output.extent(p_MipIdx);
+  const float roughness = _minRoughness + float(p_MipIdx) /
+                                              p_Output.max_level() *
+                                              (1.0f - _minRoughness);
+  const float roughness2 = roughness * roughness;
+  const float resolution = (float)(p_Input.extent(0u).x * p_Input.extent(0u).y);
+  const float saTexel = 4.0f * glm::pi<float>() / (6.0f * resolution);
+  const uint32_t sampleCount = _sampleCounts[p_MipIdx];
+
+  for (uint32_t faceIdx = 0u; faceIdx < 6u; ++faceIdx)
+  {
+    for (uint32_t y = 0u; y < extent.y; ++y)
+    {
+      for (uint32_t x = 0u; x < extent.x; ++x)
+      {
+        const glm::uvec3 pixelPos = glm::uvec3(x, y, faceIdx);
+        const glm::vec3 R = mapXYSToDirection(pixelPos, extent);
+
+        glm::vec3 preFilteredColor = glm::vec3(0.0f);
+        float totalWeight = 0.0f;
+
+        for (uint32_t i = 0; i < sampleCount; ++i)
+        {
+          const glm::vec2 Xi = Math::hammersley(i, sampleCount);
+          const glm::vec3 H = importanceSampleGGX(Xi, roughness, R);
+          const glm::vec3 L = 2.0f * glm::dot(R, H) * H - R;
+          const float NdL = glm::clamp(glm::dot(R, L), 0.0f, 1.0f);
+          const float NdH = glm::clamp(glm::dot(R, H), 0.0f, 1.0f);
+
+          if (NdL > 0.0f)
+          {
+            const glm::vec3 uvs = mapDirectionToUVS(L);
+
+            const float D = D_GGX(NdH, roughness2);
+            const float pdf = D * 0.25f + 0.0001f;
+
+            const float saSample = 1.0f / (float(sampleCount) * pdf + 0.0001f);
+            const float mipLevel = glm::clamp(
+                1.0f /* Bias*/ + 0.5f * log2(saSample / saTexel), 0.0f,
+                (float)p_Input.max_level());
+
+            preFilteredColor += glm::vec3(sourceSamplerTrilinear.texture_lod(
+                                    uvs, (size_t)uvs.z, mipLevel)) *
+                                NdL;
+            totalWeight += NdL;
+          }
+        }
+
+        targetSampler.texel_write(
+            pixelPos, faceIdx, p_MipIdx,
+            glm::vec4(preFilteredColor / totalWeight, 1.0f));
+      }
+    }
+  }
+}
+
+// <-
+
+float calcMaxRelativeError(const gli::texture_cube& p_Expected,
+                           const gli::texture_cube& p_Actual, uint32_t p_MipIdx)
+{
+  const glm::uvec2 extent = glm::uvec2(p_Expected.extent(p_MipIdx));
+
+  float maxError = 0.0f;
+  for (uint32_t faceIdx = 0u; faceIdx < 6u; ++faceIdx)
+  {
+    const glm::vec4* expected =
+        (const glm::vec4*)p_Expected.data(0u, faceIdx, p_MipIdx);
+    const glm::vec4* actual =
+        (const glm::vec4*)p_Actual.data(0u, faceIdx, p_MipIdx);
+
+    for (uint32_t i = 0u; i < extent.x * extent.y; ++i)
+    {
+      const glm::vec3 error =
+          glm::abs(glm::vec3(expected[i]) - glm::vec3(actual[i])) /
+          glm::max(glm::abs(glm::vec3(expected[i])), glm::vec3(0.001f));
+      maxError = std::max(maxError,
+                          std::max(std::max(error.x, error.y), error.z));
+    }
+  }
+
+  return maxError;
+}
+
+// <-
+
+// The SH projection as it was done before the precomputed tables
+Rendering::IBL::SH9 projectReference(const gli::texture_cube& p_CubeMap)
+{
+  using namespace Rendering::IBL;
+
+  gli::texture_cube decCube =
+      gli::convert(p_CubeMap, gli::FORMAT_RGB32_SFLOAT_PACK32);
+
+  SH9 result;
+  float weightSum = 0.0f;
+  for (uint32_t face = 0; face < 6; ++face)
+  {
+    for (int32_t y = 0; y < decCube.extent().y; ++y)
+    {
+      for (int32_t x = 0; x < decCube.extent().x; ++x)
+      {
+        const glm::vec3 sample =
+            decCube.load<glm::vec3>(gli::uvec2(x, y), face, 0);
+        glm::vec2 uv0 =
+            (glm::vec2(x, y) + 0.5f) / glm::vec2(decCube.extent()) * 2.0f -
+            1.0f;
+
+        const float temp = 1.0f + uv0.x * uv0.x + uv0.y * uv0.y;
+        const float weight = 4.0f / (std::sqrt(temp) * temp);
+
+        const glm::vec3 dir =
+            mapXYSToDirection(glm::uvec3(x, y, face), decCube.extent());
+        result += project(dir, sample) * weight;
+        weightSum += weight;
+      }
+    }
+  }
+
+  result *= (4.0f * glm::pi<float>()) / weightSum;
+  return result;
+}
+
+// <-
+
+// Returns the max. error relative to the magnitude of the first band
+float calcMaxSHError(const Rendering::IBL::SH9* p_Expected,
+                     const Rendering::IBL::SH9* p_Actual, uint32_t p_Count)
+{
+  float maxError = 0.0f;
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    const glm::vec3* expected = (const glm::vec3*)&p_Expected[i];
+    const glm::vec3* actual = (const glm::vec3*)&p_Actual[i];
+    const float scale = std::max(glm::length(expected[0]), 0.001f);
+
+    for (uint32_t j = 0u; j < 9u; ++j)
+    {
+      maxError =
+          std::max(maxError, glm::length(expected[j] - actual[j]) / scale);
+    }
+  }
+
+  return maxError;
+}
+}
+
+// <-
+
+bool runPreFilterBenchmark()
+{
+  const glm::uvec2 extent = glm::uvec2(_cubeMapExtent);
+  const uint32_t levelCount = (uint32_t)gli::levels(extent);
+  _INTR_ASSERT(levelCount == sizeof(_sampleCounts) / sizeof(uint32_t));
+
+  _INTR_LOG_INFO("GGX pre filtering of a %ux%u HDR cube map to a full mip "
+                 "chain (avg. of %u runs, AVX2: %s)",
+                 _cubeMapExtent, _cubeMapExtent, _iterationCount,
+                 Simd::isAvx2Supported() ? "true" : "false");
+
+  gli::texture_cube input =
+      gli::texture_cube(gli::FORMAT_RGBA32_SFLOAT_PACK32, extent, levelCount);
+  initEnvironmentCube(input,
+                      glm::normalize(glm::vec3(0.3f, 0.6f, 0.2f)));
+
+  gli::texture_cube output =
+      gli::texture_cube(gli::FORMAT_RGBA32_SFLOAT_PACK32, extent, levelCount);
+  gli::texture_cube referenceOutput =
+      gli::texture_cube(gli::FORMAT_RGBA32_SFLOAT_PACK32, extent, levelCount);
+
+  uint32_t totalSampleCount = 0u;
+  for (uint32_t mipIdx = 0u; mipIdx < levelCount; ++mipIdx)
+  {
+    totalSampleCount += output.extent(mipIdx).x * output.extent(mipIdx).y *
+                        6u * _sampleCounts[mipIdx];
+  }
+
+  const float filterTime = measure(
+      [&]() {
+        Rendering::IBL::preFilterGGX(input, output, _sampleCounts,
+                                     _minRoughness);
+      },
+      _iterationCount);
+
+  // The reference is too slow for the full mip chain, so only a single level
+  // is compared
+  const float referenceTime = measure(
+      [&]() {
+        preFilterGGXReference(input, referenceOutput, _referenceMipIdx);
+      },
+      1u);
+  const uint32_t referenceSampleCount =
+      output.extent(_referenceMipIdx).x * output.extent(_referenceMipIdx).y *
+      6u * _sampleCounts[_referenceMipIdx];
+
+  _INTR_LOG_INFO("Filtering engine: %.1f ms for %u samples (%.1f MSamples/s)",
+                 filterTime / 1000.0f, totalSampleCount,
+                 totalSampleCount / filterTime);
+  _INTR_LOG_INFO("Reference (single thread, mip %u): %.1f MSamples/s, "
+                 "max. relative error %f",
+                 _referenceMipIdx, referenceSampleCount / referenceTime,
+                 calcMaxRelativeError(referenceOutput, output,
+                                      _referenceMipIdx));
+
+  return true;
+}
+
+// <-
+
+bool runSHProjectionBenchmark()
+{
+  const glm::uvec2 extent = glm::uvec2(_cubeMapExtent);
+
+  _INTR_LOG_INFO("SH9 projection of %u %ux%u RGBA16F cube maps",
+                 _probeCount, _cubeMapExtent, _cubeMapExtent);
+
+  _INTR_ARRAY(gli::texture_cube) cubeMaps;
+  for (uint32_t i = 0u; i < _probeCount; ++i)
+  {
+    gli::texture_cube cubeMap =
+        gli::texture_cube(gli::FORMAT_RGBA32_SFLOAT_PACK32, extent, 1u);
+    initEnvironmentCube(
+        cubeMap,
+        glm::normalize(glm::vec3(Math::calcRandomFloatMinMax(-1.0f, 1.0f),
+                                 Math::calcRandomFloatMinMax(0.1f, 1.0f),
+                                 Math::calcRandomFloatMinMax(-1.0f, 1.0f))));
+
+    // Same format as the captured probes
+    cubeMaps.push_back(
+        gli::convert(cubeMap, gli::FORMAT_RGBA16_SFLOAT_PACK16));
+  }
+
+  _INTR_ARRAY(Rendering::IBL::SH9) referenceSHs;
+  referenceSHs.resize(_probeCount);
+  _INTR_ARRAY(Rendering::IBL::SH9) shs;
+  shs.resize(_probeCount);
+
+  const float referenceTime = measure(
+      [&]() {
+        for (uint32_t i = 0u; i < _probeCount; ++i)
+        {
+          referenceSHs[i] = projectReference(cubeMaps[i]);
+        }
+      },
+      1u);
+
+  const float singleTime = measure(
+      [&]() {
+        for (uint32_t i = 0u; i < _probeCount; ++i)
+        {
+          Rendering::IBL::project(&cubeMaps[i], 1u, &shs[i]);
+        }
+      },
+      _iterationCount);
+
+  const float batchedTime = measure(
+      [&]() {
+        Rendering::IBL::project(cubeMaps.data(), _probeCount, shs.data());
+      },
+      _iterationCount);
+
+  const float maxError =
+      calcMaxSHError(referenceSHs.data(), shs.data(), _probeCount);
+
+  _INTR_LOG_INFO("Reference %.1f ms, per probe %.1f ms (%.2fx), batched "
+                 "%.1f ms (%.2fx), max. relative error %f",
+                 referenceTime / 1000.0f, singleTime / 1000.0f,
+                 referenceTime / singleTime, batchedTime / 1000.0f,
+                 referenceTime / batchedTime, maxError);
+
+  if (maxError > _maxSHError)
+  {
+    _INTR_LOG_ERROR("SH9 projection does not match the reference (max. "
+                    "relative error %f > %f)",
+                    maxError, _maxSHError);
+    return false;
+  }
+
+  return true;
+}
+}
+}
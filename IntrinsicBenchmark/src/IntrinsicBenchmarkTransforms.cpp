@@ -0,0 +1,218 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+namespace Intrinsic
+{
+namespace Benchmark
+{
+namespace
+{
+const uint32_t _nodeCounts[] = {10000u, 100000u};
+const uint32_t _iterationCount = 100u;
+const uint32_t _nodesPerTask = 1024u;
+
+struct TransformData
+{
+  void resize(uint32_t p_Count)
+  {
+    flags.resize(p_Count);
+    worldPosition.resize(p_Count);
+    worldOrientation.resize(p_Count);
+    worldSize.resize(p_Count);
+    localAABB.resize(p_Count);
+    worldMatrix.resize(p_Count);
+    inverseWorldMatrix.resize(p_Count);
+    worldAABB.resize(p_Count);
+    worldBoundingSphere.resize(p_Count);
+    nodeIds.resize(p_Count);
+  }
+
+  Components::NodeTransformStreams getStreams()
+  {
+    Components::NodeTransformStreams streams;
+    {
+      streams.flags = flags.data();
+      streams.worldPosition = worldPosition.data();
+      streams.worldOrientation = worldOrientation.data();
+      streams.worldSize = worldSize.data();
+      streams.localAABB = localAABB.data();
+
+      streams.worldMatrix = worldMatrix.data();
+      streams.inverseWorldMatrix = inverseWorldMatrix.data();
+      streams.worldAABB = worldAABB.data();
+      streams.worldBoundingSphere = worldBoundingSphere.data();
+    }
+
+    return streams;
+  }
+
+  _INTR_ARRAY(uint32_t) flags;
+  _INTR_ARRAY(glm::vec3) worldPosition;
+  _INTR_ARRAY(glm::quat) worldOrientation;
+  _INTR_ARRAY(glm::vec3) worldSize;
+  _INTR_ARRAY(Math::AABB) localAABB;
+
+  _INTR_ARRAY(glm::mat4x4) worldMatrix;
+  _INTR_ARRAY(glm::mat4x4) inverseWorldMatrix;
+  _INTR_ARRAY(Math::AABB) worldAABB;
+  _INTR_ARRAY(Math::Sphere) worldBoundingSphere;
+
+  _INTR_ARRAY(uint32_t) nodeIds;
+};
+
+// <-
+
+void initTransformData(TransformData& p_Data, uint32_t p_Count)
+{
+  p_Data.resize(p_Count);
+
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    p_Data.flags[i] = Components::NodeFlags::kLocalAABBFromMesh;
+    p_Data.worldPosition[i] =
+        glm::vec3(Math::calcRandomFloatMinMax(-1000.0f, 1000.0f),
+                  Math::calcRandomFloatMinMax(-1000.0f, 1000.0f),
+                  Math::calcRandomFloatMinMax(-1000.0f, 1000.0f));
+    p_Data.worldOrientation[i] = glm::angleAxis(
+        Math::calcRandomFloatMinMax(0.0f, glm::pi<float>() * 2.0f),
+        glm::normalize(glm::vec3(Math::calcRandomFloatMinMax(-1.0f, 1.0f),
+                                 Math::calcRandomFloatMinMax(-1.0f, 1.0f),
+                                 1.0f)));
+    p_Data.worldSize[i] = glm::vec3(Math::calcRandomFloatMinMax(0.5f, 2.0f));
+    p_Data.localAABB[i] = Math::AABB(glm::vec3(-1.0f, -2.0f, -0.5f),
+                                     glm::vec3(1.0f, 2.0f, 0.5f));
+    p_Data.nodeIds[i] = i;
+  }
+}
+
+// <-
+
+// The transform calculation as it was done before the batched kernels
+void calcWorldMatricesReference(TransformData& p_Data)
+{
+  for (uint32_t i = 0u; i < p_Data.nodeIds.size(); ++i)
+  {
+    glm::mat4 rot = glm::mat4_cast(p_Data.worldOrientation[i]);
+    glm::mat4 trans = glm::translate(glm::mat4(1.0f), p_Data.worldPosition[i]);
+    glm::mat4 scale = glm::scale(glm::mat4(1.0f), p_Data.worldSize[i]);
+
+    p_Data.worldMatrix[i] = trans * rot * scale;
+    p_Data.inverseWorldMatrix[i] = glm::inverse(p_Data.worldMatrix[i]);
+
+    Math::AABB& worldAABB = p_Data.worldAABB[i];
+    worldAABB = p_Data.localAABB[i];
+    Math::transformAABBAffine(worldAABB, p_Data.worldMatrix[i]);
+
+    p_Data.worldBoundingSphere[i] = {
+        Math::calcAABBCenter(worldAABB),
+        glm::length(Math::calcAABBHalfExtent(worldAABB))};
+  }
+}
+
+// <-
+
+struct TransformParallelTaskSet : enki::ITaskSet
+{
+  virtual ~TransformParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    const uint32_t nodeCount = (uint32_t)_data->nodeIds.size();
+    const uint32_t start = p_Range.start * _nodesPerTask;
+    const uint32_t end = std::min(p_Range.end * _nodesPerTask, nodeCount);
+
+    Components::NodeManager::calcWorldMatrices(
+        _data->getStreams(), &_data->nodeIds[start], end - start);
+  }
+
+  TransformData* _data;
+};
+
+// <-
+
+float calcMaxMatrixError(const _INTR_ARRAY(glm::mat4x4) & p_Expected,
+                         const _INTR_ARRAY(glm::mat4x4) & p_Actual)
+{
+  float maxError = 0.0f;
+  for (uint32_t i = 0u; i < p_Expected.size(); ++i)
+  {
+    for (uint32_t j = 0u; j < 4u; ++j)
+    {
+      const glm::vec4 error = glm::abs(p_Expected[i][j] - p_Actual[i][j]);
+      maxError = std::max(maxError, std::max(std::max(error.x, error.y),
+                                             std::max(error.z, error.w)));
+    }
+  }
+
+  return maxError;
+}
+}
+
+// <-
+
+bool runTransformBenchmark()
+{
+  _INTR_LOG_INFO("World matrix, inverse world matrix and world AABB "
+                 "calculation (avg. of %u runs, AVX2: %s)",
+                 _iterationCount,
+                 Simd::isAvx2Supported() ? "true" : "false");
+
+  for (uint32_t i = 0u; i < sizeof(_nodeCounts) / sizeof(uint32_t); ++i)
+  {
+    const uint32_t nodeCount = _nodeCounts[i];
+
+    TransformData data;
+    initTransformData(data, nodeCount);
+
+    const float referenceTime = measure(
+        [&]() { calcWorldMatricesReference(data); }, _iterationCount);
+    const _INTR_ARRAY(glm::mat4x4) referenceInverseWorldMatrices =
+        data.inverseWorldMatrix;
+
+    const float batchedTime = measure(
+        [&]() {
+          Components::NodeManager::calcWorldMatrices(
+              data.getStreams(), data.nodeIds.data(), nodeCount);
+        },
+        _iterationCount);
+
+    TransformParallelTaskSet taskSet;
+    taskSet._data = &data;
+    taskSet.m_SetSize = (nodeCount + _nodesPerTask - 1u) / _nodesPerTask;
+
+    const float parallelTime = measure(
+        [&]() {
+          Application::_scheduler.AddTaskSetToPipe(&taskSet);
+          Application::_scheduler.WaitforTaskSet(&taskSet);
+        },
+        _iterationCount);
+
+    _INTR_LOG_INFO("%u nodes: scalar %.1f us, batched %.1f us (%.2fx), "
+                   "batched parallel %.1f us (%.2fx), max. inverse error %f",
+                   nodeCount, referenceTime, batchedTime,
+                   referenceTime / batchedTime, parallelTime,
+                   referenceTime / parallelTime,
+                   calcMaxMatrixError(referenceInverseWorldMatrices,
+                                      data.inverseWorldMatrix));
+  }
+
+  return true;
+}
+}
+}
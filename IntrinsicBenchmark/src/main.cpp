@@ -0,0 +1,61 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+#include "IntrinsicBenchmark.h"
+
+using namespace Intrinsic::Benchmark;
+
+namespace
+{
+BenchmarkEntry _benchmarks[] = {{"Transforms", runTransformBenchmark},
+                                 {"Culling", runCullingBenchmark},
+                                 {"PreFilter", runPreFilterBenchmark},
+                                 {"SHProjection", runSHProjectionBenchmark},
+                                 {"Events", runEventBenchmark},
+                                 {"Clustering", runClusteringBenchmark}};
+}
+
+int main(int argc, char* argv[])
+{
+  Application::_scheduler.Initialize(
+      std::min(enki::GetNumHardwareThreads(), 6u));
+
+  // Executes all benchmarks or only the one with the provided name
+  const char* benchmarkName = argc > 1 ? argv[1] : nullptr;
+  uint32_t failedCount = 0u;
+
+  for (uint32_t i = 0u; i < sizeof(_benchmarks) / sizeof(BenchmarkEntry); ++i)
+  {
+    const BenchmarkEntry& entry = _benchmarks[i];
+
+    if (benchmarkName != nullptr && strcmp(benchmarkName, entry.name) != 0)
+    {
+      continue;
+    }
+
+    _INTR_LOG_INFO("Running benchmark '%s'...", entry.name);
+    _INTR_LOG_PUSH();
+    if (!entry.function())
+    {
+      _INTR_LOG_ERROR("Benchmark '%s' failed...", entry.name);
+      ++failedCount;
+    }
+    _INTR_LOG_POP();
+  }
+
+  // Fail the run if any of the results didn't match their reference
+  return failedCount > 0u ? 1 : 0;
+}
@@ -23,7 +23,215 @@ namespace Algorithm
 {
 namespace
 {
-uint32_t foo; // Shut up
+#define _INTR_RADIX_SORT_DIGIT_BITS 8u
+#define _INTR_RADIX_SORT_DIGIT_COUNT 256u
+#define _INTR_RADIX_SORT_MAX_PARTITION_COUNT 32u
+#define _INTR_RADIX_SORT_MIN_PAIRS_PER_PARTITION 2048u
+
+typedef uint32_t DigitHistogram[_INTR_RADIX_SORT_DIGIT_COUNT];
+
+struct RadixSortPass
+{
+  const SortKeyValuePair* src;
+  SortKeyValuePair* dst;
+  uint32_t count;
+  uint32_t partitionCount;
+  uint32_t shift;
+
+  // Digit counts per partition which are converted to the scatter offsets
+  // of each partition in place
+  DigitHistogram histograms[_INTR_RADIX_SORT_MAX_PARTITION_COUNT];
+};
+
+// <-
+
+_INTR_INLINE uint32_t getDigit(uint64_t p_Key, uint32_t p_Shift)
+{
+  return (uint32_t)(p_Key >> p_Shift) & (_INTR_RADIX_SORT_DIGIT_COUNT - 1u);
+}
+
+// <-
+
+_INTR_INLINE void calcPartitionRange(const RadixSortPass& p_Pass,
+                                     uint32_t p_PartitionIdx,
+                                     uint32_t& p_Start, uint32_t& p_End)
+{
+  const uint32_t pairsPerPartition =
+      (p_Pass.count + p_Pass.partitionCount - 1u) / p_Pass.partitionCount;
+
+  p_Start = std::min(p_PartitionIdx * pairsPerPartition, p_Pass.count);
+  p_End = std::min(p_Start + pairsPerPartition, p_Pass.count);
+}
+
+// <-
+
+void countDigits(RadixSortPass& p_Pass, uint32_t p_PartitionIdx)
+{
+  uint32_t* histogram = p_Pass.histograms[p_PartitionIdx];
+  memset(histogram, 0x00, sizeof(DigitHistogram));
+
+  uint32_t start, end;
+  calcPartitionRange(p_Pass, p_PartitionIdx, start, end);
+
+  for (uint32_t i = start; i < end; ++i)
+  {
+    ++histogram[getDigit(p_Pass.src[i].key, p_Pass.shift)];
+  }
+}
+
+// <-
+
+void calcScatterOffsets(RadixSortPass& p_Pass)
+{
+  // Partitions are laid out in order within each digit which keeps the sort
+  // stable
+  uint32_t offset = 0u;
+  for (uint32_t digit = 0u; digit < _INTR_RADIX_SORT_DIGIT_COUNT; ++digit)
+  {
+    for (uint32_t partIdx = 0u; partIdx < p_Pass.partitionCount; ++partIdx)
+    {
+      uint32_t& entry = p_Pass.histograms[partIdx][digit];
+      const uint32_t digitCount = entry;
+
+      entry = offset;
+      offset += digitCount;
+    }
+  }
+}
+
+// <-
+
+void scatterPairs(RadixSortPass& p_Pass, uint32_t p_PartitionIdx)
+{
+  uint32_t* offsets = p_Pass.histograms[p_PartitionIdx];
+
+  uint32_t start, end;
+  calcPartitionRange(p_Pass, p_PartitionIdx, start, end);
+
+  for (uint32_t i = start; i < end; ++i)
+  {
+    const SortKeyValuePair& pair = p_Pass.src[i];
+    p_Pass.dst[offsets[getDigit(pair.key, p_Pass.shift)]++] = pair;
+  }
+}
+
+// <-
+
+struct RadixSortCountTaskSet : enki::ITaskSet
+{
+  virtual ~RadixSortCountTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("General", "Radix Sort Count Job");
+
+    for (uint32_t partIdx = p_Range.start; partIdx < p_Range.end; ++partIdx)
+    {
+      countDigits(*_pass, partIdx);
+    }
+  }
+
+  RadixSortPass* _pass;
+};
+
+// <-
+
+struct RadixSortScatterTaskSet : enki::ITaskSet
+{
+  virtual ~RadixSortScatterTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("General", "Radix Sort Scatter Job");
+
+    for (uint32_t partIdx = p_Range.start; partIdx < p_Range.end; ++partIdx)
+    {
+      scatterPairs(*_pass, partIdx);
+    }
+  }
+
+  RadixSortPass* _pass;
+};
+}
+
+// <-
+
+void radixSort(SortKeyValuePairArray& p_Pairs, SortKeyValuePairArray& p_Temp)
+{
+  const uint32_t count = (uint32_t)p_Pairs.size();
+  if (count <= 1u)
+  {
+    return;
+  }
+
+  p_Temp.resize(count);
+
+  // Find the digits which differ between the keys, all others would result in
+  // a plain copy
+  uint64_t keyOr = 0ull;
+  uint64_t keyAnd = ~0ull;
+  for (uint32_t i = 0u; i < count; ++i)
+  {
+    keyOr |= p_Pairs[i].key;
+    keyAnd &= p_Pairs[i].key;
+  }
+  const uint64_t differingBits = keyOr ^ keyAnd;
+
+  RadixSortPass pass;
+  pass.count = count;
+  pass.partitionCount = std::min(
+      std::min(Application::_scheduler.GetNumTaskThreads(),
+               _INTR_RADIX_SORT_MAX_PARTITION_COUNT),
+      std::max(count / _INTR_RADIX_SORT_MIN_PAIRS_PER_PARTITION, 1u));
+
+  RadixSortCountTaskSet countTaskSet;
+  countTaskSet._pass = &pass;
+  countTaskSet.m_SetSize = pass.partitionCount;
+  RadixSortScatterTaskSet scatterTaskSet;
+  scatterTaskSet._pass = &pass;
+  scatterTaskSet.m_SetSize = pass.partitionCount;
+
+  SortKeyValuePair* src = p_Pairs.data();
+  SortKeyValuePair* dst = p_Temp.data();
+
+  for (uint32_t shift = 0u; shift < 64u; shift += _INTR_RADIX_SORT_DIGIT_BITS)
+  {
+    if (getDigit(differingBits, shift) == 0u)
+    {
+      continue;
+    }
+
+    pass.src = src;
+    pass.dst = dst;
+    pass.shift = shift;
+
+    if (pass.partitionCount > 1u)
+    {
+      Application::_scheduler.AddTaskSetToPipe(&countTaskSet);
+      Application::_scheduler.WaitforTaskSet(&countTaskSet);
+
+      calcScatterOffsets(pass);
+
+      Application::_scheduler.AddTaskSetToPipe(&scatterTaskSet);
+      Application::_scheduler.WaitforTaskSet(&scatterTaskSet);
+    }
+    else
+    {
+      countDigits(pass, 0u);
+      calcScatterOffsets(pass);
+      scatterPairs(pass, 0u);
+    }
+
+    std::swap(src, dst);
+  }
+
+  // Odd number of passes: the sorted pairs reside in the scratch array
+  if (src != p_Pairs.data())
+  {
+    p_Pairs.swap(p_Temp);
+  }
 }
 }
 }
@@ -20,6 +20,24 @@ namespace Core
 {
 namespace Algorithm
 {
+struct SortKeyValuePair
+{
+  uint64_t key;
+  Dod::Ref value;
+};
+
+typedef _INTR_ARRAY(SortKeyValuePair) SortKeyValuePairArray;
+
+// <-
+
+// Stable LSD radix sort (eight bits per pass) sorting the pairs by key in
+// ascending order. Passes in which all keys share the same digit are skipped,
+// so narrow keys only pay for the bytes they actually use. Large arrays are
+// histogrammed and scattered in parallel. p_Temp is used as scratch memory
+void radixSort(SortKeyValuePairArray& p_Pairs, SortKeyValuePairArray& p_Temp);
+
+// <-
+
 template <class Type, class ComparatorType>
 _INTR_INLINE void parallelSort(_INTR_ARRAY(Type) & p_Array,
                                const ComparatorType& p_Comparator)
@@ -71,9 +89,9 @@ _INTR_INLINE void parallelSort(_INTR_ARRAY(Type) & p_Array,
     uint32_t _end;
   };
 
-  _INTR_ARRAY(MergeTaskSet) mergeTaskSets;
+  _INTR_SCRATCH_ARRAY(MergeTaskSet) mergeTaskSets;
   mergeTaskSets.resize(partitionCount);
-  _INTR_ARRAY(SortTaskSet) sortTaskSets;
+  _INTR_SCRATCH_ARRAY(SortTaskSet) sortTaskSets;
   sortTaskSets.resize(partitionCount);
 
   uint32_t actualPartCount = 0u;
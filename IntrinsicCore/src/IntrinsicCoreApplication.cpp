@@ -126,6 +126,7 @@ void Application::initManagers()
   // Initialize resource managers
   {
     Resources::FrustumManager::init();
+    Culling::Bvh::init();
     Resources::MeshManager::init();
     Resources::ScriptManager::init();
     Resources::PostEffectManager::init();
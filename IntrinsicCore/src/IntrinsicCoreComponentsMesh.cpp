@@ -36,10 +36,6 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
 
     Dod::Ref frustumRef =
         R::RenderProcess::Default::_activeFrustums[_frustumIdx];
-    glm::mat4& viewMatrix =
-        Resources::FrustumManager::_descViewMatrix(frustumRef);
-    glm::mat4& viewProjectionMatrix =
-        Resources::FrustumManager::_viewProjectionMatrix(frustumRef);
 
     for (uint32_t meshIdx = p_Range.start; meshIdx < p_Range.end; ++meshIdx)
     {
@@ -58,14 +54,11 @@ struct PerInstanceDataUpdateParallelTaskSet : enki::ITaskSet
       MeshPerInstanceDataVertex& perInstanceDataVertex =
           Components::MeshManager::_perInstanceDataVertex(meshCompRef);
       {
-        perInstanceDataVertex.worldMatrix =
-            Components::NodeManager::_worldMatrix(nodeRef);
-        perInstanceDataVertex.viewProjMatrix = viewProjectionMatrix;
-        perInstanceDataVertex.worldViewProjMatrix =
-            viewProjectionMatrix * perInstanceDataVertex.worldMatrix;
-        perInstanceDataVertex.worldViewMatrix =
-            viewMatrix * perInstanceDataVertex.worldMatrix;
-        perInstanceDataVertex.viewMatrix = viewMatrix;
+        const glm::mat4 worldMatrixTransposed =
+            glm::transpose(Components::NodeManager::_worldMatrix(nodeRef));
+        perInstanceDataVertex.worldMatrixRows[0] = worldMatrixTransposed[0];
+        perInstanceDataVertex.worldMatrixRows[1] = worldMatrixTransposed[1];
+        perInstanceDataVertex.worldMatrixRows[2] = worldMatrixTransposed[2];
         perInstanceDataVertex.data0.w = TaskManager::_totalTimePassed;
         perInstanceDataVertex.data0.y = distToCamera;
       }
@@ -109,22 +102,43 @@ struct UniformUpdateParallelTaskSet : enki::ITaskSet
 
     DrawCallRefArray& drawCalls = *_drawCalls;
 
+    uint32_t uploadedBytes = 0u;
     for (uint32_t dcIdx = p_Range.start; dcIdx < p_Range.end; ++dcIdx)
     {
       DrawCallRef dcRef = drawCalls[dcIdx];
-      MeshRef meshCompRef = DrawCallManager::_descMeshComponent(dcRef);
-      _INTR_ASSERT(meshCompRef.isValid());
+      DrawCallManager::allocateUniformMemory(dcRef);
 
-      MeshPerInstanceDataVertex& vertData =
-          Components::MeshManager::_perInstanceDataVertex(meshCompRef);
-      MeshPerInstanceDataFragment& fragData =
-          Components::MeshManager::_perInstanceDataFragment(meshCompRef);
+      const uint8_t materialPass = DrawCallManager::_descMaterialPass(dcRef);
+      const bool instanced =
+          MaterialManager::_materialPasses[materialPass].instanced;
+      const uint32_t instanceCount =
+          instanced ? DrawCallManager::_instanceCount(dcRef) : 1u;
+      const uint32_t firstInstanceIdx =
+          DrawCallManager::_firstInstanceIdx(dcRef);
 
-      DrawCallManager::allocateUniformMemory(dcRef);
-      DrawCallManager::updateUniformMemory(
-          dcRef, &vertData, sizeof(MeshPerInstanceDataVertex), &fragData,
-          sizeof(MeshPerInstanceDataFragment));
+      // Instanced draw calls write the data of all batched draw calls
+      for (uint32_t instIdx = 0u; instIdx < instanceCount; ++instIdx)
+      {
+        DrawCallRef instanceDcRef =
+            instanced ? DrawCallManager::_instancedDrawCalls[firstInstanceIdx +
+                                                             instIdx]
+                      : dcRef;
+        MeshRef meshCompRef =
+            DrawCallManager::_descMeshComponent(instanceDcRef);
+        _INTR_ASSERT(meshCompRef.isValid());
+
+        MeshPerInstanceDataVertex& vertData =
+            Components::MeshManager::_perInstanceDataVertex(meshCompRef);
+        MeshPerInstanceDataFragment& fragData =
+            Components::MeshManager::_perInstanceDataFragment(meshCompRef);
+
+        uploadedBytes += DrawCallManager::updateUniformMemory(
+            dcRef, &vertData, sizeof(MeshPerInstanceDataVertex), &fragData,
+            sizeof(MeshPerInstanceDataFragment), instIdx);
+      }
     }
+
+    R::UniformManager::_perInstanceDataUploadedBytes += uploadedBytes;
   }
 
   DrawCallRefArray* _drawCalls;
@@ -132,6 +146,111 @@ struct UniformUpdateParallelTaskSet : enki::ITaskSet
 
 // <-
 
+// Visibility collection is split into chunks of a fixed size. Each chunk
+// writes the visible refs to its own output and the outputs are concatenated
+// in chunk order afterwards. This keeps the collection lock free and the
+// order of the visible refs stable, independent of the task partitioning
+const uint32_t _collectionChunkSize = 256u;
+
+struct CollectionChunk
+{
+  uint32_t start;
+  uint32_t end;
+  uint8_t materialPassIdx;
+
+  // Each frustum owns a range of "_collectionChunkSize" entries
+  _INTR_ARRAY(Dod::Ref) visibleRefs;
+  uint32_t visibleRefCounts[_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT];
+  uint32_t outputOffsets[_INTR_MAX_FRUSTUMS_PER_FRAME_COUNT];
+};
+
+_INTR_ARRAY(CollectionChunk) _meshCollectionChunks;
+_INTR_ARRAY(CollectionChunk) _drawCallCollectionChunks;
+
+// <-
+
+_INTR_INLINE void addCollectionChunks(_INTR_ARRAY(CollectionChunk) &
+                                          p_Chunks,
+                                      uint32_t& p_ChunkCount, uint32_t p_Count,
+                                      uint8_t p_MaterialPassIdx = 0u)
+{
+  const uint32_t activeFrustumCount =
+      (uint32_t)R::RenderProcess::Default::_activeFrustums.size();
+
+  for (uint32_t start = 0u; start < p_Count; start += _collectionChunkSize)
+  {
+    if (p_ChunkCount == p_Chunks.size())
+    {
+      p_Chunks.resize(p_ChunkCount + 1u);
+    }
+
+    CollectionChunk& chunk = p_Chunks[p_ChunkCount++];
+    chunk.start = start;
+    chunk.end = std::min(start + _collectionChunkSize, p_Count);
+    chunk.materialPassIdx = p_MaterialPassIdx;
+    chunk.visibleRefs.resize(activeFrustumCount * _collectionChunkSize);
+  }
+}
+
+// <-
+
+// Exclusive prefix sum over the visible ref counts of the chunks, also
+// resizes the visible ref arrays to the final counts. The chunks of each
+// material pass have to be adjacent. Runs serially on purpose: it touches
+// one counter per chunk and frustum (a few thousand additions for 100k draw
+// calls), which is cheaper than dispatching it to the workers
+_INTR_INLINE void calcCollectionChunkOffsets(_INTR_ARRAY(CollectionChunk) &
+                                                 p_Chunks,
+                                             uint32_t p_ChunkCount,
+                                             bool p_MeshComponents)
+{
+  _INTR_PROFILE_CPU("General", "Calc. Collection Chunk Offsets");
+
+  const uint32_t activeFrustumCount =
+      (uint32_t)R::RenderProcess::Default::_activeFrustums.size();
+
+  uint32_t firstChunkIdx = 0u;
+  while (firstChunkIdx < p_ChunkCount)
+  {
+    const uint8_t materialPassIdx = p_Chunks[firstChunkIdx].materialPassIdx;
+
+    uint32_t endChunkIdx = firstChunkIdx;
+    while (endChunkIdx < p_ChunkCount &&
+           p_Chunks[endChunkIdx].materialPassIdx == materialPassIdx)
+    {
+      ++endChunkIdx;
+    }
+
+    for (uint32_t frustIdx = 0u; frustIdx < activeFrustumCount; ++frustIdx)
+    {
+      uint32_t offset = 0u;
+      for (uint32_t chunkIdx = firstChunkIdx; chunkIdx < endChunkIdx;
+           ++chunkIdx)
+      {
+        CollectionChunk& chunk = p_Chunks[chunkIdx];
+        chunk.outputOffsets[frustIdx] = offset;
+        offset += chunk.visibleRefCounts[frustIdx];
+      }
+
+      if (p_MeshComponents)
+      {
+        R::RenderProcess::Default::_visibleMeshComponents[frustIdx].resize(
+            offset);
+      }
+      else
+      {
+        R::RenderProcess::Default::_visibleDrawCallsPerMaterialPass
+            [frustIdx][materialPassIdx]
+                .resize(offset);
+      }
+    }
+
+    firstChunkIdx = endChunkIdx;
+  }
+}
+
+// <-
+
 struct DrawCallCollectionParallelTaskSet : enki::ITaskSet
 {
   virtual ~DrawCallCollectionParallelTaskSet() {}
@@ -141,44 +260,51 @@ struct DrawCallCollectionParallelTaskSet : enki::ITaskSet
   {
     _INTR_PROFILE_CPU("General", "Collect Visible Mesh Draw Calls Job");
 
-    auto& drawCallsPerMaterialPass =
-        DrawCallManager::_drawCallsPerMaterialPass[_materialPassIdx];
     const uint32_t activeFrustumCount =
         (uint32_t)R::RenderProcess::Default::_activeFrustums.size();
 
-    for (uint32_t frustIdx = 0u; frustIdx < activeFrustumCount; ++frustIdx)
+    for (uint32_t chunkIdx = p_Range.start; chunkIdx < p_Range.end;
+         ++chunkIdx)
     {
-      auto& visibleDrawCallsPerMaterialPass = R::RenderProcess::Default::
-          _visibleDrawCallsPerMaterialPass[frustIdx][_materialPassIdx];
+      CollectionChunk& chunk = _drawCallCollectionChunks[chunkIdx];
+      auto& drawCallsPerMaterialPass =
+          DrawCallManager::_drawCallsPerMaterialPass[chunk.materialPassIdx];
 
-      for (uint32_t drawCallIdx = p_Range.start; drawCallIdx < p_Range.end;
-           ++drawCallIdx)
+      for (uint32_t frustIdx = 0u; frustIdx < activeFrustumCount; ++frustIdx)
       {
-        DrawCallRef drawCallRef = drawCallsPerMaterialPass[drawCallIdx];
-        Components::MeshRef meshComponentRef =
-            DrawCallManager::_descMeshComponent(drawCallRef);
+        Dod::Ref* visibleDrawCalls =
+            &chunk.visibleRefs[frustIdx * _collectionChunkSize];
+        uint32_t visibleDrawCallCount = 0u;
 
-        if (meshComponentRef.isValid())
+        for (uint32_t drawCallIdx = chunk.start; drawCallIdx < chunk.end;
+             ++drawCallIdx)
         {
-          Components::NodeRef nodeComponentRef =
-              Components::MeshManager::_node(meshComponentRef);
+          DrawCallRef drawCallRef = drawCallsPerMaterialPass[drawCallIdx];
+          Components::MeshRef meshComponentRef =
+              DrawCallManager::_descMeshComponent(drawCallRef);
 
-          if ((Components::NodeManager::_visibilityMask(nodeComponentRef) &
-               (1u << frustIdx)) > 0u)
+          if (meshComponentRef.isValid())
           {
-            DrawCallManager::updateSortingHash(
-                drawCallRef, Components::MeshManager::_perInstanceDataVertex(
-                                 meshComponentRef)
-                                 .data0.y);
-
-            visibleDrawCallsPerMaterialPass.push_back(drawCallRef);
+            Components::NodeRef nodeComponentRef =
+                Components::MeshManager::_node(meshComponentRef);
+
+            if ((Components::NodeManager::_visibilityMask(nodeComponentRef) &
+                 (1u << frustIdx)) > 0u)
+            {
+              DrawCallManager::updateSortingHash(
+                  drawCallRef, Components::MeshManager::_perInstanceDataVertex(
+                                   meshComponentRef)
+                                   .data0.y);
+
+              visibleDrawCalls[visibleDrawCallCount++] = drawCallRef;
+            }
           }
         }
+
+        chunk.visibleRefCounts[frustIdx] = visibleDrawCallCount;
       }
     }
   }
-
-  uint8_t _materialPassIdx;
 };
 
 // <-
@@ -195,44 +321,101 @@ struct MeshCollectionParallelTaskSet : enki::ITaskSet
     uint32_t activeFrustumsCount =
         (uint32_t)R::RenderProcess::Default::_activeFrustums.size();
 
-    for (uint32_t meshCompId = p_Range.start; meshCompId < p_Range.end;
-         ++meshCompId)
+    for (uint32_t chunkIdx = p_Range.start; chunkIdx < p_Range.end;
+         ++chunkIdx)
     {
-      Components::MeshRef meshComponentRef =
-          Components::MeshManager::getActiveResourceAtIndex(meshCompId);
-      Components::NodeRef nodeComponentRef =
-          Components::MeshManager::_node(meshComponentRef);
+      CollectionChunk& chunk = _meshCollectionChunks[chunkIdx];
+      memset(chunk.visibleRefCounts, 0x00, sizeof(chunk.visibleRefCounts));
 
-      for (uint32_t frustIdx = 0u; frustIdx < activeFrustumsCount; ++frustIdx)
+      for (uint32_t meshCompId = chunk.start; meshCompId < chunk.end;
+           ++meshCompId)
       {
+        Components::MeshRef meshComponentRef =
+            Components::MeshManager::getActiveResourceAtIndex(meshCompId);
+        Components::NodeRef nodeComponentRef =
+            Components::MeshManager::_node(meshComponentRef);
 
-        if ((Components::NodeManager::_visibilityMask(nodeComponentRef) &
-             (1u << frustIdx)) > 0u)
+        for (uint32_t frustIdx = 0u; frustIdx < activeFrustumsCount;
+             ++frustIdx)
         {
-          auto& visibleMeshComponents =
-              R::RenderProcess::Default::_visibleMeshComponents[frustIdx];
-          visibleMeshComponents.push_back(meshComponentRef);
+          if ((Components::NodeManager::_visibilityMask(nodeComponentRef) &
+               (1u << frustIdx)) > 0u)
+          {
+            uint32_t& visibleMeshCount = chunk.visibleRefCounts[frustIdx];
+            chunk.visibleRefs[frustIdx * _collectionChunkSize +
+                              visibleMeshCount] = meshComponentRef;
+            ++visibleMeshCount;
+          }
         }
       }
     }
   }
 };
+
+// <-
+
+struct CollectionConcatParallelTaskSet : enki::ITaskSet
+{
+  virtual ~CollectionConcatParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("General", "Concat Visible Meshes And Draw Calls Job");
+
+    const uint32_t activeFrustumCount =
+        (uint32_t)R::RenderProcess::Default::_activeFrustums.size();
+
+    // The mesh chunks are followed by the draw call chunks
+    for (uint32_t chunkIdx = p_Range.start; chunkIdx < p_Range.end;
+         ++chunkIdx)
+    {
+      const bool meshChunk = chunkIdx < _meshChunkCount;
+      const CollectionChunk& chunk =
+          meshChunk ? _meshCollectionChunks[chunkIdx]
+                    : _drawCallCollectionChunks[chunkIdx - _meshChunkCount];
+
+      for (uint32_t frustIdx = 0u; frustIdx < activeFrustumCount; ++frustIdx)
+      {
+        Dod::Ref* visibleRefs =
+            meshChunk
+                ? R::RenderProcess::Default::_visibleMeshComponents[frustIdx]
+                      ._data
+                : R::RenderProcess::Default::_visibleDrawCallsPerMaterialPass
+                      [frustIdx][chunk.materialPassIdx]
+                          ._data;
+
+        memcpy(&visibleRefs[chunk.outputOffsets[frustIdx]],
+               &chunk.visibleRefs[frustIdx * _collectionChunkSize],
+               chunk.visibleRefCounts[frustIdx] * sizeof(Dod::Ref));
+      }
+    }
+  }
+
+  uint32_t _meshChunkCount;
+};
 }
 
 // <-
 
-MeshData::MeshData()
-    : Dod::Components::ComponentDataBase(_INTR_MAX_MESH_COMPONENT_COUNT)
+MeshData::MeshData() : Dod::Components::ComponentDataBase(0u) {}
+
+// <-
+
+void MeshData::resize(uint32_t p_Size)
 {
-  descMeshName.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
-  descColorTint.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
+  const uint32_t prevSize = (uint32_t)drawCalls.size();
+
+  Dod::Components::ComponentDataBase::resize(p_Size);
+  descMeshName.resize(p_Size);
+  descColorTint.resize(p_Size);
 
-  perInstanceDataVertex.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
-  perInstanceDataFragment.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
-  drawCalls.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
-  node.resize(_INTR_MAX_MESH_COMPONENT_COUNT);
+  perInstanceDataVertex.resize(p_Size);
+  perInstanceDataFragment.resize(p_Size);
+  drawCalls.resize(p_Size);
+  node.resize(p_Size);
 
-  for (uint32_t i = 0u; i < _INTR_MAX_MESH_COMPONENT_COUNT; ++i)
+  for (uint32_t i = prevSize; i < p_Size; ++i)
   {
     drawCalls[i].resize(MaterialManager::_materialPasses.size());
   }
@@ -240,6 +423,20 @@ MeshData::MeshData()
 
 // <-
 
+void MeshData::move(uint32_t p_SrcIdx, uint32_t p_DstIdx)
+{
+  Dod::Components::ComponentDataBase::move(p_SrcIdx, p_DstIdx);
+  descMeshName[p_DstIdx] = descMeshName[p_SrcIdx];
+  descColorTint[p_DstIdx] = descColorTint[p_SrcIdx];
+
+  perInstanceDataVertex[p_DstIdx] = perInstanceDataVertex[p_SrcIdx];
+  perInstanceDataFragment[p_DstIdx] = perInstanceDataFragment[p_SrcIdx];
+  drawCalls[p_DstIdx] = std::move(drawCalls[p_SrcIdx]);
+  node[p_DstIdx] = node[p_SrcIdx];
+}
+
+// <-
+
 void MeshManager::resetToDefault(MeshRef p_Mesh)
 {
   _descMeshName(p_Mesh) = "";
@@ -251,7 +448,8 @@ void MeshManager::init()
   _INTR_LOG_INFO("Inititializing Mesh Component Manager...");
 
   Dod::Components::ComponentManagerBase<
-      MeshData, _INTR_MAX_MESH_COMPONENT_COUNT>::_initComponentManager();
+      MeshData, _INTR_MAX_MESH_COMPONENT_COUNT,
+      Dod::Components::StoragePolicy::kDense>::_initComponentManager();
 
   Dod::Components::ComponentManagerEntry meshEntry;
   {
@@ -296,7 +494,7 @@ void MeshManager::createResources(const MeshRefArray& p_Meshes)
     Resources::MeshRef meshRef =
         Resources::MeshManager::getResourceByName(meshName);
     const uint32_t subMeshCount =
-        (uint32_t)Resources::MeshManager::_descIndicesPerSubMesh(meshRef)
+        (uint32_t)Resources::MeshManager::_indexCountPerSubMesh(meshRef)
             .size();
 
     for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
@@ -333,6 +531,7 @@ void MeshManager::createResources(const MeshRefArray& p_Meshes)
     }
 
     // Update transform since the AABB most probably changed
+    NodeManager::updateLocalAABB(nodeRef);
     NodeManager::updateTransforms(nodeRef);
 
     // Create references
@@ -371,6 +570,11 @@ void MeshManager::destroyResources(const MeshRefArray& p_Meshes)
     MeshRef meshRef = p_Meshes[mIdx];
     DrawCallArray& drawCallsPerMaterialPass = _drawCalls(meshRef);
 
+    if (_node(meshRef).isValid())
+    {
+      NodeManager::_flags(_node(meshRef)) &= ~NodeFlags::kLocalAABBFromMesh;
+      NodeManager::markTransformDirty(_node(meshRef));
+    }
     _node(meshRef) = Dod::Ref();
 
     for (uint32_t matPassIdx = 0u; matPassIdx < drawCallsPerMaterialPass.size();
@@ -406,6 +610,20 @@ void MeshManager::updatePerInstanceData(Dod::Ref p_CameraRef,
   _perInstanceDataUpdateTaskSet._camRef = p_CameraRef;
 
   Application::_scheduler.AddTaskSetToPipe(&_perInstanceDataUpdateTaskSet);
+
+  // Shared by all draw calls updated for this view
+  {
+    Dod::Ref frustumRef = R::RenderProcess::Default::_activeFrustums[frustumId];
+
+    R::PerViewDataVertex perViewDataVertex;
+    perViewDataVertex.viewProjMatrix =
+        Resources::FrustumManager::_viewProjectionMatrix(frustumRef);
+    perViewDataVertex.viewMatrix =
+        Resources::FrustumManager::_descViewMatrix(frustumRef);
+
+    R::UniformManager::updatePerViewData(perViewDataVertex);
+  }
+
   Application::_scheduler.WaitforTaskSet(&_perInstanceDataUpdateTaskSet);
 }
 
@@ -417,6 +635,8 @@ void MeshManager::updateUniformData(Dod::RefArray& p_DrawCalls)
 
   _INTR_PROFILE_CPU("General", "Mesh Uniform Data Updt.");
 
+  DrawCallManager::batchInstancedDrawCalls(p_DrawCalls);
+
   uniformUpdateTaskSet._drawCalls = &p_DrawCalls;
   uniformUpdateTaskSet.m_SetSize = (uint32_t)p_DrawCalls.size();
 
@@ -429,17 +649,14 @@ void MeshManager::updateUniformData(Dod::RefArray& p_DrawCalls)
 void MeshManager::collectDrawCallsAndMeshComponents()
 {
   static MeshCollectionParallelTaskSet meshCollectionTaskSet;
-  static _INTR_ARRAY(DrawCallCollectionParallelTaskSet)
-      drawCallCollectionTaskSets;
+  static DrawCallCollectionParallelTaskSet drawCallCollectionTaskSet;
+  static CollectionConcatParallelTaskSet concatTaskSet;
 
   _INTR_PROFILE_CPU("General",
                     "Collect Visible Mesh Components And Draw Calls");
 
   using namespace Renderer;
 
-  drawCallCollectionTaskSets.resize(
-      Renderer::Resources::MaterialManager::_materialPasses.size());
-
   for (uint32_t frustIdx = 0u;
        frustIdx < RenderProcess::Default::_activeFrustums.size(); ++frustIdx)
   {
@@ -456,41 +673,41 @@ void MeshManager::collectDrawCallsAndMeshComponents()
     RenderProcess::Default::_visibleMeshComponents[frustIdx].clear();
   }
 
-  meshCollectionTaskSet.m_SetSize =
-      Components::MeshManager::getActiveResourceCount();
-  Application::_scheduler.AddTaskSetToPipe(&meshCollectionTaskSet);
+  uint32_t meshChunkCount = 0u;
+  addCollectionChunks(_meshCollectionChunks, meshChunkCount,
+                      Components::MeshManager::getActiveResourceCount());
 
-  uint32_t currentJobIdx = 0u;
+  uint32_t drawCallChunkCount = 0u;
   for (uint32_t matPassIdx = 0u;
        matPassIdx <
        Renderer::Resources::MaterialManager::_materialPasses.size();
        ++matPassIdx)
   {
-    if (!Renderer::Resources::DrawCallManager::_drawCallsPerMaterialPass
-             [matPassIdx]
-                 .empty())
-    {
-      DrawCallCollectionParallelTaskSet& drawCallTaskSet =
-          drawCallCollectionTaskSets[currentJobIdx];
-      drawCallTaskSet._materialPassIdx = matPassIdx;
-      drawCallTaskSet.m_SetSize =
-          (uint32_t)Renderer::Resources::DrawCallManager::
-              _drawCallsPerMaterialPass[matPassIdx]
-                  .size();
-
-      Application::_scheduler.AddTaskSetToPipe(&drawCallTaskSet);
-    }
-
-    ++currentJobIdx;
+    addCollectionChunks(
+        _drawCallCollectionChunks, drawCallChunkCount,
+        (uint32_t)Renderer::Resources::DrawCallManager::
+            _drawCallsPerMaterialPass[matPassIdx]
+                .size(),
+        (uint8_t)matPassIdx);
   }
 
-  // Wait for all
-  for (uint32_t i = 0u; i < currentJobIdx; ++i)
-  {
-    Application::_scheduler.WaitforTaskSet(&drawCallCollectionTaskSets[i]);
-  }
+  meshCollectionTaskSet.m_SetSize = meshChunkCount;
+  Application::_scheduler.AddTaskSetToPipe(&meshCollectionTaskSet);
+  drawCallCollectionTaskSet.m_SetSize = drawCallChunkCount;
+  Application::_scheduler.AddTaskSetToPipe(&drawCallCollectionTaskSet);
 
+  Application::_scheduler.WaitforTaskSet(&drawCallCollectionTaskSet);
   Application::_scheduler.WaitforTaskSet(&meshCollectionTaskSet);
+
+  // Place the outputs of the chunks and concatenate them
+  calcCollectionChunkOffsets(_meshCollectionChunks, meshChunkCount, true);
+  calcCollectionChunkOffsets(_drawCallCollectionChunks, drawCallChunkCount,
+                             false);
+
+  concatTaskSet._meshChunkCount = meshChunkCount;
+  concatTaskSet.m_SetSize = meshChunkCount + drawCallChunkCount;
+  Application::_scheduler.AddTaskSetToPipe(&concatTaskSet);
+  Application::_scheduler.WaitforTaskSet(&concatTaskSet);
 }
 }
 }
@@ -26,13 +26,11 @@ typedef _INTR_ARRAY(MeshRef) MeshRefArray;
 
 typedef _INTR_ARRAY(_INTR_ARRAY(Dod::Ref)) DrawCallArray;
 
+// The view dependent matrices are stored once per view in the per view data
 struct MeshPerInstanceDataVertex
 {
-  glm::mat4 worldMatrix;
-  glm::mat4 worldViewProjMatrix;
-  glm::mat4 worldViewMatrix;
-  glm::mat4 viewProjMatrix;
-  glm::mat4 viewMatrix;
+  // Rows of the world matrix, the last row is always (0, 0, 0, 1)
+  glm::vec4 worldMatrixRows[3];
 
   glm::vec4 data0;
 };
@@ -48,6 +46,9 @@ struct MeshData : Dod::Components::ComponentDataBase
 {
   MeshData();
 
+  void resize(uint32_t p_Size);
+  void move(uint32_t p_SrcIdx, uint32_t p_DstIdx);
+
   // Description
   _INTR_ARRAY(Name) descMeshName;
   _INTR_ARRAY(glm::vec4) descColorTint;
@@ -59,9 +60,11 @@ struct MeshData : Dod::Components::ComponentDataBase
   _INTR_ARRAY(Components::NodeRef) node;
 };
 
+// Mesh components are iterated every frame and thus use the dense storage
 struct MeshManager
-    : Dod::Components::ComponentManagerBase<MeshData,
-                                            _INTR_MAX_MESH_COMPONENT_COUNT>
+    : Dod::Components::ComponentManagerBase<
+          MeshData, _INTR_MAX_MESH_COMPONENT_COUNT,
+          Dod::Components::StoragePolicy::kDense>
 {
   static void init();
 
@@ -70,8 +73,9 @@ struct MeshManager
   _INTR_INLINE static MeshRef createMesh(Entity::EntityRef p_ParentEntity)
   {
     MeshRef ref = Dod::Components::ComponentManagerBase<
-        MeshData,
-        _INTR_MAX_MESH_COMPONENT_COUNT>::_createComponent(p_ParentEntity);
+        MeshData, _INTR_MAX_MESH_COMPONENT_COUNT,
+        Dod::Components::StoragePolicy::kDense>::
+        _createComponent(p_ParentEntity);
     return ref;
   }
 
@@ -80,7 +84,8 @@ struct MeshManager
   _INTR_INLINE static void destroyMesh(MeshRef p_Mesh)
   {
     Dod::Components::ComponentManagerBase<
-        MeshData, _INTR_MAX_MESH_COMPONENT_COUNT>::_destroyComponent(p_Mesh);
+        MeshData, _INTR_MAX_MESH_COMPONENT_COUNT,
+        Dod::Components::StoragePolicy::kDense>::_destroyComponent(p_Mesh);
   }
 
   // <-
@@ -155,41 +160,41 @@ struct MeshManager
   // Scripting interface
   _INTR_INLINE static const Name& getMeshName(MeshRef p_Ref)
   {
-    return _data.descMeshName[p_Ref._id];
+    return _data.descMeshName[_dataIdx(p_Ref)];
   }
   _INTR_INLINE static void setMeshName(MeshRef p_Ref, const Name& p_Name)
   {
-    _data.descMeshName[p_Ref._id] = p_Name;
+    _data.descMeshName[_dataIdx(p_Ref)] = p_Name;
   }
 
   // Description
   _INTR_INLINE static Name& _descMeshName(MeshRef p_Ref)
   {
-    return _data.descMeshName[p_Ref._id];
+    return _data.descMeshName[_dataIdx(p_Ref)];
   }
   _INTR_INLINE static glm::vec4& _descColorTint(MeshRef p_Ref)
   {
-    return _data.descColorTint[p_Ref._id];
+    return _data.descColorTint[_dataIdx(p_Ref)];
   }
 
   // Resources
   _INTR_INLINE static MeshPerInstanceDataVertex&
   _perInstanceDataVertex(MeshRef p_Ref)
   {
-    return _data.perInstanceDataVertex[p_Ref._id];
+    return _data.perInstanceDataVertex[_dataIdx(p_Ref)];
   }
   _INTR_INLINE static MeshPerInstanceDataFragment&
   _perInstanceDataFragment(MeshRef p_Ref)
   {
-    return _data.perInstanceDataFragment[p_Ref._id];
+    return _data.perInstanceDataFragment[_dataIdx(p_Ref)];
   }
   _INTR_INLINE static DrawCallArray& _drawCalls(MeshRef p_Ref)
   {
-    return _data.drawCalls[p_Ref._id];
+    return _data.drawCalls[_dataIdx(p_Ref)];
   }
   _INTR_INLINE static Components::NodeRef& _node(MeshRef p_Ref)
   {
-    return _data.node[p_Ref._id];
+    return _data.node[_dataIdx(p_Ref)];
   }
 
   // <-
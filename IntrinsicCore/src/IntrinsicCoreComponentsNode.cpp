@@ -15,6 +15,13 @@
 // Precompiled header file
 #include "stdafx.h"
 
+// The maximum amount of nodes processed by the SIMD kernels at once
+#define _INTR_TRANSFORM_MAX_LANE_COUNT 8u
+// The amount of nodes processed by a single task set element
+#define _INTR_TRANSFORM_NODES_PER_TASK 64u
+// Levels with less dirty nodes are updated on the calling thread
+#define _INTR_TRANSFORM_MIN_PARALLEL_NODE_COUNT 512u
+
 namespace Intrinsic
 {
 namespace Core
@@ -24,6 +31,11 @@ namespace Components
 // Static members
 NodeRefArray NodeManager::_rootNodes;
 NodeRefArray NodeManager::_sortedNodes;
+NodeRefArray NodeManager::_updatedNodes;
+NodeRefArray NodeManager::_dirtyNodes;
+_INTR_ARRAY(uint32_t) NodeManager::_sortedNodeParentIndices;
+_INTR_ARRAY(uint32_t) NodeManager::_sortedIndices;
+_INTR_ARRAY(uint32_t) NodeManager::_sortedNodeLevelOffsets;
 
 void NodeManager::init()
 {
@@ -33,6 +45,11 @@ void NodeManager::init()
       NodeData, _INTR_MAX_NODE_COMPONENT_COUNT>::_initComponentManager();
 
   _sortedNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _sortedNodeParentIndices.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _sortedIndices.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _sortedNodeLevelOffsets.reserve(_INTR_MAX_NODE_COMPONENT_COUNT + 1u);
+  _updatedNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _dirtyNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
   _rootNodes.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
 
   Dod::Components::ComponentManagerEntry nodeEntry;
@@ -61,82 +78,742 @@ void NodeManager::init()
   }
 }
 
-void NodeManager::updateTransforms(const NodeRefArray& p_Nodes)
+namespace
+{
+// Fields of the SoA input of the batched world matrix calculation
+namespace TransformInput
+{
+enum Enum
+{
+  kPosX,
+  kPosY,
+  kPosZ,
+
+  kOrientX,
+  kOrientY,
+  kOrientZ,
+  kOrientW,
+
+  kSizeX,
+  kSizeY,
+  kSizeZ,
+
+  kLocalCenterX,
+  kLocalCenterY,
+  kLocalCenterZ,
+
+  kLocalHalfExtentX,
+  kLocalHalfExtentY,
+  kLocalHalfExtentZ,
+
+  kCount
+};
+}
+
+// Fields of the SoA output of the batched world matrix calculation
+namespace TransformOutput
+{
+enum Enum
+{
+  // World matrix (rotation and scale)
+  kM00,
+  kM01,
+  kM02,
+  kM10,
+  kM11,
+  kM12,
+  kM20,
+  kM21,
+  kM22,
+
+  // Inverse world matrix
+  kInv00,
+  kInv01,
+  kInv02,
+  kInv10,
+  kInv11,
+  kInv12,
+  kInv20,
+  kInv21,
+  kInv22,
+  kInvTransX,
+  kInvTransY,
+  kInvTransZ,
+
+  // World AABB and bounding sphere
+  kWorldCenterX,
+  kWorldCenterY,
+  kWorldCenterZ,
+  kWorldHalfExtentX,
+  kWorldHalfExtentY,
+  kWorldHalfExtentZ,
+  kWorldRadius,
+
+  kCount
+};
+}
+
+typedef float TransformLanes[_INTR_TRANSFORM_MAX_LANE_COUNT];
+
+// <-
+
+_INTR_INLINE void gatherTransformInput(const NodeTransformStreams& p_Streams,
+                                       const uint32_t* p_NodeIds,
+                                       uint32_t p_Count, uint32_t p_LaneCount,
+                                       TransformLanes* p_Input)
+{
+  using namespace TransformInput;
+
+  for (uint32_t lane = 0u; lane < p_LaneCount; ++lane)
+  {
+    // Fill unused lanes with the identity transform
+    if (lane >= p_Count)
+    {
+      for (uint32_t i = 0u; i < kCount; ++i)
+        p_Input[i][lane] = 0.0f;
+
+      p_Input[kOrientW][lane] = 1.0f;
+      p_Input[kSizeX][lane] = 1.0f;
+      p_Input[kSizeY][lane] = 1.0f;
+      p_Input[kSizeZ][lane] = 1.0f;
+      continue;
+    }
+
+    const uint32_t nodeId = p_NodeIds[lane];
+
+    const glm::vec3& pos = p_Streams.worldPosition[nodeId];
+    const glm::quat& orient = p_Streams.worldOrientation[nodeId];
+    const glm::vec3& size = p_Streams.worldSize[nodeId];
+    const Math::AABB& localAABB = p_Streams.localAABB[nodeId];
+
+    const glm::vec3 localCenter = Math::calcAABBCenter(localAABB);
+    const glm::vec3 localHalfExtent = Math::calcAABBHalfExtent(localAABB);
+
+    p_Input[kPosX][lane] = pos.x;
+    p_Input[kPosY][lane] = pos.y;
+    p_Input[kPosZ][lane] = pos.z;
+
+    p_Input[kOrientX][lane] = orient.x;
+    p_Input[kOrientY][lane] = orient.y;
+    p_Input[kOrientZ][lane] = orient.z;
+    p_Input[kOrientW][lane] = orient.w;
+
+    p_Input[kSizeX][lane] = size.x;
+    p_Input[kSizeY][lane] = size.y;
+    p_Input[kSizeZ][lane] = size.z;
+
+    p_Input[kLocalCenterX][lane] = localCenter.x;
+    p_Input[kLocalCenterY][lane] = localCenter.y;
+    p_Input[kLocalCenterZ][lane] = localCenter.z;
+
+    p_Input[kLocalHalfExtentX][lane] = localHalfExtent.x;
+    p_Input[kLocalHalfExtentY][lane] = localHalfExtent.y;
+    p_Input[kLocalHalfExtentZ][lane] = localHalfExtent.z;
+  }
+}
+
+// <-
+
+_INTR_INLINE void
+scatterTransformOutput(const NodeTransformStreams& p_Streams,
+                       const uint32_t* p_NodeIds, uint32_t p_Count,
+                       const TransformLanes* p_Output)
+{
+  using namespace TransformOutput;
+
+  for (uint32_t lane = 0u; lane < p_Count; ++lane)
+  {
+    const uint32_t nodeId = p_NodeIds[lane];
+    const glm::vec3& pos = p_Streams.worldPosition[nodeId];
+
+    glm::mat4& worldMatrix = p_Streams.worldMatrix[nodeId];
+    worldMatrix[0] = glm::vec4(p_Output[kM00][lane], p_Output[kM10][lane],
+                               p_Output[kM20][lane], 0.0f);
+    worldMatrix[1] = glm::vec4(p_Output[kM01][lane], p_Output[kM11][lane],
+                               p_Output[kM21][lane], 0.0f);
+    worldMatrix[2] = glm::vec4(p_Output[kM02][lane], p_Output[kM12][lane],
+                               p_Output[kM22][lane], 0.0f);
+    worldMatrix[3] = glm::vec4(pos, 1.0f);
+
+    glm::mat4& inverseWorldMatrix = p_Streams.inverseWorldMatrix[nodeId];
+    inverseWorldMatrix[0] =
+        glm::vec4(p_Output[kInv00][lane], p_Output[kInv10][lane],
+                  p_Output[kInv20][lane], 0.0f);
+    inverseWorldMatrix[1] =
+        glm::vec4(p_Output[kInv01][lane], p_Output[kInv11][lane],
+                  p_Output[kInv21][lane], 0.0f);
+    inverseWorldMatrix[2] =
+        glm::vec4(p_Output[kInv02][lane], p_Output[kInv12][lane],
+                  p_Output[kInv22][lane], 0.0f);
+    inverseWorldMatrix[3] =
+        glm::vec4(p_Output[kInvTransX][lane], p_Output[kInvTransY][lane],
+                  p_Output[kInvTransZ][lane], 1.0f);
+
+    // Update AABB
+    if ((p_Streams.flags[nodeId] & NodeFlags::kLocalAABBFromMesh) > 0u)
+    {
+      const glm::vec3 worldCenter =
+          glm::vec3(p_Output[kWorldCenterX][lane],
+                    p_Output[kWorldCenterY][lane],
+                    p_Output[kWorldCenterZ][lane]);
+      const glm::vec3 worldHalfExtent =
+          glm::vec3(p_Output[kWorldHalfExtentX][lane],
+                    p_Output[kWorldHalfExtentY][lane],
+                    p_Output[kWorldHalfExtentZ][lane]);
+
+      p_Streams.worldAABB[nodeId] = Math::AABB(worldCenter - worldHalfExtent,
+                                               worldCenter + worldHalfExtent);
+      p_Streams.worldBoundingSphere[nodeId] = {worldCenter,
+                                               p_Output[kWorldRadius][lane]};
+    }
+    else
+    {
+      p_Streams.worldAABB[nodeId] =
+          Math::AABB(pos - glm::vec3(0.5f), pos + glm::vec3(0.5f));
+    }
+  }
+}
+
+// <-
+
+void calcWorldMatricesSse(const TransformLanes* p_Input,
+                          TransformLanes* p_Output)
+{
+  using namespace TransformInput;
+  using namespace TransformOutput;
+
+  const __m128 one = _mm_set1_ps(1.0f);
+  const __m128 two = _mm_set1_ps(2.0f);
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+
+  const __m128 px = _mm_load_ps(p_Input[kPosX]);
+  const __m128 py = _mm_load_ps(p_Input[kPosY]);
+  const __m128 pz = _mm_load_ps(p_Input[kPosZ]);
+
+  const __m128 qx = _mm_load_ps(p_Input[kOrientX]);
+  const __m128 qy = _mm_load_ps(p_Input[kOrientY]);
+  const __m128 qz = _mm_load_ps(p_Input[kOrientZ]);
+  const __m128 qw = _mm_load_ps(p_Input[kOrientW]);
+
+  const __m128 sx = _mm_load_ps(p_Input[kSizeX]);
+  const __m128 sy = _mm_load_ps(p_Input[kSizeY]);
+  const __m128 sz = _mm_load_ps(p_Input[kSizeZ]);
+
+  // Rotation matrix of the (unit) quaternion
+  const __m128 xx = _mm_mul_ps(qx, qx);
+  const __m128 yy = _mm_mul_ps(qy, qy);
+  const __m128 zz = _mm_mul_ps(qz, qz);
+  const __m128 xy = _mm_mul_ps(qx, qy);
+  const __m128 xz = _mm_mul_ps(qx, qz);
+  const __m128 yz = _mm_mul_ps(qy, qz);
+  const __m128 wx = _mm_mul_ps(qw, qx);
+  const __m128 wy = _mm_mul_ps(qw, qy);
+  const __m128 wz = _mm_mul_ps(qw, qz);
+
+  const __m128 r00 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(yy, zz)));
+  const __m128 r01 = _mm_mul_ps(two, _mm_sub_ps(xy, wz));
+  const __m128 r02 = _mm_mul_ps(two, _mm_add_ps(xz, wy));
+  const __m128 r10 = _mm_mul_ps(two, _mm_add_ps(xy, wz));
+  const __m128 r11 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, zz)));
+  const __m128 r12 = _mm_mul_ps(two, _mm_sub_ps(yz, wx));
+  const __m128 r20 = _mm_mul_ps(two, _mm_sub_ps(xz, wy));
+  const __m128 r21 = _mm_mul_ps(two, _mm_add_ps(yz, wx));
+  const __m128 r22 = _mm_sub_ps(one, _mm_mul_ps(two, _mm_add_ps(xx, yy)));
+
+  // World matrix: T * R * S
+  const __m128 m00 = _mm_mul_ps(r00, sx);
+  const __m128 m01 = _mm_mul_ps(r01, sy);
+  const __m128 m02 = _mm_mul_ps(r02, sz);
+  const __m128 m10 = _mm_mul_ps(r10, sx);
+  const __m128 m11 = _mm_mul_ps(r11, sy);
+  const __m128 m12 = _mm_mul_ps(r12, sz);
+  const __m128 m20 = _mm_mul_ps(r20, sx);
+  const __m128 m21 = _mm_mul_ps(r21, sy);
+  const __m128 m22 = _mm_mul_ps(r22, sz);
+
+  _mm_store_ps(p_Output[kM00], m00);
+  _mm_store_ps(p_Output[kM01], m01);
+  _mm_store_ps(p_Output[kM02], m02);
+  _mm_store_ps(p_Output[kM10], m10);
+  _mm_store_ps(p_Output[kM11], m11);
+  _mm_store_ps(p_Output[kM12], m12);
+  _mm_store_ps(p_Output[kM20], m20);
+  _mm_store_ps(p_Output[kM21], m21);
+  _mm_store_ps(p_Output[kM22], m22);
+
+  // Affine inverse: S^-1 * R^T and -(S^-1 * R^T) * t
+  const __m128 rsx = _mm_div_ps(one, sx);
+  const __m128 rsy = _mm_div_ps(one, sy);
+  const __m128 rsz = _mm_div_ps(one, sz);
+
+  const __m128 i00 = _mm_mul_ps(r00, rsx);
+  const __m128 i01 = _mm_mul_ps(r10, rsx);
+  const __m128 i02 = _mm_mul_ps(r20, rsx);
+  const __m128 i10 = _mm_mul_ps(r01, rsy);
+  const __m128 i11 = _mm_mul_ps(r11, rsy);
+  const __m128 i12 = _mm_mul_ps(r21, rsy);
+  const __m128 i20 = _mm_mul_ps(r02, rsz);
+  const __m128 i21 = _mm_mul_ps(r12, rsz);
+  const __m128 i22 = _mm_mul_ps(r22, rsz);
+
+  _mm_store_ps(p_Output[kInv00], i00);
+  _mm_store_ps(p_Output[kInv01], i01);
+  _mm_store_ps(p_Output[kInv02], i02);
+  _mm_store_ps(p_Output[kInv10], i10);
+  _mm_store_ps(p_Output[kInv11], i11);
+  _mm_store_ps(p_Output[kInv12], i12);
+  _mm_store_ps(p_Output[kInv20], i20);
+  _mm_store_ps(p_Output[kInv21], i21);
+  _mm_store_ps(p_Output[kInv22], i22);
+
+  _mm_store_ps(p_Output[kInvTransX],
+               _mm_xor_ps(Simd::simdMadd(i00, px,
+                                         Simd::simdMadd(i01, py,
+                                                        _mm_mul_ps(i02, pz))),
+                          signMask));
+  _mm_store_ps(p_Output[kInvTransY],
+               _mm_xor_ps(Simd::simdMadd(i10, px,
+                                         Simd::simdMadd(i11, py,
+                                                        _mm_mul_ps(i12, pz))),
+                          signMask));
+  _mm_store_ps(p_Output[kInvTransZ],
+               _mm_xor_ps(Simd::simdMadd(i20, px,
+                                         Simd::simdMadd(i21, py,
+                                                        _mm_mul_ps(i22, pz))),
+                          signMask));
+
+  // World AABB (Arvo): transform the center and project the half extent onto
+  // the world axes
+  const __m128 cx = _mm_load_ps(p_Input[kLocalCenterX]);
+  const __m128 cy = _mm_load_ps(p_Input[kLocalCenterY]);
+  const __m128 cz = _mm_load_ps(p_Input[kLocalCenterZ]);
+  const __m128 ex = _mm_load_ps(p_Input[kLocalHalfExtentX]);
+  const __m128 ey = _mm_load_ps(p_Input[kLocalHalfExtentY]);
+  const __m128 ez = _mm_load_ps(p_Input[kLocalHalfExtentZ]);
+
+  _mm_store_ps(p_Output[kWorldCenterX],
+               Simd::simdMadd(m00, cx, Simd::simdMadd(m01, cy,
+                                                      Simd::simdMadd(m02, cz,
+                                                                     px))));
+  _mm_store_ps(p_Output[kWorldCenterY],
+               Simd::simdMadd(m10, cx, Simd::simdMadd(m11, cy,
+                                                      Simd::simdMadd(m12, cz,
+                                                                     py))));
+  _mm_store_ps(p_Output[kWorldCenterZ],
+               Simd::simdMadd(m20, cx, Simd::simdMadd(m21, cy,
+                                                      Simd::simdMadd(m22, cz,
+                                                                     pz))));
+
+  const __m128 wex = Simd::simdMadd(
+      _mm_andnot_ps(signMask, m00), ex,
+      Simd::simdMadd(_mm_andnot_ps(signMask, m01), ey,
+                     _mm_mul_ps(_mm_andnot_ps(signMask, m02), ez)));
+  const __m128 wey = Simd::simdMadd(
+      _mm_andnot_ps(signMask, m10), ex,
+      Simd::simdMadd(_mm_andnot_ps(signMask, m11), ey,
+                     _mm_mul_ps(_mm_andnot_ps(signMask, m12), ez)));
+  const __m128 wez = Simd::simdMadd(
+      _mm_andnot_ps(signMask, m20), ex,
+      Simd::simdMadd(_mm_andnot_ps(signMask, m21), ey,
+                     _mm_mul_ps(_mm_andnot_ps(signMask, m22), ez)));
+
+  _mm_store_ps(p_Output[kWorldHalfExtentX], wex);
+  _mm_store_ps(p_Output[kWorldHalfExtentY], wey);
+  _mm_store_ps(p_Output[kWorldHalfExtentZ], wez);
+  _mm_store_ps(p_Output[kWorldRadius],
+               _mm_sqrt_ps(Simd::simdMadd(
+                   wex, wex, Simd::simdMadd(wey, wey, _mm_mul_ps(wez, wez)))));
+}
+
+// <-
+
+_INTR_TARGET_AVX2 void calcWorldMatricesAvx2(const TransformLanes* p_Input,
+                                             TransformLanes* p_Output)
+{
+  using namespace TransformInput;
+  using namespace TransformOutput;
+
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 two = _mm256_set1_ps(2.0f);
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+  const __m256 px = _mm256_load_ps(p_Input[kPosX]);
+  const __m256 py = _mm256_load_ps(p_Input[kPosY]);
+  const __m256 pz = _mm256_load_ps(p_Input[kPosZ]);
+
+  const __m256 qx = _mm256_load_ps(p_Input[kOrientX]);
+  const __m256 qy = _mm256_load_ps(p_Input[kOrientY]);
+  const __m256 qz = _mm256_load_ps(p_Input[kOrientZ]);
+  const __m256 qw = _mm256_load_ps(p_Input[kOrientW]);
+
+  const __m256 sx = _mm256_load_ps(p_Input[kSizeX]);
+  const __m256 sy = _mm256_load_ps(p_Input[kSizeY]);
+  const __m256 sz = _mm256_load_ps(p_Input[kSizeZ]);
+
+  // Rotation matrix of the (unit) quaternion
+  const __m256 xx = _mm256_mul_ps(qx, qx);
+  const __m256 yy = _mm256_mul_ps(qy, qy);
+  const __m256 zz = _mm256_mul_ps(qz, qz);
+  const __m256 xy = _mm256_mul_ps(qx, qy);
+  const __m256 xz = _mm256_mul_ps(qx, qz);
+  const __m256 yz = _mm256_mul_ps(qy, qz);
+  const __m256 wx = _mm256_mul_ps(qw, qx);
+  const __m256 wy = _mm256_mul_ps(qw, qy);
+  const __m256 wz = _mm256_mul_ps(qw, qz);
+
+  const __m256 r00 = _mm256_fnmadd_ps(two, _mm256_add_ps(yy, zz), one);
+  const __m256 r01 = _mm256_mul_ps(two, _mm256_sub_ps(xy, wz));
+  const __m256 r02 = _mm256_mul_ps(two, _mm256_add_ps(xz, wy));
+  const __m256 r10 = _mm256_mul_ps(two, _mm256_add_ps(xy, wz));
+  const __m256 r11 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, zz), one);
+  const __m256 r12 = _mm256_mul_ps(two, _mm256_sub_ps(yz, wx));
+  const __m256 r20 = _mm256_mul_ps(two, _mm256_sub_ps(xz, wy));
+  const __m256 r21 = _mm256_mul_ps(two, _mm256_add_ps(yz, wx));
+  const __m256 r22 = _mm256_fnmadd_ps(two, _mm256_add_ps(xx, yy), one);
+
+  // World matrix: T * R * S
+  const __m256 m00 = _mm256_mul_ps(r00, sx);
+  const __m256 m01 = _mm256_mul_ps(r01, sy);
+  const __m256 m02 = _mm256_mul_ps(r02, sz);
+  const __m256 m10 = _mm256_mul_ps(r10, sx);
+  const __m256 m11 = _mm256_mul_ps(r11, sy);
+  const __m256 m12 = _mm256_mul_ps(r12, sz);
+  const __m256 m20 = _mm256_mul_ps(r20, sx);
+  const __m256 m21 = _mm256_mul_ps(r21, sy);
+  const __m256 m22 = _mm256_mul_ps(r22, sz);
+
+  _mm256_store_ps(p_Output[kM00], m00);
+  _mm256_store_ps(p_Output[kM01], m01);
+  _mm256_store_ps(p_Output[kM02], m02);
+  _mm256_store_ps(p_Output[kM10], m10);
+  _mm256_store_ps(p_Output[kM11], m11);
+  _mm256_store_ps(p_Output[kM12], m12);
+  _mm256_store_ps(p_Output[kM20], m20);
+  _mm256_store_ps(p_Output[kM21], m21);
+  _mm256_store_ps(p_Output[kM22], m22);
+
+  // Affine inverse: S^-1 * R^T and -(S^-1 * R^T) * t
+  const __m256 rsx = _mm256_div_ps(one, sx);
+  const __m256 rsy = _mm256_div_ps(one, sy);
+  const __m256 rsz = _mm256_div_ps(one, sz);
+
+  const __m256 i00 = _mm256_mul_ps(r00, rsx);
+  const __m256 i01 = _mm256_mul_ps(r10, rsx);
+  const __m256 i02 = _mm256_mul_ps(r20, rsx);
+  const __m256 i10 = _mm256_mul_ps(r01, rsy);
+  const __m256 i11 = _mm256_mul_ps(r11, rsy);
+  const __m256 i12 = _mm256_mul_ps(r21, rsy);
+  const __m256 i20 = _mm256_mul_ps(r02, rsz);
+  const __m256 i21 = _mm256_mul_ps(r12, rsz);
+  const __m256 i22 = _mm256_mul_ps(r22, rsz);
+
+  _mm256_store_ps(p_Output[kInv00], i00);
+  _mm256_store_ps(p_Output[kInv01], i01);
+  _mm256_store_ps(p_Output[kInv02], i02);
+  _mm256_store_ps(p_Output[kInv10], i10);
+  _mm256_store_ps(p_Output[kInv11], i11);
+  _mm256_store_ps(p_Output[kInv12], i12);
+  _mm256_store_ps(p_Output[kInv20], i20);
+  _mm256_store_ps(p_Output[kInv21], i21);
+  _mm256_store_ps(p_Output[kInv22], i22);
+
+  _mm256_store_ps(
+      p_Output[kInvTransX],
+      _mm256_xor_ps(_mm256_fmadd_ps(i00, px,
+                                    _mm256_fmadd_ps(i01, py,
+                                                    _mm256_mul_ps(i02, pz))),
+                    signMask));
+  _mm256_store_ps(
+      p_Output[kInvTransY],
+      _mm256_xor_ps(_mm256_fmadd_ps(i10, px,
+                                    _mm256_fmadd_ps(i11, py,
+                                                    _mm256_mul_ps(i12, pz))),
+                    signMask));
+  _mm256_store_ps(
+      p_Output[kInvTransZ],
+      _mm256_xor_ps(_mm256_fmadd_ps(i20, px,
+                                    _mm256_fmadd_ps(i21, py,
+                                                    _mm256_mul_ps(i22, pz))),
+                    signMask));
+
+  // World AABB (Arvo): transform the center and project the half extent onto
+  // the world axes
+  const __m256 cx = _mm256_load_ps(p_Input[kLocalCenterX]);
+  const __m256 cy = _mm256_load_ps(p_Input[kLocalCenterY]);
+  const __m256 cz = _mm256_load_ps(p_Input[kLocalCenterZ]);
+  const __m256 ex = _mm256_load_ps(p_Input[kLocalHalfExtentX]);
+  const __m256 ey = _mm256_load_ps(p_Input[kLocalHalfExtentY]);
+  const __m256 ez = _mm256_load_ps(p_Input[kLocalHalfExtentZ]);
+
+  _mm256_store_ps(
+      p_Output[kWorldCenterX],
+      _mm256_fmadd_ps(
+          m00, cx, _mm256_fmadd_ps(m01, cy, _mm256_fmadd_ps(m02, cz, px))));
+  _mm256_store_ps(
+      p_Output[kWorldCenterY],
+      _mm256_fmadd_ps(
+          m10, cx, _mm256_fmadd_ps(m11, cy, _mm256_fmadd_ps(m12, cz, py))));
+  _mm256_store_ps(
+      p_Output[kWorldCenterZ],
+      _mm256_fmadd_ps(
+          m20, cx, _mm256_fmadd_ps(m21, cy, _mm256_fmadd_ps(m22, cz, pz))));
+
+  const __m256 wex = _mm256_fmadd_ps(
+      _mm256_andnot_ps(signMask, m00), ex,
+      _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m01), ey,
+                      _mm256_mul_ps(_mm256_andnot_ps(signMask, m02), ez)));
+  const __m256 wey = _mm256_fmadd_ps(
+      _mm256_andnot_ps(signMask, m10), ex,
+      _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m11), ey,
+                      _mm256_mul_ps(_mm256_andnot_ps(signMask, m12), ez)));
+  const __m256 wez = _mm256_fmadd_ps(
+      _mm256_andnot_ps(signMask, m20), ex,
+      _mm256_fmadd_ps(_mm256_andnot_ps(signMask, m21), ey,
+                      _mm256_mul_ps(_mm256_andnot_ps(signMask, m22), ez)));
+
+  _mm256_store_ps(p_Output[kWorldHalfExtentX], wex);
+  _mm256_store_ps(p_Output[kWorldHalfExtentY], wey);
+  _mm256_store_ps(p_Output[kWorldHalfExtentZ], wez);
+  _mm256_store_ps(p_Output[kWorldRadius],
+                  _mm256_sqrt_ps(_mm256_fmadd_ps(
+                      wex, wex, _mm256_fmadd_ps(wey, wey,
+                                                _mm256_mul_ps(wez, wez)))));
+}
+
+// <-
+
+_INTR_INLINE void updateWorldTransform(NodeRef p_NodeRef)
+{
+  NodeRef parentNodeRef = NodeManager::_parent(p_NodeRef);
+
+  if (!parentNodeRef.isValid())
+  {
+    NodeManager::_worldPosition(p_NodeRef) = NodeManager::_position(p_NodeRef);
+    NodeManager::_worldOrientation(p_NodeRef) =
+        NodeManager::_orientation(p_NodeRef);
+    NodeManager::_worldSize(p_NodeRef) = NodeManager::_size(p_NodeRef);
+  }
+  else
+  {
+    const glm::vec3& parentPos = NodeManager::_worldPosition(parentNodeRef);
+    const glm::quat& parentOrient =
+        NodeManager::_worldOrientation(parentNodeRef);
+    const glm::vec3& parentSize = NodeManager::_worldSize(parentNodeRef);
+
+    const glm::vec3& localPos = NodeManager::_position(p_NodeRef);
+    const glm::quat& localOrient = NodeManager::_orientation(p_NodeRef);
+    const glm::vec3& localSize = NodeManager::_size(p_NodeRef);
+
+    const glm::vec3 worldPos = parentPos + (parentOrient * localPos);
+    const glm::quat worldOrient = parentOrient * localOrient;
+    const glm::vec3 worldSize = parentSize * localSize;
+
+    NodeManager::_worldPosition(p_NodeRef) = worldPos;
+    NodeManager::_worldOrientation(p_NodeRef) = worldOrient;
+    NodeManager::_worldSize(p_NodeRef) = worldSize;
+  }
+}
+
+// <-
+
+// Updates the world transforms of up to _INTR_TRANSFORM_NODES_PER_TASK nodes
+_INTR_INLINE void updateTransformsChunk(const NodeRef* p_Nodes,
+                                        uint32_t p_Count)
 {
-  for (uint32_t nodeIdx = 0u; nodeIdx < p_Nodes.size(); ++nodeIdx)
+  _INTR_ASSERT(p_Count <= _INTR_TRANSFORM_NODES_PER_TASK);
+  uint32_t nodeIds[_INTR_TRANSFORM_NODES_PER_TASK];
+
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    updateWorldTransform(p_Nodes[i]);
+    nodeIds[i] = p_Nodes[i]._id;
+  }
+
+  NodeManager::calcWorldMatrices(NodeManager::getTransformStreams(), nodeIds,
+                                 p_Count);
+}
+
+// <-
+
+struct TransformUpdateParallelTaskSet : enki::ITaskSet
+{
+  virtual ~TransformUpdateParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Nodes", "Update Transforms Job");
+
+    for (uint32_t chunkIdx = p_Range.start; chunkIdx < p_Range.end;
+         ++chunkIdx)
+    {
+      const uint32_t start = chunkIdx * _INTR_TRANSFORM_NODES_PER_TASK;
+      updateTransformsChunk(
+          &_nodes[start],
+          std::min(_INTR_TRANSFORM_NODES_PER_TASK, _nodeCount - start));
+    }
+  }
+
+  const NodeRef* _nodes;
+  uint32_t _nodeCount;
+};
+}
+
+// <-
+
+void NodeManager::calcWorldMatrices(const NodeTransformStreams& p_Streams,
+                                    const uint32_t* p_NodeIds,
+                                    uint32_t p_Count)
+{
+  _INTR_ALIGN(32) TransformLanes input[TransformInput::kCount];
+  _INTR_ALIGN(32) TransformLanes output[TransformOutput::kCount];
+
+  const bool avx2Supported = Simd::isAvx2Supported();
+  const uint32_t laneCount = avx2Supported ? 8u : 4u;
+
+  for (uint32_t i = 0u; i < p_Count; i += laneCount)
   {
-    NodeRef nodeRef = p_Nodes[nodeIdx];
-    NodeRef parentNodeRef = _parent(nodeRef);
+    const uint32_t count = std::min(laneCount, p_Count - i);
 
-    if (!parentNodeRef.isValid())
+    gatherTransformInput(p_Streams, &p_NodeIds[i], count, laneCount, input);
+
+    if (avx2Supported)
     {
-      _worldPosition(nodeRef) = _position(nodeRef);
-      _worldOrientation(nodeRef) = _orientation(nodeRef);
-      _worldSize(nodeRef) = _size(nodeRef);
+      calcWorldMatricesAvx2(input, output);
     }
     else
     {
-      const glm::vec3& parentPos = _worldPosition(parentNodeRef);
-      const glm::quat& parentOrient = _worldOrientation(parentNodeRef);
-      const glm::vec3& parentSize = _worldSize(parentNodeRef);
+      calcWorldMatricesSse(input, output);
+    }
 
-      const glm::vec3& localPos = _position(nodeRef);
-      const glm::quat& localOrient = _orientation(nodeRef);
-      const glm::vec3& localSize = _size(nodeRef);
+    scatterTransformOutput(p_Streams, &p_NodeIds[i], count, output);
+  }
+}
 
-      const glm::vec3 worldPos = parentPos + (parentOrient * localPos);
-      const glm::quat worldOrient = parentOrient * localOrient;
-      const glm::vec3 worldSize = parentSize * localSize;
+// <-
 
-      _worldPosition(nodeRef) = worldPos;
-      _worldOrientation(nodeRef) = worldOrient;
-      _worldSize(nodeRef) = worldSize;
+void NodeManager::updateTransforms(const NodeRefArray& p_Nodes)
+{
+  const uint32_t nodeCount = (uint32_t)p_Nodes.size();
+
+  // Chunks are processed in order, so parents are still updated before their
+  // children
+  for (uint32_t start = 0u; start < nodeCount;
+       start += _INTR_TRANSFORM_NODES_PER_TASK)
+  {
+    const uint32_t count =
+        std::min(_INTR_TRANSFORM_NODES_PER_TASK, nodeCount - start);
+    updateTransformsChunk(&p_Nodes[start], count);
+
+    for (uint32_t i = start; i < start + count; ++i)
+    {
+      _flags(p_Nodes[i]) &= ~NodeFlags::kTransformDirty;
+      internalAddToUpdatedNodes(p_Nodes[i]);
     }
+  }
+}
 
-    glm::mat4 rot = glm::mat4_cast(NodeManager::_worldOrientation(nodeRef));
-    glm::mat4 trans =
-        glm::translate(glm::mat4(1.0f), NodeManager::_worldPosition(nodeRef));
-    glm::mat4 scale =
-        glm::scale(glm::mat4(1.0f), NodeManager::_worldSize(nodeRef));
+// <-
 
-    _worldMatrix(nodeRef) = trans * rot * scale;
-    _inverseWorldMatrix(nodeRef) = glm::inverse(_worldMatrix(nodeRef));
+void NodeManager::updateDirtyTransforms()
+{
+  _INTR_PROFILE_CPU("Nodes", "Update Dirty Transforms");
 
-    // Update AABB
-    // TODO: Merge sub meshes
-    Components::MeshRef meshCompRef =
-        Components::MeshManager::getComponentForEntity(_entity(nodeRef));
-    if (meshCompRef.isValid())
+  static TransformUpdateParallelTaskSet transformUpdateTaskSet;
+
+  _dirtyNodes.clear();
+
+  for (uint32_t levelIdx = 0u; levelIdx + 1u < _sortedNodeLevelOffsets.size();
+       ++levelIdx)
+  {
+    const uint32_t levelStart = (uint32_t)_dirtyNodes.size();
+
+    for (uint32_t i = _sortedNodeLevelOffsets[levelIdx];
+         i < _sortedNodeLevelOffsets[levelIdx + 1u]; ++i)
     {
-      Name& meshName = Components::MeshManager::_descMeshName(meshCompRef);
-      Resources::MeshRef meshRef =
-          Resources::MeshManager::_getResourceByName(meshName);
+      NodeRef nodeRef = _sortedNodes[i];
+      uint32_t& flags = _flags(nodeRef);
 
-      if (meshRef.isValid())
+      // Propagate changes of the parent node - the parent is always placed on
+      // the previous level and thus already got updated
+      const uint32_t parentIdx = _sortedNodeParentIndices[i];
+      if (parentIdx != Dod::kInvalidId &&
+          (_flags(_sortedNodes[parentIdx]) & NodeFlags::kTransformUpdated) >
+              0u)
       {
-        const uint32_t aabbCount =
-            (uint32_t)Resources::MeshManager::_aabbPerSubMesh(meshRef).size();
-
-        if (aabbCount > 0u)
-        {
-          _localAABB(nodeRef) =
-              Resources::MeshManager::_aabbPerSubMesh(meshRef)[0u];
-          _worldAABB(nodeRef) = _localAABB(nodeRef);
-          Math::transformAABBAffine(_worldAABB(nodeRef), _worldMatrix(nodeRef));
-
-          _worldBoundingSphere(nodeRef) = {
-              Math::calcAABBCenter(_worldAABB(nodeRef)),
-              glm::length(Math::calcAABBHalfExtent(_worldAABB(nodeRef)))};
-        }
+        flags |= NodeFlags::kTransformDirty;
       }
+
+      if ((flags & NodeFlags::kTransformDirty) == 0u)
+      {
+        continue;
+      }
+
+      flags &= ~NodeFlags::kTransformDirty;
+      flags |= NodeFlags::kTransformUpdated;
+      _dirtyNodes.push_back(nodeRef);
+    }
+
+    const uint32_t levelNodeCount =
+        (uint32_t)_dirtyNodes.size() - levelStart;
+    if (levelNodeCount == 0u)
+    {
+      continue;
+    }
+
+    // The nodes of a single level don't depend on each other and can be
+    // updated in parallel
+    transformUpdateTaskSet._nodes = &_dirtyNodes[levelStart];
+    transformUpdateTaskSet._nodeCount = levelNodeCount;
+    transformUpdateTaskSet.m_SetSize =
+        (levelNodeCount + _INTR_TRANSFORM_NODES_PER_TASK - 1u) /
+        _INTR_TRANSFORM_NODES_PER_TASK;
+
+    if (levelNodeCount >= _INTR_TRANSFORM_MIN_PARALLEL_NODE_COUNT)
+    {
+      Application::_scheduler.AddTaskSetToPipe(&transformUpdateTaskSet);
+      Application::_scheduler.WaitforTaskSet(&transformUpdateTaskSet);
     }
     else
     {
-      _worldAABB(nodeRef) =
-          Math::AABB(_worldPosition(nodeRef) - glm::vec3(0.5f),
-                     _worldPosition(nodeRef) + glm::vec3(0.5f));
+      enki::TaskSetPartition range;
+      range.start = 0u;
+      range.end = transformUpdateTaskSet.m_SetSize;
+      transformUpdateTaskSet.ExecuteRange(range, 0u);
     }
   }
+
+  for (uint32_t i = 0u; i < _dirtyNodes.size(); ++i)
+  {
+    _flags(_dirtyNodes[i]) &= ~NodeFlags::kTransformUpdated;
+    internalAddToUpdatedNodes(_dirtyNodes[i]);
+  }
+}
+
+// <-
+
+void NodeManager::updateLocalAABB(NodeRef p_Ref)
+{
+  _flags(p_Ref) &= ~NodeFlags::kLocalAABBFromMesh;
+
+  // TODO: Merge sub meshes
+  Components::MeshRef meshCompRef =
+      Components::MeshManager::getComponentForEntity(_entity(p_Ref));
+  if (meshCompRef.isValid())
+  {
+    Name& meshName = Components::MeshManager::_descMeshName(meshCompRef);
+    Resources::MeshRef meshRef =
+        Resources::MeshManager::_getResourceByName(meshName);
+
+    if (meshRef.isValid() &&
+        !Resources::MeshManager::_aabbPerSubMesh(meshRef).empty())
+    {
+      _localAABB(p_Ref) = Resources::MeshManager::_aabbPerSubMesh(meshRef)[0u];
+      _flags(p_Ref) |= NodeFlags::kLocalAABBFromMesh;
+    }
+  }
+
+  markTransformDirty(p_Ref);
 }
 }
 }
@@ -29,6 +29,16 @@ namespace NodeFlags
 enum Flags
 {
   kSpawned = 0x01u,
+
+  // Set if the local transform (or the transform of one of the parent nodes)
+  // changed and the world transform has to be recalculated
+  kTransformDirty = 0x02u,
+  // Set for all nodes which got updated during the current dirty node sweep
+  kTransformUpdated = 0x04u,
+  // Set if the local AABB of the node has been retrieved from a mesh
+  kLocalAABBFromMesh = 0x08u,
+  // Set if the node is part of the updated nodes array
+  kWorldTransformChanged = 0x10u
 };
 }
 
@@ -89,6 +99,25 @@ struct NodeData : Dod::Components::ComponentDataBase
   _INTR_ARRAY(NodeRef) nextSibling;
 };
 
+/**
+ * The input and output streams used to calculate the world matrices and world
+ * bounding volumes of a batch of Nodes. All arrays are indexed using the ids of
+ * the Nodes.
+ */
+struct NodeTransformStreams
+{
+  const uint32_t* flags;
+  const glm::vec3* worldPosition;
+  const glm::quat* worldOrientation;
+  const glm::vec3* worldSize;
+  const Math::AABB* localAABB;
+
+  glm::mat4x4* worldMatrix;
+  glm::mat4x4* inverseWorldMatrix;
+  Math::AABB* worldAABB;
+  Math::Sphere* worldBoundingSphere;
+};
+
 /**
  * The manager for all Node Components.
  */
@@ -112,7 +141,7 @@ struct NodeManager
     _firstChild(p_Ref) = NodeRef();
     _prevSibling(p_Ref) = NodeRef();
     _nextSibling(p_Ref) = NodeRef();
-    _flags(p_Ref) = 0u;
+    _flags(p_Ref) = NodeFlags::kTransformDirty;
 
     _position(p_Ref) = _worldPosition(p_Ref) = glm::vec3();
     _orientation(p_Ref) = _worldOrientation(p_Ref) =
@@ -232,18 +261,52 @@ struct NodeManager
   // <-
 
   /**
-   * Rebuilds the internal sorted node array.
+   * Rebuilds the internal sorted node array. The nodes are sorted level by
+   * level, so parent nodes are always placed in front of their child nodes and
+   * all nodes of the same depth are stored next to each other.
    */
   _INTR_INLINE static void rebuildTree()
   {
     _sortedNodes.clear();
+    _sortedNodeLevelOffsets.clear();
 
     for (uint32_t i = 0; i < _rootNodes.size(); ++i)
     {
-      NodeRef currentRootNode = _rootNodes[i];
+      _sortedNodes.push_back(_rootNodes[i]);
+    }
 
-      NodeRefArray nodes;
-      collectNodes(currentRootNode, _sortedNodes);
+    // Append the children of the previous level until we run out of nodes
+    uint32_t levelStart = 0u;
+    while (levelStart < _sortedNodes.size())
+    {
+      const uint32_t levelEnd = (uint32_t)_sortedNodes.size();
+      _sortedNodeLevelOffsets.push_back(levelStart);
+
+      for (uint32_t i = levelStart; i < levelEnd; ++i)
+      {
+        NodeRef childNodeRef = _firstChild(_sortedNodes[i]);
+        while (childNodeRef.isValid())
+        {
+          _sortedNodes.push_back(childNodeRef);
+          childNodeRef = _nextSibling(childNodeRef);
+        }
+      }
+
+      levelStart = levelEnd;
+    }
+    _sortedNodeLevelOffsets.push_back((uint32_t)_sortedNodes.size());
+
+    // Store the index of the parent node in the sorted array for each node
+    _sortedNodeParentIndices.resize(_sortedNodes.size());
+    for (uint32_t i = 0u; i < _sortedNodes.size(); ++i)
+    {
+      NodeRef nodeRef = _sortedNodes[i];
+      NodeRef parentNodeRef = _parent(nodeRef);
+
+      _sortedIndices[nodeRef._id] = i;
+      _sortedNodeParentIndices[i] = parentNodeRef.isValid()
+                                        ? _sortedIndices[parentNodeRef._id]
+                                        : Dod::kInvalidId;
     }
   }
 
@@ -266,6 +329,85 @@ struct NodeManager
 
   // <-
 
+  /**
+   * Marks the transform of the given Node as dirty. The world transform of the
+   * Node and all of its children is updated during the next call to
+   * updateDirtyTransforms().
+   */
+  _INTR_INLINE static void markTransformDirty(NodeRef p_Ref)
+  {
+    _flags(p_Ref) |= NodeFlags::kTransformDirty;
+  }
+
+  // <-
+
+  /**
+   * Updates the transformations of all dirty Nodes and their children. The
+   * sorted nodes are processed level by level and the world matrices of each
+   * level are calculated in parallel.
+   */
+  static void updateDirtyTransforms();
+
+  // <-
+
+  /**
+   * Clears the array of Nodes which got updated since the last call to this
+   * function.
+   */
+  _INTR_INLINE static void resetUpdatedNodes()
+  {
+    for (uint32_t i = 0u; i < _updatedNodes.size(); ++i)
+    {
+      _flags(_updatedNodes[i]) &= ~NodeFlags::kWorldTransformChanged;
+    }
+    _updatedNodes.clear();
+  }
+
+  // <-
+
+  /**
+   * Calculates the world matrices, the inverse world matrices and the world
+   * bounding volumes for the given Nodes. The world position, orientation and
+   * size have to be up to date. Processes eight (AVX2) or four (SSE) Nodes at
+   * once.
+   */
+  static void calcWorldMatrices(const NodeTransformStreams& p_Streams,
+                                const uint32_t* p_NodeIds, uint32_t p_Count);
+
+  // <-
+
+  /**
+   * Returns the transform streams pointing to the data of this manager.
+   */
+  _INTR_INLINE static NodeTransformStreams getTransformStreams()
+  {
+    NodeTransformStreams streams;
+    {
+      streams.flags = _data.flags.data();
+      streams.worldPosition = _data.worldPosition.data();
+      streams.worldOrientation = _data.worldOrientation.data();
+      streams.worldSize = _data.worldSize.data();
+      streams.localAABB = _data.localAABB.data();
+
+      streams.worldMatrix = _data.worldMatrix.data();
+      streams.inverseWorldMatrix = _data.inverseWorldMatrix.data();
+      streams.worldAABB = _data.worldAABB.data();
+      streams.worldBoundingSphere = _data.worldBoundingSphere.data();
+    }
+
+    return streams;
+  }
+
+  // <-
+
+  /**
+   * Retrieves the local AABB of the given Node from the attached Mesh
+   * Component. If any.
+   */
+  static void updateLocalAABB(NodeRef p_Ref);
+
+  // <-
+
   /**
    * Updates the transformations recursively starting at the given Node.
    */
@@ -541,6 +683,7 @@ struct NodeManager
                                        const glm::vec3& p_Position)
   {
     _data.position[p_Ref._id] = p_Position;
+    markTransformDirty(p_Ref);
   }
 
   /**
@@ -558,6 +701,7 @@ struct NodeManager
                                           const glm::quat& p_Orientation)
   {
     _data.orientation[p_Ref._id] = p_Orientation;
+    markTransformDirty(p_Ref);
   }
 
   /**
@@ -574,6 +718,7 @@ struct NodeManager
   _INTR_INLINE static void setSize(NodeRef p_Ref, const glm::vec3& p_Size)
   {
     _data.size[p_Ref._id] = p_Size;
+    markTransformDirty(p_Ref);
   }
 
   // Resources
@@ -750,6 +895,19 @@ private:
     }
   }
 
+  /**
+   * Adds the given Node to the updated nodes array. If not present already.
+   */
+  _INTR_INLINE static void internalAddToUpdatedNodes(NodeRef p_Ref)
+  {
+    uint32_t& flags = _flags(p_Ref);
+    if ((flags & NodeFlags::kWorldTransformChanged) == 0u)
+    {
+      flags |= NodeFlags::kWorldTransformChanged;
+      _updatedNodes.push_back(p_Ref);
+    }
+  }
+
   // <-
 
   /**
@@ -760,6 +918,31 @@ private:
    * The sorted nodes of all trees.
    */
   static NodeRefArray _sortedNodes;
+  /**
+   * The index of the parent node in the sorted node array for each sorted
+   * node.
+   */
+  static _INTR_ARRAY(uint32_t) _sortedNodeParentIndices;
+  /**
+   * The index in the sorted node array for each node.
+   */
+  static _INTR_ARRAY(uint32_t) _sortedIndices;
+  /**
+   * The index of the first node of each level in the sorted node array. The
+   * last entry marks the end of the last level.
+   */
+  static _INTR_ARRAY(uint32_t) _sortedNodeLevelOffsets;
+  /**
+   * The dirty nodes of the current sweep sorted by level.
+   */
+  static NodeRefArray _dirtyNodes;
+
+public:
+  /**
+   * The nodes whose world transform got updated since the last call to
+   * resetUpdatedNodes().
+   */
+  static NodeRefArray _updatedNodes;
 };
 }
 }
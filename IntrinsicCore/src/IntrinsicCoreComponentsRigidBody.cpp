@@ -207,7 +207,7 @@ physx::PxRigidActor* createTriangleMeshStaticKinematic(RigidBodyRef p_Ref,
   {
     _INTR_LOG_WARNING(
         "No physics triangle mesh available for mesh \"%s\"!",
-        Resources::MeshManager::_name(meshRef).getString().c_str());
+        Resources::MeshManager::_name(meshRef).getCString());
     return nullptr;
   }
 
@@ -275,7 +275,7 @@ physx::PxRigidActor* createConvexMeshDynamicKinematic(RigidBodyRef p_Ref,
   {
     _INTR_LOG_WARNING(
         "No physics convex mesh available for mesh \"%s\"!",
-        Resources::MeshManager::_name(meshRef).getString().c_str());
+        Resources::MeshManager::_name(meshRef).getCString());
     return nullptr;
   }
 
@@ -328,7 +328,7 @@ physx::PxRigidActor* createConvexMeshStatic(RigidBodyRef p_Ref)
   {
     _INTR_LOG_WARNING(
         "No physics convex mesh available for mesh \"%s\"!",
-        Resources::MeshManager::_name(meshRef).getString().c_str());
+        Resources::MeshManager::_name(meshRef).getCString());
     return nullptr;
   }
 
@@ -449,7 +449,7 @@ void RigidBodyManager::updateNodesFromActors(
       NodeManager::updateFromWorldPosition(nodeCompRef, worldPosition);
       NodeManager::updateFromWorldOrientation(nodeCompRef, worldOrientation);
 
-      NodeManager::updateTransforms(nodeCompRef);
+      NodeManager::markTransformDirty(nodeCompRef);
     }
   }
 }
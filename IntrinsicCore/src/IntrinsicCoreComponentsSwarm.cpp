@@ -209,6 +209,7 @@ void SwarmManager::simulateSwarms(const SwarmRefArray& p_Swarms, float p_DeltaT)
         Components::NodeManager::_position(nodeRef) = boid.pos;
         Components::NodeManager::_orientation(nodeRef) = glm::rotation(
             glm::vec3(0.0f, 0.0f, 1.0f), glm::normalize(boid.vel + 0.01f));
+        Components::NodeManager::markTransformDirty(nodeRef);
 
         // Update lights and mesh color
         glm::vec4 boidColor = glm::vec4(boid.color, 1.0f);
@@ -223,8 +224,6 @@ void SwarmManager::simulateSwarms(const SwarmRefArray& p_Swarms, float p_DeltaT)
         Components::MeshManager::_descColorTint(meshes[boidIdx]) = boidColor;
         Components::LightManager::_descColor(lights[boidIdx]) = boidColor;
       }
-
-      Components::NodeManager::updateTransforms(nodes);
     }
 
     currentCenterOfMass = newCenterOfMass / (float)boids.size();
@@ -0,0 +1,298 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+// The maximum amount of Nodes stored in a single leaf node
+#define _INTR_BVH_MAX_LEAF_ITEM_COUNT 8u
+// The amount of subtrees the traversal is split into (at least)
+#define _INTR_BVH_MIN_TASK_ROOT_COUNT 32u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Culling
+{
+// Static members
+_INTR_ARRAY(BvhNode) Bvh::_nodes;
+Components::NodeRefArray Bvh::_items;
+_INTR_ARRAY(float) Bvh::_sphereX;
+_INTR_ARRAY(float) Bvh::_sphereY;
+_INTR_ARRAY(float) Bvh::_sphereZ;
+_INTR_ARRAY(float) Bvh::_sphereRadius;
+_INTR_ARRAY(uint32_t) Bvh::_taskRoots;
+_INTR_ARRAY(uint32_t) Bvh::_leafIndices;
+_INTR_ARRAY(uint32_t) Bvh::_itemIndices;
+bool Bvh::_rebuildRequested = true;
+
+namespace
+{
+_INTR_INLINE Math::AABB calcItemAABB(Components::NodeRef p_NodeRef)
+{
+  const Math::Sphere& sphere =
+      Components::NodeManager::_worldBoundingSphere(p_NodeRef);
+  return Math::AABB(sphere.p - sphere.r, sphere.p + sphere.r);
+}
+
+// <-
+
+_INTR_INLINE Math::AABB calcItemRangeAABB(uint32_t p_FirstItem,
+                                          uint32_t p_ItemCount)
+{
+  Math::AABB aabb;
+  Math::initAABB(aabb);
+
+  for (uint32_t i = p_FirstItem; i < p_FirstItem + p_ItemCount; ++i)
+  {
+    Math::mergeAABBToAABB(aabb, calcItemAABB(Bvh::_items[i]));
+  }
+
+  return aabb;
+}
+
+// <-
+
+_INTR_INLINE bool isAABBEqual(const Math::AABB& p_Lhs, const Math::AABB& p_Rhs)
+{
+  return p_Lhs.min == p_Rhs.min && p_Lhs.max == p_Rhs.max;
+}
+
+// <-
+
+void buildNode(uint32_t p_NodeIdx, uint32_t p_Parent, uint32_t p_FirstItem,
+               uint32_t p_ItemCount, _INTR_ARRAY(uint32_t) & p_LeafIndices)
+{
+  BvhNode& node = Bvh::_nodes[p_NodeIdx];
+  node.aabb = calcItemRangeAABB(p_FirstItem, p_ItemCount);
+  node.parent = p_Parent;
+  node.firstChild = Dod::kInvalidId;
+  node.firstItem = p_FirstItem;
+  node.itemCount = p_ItemCount;
+
+  if (p_ItemCount <= _INTR_BVH_MAX_LEAF_ITEM_COUNT)
+  {
+    for (uint32_t i = p_FirstItem; i < p_FirstItem + p_ItemCount; ++i)
+    {
+      p_LeafIndices[Bvh::_items[i]._id] = p_NodeIdx;
+    }
+    return;
+  }
+
+  // Split at the median along the longest axis of the sphere centers
+  Math::AABB centerAABB;
+  Math::initAABB(centerAABB);
+  for (uint32_t i = p_FirstItem; i < p_FirstItem + p_ItemCount; ++i)
+  {
+    Math::mergePointToAABB(
+        centerAABB,
+        Components::NodeManager::_worldBoundingSphere(Bvh::_items[i]).p);
+  }
+
+  const glm::vec3 centerExtent = centerAABB.max - centerAABB.min;
+  uint32_t axis = 0u;
+  if (centerExtent.y > centerExtent[axis])
+    axis = 1u;
+  if (centerExtent.z > centerExtent[axis])
+    axis = 2u;
+
+  const uint32_t leftItemCount = p_ItemCount / 2u;
+  Components::NodeRefArray::iterator first =
+      Bvh::_items.begin() + p_FirstItem;
+  std::nth_element(
+      first, first + leftItemCount, first + p_ItemCount,
+      [axis](Components::NodeRef p_Lhs, Components::NodeRef p_Rhs) {
+        return Components::NodeManager::_worldBoundingSphere(p_Lhs).p[axis] <
+               Components::NodeManager::_worldBoundingSphere(p_Rhs).p[axis];
+      });
+
+  // Both children are allocated next to each other
+  const uint32_t firstChild = (uint32_t)Bvh::_nodes.size();
+  Bvh::_nodes.resize(Bvh::_nodes.size() + 2u);
+  Bvh::_nodes[p_NodeIdx].firstChild = firstChild;
+
+  buildNode(firstChild, p_NodeIdx, p_FirstItem, leftItemCount, p_LeafIndices);
+  buildNode(firstChild + 1u, p_NodeIdx, p_FirstItem + leftItemCount,
+            p_ItemCount - leftItemCount, p_LeafIndices);
+}
+}
+
+// <-
+
+void Bvh::init()
+{
+  _INTR_LOG_INFO("Inititializing Culling BVH...");
+
+  _nodes.reserve(2u * _INTR_MAX_NODE_COMPONENT_COUNT);
+  _items.reserve(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _leafIndices.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+  _itemIndices.resize(_INTR_MAX_NODE_COMPONENT_COUNT);
+
+  // Padded so the culling kernels can always read eight spheres at once
+  _sphereX.resize(_INTR_MAX_NODE_COMPONENT_COUNT + 8u);
+  _sphereY.resize(_INTR_MAX_NODE_COMPONENT_COUNT + 8u);
+  _sphereZ.resize(_INTR_MAX_NODE_COMPONENT_COUNT + 8u);
+  _sphereRadius.resize(_INTR_MAX_NODE_COMPONENT_COUNT + 8u);
+
+  Resources::EventManager::connect(
+      _N(NodeCreated), [](Resources::EventRef) { _rebuildRequested = true; });
+  Resources::EventManager::connect(
+      _N(NodeDestroyed), [](Resources::EventRef) { _rebuildRequested = true; });
+}
+
+// <-
+
+void Bvh::update()
+{
+  _INTR_PROFILE_CPU("Culling", "Update BVH");
+
+  const uint32_t nodeCount =
+      Components::NodeManager::getActiveResourceCount();
+
+  // Rebuilding restores the quality of the tree and is not more expensive
+  // than refitting if a large part of the Nodes moved
+  if (_rebuildRequested || nodeCount != _items.size() ||
+      Components::NodeManager::_updatedNodes.size() > nodeCount / 4u)
+  {
+    rebuild();
+  }
+  else
+  {
+    refit();
+  }
+
+  Components::NodeManager::resetUpdatedNodes();
+}
+
+// <-
+
+void Bvh::rebuild()
+{
+  _INTR_PROFILE_CPU("Culling", "Rebuild BVH");
+
+  _rebuildRequested = false;
+
+  _nodes.clear();
+  _items.clear();
+  _taskRoots.clear();
+
+  const uint32_t nodeCount =
+      Components::NodeManager::getActiveResourceCount();
+  if (nodeCount == 0u)
+  {
+    return;
+  }
+
+  for (uint32_t i = 0u; i < nodeCount; ++i)
+  {
+    _items.push_back(Components::NodeManager::getActiveResourceAtIndex(i));
+  }
+
+  _nodes.resize(1u);
+  buildNode(0u, Dod::kInvalidId, 0u, nodeCount, _leafIndices);
+
+  for (uint32_t i = 0u; i < nodeCount; ++i)
+  {
+    _itemIndices[_items[i]._id] = i;
+    updateSphere(i);
+  }
+
+  // Split the tree into enough subtrees to keep all worker threads busy
+  _taskRoots.push_back(0u);
+  _INTR_ARRAY(uint32_t) nextTaskRoots;
+  while (_taskRoots.size() < _INTR_BVH_MIN_TASK_ROOT_COUNT)
+  {
+    nextTaskRoots.clear();
+    for (uint32_t i = 0u; i < _taskRoots.size(); ++i)
+    {
+      const BvhNode& node = _nodes[_taskRoots[i]];
+      if (node.firstChild != Dod::kInvalidId)
+      {
+        nextTaskRoots.push_back(node.firstChild);
+        nextTaskRoots.push_back(node.firstChild + 1u);
+      }
+      else
+      {
+        nextTaskRoots.push_back(_taskRoots[i]);
+      }
+    }
+
+    // Only leaf nodes left
+    if (nextTaskRoots.size() == _taskRoots.size())
+    {
+      break;
+    }
+    _taskRoots.swap(nextTaskRoots);
+  }
+}
+
+// <-
+
+void Bvh::refit()
+{
+  _INTR_PROFILE_CPU("Culling", "Refit BVH");
+
+  const Components::NodeRefArray& updatedNodes =
+      Components::NodeManager::_updatedNodes;
+
+  for (uint32_t i = 0u; i < updatedNodes.size(); ++i)
+  {
+    Components::NodeRef nodeRef = updatedNodes[i];
+    if (!Components::NodeManager::isAlive(nodeRef))
+    {
+      continue;
+    }
+
+    updateSphere(_itemIndices[nodeRef._id]);
+
+    uint32_t nodeIdx = _leafIndices[nodeRef._id];
+    BvhNode& leafNode = _nodes[nodeIdx];
+    leafNode.aabb = calcItemRangeAABB(leafNode.firstItem, leafNode.itemCount);
+
+    // Walk up the tree until the bounds stop changing
+    nodeIdx = leafNode.parent;
+    while (nodeIdx != Dod::kInvalidId)
+    {
+      BvhNode& node = _nodes[nodeIdx];
+
+      Math::AABB aabb = _nodes[node.firstChild].aabb;
+      Math::mergeAABBToAABB(aabb, _nodes[node.firstChild + 1u].aabb);
+
+      if (isAABBEqual(aabb, node.aabb))
+      {
+        break;
+      }
+
+      node.aabb = aabb;
+      nodeIdx = node.parent;
+    }
+  }
+}
+
+// <-
+
+void Bvh::updateSphere(uint32_t p_ItemIdx)
+{
+  const Math::Sphere& sphere =
+      Components::NodeManager::_worldBoundingSphere(_items[p_ItemIdx]);
+
+  _sphereX[p_ItemIdx] = sphere.p.x;
+  _sphereY[p_ItemIdx] = sphere.p.y;
+  _sphereZ[p_ItemIdx] = sphere.p.z;
+  _sphereRadius[p_ItemIdx] = sphere.r;
+}
+}
+}
+}
@@ -0,0 +1,111 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Culling
+{
+struct BvhNode
+{
+  // Encloses the bounding spheres of all Nodes in the subtree
+  Math::AABB aabb;
+
+  uint32_t parent;
+  // The second child is always stored right after the first one. Set to
+  // Dod::kInvalidId for leaf nodes
+  uint32_t firstChild;
+
+  // The range of the Nodes (in the item array) covered by the subtree
+  uint32_t firstItem;
+  uint32_t itemCount;
+};
+
+/**
+ * Bounding volume hierarchy over the world bounding spheres of all active
+ * Nodes. Rebuilt if Nodes get created or destroyed and refitted incrementally
+ * for all Nodes whose world transform changed.
+ */
+struct Bvh
+{
+  /**
+   * Initializes the BVH.
+   */
+  static void init();
+
+  /**
+   * Rebuilds or refits the BVH so it matches the current world bounding
+   * spheres of all active Nodes.
+   */
+  static void update();
+
+  // <-
+
+  /**
+   * The nodes of the tree. The first node is the root node.
+   */
+  static _INTR_ARRAY(BvhNode) _nodes;
+  /**
+   * All active Nodes sorted so that the Nodes of each subtree are stored next
+   * to each other.
+   */
+  static Components::NodeRefArray _items;
+  /**
+   * Copy of the world bounding spheres of all items stored as a structure of
+   * arrays (in item order).
+   */
+  static _INTR_ARRAY(float) _sphereX;
+  static _INTR_ARRAY(float) _sphereY;
+  static _INTR_ARRAY(float) _sphereZ;
+  static _INTR_ARRAY(float) _sphereRadius;
+  /**
+   * Disjoint subtrees covering all Nodes. Used to distribute the traversal
+   * across multiple threads.
+   */
+  static _INTR_ARRAY(uint32_t) _taskRoots;
+
+  _INTR_INLINE static SphereStreams getSphereStreams()
+  {
+    SphereStreams streams;
+    {
+      streams.x = _sphereX.data();
+      streams.y = _sphereY.data();
+      streams.z = _sphereZ.data();
+      streams.radius = _sphereRadius.data();
+    }
+
+    return streams;
+  }
+
+private:
+  static void rebuild();
+  static void refit();
+  static void updateSphere(uint32_t p_ItemIdx);
+
+  /**
+   * The index of the leaf node containing each Node.
+   */
+  static _INTR_ARRAY(uint32_t) _leafIndices;
+  /**
+   * The index in the item array of each Node.
+   */
+  static _INTR_ARRAY(uint32_t) _itemIndices;
+  static bool _rebuildRequested;
+};
+}
+}
+}
@@ -0,0 +1,314 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+//#define USE_NAIVE_CULLING
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Culling
+{
+namespace
+{
+_INTR_INLINE uint32_t calcLaneMask(uint32_t p_Count)
+{
+  return p_Count >= 32u ? 0xFFFFFFFFu : (1u << p_Count) - 1u;
+}
+}
+
+// <-
+
+uint32_t cullSpheresScalar(const SphereStreams& p_Spheres, uint32_t p_First,
+                           uint32_t p_Count,
+                           const Math::FrustumPlanes& p_Planes)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    const uint32_t idx = p_First + i;
+    const glm::vec3 center =
+        glm::vec3(p_Spheres.x[idx], p_Spheres.y[idx], p_Spheres.z[idx]);
+
+    bool visible = true;
+    for (uint32_t planeIdx = 0u; planeIdx < Math::FrustumPlane::kCount;
+         ++planeIdx)
+    {
+      if (glm::dot(p_Planes.n[planeIdx], center) + p_Planes.d[planeIdx] <
+          -p_Spheres.radius[idx])
+      {
+        visible = false;
+        break;
+      }
+    }
+
+    result |= visible ? 1u << i : 0u;
+  }
+
+  return result;
+}
+
+// <-
+
+uint32_t cullSpheresSse(const SphereStreams& p_Spheres, uint32_t p_First,
+                        uint32_t p_Count, const Math::FrustumPlanes& p_Planes)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  const __m128 zero = _mm_setzero_ps();
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; i += 4u)
+  {
+    const uint32_t idx = p_First + i;
+    const __m128 x = _mm_loadu_ps(&p_Spheres.x[idx]);
+    const __m128 y = _mm_loadu_ps(&p_Spheres.y[idx]);
+    const __m128 z = _mm_loadu_ps(&p_Spheres.z[idx]);
+    const __m128 r = _mm_loadu_ps(&p_Spheres.radius[idx]);
+
+    __m128 outside = zero;
+    for (uint32_t planeIdx = 0u; planeIdx < Math::FrustumPlane::kCount;
+         ++planeIdx)
+    {
+      const glm::vec3& n = p_Planes.n[planeIdx];
+
+      // Signed distance plus radius - negative if the sphere is fully outside
+      __m128 dist = _mm_add_ps(_mm_set1_ps(p_Planes.d[planeIdx]), r);
+      dist = Simd::simdMadd(_mm_set1_ps(n.z), z, dist);
+      dist = Simd::simdMadd(_mm_set1_ps(n.y), y, dist);
+      dist = Simd::simdMadd(_mm_set1_ps(n.x), x, dist);
+
+      outside = _mm_or_ps(outside, _mm_cmplt_ps(dist, zero));
+    }
+
+    result |= (~(uint32_t)_mm_movemask_ps(outside) & 0xFu) << i;
+  }
+
+  return result & calcLaneMask(p_Count);
+}
+
+// <-
+
+_INTR_TARGET_AVX2 uint32_t cullSpheresAvx2(const SphereStreams& p_Spheres,
+                                           uint32_t p_First, uint32_t p_Count,
+                                           const Math::FrustumPlanes& p_Planes)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  const __m256 zero = _mm256_setzero_ps();
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; i += 8u)
+  {
+    const uint32_t idx = p_First + i;
+    const __m256 x = _mm256_loadu_ps(&p_Spheres.x[idx]);
+    const __m256 y = _mm256_loadu_ps(&p_Spheres.y[idx]);
+    const __m256 z = _mm256_loadu_ps(&p_Spheres.z[idx]);
+    const __m256 r = _mm256_loadu_ps(&p_Spheres.radius[idx]);
+
+    __m256 outside = zero;
+    for (uint32_t planeIdx = 0u; planeIdx < Math::FrustumPlane::kCount;
+         ++planeIdx)
+    {
+      const glm::vec3& n = p_Planes.n[planeIdx];
+
+      // Signed distance plus radius - negative if the sphere is fully outside
+      __m256 dist =
+          _mm256_add_ps(_mm256_broadcast_ss(&p_Planes.d[planeIdx]), r);
+      dist = _mm256_fmadd_ps(_mm256_broadcast_ss(&n.z), z, dist);
+      dist = _mm256_fmadd_ps(_mm256_broadcast_ss(&n.y), y, dist);
+      dist = _mm256_fmadd_ps(_mm256_broadcast_ss(&n.x), x, dist);
+
+      outside = _mm256_or_ps(outside, _mm256_cmp_ps(dist, zero, _CMP_LT_OQ));
+    }
+
+    result |= (~(uint32_t)_mm256_movemask_ps(outside) & 0xFFu) << i;
+  }
+
+  return result & calcLaneMask(p_Count);
+}
+
+// <-
+
+uint32_t cullSpheres(const SphereStreams& p_Spheres, uint32_t p_First,
+                     uint32_t p_Count, const Math::FrustumPlanes& p_Planes)
+{
+#if !defined(USE_NAIVE_CULLING)
+  if (Simd::isAvx2Supported())
+  {
+    return cullSpheresAvx2(p_Spheres, p_First, p_Count, p_Planes);
+  }
+
+  return cullSpheresSse(p_Spheres, p_First, p_Count, p_Planes);
+#else
+  return cullSpheresScalar(p_Spheres, p_First, p_Count, p_Planes);
+#endif // USE_NAIVE_CULLING
+}
+
+// <-
+
+uint32_t intersectSpheresAABBScalar(const SphereStreams& p_Spheres,
+                                    uint32_t p_First, uint32_t p_Count,
+                                    const Math::AABB2& p_AABB)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    const uint32_t idx = p_First + i;
+    const Math::Sphere sphere = {
+        glm::vec3(p_Spheres.x[idx], p_Spheres.y[idx], p_Spheres.z[idx]),
+        p_Spheres.radius[idx]};
+
+    result |= Math::calcIntersectSphereAABB(sphere, p_AABB) ? 1u << i : 0u;
+  }
+
+  return result;
+}
+
+// <-
+
+// The SIMD variants avoid FMA to match the results of the scalar test
+uint32_t intersectSpheresAABBSse(const SphereStreams& p_Spheres,
+                                 uint32_t p_First, uint32_t p_Count,
+                                 const Math::AABB2& p_AABB)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  const __m128 zero = _mm_setzero_ps();
+  const __m128 signMask = _mm_set1_ps(-0.0f);
+
+  const __m128 cx = _mm_set1_ps(p_AABB.center.x);
+  const __m128 cy = _mm_set1_ps(p_AABB.center.y);
+  const __m128 cz = _mm_set1_ps(p_AABB.center.z);
+  const __m128 hx = _mm_set1_ps(p_AABB.halfExtent.x);
+  const __m128 hy = _mm_set1_ps(p_AABB.halfExtent.y);
+  const __m128 hz = _mm_set1_ps(p_AABB.halfExtent.z);
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; i += 4u)
+  {
+    const uint32_t idx = p_First + i;
+    const __m128 x = _mm_loadu_ps(&p_Spheres.x[idx]);
+    const __m128 y = _mm_loadu_ps(&p_Spheres.y[idx]);
+    const __m128 z = _mm_loadu_ps(&p_Spheres.z[idx]);
+    const __m128 r = _mm_loadu_ps(&p_Spheres.radius[idx]);
+
+    // Distance from the sphere center to the box per axis
+    const __m128 dx = _mm_max_ps(
+        zero, _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(cx, x)), hx));
+    const __m128 dy = _mm_max_ps(
+        zero, _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(cy, y)), hy));
+    const __m128 dz = _mm_max_ps(
+        zero, _mm_sub_ps(_mm_andnot_ps(signMask, _mm_sub_ps(cz, z)), hz));
+
+    const __m128 distSqr =
+        _mm_add_ps(_mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy)),
+                   _mm_mul_ps(dz, dz));
+    const __m128 intersects = _mm_cmple_ps(distSqr, _mm_mul_ps(r, r));
+
+    result |= (uint32_t)_mm_movemask_ps(intersects) << i;
+  }
+
+  return result & calcLaneMask(p_Count);
+}
+
+// <-
+
+_INTR_TARGET_AVX2 uint32_t intersectSpheresAABBAvx2(
+    const SphereStreams& p_Spheres, uint32_t p_First, uint32_t p_Count,
+    const Math::AABB2& p_AABB)
+{
+  _INTR_ASSERT(p_Count <= 32u);
+
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+  const __m256 cx = _mm256_broadcast_ss(&p_AABB.center.x);
+  const __m256 cy = _mm256_broadcast_ss(&p_AABB.center.y);
+  const __m256 cz = _mm256_broadcast_ss(&p_AABB.center.z);
+  const __m256 hx = _mm256_broadcast_ss(&p_AABB.halfExtent.x);
+  const __m256 hy = _mm256_broadcast_ss(&p_AABB.halfExtent.y);
+  const __m256 hz = _mm256_broadcast_ss(&p_AABB.halfExtent.z);
+
+  uint32_t result = 0u;
+  for (uint32_t i = 0u; i < p_Count; i += 8u)
+  {
+    const uint32_t idx = p_First + i;
+    const __m256 x = _mm256_loadu_ps(&p_Spheres.x[idx]);
+    const __m256 y = _mm256_loadu_ps(&p_Spheres.y[idx]);
+    const __m256 z = _mm256_loadu_ps(&p_Spheres.z[idx]);
+    const __m256 r = _mm256_loadu_ps(&p_Spheres.radius[idx]);
+
+    // Distance from the sphere center to the box per axis
+    const __m256 dx = _mm256_max_ps(
+        zero,
+        _mm256_sub_ps(_mm256_andnot_ps(signMask, _mm256_sub_ps(cx, x)), hx));
+    const __m256 dy = _mm256_max_ps(
+        zero,
+        _mm256_sub_ps(_mm256_andnot_ps(signMask, _mm256_sub_ps(cy, y)), hy));
+    const __m256 dz = _mm256_max_ps(
+        zero,
+        _mm256_sub_ps(_mm256_andnot_ps(signMask, _mm256_sub_ps(cz, z)), hz));
+
+    const __m256 distSqr = _mm256_add_ps(
+        _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy)),
+        _mm256_mul_ps(dz, dz));
+    const __m256 intersects =
+        _mm256_cmp_ps(distSqr, _mm256_mul_ps(r, r), _CMP_LE_OQ);
+
+    result |= (uint32_t)_mm256_movemask_ps(intersects) << i;
+  }
+
+  return result & calcLaneMask(p_Count);
+}
+
+// <-
+
+uint32_t intersectSpheresAABB(const SphereStreams& p_Spheres, uint32_t p_First,
+                              uint32_t p_Count, const Math::AABB2& p_AABB)
+{
+#if !defined(USE_NAIVE_CULLING)
+  if (Simd::isAvx2Supported())
+  {
+    return intersectSpheresAABBAvx2(p_Spheres, p_First, p_Count, p_AABB);
+  }
+
+  return intersectSpheresAABBSse(p_Spheres, p_First, p_Count, p_AABB);
+#else
+  return intersectSpheresAABBScalar(p_Spheres, p_First, p_Count, p_AABB);
+#endif // USE_NAIVE_CULLING
+}
+
+// <-
+
+void cullSpheres(const SphereStreams& p_Spheres, uint32_t p_Count,
+                 const Math::FrustumPlanes& p_Planes,
+                 uint32_t* p_VisibilityBits)
+{
+  for (uint32_t i = 0u; i < p_Count; i += 32u)
+  {
+    p_VisibilityBits[i / 32u] =
+        cullSpheres(p_Spheres, i, std::min(32u, p_Count - i), p_Planes);
+  }
+}
+}
+}
+}
@@ -0,0 +1,81 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Culling
+{
+/**
+ * Bounding spheres stored as a structure of arrays. The arrays have to be
+ * padded with (at least) seven additional elements, so the kernels can always
+ * load eight spheres at once.
+ */
+struct SphereStreams
+{
+  const float* x;
+  const float* y;
+  const float* z;
+  const float* radius;
+};
+
+/**
+ * Tests up to 32 spheres starting at p_First against the frustum planes. Bit i
+ * of the result is set if sphere p_First + i is (potentially) visible. Uses
+ * AVX2 if available and SSE otherwise.
+ */
+uint32_t cullSpheres(const SphereStreams& p_Spheres, uint32_t p_First,
+                     uint32_t p_Count, const Math::FrustumPlanes& p_Planes);
+
+/**
+ * Tests p_Count spheres against the frustum planes and writes the results to
+ * the packed bitset p_VisibilityBits (one bit per sphere).
+ */
+void cullSpheres(const SphereStreams& p_Spheres, uint32_t p_Count,
+                 const Math::FrustumPlanes& p_Planes,
+                 uint32_t* p_VisibilityBits);
+
+/**
+ * Tests up to 32 spheres starting at p_First against the axis aligned box.
+ * Bit i of the result is set if sphere p_First + i intersects the box. The
+ * results match Math::calcIntersectSphereAABB exactly. Uses AVX2 if available
+ * and SSE otherwise.
+ */
+uint32_t intersectSpheresAABB(const SphereStreams& p_Spheres, uint32_t p_First,
+                              uint32_t p_Count, const Math::AABB2& p_AABB);
+
+// Variants used for benchmarking
+uint32_t cullSpheresScalar(const SphereStreams& p_Spheres, uint32_t p_First,
+                           uint32_t p_Count,
+                           const Math::FrustumPlanes& p_Planes);
+uint32_t cullSpheresSse(const SphereStreams& p_Spheres, uint32_t p_First,
+                        uint32_t p_Count, const Math::FrustumPlanes& p_Planes);
+uint32_t cullSpheresAvx2(const SphereStreams& p_Spheres, uint32_t p_First,
+                         uint32_t p_Count,
+                         const Math::FrustumPlanes& p_Planes);
+uint32_t intersectSpheresAABBScalar(const SphereStreams& p_Spheres,
+                                    uint32_t p_First, uint32_t p_Count,
+                                    const Math::AABB2& p_AABB);
+uint32_t intersectSpheresAABBSse(const SphereStreams& p_Spheres,
+                                 uint32_t p_First, uint32_t p_Count,
+                                 const Math::AABB2& p_AABB);
+uint32_t intersectSpheresAABBAvx2(const SphereStreams& p_Spheres,
+                                  uint32_t p_First, uint32_t p_Count,
+                                  const Math::AABB2& p_AABB);
+}
+}
+}
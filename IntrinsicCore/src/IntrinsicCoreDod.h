@@ -151,6 +151,7 @@ protected:
     _freeIds.reserve(IdCount);
     _activeRefs.reserve(IdCount);
     _generations.resize(IdCount);
+    _activeRefIndices.resize(IdCount);
 
     for (uint32_t i = 0u; i < IdCount; ++i)
     {
@@ -168,6 +169,7 @@ protected:
     ref._id = id;
     ref._generation = _generations[id];
 
+    _activeRefIndices[id] = (IdType)_activeRefs.size();
     _activeRefs.push_back(ref);
 
     return ref;
@@ -177,25 +179,58 @@ protected:
   {
     _INTR_ASSERT(p_Ref.isValid() && isAlive(p_Ref));
 
-    // Erase an swap
-    for (uint32_t i = 0; i < _activeRefs.size(); ++i)
+    // Erase and swap
+    const IdType activeRefIdx = _activeRefIndices[p_Ref._id];
+    const Ref lastRef = _activeRefs.back();
+    _activeRefs[activeRefIdx] = lastRef;
+    _activeRefIndices[lastRef._id] = activeRefIdx;
+    _activeRefs.pop_back();
+
+    freeId(p_Ref._id);
+  }
+
+  // Releases all given refs and compacts the active refs in a single pass
+  _INTR_INLINE static void releaseMany(const _INTR_ARRAY(Ref) & p_Refs)
+  {
+    if (p_Refs.empty())
     {
-      if (_activeRefs[i] == p_Ref)
-      {
-        _activeRefs[i] = _activeRefs[_activeRefs.size() - 1u];
-        _activeRefs.resize(_activeRefs.size() - 1u);
-        break;
-      }
+      return;
     }
 
-    _freeIds.push_back(p_Ref._id);
+    for (uint32_t i = 0u; i < p_Refs.size(); ++i)
+    {
+      _INTR_ASSERT(p_Refs[i].isValid() && isAlive(p_Refs[i]));
+      freeId(p_Refs[i]._id);
+    }
 
-    const GenerationType currentGenId = _generations[p_Ref._id];
-    _generations[p_Ref._id] = (currentGenId + 1u) % (maxGenerationIdValue + 1u);
+    // Released refs are no longer alive after bumping their generation
+    uint32_t activeRefCount = 0u;
+    for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+    {
+      const Ref ref = _activeRefs[i];
+      if (isAlive(ref))
+      {
+        _activeRefIndices[ref._id] = activeRefCount;
+        _activeRefs[activeRefCount++] = ref;
+      }
+    }
+    _activeRefs.resize(activeRefCount);
   }
 
   static _INTR_ARRAY(IdType) _freeIds;
   static _INTR_ARRAY(GenerationType) _generations;
+
+  // Index of each allocated id in the active refs
+  static _INTR_ARRAY(IdType) _activeRefIndices;
+
+private:
+  _INTR_INLINE static void freeId(IdType p_Id)
+  {
+    _freeIds.push_back(p_Id);
+
+    const GenerationType currentGenId = _generations[p_Id];
+    _generations[p_Id] = (currentGenId + 1u) % (maxGenerationIdValue + 1u);
+  }
 };
 
 // <-
@@ -209,6 +244,9 @@ ManagerBase<IdCount, DataType>::_activeRefs;
 template <uint32_t IdCount, class DataType>
 _INTR_ARRAY(GenerationType)
 ManagerBase<IdCount, DataType>::_generations;
+template <uint32_t IdCount, class DataType>
+_INTR_ARRAY(IdType)
+ManagerBase<IdCount, DataType>::_activeRefIndices;
 }
 }
 }
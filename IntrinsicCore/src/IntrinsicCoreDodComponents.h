@@ -30,6 +30,13 @@ struct ComponentDataBase
 {
   ComponentDataBase(uint32_t p_Size) { entity.resize(p_Size); }
 
+  // Required by the dense storage policy
+  _INTR_INLINE void resize(uint32_t p_Size) { entity.resize(p_Size); }
+  _INTR_INLINE void move(uint32_t p_SrcIdx, uint32_t p_DstIdx)
+  {
+    entity[p_DstIdx] = entity[p_SrcIdx];
+  }
+
   _INTR_ARRAY(Entity::EntityRef) entity;
 };
 
@@ -47,7 +54,25 @@ struct ComponentManagerEntry : ManagerEntry
 
 // <-
 
-template <class DataType, uint32_t IdCount>
+namespace StoragePolicy
+{
+enum Policy
+{
+  // The component data is allocated for the max. component count and indexed
+  // by the id of the component ref
+  kSparse,
+  // The component data of the live components is kept packed in the order of
+  // the active refs and grows with the live component count - the data type
+  // has to provide "resize" and "move" (see ComponentDataBase) and components
+  // can't be released in bulk via "releaseMany"
+  kDense
+};
+}
+
+// <-
+
+template <class DataType, uint32_t IdCount,
+          StoragePolicy::Policy Storage = StoragePolicy::kSparse>
 struct ComponentManagerBase : Dod::ManagerBase<IdCount, DataType>
 {
   typedef _INTR_HASH_MAP(uint32_t, Ref) EntityComponentMap;
@@ -66,7 +91,18 @@ struct ComponentManagerBase : Dod::ManagerBase<IdCount, DataType>
 
   _INTR_INLINE static Entity::EntityRef& _entity(Ref p_Ref)
   {
-    return _data.entity[p_Ref._id];
+    return _data.entity[_dataIdx(p_Ref)];
+  }
+
+  // Returns the index of the component's data in the data arrays
+  _INTR_INLINE static uint32_t _dataIdx(Ref p_Ref)
+  {
+    if (Storage == StoragePolicy::kDense)
+    {
+      return Dod::ManagerBase<IdCount, DataType>::_activeRefIndices[p_Ref._id];
+    }
+
+    return p_Ref._id;
   }
 
 protected:
@@ -79,28 +115,62 @@ protected:
   _INTR_INLINE static Ref _createComponent(Entity::EntityRef p_ParentEntity)
   {
     Ref ref = Dod::ManagerBase<IdCount, DataType>::allocate();
-    _data.entity[ref._id] = p_ParentEntity;
+
+    if (Storage == StoragePolicy::kDense)
+    {
+      _data.resize(
+          (uint32_t)Dod::ManagerBase<IdCount, DataType>::_activeRefs.size());
+    }
+
+    _data.entity[_dataIdx(ref)] = p_ParentEntity;
     _entityComponentMap[p_ParentEntity._id] = ref;
     return ref;
   }
 
+  // Bulk releases would skip the compaction of the dense component data
+  _INTR_INLINE static void releaseMany(const _INTR_ARRAY(Ref) & p_Refs)
+  {
+    static_assert(Storage != StoragePolicy::kDense,
+                  "Dense components can't be released via \"releaseMany\"");
+    Dod::ManagerBase<IdCount, DataType>::releaseMany(p_Refs);
+  }
+
   _INTR_INLINE static void _destroyComponent(Ref p_Ref)
   {
     Entity::EntityRef entity = _entity(p_Ref);
     _entityComponentMap.erase(entity._id);
 
-    Dod::ManagerBase<IdCount, DataType>::release(p_Ref);
+    if (Storage == StoragePolicy::kDense)
+    {
+      // Mirror the swap and erase of the active refs done on release
+      const uint32_t dataIdx = _dataIdx(p_Ref);
+      const uint32_t lastDataIdx =
+          (uint32_t)Dod::ManagerBase<IdCount, DataType>::_activeRefs.size() -
+          1u;
+
+      if (dataIdx != lastDataIdx)
+      {
+        _data.move(lastDataIdx, dataIdx);
+      }
+
+      Dod::ManagerBase<IdCount, DataType>::release(p_Ref);
+      _data.resize(lastDataIdx);
+    }
+    else
+    {
+      Dod::ManagerBase<IdCount, DataType>::release(p_Ref);
+    }
   }
 
   static EntityComponentMap _entityComponentMap;
   static DataType _data;
 };
 
-template <class DataType, uint32_t IdCount>
-DataType ComponentManagerBase<DataType, IdCount>::_data;
-template <class DataType, uint32_t IdCount>
+template <class DataType, uint32_t IdCount, StoragePolicy::Policy Storage>
+DataType ComponentManagerBase<DataType, IdCount, Storage>::_data;
+template <class DataType, uint32_t IdCount, StoragePolicy::Policy Storage>
 _INTR_HASH_MAP(uint32_t, Ref)
-ComponentManagerBase<DataType, IdCount>::_entityComponentMap;
+ComponentManagerBase<DataType, IdCount, Storage>::_entityComponentMap;
 }
 }
 }
@@ -90,8 +90,8 @@ struct ResourceManagerBase : Dod::ManagerBase<IdCount, DataType>
     {
       _INTR_LOG_WARNING("Resource '%s' not found - falling back to default "
                         "resource '%s'...",
-                        p_Name.getString().c_str(),
-                        _defaultResourceName.getString().c_str());
+                        p_Name.getCString(),
+                        _defaultResourceName.getCString());
       resourceIt = _nameResourceMap.find(_defaultResourceName);
     }
 
@@ -224,7 +224,7 @@ protected:
 
       rapidjson::Value resource = rapidjson::Value(rapidjson::kObjectType);
       rapidjson::Value nameValue;
-      nameValue.SetString(name.getString().c_str(), resources.GetAllocator());
+      nameValue.SetString(name.getCString(), resources.GetAllocator());
 
       resource.AddMember("name", nameValue, resources.GetAllocator());
 
@@ -263,54 +263,60 @@ protected:
                        ManagerCompileDescriptorFunction p_CompileFunction)
   {
     // Delete removed files
+    _deleteRemovedFiles(p_Path, p_Extension);
+
+    for (uint32_t i = 0;
+         i < Dod::ManagerBase<IdCount, DataType>::_activeRefs.size(); ++i)
+    {
+      Ref ref = Dod::ManagerBase<IdCount, DataType>::_activeRefs[i];
+      _saveToMultipleFilesSingleResource<WriterType>(ref, p_Path, p_Extension,
+                                                     p_CompileFunction);
+    }
+  }
+
+  // <-
+
+  _INTR_INLINE static void _deleteRemovedFiles(const char* p_Path,
+                                               const char* p_Extension)
+  {
+    tinydir_dir dir;
+    if (tinydir_open(&dir, p_Path) == -1)
     {
-      tinydir_dir dir;
-      if (tinydir_open(&dir, p_Path) == -1)
+      _INTR_LOG_ERROR("Directory not found while saving resources to "
+                      "multiple files...");
+      return;
+    }
+
+    while (dir.has_next)
+    {
+      tinydir_file file;
+      if (tinydir_readfile(&dir, &file) == -1)
       {
-        _INTR_LOG_ERROR("Directory not found while saving resources to "
-                        "multiple files...");
-        return;
+        _INTR_LOG_ERROR("Failed to read file in directory...");
+        tinydir_next(&dir);
+        continue;
       }
 
-      while (dir.has_next)
-      {
-        tinydir_file file;
-        if (tinydir_readfile(&dir, &file) == -1)
-        {
-          _INTR_LOG_ERROR("Failed to read file in directory...");
-          tinydir_next(&dir);
-          continue;
-        }
-
-        _INTR_STRING resourceName, extension;
-        StringUtil::extractFileNameAndExtension(file.path, resourceName,
-                                                extension);
-
-        // Ignore files not matching the extension
-        if (extension != p_Extension)
-        {
-          tinydir_next(&dir);
-          continue;
-        }
-
-        if (!_getResourceByName(resourceName).isValid())
-        {
-          std::remove(file.path);
-        }
+      _INTR_STRING resourceName, extension;
+      StringUtil::extractFileNameAndExtension(file.path, resourceName,
+                                              extension);
 
+      // Ignore files not matching the extension
+      if (extension != p_Extension)
+      {
         tinydir_next(&dir);
+        continue;
       }
 
-      tinydir_close(&dir);
-    }
+      if (!_getResourceByName(resourceName).isValid())
+      {
+        std::remove(file.path);
+      }
 
-    for (uint32_t i = 0;
-         i < Dod::ManagerBase<IdCount, DataType>::_activeRefs.size(); ++i)
-    {
-      Ref ref = Dod::ManagerBase<IdCount, DataType>::_activeRefs[i];
-      _saveToMultipleFilesSingleResource<WriterType>(ref, p_Path, p_Extension,
-                                                     p_CompileFunction);
+      tinydir_next(&dir);
     }
+
+    tinydir_close(&dir);
   }
 
   // <-
@@ -331,7 +337,7 @@ protected:
 
     rapidjson::Document resource = rapidjson::Document(rapidjson::kObjectType);
     rapidjson::Value nameValue;
-    nameValue.SetString(name.getString().c_str(), resource.GetAllocator());
+    nameValue.SetString(name.getCString(), resource.GetAllocator());
 
     resource.AddMember("name", nameValue, resource.GetAllocator());
 
@@ -404,7 +410,8 @@ protected:
   _INTR_INLINE static void
   _loadFromMultipleFiles(const char* p_Path, const char* p_Extension,
                          ManagerInitFromDescriptorFunction p_InitFunction,
-                         ManagerResetToDefaultFunction p_ResetToDefaultFunction)
+                         ManagerResetToDefaultFunction p_ResetToDefaultFunction,
+                         bool p_SkipExistingResources = false)
   {
     char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
 
@@ -437,6 +444,13 @@ protected:
         continue;
       }
 
+      // Ignore resources which have already been loaded from another source
+      if (p_SkipExistingResources && _getResourceByName(resourceName).isValid())
+      {
+        tinydir_next(&dir);
+        continue;
+      }
+
       FILE* fp = fopen(file.path, "rb");
 
       if (fp == nullptr)
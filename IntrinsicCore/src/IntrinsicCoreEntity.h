@@ -49,6 +49,15 @@ struct EntityManager : Dod::ManagerBase<_INTR_MAX_ENTITY_COUNT, EntityData>
     release(p_Ref);
   }
 
+  _INTR_INLINE static void destroyEntities(const EntityRefArray& p_Refs)
+  {
+    for (uint32_t i = 0u; i < p_Refs.size(); ++i)
+    {
+      _nameResourceMap.erase(_name(p_Refs[i]));
+    }
+    releaseMany(p_Refs);
+  }
+
   static void destroyAllComponents(EntityRefArray p_Refs);
   static void destroyAllResources(EntityRefArray p_Refs);
   static void createAllResources(EntityRefArray p_Refs);
@@ -113,7 +122,7 @@ struct EntityManager : Dod::ManagerBase<_INTR_MAX_ENTITY_COUNT, EntityData>
     }
 
     // Find a unique name
-    _data.name[p_Ref._id] = makeNameUnique(p_NewName.getString().c_str());
+    _data.name[p_Ref._id] = makeNameUnique(p_NewName.getCString());
     // ... and finally update the name => entity mapping and the actual name
     _nameResourceMap[_data.name[p_Ref._id]] = p_Ref;
   }
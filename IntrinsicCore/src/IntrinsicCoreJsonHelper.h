@@ -33,9 +33,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
   if (p_GenerateDesc)
   {
     rapidjson::Value propertyCat =
-        rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
     rapidjson::Value propertyEditor =
-        rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
     property.AddMember("cat", propertyCat, p_Doc.GetAllocator());
     property.AddMember("type", "vec2", p_Doc.GetAllocator());
@@ -75,9 +75,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
   if (p_GenerateDesc)
   {
     rapidjson::Value propertyCat =
-        rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
     rapidjson::Value propertyEditor =
-        rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
     property.AddMember("cat", propertyCat, p_Doc.GetAllocator());
     property.AddMember("type", "vec3", p_Doc.GetAllocator());
@@ -120,9 +120,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
   if (p_GenerateDesc)
   {
     rapidjson::Value propertyCat =
-        rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
     rapidjson::Value propertyEditor =
-        rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
     property.AddMember("cat", propertyCat, p_Doc.GetAllocator());
     property.AddMember("type", "vec4", p_Doc.GetAllocator());
@@ -174,9 +174,9 @@ _INTR_INLINE rapidjson::Value createProperty(rapidjson::Document& p_Doc,
   if (p_GenerateDesc)
   {
     rapidjson::Value propertyCat =
-        rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
     rapidjson::Value propertyEditor =
-        rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
     property.AddMember("cat", propertyCat, p_Doc.GetAllocator());
     property.AddMember("type", "sh", p_Doc.GetAllocator());
@@ -237,9 +237,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
   if (p_GenerateDesc)
   {
     rapidjson::Value propertyCat =
-        rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
     rapidjson::Value propertyEditor =
-        rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+        rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
     property.AddMember("cat", propertyCat, p_Doc.GetAllocator());
     property.AddMember("type", "quat", p_Doc.GetAllocator());
@@ -265,9 +265,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   if (p_GenerateDesc)
   {
@@ -306,12 +306,12 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   rapidjson::Value propertyValue =
-      rapidjson::Value(p_Value.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Value.getCString(), p_Doc.GetAllocator());
 
   if (p_GenerateDesc)
   {
@@ -337,9 +337,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   rapidjson::Value propertyValue =
       rapidjson::Value(p_Value.c_str(), p_Doc.GetAllocator());
@@ -368,9 +368,9 @@ createProperty(rapidjson::Document& p_Doc, bool p_GenerateDesc,
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   if (p_GenerateDesc)
   {
@@ -397,9 +397,9 @@ createPropertyEnum(rapidjson::Document& p_Doc, bool p_GenerateDesc,
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   if (p_GenerateDesc)
   {
@@ -440,16 +440,16 @@ _INTR_INLINE rapidjson::Value createPropertyFlags(
 {
   rapidjson::Value property = rapidjson::Value(rapidjson::kObjectType);
   rapidjson::Value propertyCat =
-      rapidjson::Value(p_Category.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Category.getCString(), p_Doc.GetAllocator());
   rapidjson::Value propertyEditor =
-      rapidjson::Value(p_Editor.getString().c_str(), p_Doc.GetAllocator());
+      rapidjson::Value(p_Editor.getCString(), p_Doc.GetAllocator());
 
   // Create a list of selected flags
   rapidjson::Value value = rapidjson::Value(rapidjson::kArrayType);
   {
     for (uint32_t i = 0u; i < p_Value.size(); ++i)
     {
-      value.PushBack(rapidjson::Value(p_Value[i].getString().c_str(),
+      value.PushBack(rapidjson::Value(p_Value[i].getCString(),
                                       p_Doc.GetAllocator()),
                      p_Doc.GetAllocator());
     }
@@ -134,6 +134,72 @@ _INTR_INLINE uint32_t hash(const char* p_Data, std::size_t p_Size)
   return hash;
 }
 
+// Compile time version of the djb2 hash function above
+constexpr uint32_t hashConstexpr(const char* p_Data, std::size_t p_Size,
+                                 uint32_t p_Hash = 0u)
+{
+  return p_Size == 0u ? p_Hash
+                      : hashConstexpr(p_Data + 1u, p_Size - 1u,
+                                      ((p_Hash << 5) + p_Hash) + p_Data[0]);
+}
+
+// 64 bit FNV-1a hash function - pass the previous hash as the basis to
+// combine multiple blocks of data
+_INTR_INLINE uint64_t hash64(const char* p_Data, std::size_t p_Size,
+                             uint64_t p_Basis = 14695981039346656037ull)
+{
+  uint64_t hash = p_Basis;
+
+  for (std::size_t i = 0u; i < p_Size; ++i)
+  {
+    hash = (hash ^ (uint8_t)p_Data[i]) * 1099511628211ull;
+  }
+
+  return hash;
+}
+
+// <-
+
+// Returns the index of the lowest set bit - the value must not be zero
+_INTR_INLINE uint32_t calcLowestSetBit(uint32_t p_Value)
+{
+  _INTR_ASSERT(p_Value != 0u);
+
+#if defined(_WIN32)
+  unsigned long idx;
+  _BitScanForward(&idx, p_Value);
+  return (uint32_t)idx;
+#else
+  return (uint32_t)__builtin_ctz(p_Value);
+#endif // _WIN32
+}
+
+// <-
+
+_INTR_INLINE uint32_t calcLowestSetBit64(uint64_t p_Value)
+{
+  _INTR_ASSERT(p_Value != 0u);
+
+#if defined(_WIN32)
+  unsigned long idx;
+  _BitScanForward64(&idx, p_Value);
+  return (uint32_t)idx;
+#else
+  return (uint32_t)__builtin_ctzll(p_Value);
+#endif // _WIN32
+}
+
+// <-
+
+_INTR_INLINE uint32_t calcBitCount(uint32_t p_Value)
+{
+#if defined(_WIN32)
+  return (uint32_t)__popcnt(p_Value);
+#else
+  return (uint32_t)__builtin_popcount(p_Value);
+#endif // _WIN32
+}
+
 // <-
 
 _INTR_INLINE uint32_t calcRandomNumber()
@@ -441,6 +507,14 @@ _INTR_INLINE void mergePointToAABB(AABB& p_AABB, const glm::vec3& p_Point)
 
 // <-
 
+_INTR_INLINE void mergeAABBToAABB(AABB& p_AABB, const AABB& p_Other)
+{
+  p_AABB.min = calcVecMin(p_Other.min, p_AABB.min);
+  p_AABB.max = calcVecMax(p_Other.max, p_AABB.max);
+}
+
+// <-
+
 _INTR_INLINE void transformAABBAffine(AABB& p_AABB,
                                       const glm::mat4& p_Transform)
 {
@@ -451,13 +525,13 @@ _INTR_INLINE void transformAABBAffine(AABB& p_AABB,
 
   glm::vec3 newHalfSize =
       glm::vec3(glm::abs(p_Transform[0][0]) * halfSize.x +
-                    glm::abs(p_Transform[0][1]) * halfSize.y +
-                    glm::abs(p_Transform[0][2]) * halfSize.z,
-                glm::abs(p_Transform[1][0]) * halfSize.x +
+                    glm::abs(p_Transform[1][0]) * halfSize.y +
+                    glm::abs(p_Transform[2][0]) * halfSize.z,
+                glm::abs(p_Transform[0][1]) * halfSize.x +
                     glm::abs(p_Transform[1][1]) * halfSize.y +
-                    glm::abs(p_Transform[1][2]) * halfSize.z,
-                glm::abs(p_Transform[2][0]) * halfSize.x +
-                    glm::abs(p_Transform[2][1]) * halfSize.y +
+                    glm::abs(p_Transform[2][1]) * halfSize.z,
+                glm::abs(p_Transform[0][2]) * halfSize.x +
+                    glm::abs(p_Transform[1][2]) * halfSize.y +
                     glm::abs(p_Transform[2][2]) * halfSize.z);
 
   p_AABB.min = newCentre - newHalfSize;
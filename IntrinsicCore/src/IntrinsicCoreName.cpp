@@ -15,10 +15,182 @@
 // Precompiled header file
 #include "stdafx.h"
 
+#define _INTR_MAX_NAME_COUNT 65536u
+#define _INTR_NAME_ARENA_CHUNK_SIZE_IN_BYTES (64u * 1024u)
+
 namespace Intrinsic
 {
 namespace Core
 {
-_INTR_HASH_MAP(uint32_t, _INTR_STRING) Name::_stringMap;
+namespace
+{
+// Chunk of the append only arena which stores the interned strings
+struct NameArenaChunk
+{
+  NameArenaChunk* next;
+  std::atomic<uint32_t> usedSizeInBytes;
+  char data[_INTR_NAME_ARENA_CHUNK_SIZE_IN_BYTES];
+};
+
+// Entry of the open addressing index - the hash gets claimed first and the
+// string is published afterwards
+struct NameIndexEntry
+{
+  std::atomic<uint32_t> hash;
+  std::atomic<const char*> string;
+};
+
+// Both are zero initialized before any dynamic initialization takes place
+NameIndexEntry _nameIndex[_INTR_MAX_NAME_COUNT];
+std::atomic<NameArenaChunk*> _currentArenaChunk;
+
+// <-
+
+const char* allocateString(const char* p_String)
+{
+  const uint32_t sizeInBytes = (uint32_t)strlen(p_String) + 1u;
+
+  // Names which don't fit into a chunk get an allocation of their own, which
+  // lives as long as the arena
+  if (sizeInBytes > _INTR_NAME_ARENA_CHUNK_SIZE_IN_BYTES)
+  {
+    _INTR_LOG_WARNING("Name of %u bytes exceeds the arena chunk size, "
+                      "allocating it separately...",
+                      sizeInBytes);
+
+    char* string = (char*)Memory::Tlsf::MainAllocator::allocate(sizeInBytes);
+    memcpy(string, p_String, sizeInBytes);
+    return string;
+  }
+
+  while (true)
+  {
+    NameArenaChunk* chunk = _currentArenaChunk.load(std::memory_order_acquire);
+
+    if (chunk != nullptr)
+    {
+      const uint32_t offset = chunk->usedSizeInBytes.fetch_add(
+          sizeInBytes, std::memory_order_relaxed);
+
+      if (offset + sizeInBytes <= _INTR_NAME_ARENA_CHUNK_SIZE_IN_BYTES)
+      {
+        memcpy(&chunk->data[offset], p_String, sizeInBytes);
+        return &chunk->data[offset];
+      }
+    }
+
+    // The chunk is exhausted, try to install a new one - if another thread
+    // was faster, its chunk is used instead
+    NameArenaChunk* newChunk = (NameArenaChunk*)
+        Memory::Tlsf::MainAllocator::allocate(sizeof(NameArenaChunk));
+    newChunk->next = chunk;
+    newChunk->usedSizeInBytes.store(0u, std::memory_order_relaxed);
+
+    if (!_currentArenaChunk.compare_exchange_strong(
+            chunk, newChunk, std::memory_order_acq_rel))
+    {
+      Memory::Tlsf::MainAllocator::free(newChunk);
+    }
+  }
+}
+
+// <-
+
+_INTR_INLINE const char* waitForString(const NameIndexEntry& p_Entry)
+{
+  const char* string;
+  while ((string = p_Entry.string.load(std::memory_order_acquire)) == nullptr)
+  {
+    std::this_thread::yield();
+  }
+
+  return string;
+}
+}
+
+// <-
+
+const char* Name::getCString() const
+{
+  if (_hash == 0u)
+  {
+    return "";
+  }
+
+  uint32_t idx = _hash & (_INTR_MAX_NAME_COUNT - 1u);
+  for (uint32_t i = 0u; i < _INTR_MAX_NAME_COUNT; ++i)
+  {
+    const NameIndexEntry& entry = _nameIndex[idx];
+    const uint32_t entryHash = entry.hash.load(std::memory_order_acquire);
+
+    if (entryHash == _hash)
+    {
+      return waitForString(entry);
+    }
+    else if (entryHash == 0u)
+    {
+      break;
+    }
+
+    idx = (idx + 1u) & (_INTR_MAX_NAME_COUNT - 1u);
+  }
+
+  // Names created from a hash without a registered string
+  return "";
+}
+
+// <-
+
+bool Name::registerString(uint32_t p_Hash, const char* p_String)
+{
+  // Zero is reserved for invalid names (and the empty string)
+  if (p_Hash == 0u)
+  {
+    return true;
+  }
+
+  uint32_t idx = p_Hash & (_INTR_MAX_NAME_COUNT - 1u);
+  for (uint32_t i = 0u; i < _INTR_MAX_NAME_COUNT; ++i)
+  {
+    NameIndexEntry& entry = _nameIndex[idx];
+    uint32_t entryHash = entry.hash.load(std::memory_order_acquire);
+
+    if (entryHash == 0u)
+    {
+      if (entry.hash.compare_exchange_strong(entryHash, p_Hash,
+                                             std::memory_order_acq_rel))
+      {
+        entry.string.store(allocateString(p_String),
+                           std::memory_order_release);
+        return true;
+      }
+
+      // Another thread claimed the entry in the meantime, entryHash now
+      // contains its hash
+    }
+
+    if (entryHash == p_Hash)
+    {
+      const char* string = waitForString(entry);
+      if (strcmp(string, p_String) != 0)
+      {
+        _INTR_LOG_ERROR("Hash collision: The names '%s' and '%s' share the "
+                        "hash 0x%x",
+                        string, p_String, p_Hash);
+        return false;
+      }
+
+      return true;
+    }
+
+    idx = (idx + 1u) & (_INTR_MAX_NAME_COUNT - 1u);
+  }
+
+  _INTR_LOG_ERROR("Max. amount of names (%u) exceeded, failed to register "
+                  "the name '%s'",
+                  _INTR_MAX_NAME_COUNT, p_String);
+  _INTR_ASSERT(false && "Max. amount of names exceeded");
+  return false;
+}
 }
 }
@@ -23,18 +23,35 @@ struct Name
   _INTR_INLINE Name() : _hash(0u) {}
   _INTR_INLINE Name(const _INTR_STRING& p_String) { setName(p_String.c_str()); }
   _INTR_INLINE Name(const char* p_String) { setName(p_String); }
-  _INTR_INLINE Name(uint32_t p_Hash) : _hash(p_Hash) {}
+  constexpr Name(uint32_t p_Hash) : _hash(p_Hash) {}
+
+  // Used by _N() - the hash is a compile time constant and the string only
+  // gets registered on the first evaluation
+  template <uint32_t Hash>
+  _INTR_INLINE static Name fromLiteral(const char* p_String)
+  {
+    static const bool registered = registerString(Hash, p_String);
+    (void)registered;
+
+    return Name(Hash);
+  }
 
   _INTR_INLINE void setName(const char* p_String)
   {
     _hash = Math::hash(p_String, strlen(p_String));
-    if (_stringMap.find(_hash) == _stringMap.end())
-      _stringMap[_hash] = p_String;
+    registerString(_hash, p_String);
   }
 
   _INTR_INLINE bool isValid() const { return _hash != 0u; }
 
-  _INTR_INLINE _INTR_STRING getString() const { return _stringMap[_hash]; }
+  // Returns the interned string which stays valid for the lifetime of the
+  // application
+  const char* getCString() const;
+  _INTR_INLINE _INTR_STRING getString() const { return getCString(); }
+
+  // Lock free and thread safe - returns false if a different string with the
+  // same hash has already been registered
+  static bool registerString(uint32_t p_Hash, const char* p_String);
 
   _INTR_INLINE bool operator==(const Name& p_Rhs) const
   {
@@ -47,7 +64,6 @@ struct Name
   }
 
   uint32_t _hash;
-  static _INTR_HASH_MAP(uint32_t, _INTR_STRING) _stringMap;
 };
 }
 }
@@ -50,6 +50,7 @@
 #define _INTR_MAX_POST_EFFECT_COUNT 1024u
 #define _INTR_MAX_SCRIPT_COUNT 1024u
 #define _INTR_MAX_EVENT_COUNT 1024u
+#define _INTR_MAX_EVENT_TYPE_COUNT 256u
 #define _INTR_MAX_EVENT_LISTENER_COUNT 1024u
 #define _INTR_MAX_MATERIAL_PASS_COUNT 256u
 
@@ -78,8 +79,10 @@
 #define _INTR_LOG_POP()
 #endif // _INTR_LOGGING_ENABLED
 
-// Names
-#define _N(x) Name(#x)
+// Names - the hash of the literal is computed at compile time
+#define _N(x)                                                                  \
+  Intrinsic::Core::Name::fromLiteral<Intrinsic::Core::Math::hashConstexpr(    \
+      #x, sizeof(#x) - 1u)>(#x)
 
 // Memory management
 #define _INTR_NEW(x, y)                                                        \
@@ -106,6 +109,9 @@
   std::basic_stringstream<char, std::char_traits<char>,                        \
                           Intrinsic::Core::Memory::StlAllocator<char>>
 #define _INTR_ARRAY(a) std::vector<a, Intrinsic::Core::Memory::StlAllocator<a>>
+// Array for temporaries which do not outlive the current frame
+#define _INTR_SCRATCH_ARRAY(a)                                                 \
+  std::vector<a, Intrinsic::Core::Memory::ScratchStlAllocator<a>>
 #define _INTR_STACK_ARRAY(a, b) std::array<a, b>
 #define _INTR_HASH_MAP(a, b)                                                   \
   spp::sparse_hash_map<a, b, spp::spp_hash<a>, std::equal_to<a>>
@@ -245,6 +251,10 @@
   MICROPROFILE_COUNTER_SET(_name, _count)
 #define _INTR_PROFILE_COUNTER_SUB(_name, _count)                               \
   MICROPROFILE_COUNTER_SUB(_name, _count)
+#define _INTR_PROFILE_COUNTER_GET_TOKEN(_name)                                 \
+  MicroProfileGetCounterToken(_name)
+#define _INTR_PROFILE_COUNTER_TOKEN_SET(_token, _count)                        \
+  MicroProfileCounterSet(_token, _count)
 
 #define _INTR_PROFILE_DEFINE_LOCAL_COUNTER(_var, _name)                        \
   MICROPROFILE_DEFINE_LOCAL_COUNTER(_var, _name)
@@ -264,6 +274,8 @@
 #define _INTR_PROFILE_COUNTER_ADD(_name, _count)
 #define _INTR_PROFILE_COUNTER_SET(_name, _count)
 #define _INTR_PROFILE_COUNTER_SUB(_name, _count)
+#define _INTR_PROFILE_COUNTER_GET_TOKEN(_name) 0u
+#define _INTR_PROFILE_COUNTER_TOKEN_SET(_token, _count)
 
 #define _INTR_PROFILE_DEFINE_LOCAL_COUNTER(_var, _name)
 #define _INTR_PROFILE_COUNTER_LOCAL_ADD(_var, _count)
@@ -284,3 +296,12 @@
 #else
 #define _INTR_INLINE inline
 #endif // _WIN32
+
+// SIMD
+#if defined(_WIN32)
+#define _INTR_ALIGN(x) __declspec(align(x))
+#define _INTR_TARGET_AVX2
+#else
+#define _INTR_ALIGN(x) __attribute__((aligned(x)))
+#define _INTR_TARGET_AVX2 __attribute__((target("avx2,fma")))
+#endif // _WIN32
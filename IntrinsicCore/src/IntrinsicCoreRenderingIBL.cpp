@@ -16,6 +16,7 @@
 #include "stdafx.h"
 
 #define PRE_FILTERING_BLOCK_SIZE 32u
+#define SH_PROJECTION_BATCH_SIZE 16u
 
 namespace Intrinsic
 {
@@ -27,131 +28,412 @@ namespace IBL
 {
 namespace
 {
-_INTR_INLINE void _preFilterGGXOpt(const gli::texture_cube& p_Input,
-                                   gli::texture_cube& p_Output,
-                                   uint32_t p_FaceIdx, uint32_t p_MipIdx,
-                                   glm::uvec2 p_RangeX, glm::uvec2 p_RangeY,
-                                   const uint32_t* p_SampleCounts,
-                                   float p_MinRoughness)
+// Float32 SoA copy of a cube map and its mip chain - every color channel is
+// stored in a separate plane, the faces of each level follow each other
+struct FilterSource
 {
-  using namespace Renderer::RenderProcess;
-
-  gli::fsamplerCube sourceSamplerTrilinear = gli::fsamplerCube(
-      p_Input, gli::WRAP_CLAMP_TO_EDGE, gli::FILTER_LINEAR, gli::FILTER_LINEAR);
-  gli::fsamplerCube targetSampler =
-      gli::fsamplerCube(p_Output, gli::WRAP_CLAMP_TO_EDGE);
-
-  glm::uvec2 extent = p_Output.extent(p_MipIdx);
-  const float roughness = p_MinRoughness + float(p_MipIdx) /
-                                               p_Output.max_level() *
-                                               (1.0f - p_MinRoughness);
-  const float roughness2 = roughness * roughness;
-  const float resolution = (float)(p_Input.extent(0u).x * p_Input.extent(0u).y);
-  const float saTexel = 4.0f * glm::pi<float>() / (6.0f * resolution);
+  void init(const gli::texture_cube& p_Input)
+  {
+    const gli::texture_cube input =
+        p_Input.format() == gli::FORMAT_RGBA32_SFLOAT_PACK32
+            ? p_Input
+            : gli::convert(p_Input, gli::FORMAT_RGBA32_SFLOAT_PACK32);
 
-  const uint32_t sampleCount = p_SampleCounts[p_MipIdx];
+    levelCount = (uint32_t)input.levels();
+    extents.resize(levelCount);
+    offsets.resize(levelCount);
 
-  for (uint32_t y = p_RangeY.x; y < p_RangeY.y; ++y)
-  {
-    for (uint32_t x = p_RangeX.x; x < p_RangeX.y; ++x)
+    uint32_t texelCount = 0u;
+    for (uint32_t levelIdx = 0u; levelIdx < levelCount; ++levelIdx)
     {
-      const glm::uvec3 pixelPos = glm::uvec3(x, y, p_FaceIdx);
-      const glm::vec3 R = Rendering::IBL::mapXYSToDirection(pixelPos, extent);
+      extents[levelIdx] = (uint32_t)input.extent(levelIdx).x;
+      offsets[levelIdx] = texelCount;
+      texelCount += 6u * extents[levelIdx] * extents[levelIdx];
+    }
 
-      glm::vec3 preFilteredColor = glm::vec3(0.0f);
+    for (uint32_t channelIdx = 0u; channelIdx < 3u; ++channelIdx)
+    {
+      planes[channelIdx].resize(texelCount);
+    }
 
-      float totalWeight = 0.0f;
+    for (uint32_t levelIdx = 0u; levelIdx < levelCount; ++levelIdx)
+    {
+      const uint32_t faceTexelCount = extents[levelIdx] * extents[levelIdx];
 
-      for (uint32_t i = 0; i < sampleCount; ++i)
+      for (uint32_t faceIdx = 0u; faceIdx < 6u; ++faceIdx)
       {
-        const glm::vec2 Xi = Math::hammersley(i, sampleCount);
-        const glm::vec3 H = importanceSampleGGX(Xi, roughness, R);
-        const glm::vec3 L = 2.0f * glm::dot(R, H) * H - R;
-        const float NdL = glm::clamp(glm::dot(R, L), 0.0f, 1.0f);
-        const float NdH = glm::clamp(glm::dot(R, H), 0.0f, 1.0f);
+        const glm::vec4* texels =
+            (const glm::vec4*)input.data(0u, faceIdx, levelIdx);
+        const uint32_t offset = offsets[levelIdx] + faceIdx * faceTexelCount;
 
-        if (NdL > 0.0f)
+        for (uint32_t i = 0u; i < faceTexelCount; ++i)
         {
-          const glm::vec3 uvs = mapDirectionToUVS(L);
+          planes[0u][offset + i] = texels[i].x;
+          planes[1u][offset + i] = texels[i].y;
+          planes[2u][offset + i] = texels[i].z;
+        }
+      }
+    }
+  }
 
-          const float D = D_GGX(NdH, roughness2);
-          const float pdf = D * 0.25f + 0.0001f;
+  uint32_t levelCount;
+  _INTR_ARRAY(uint32_t) extents;
+  _INTR_ARRAY(uint32_t) offsets;
+  _INTR_ARRAY(float) planes[3];
+};
 
-          const float saSample = 1.0f / (float(sampleCount) * pdf + 0.0001f);
-          const float mipLevel =
-              glm::clamp(1.0f /* Bias*/ + 0.5f * log2(saSample / saTexel), 0.0f,
-                         (float)p_Input.max_level());
+// <-
 
-          preFilteredColor += glm::vec3(sourceSamplerTrilinear.texture_lod(
-                                  uvs, (size_t)uvs.z, mipLevel)) *
-                              NdL;
-          totalWeight += NdL;
-        }
+// The importance sampled light directions for one roughness in tangent space
+// (with the normal pointing along +z) and the mip level to sample for each
+// of them. Neither depends on the texel, so they are only computed once per
+// output mip level. Samples facing away from the normal are discarded
+// upfront.
+struct FilterSampleTable
+{
+  void init(uint32_t p_SampleCount, float p_Roughness, float p_TexelSolidAngle,
+            float p_MaxLod, bool p_UseLod)
+  {
+    const float roughness2 = p_Roughness * p_Roughness;
+    float totalWeight = 0.0f;
+
+    for (uint32_t i = 0u; i < p_SampleCount; ++i)
+    {
+      const glm::vec2 Xi = Math::hammersley(i, p_SampleCount);
+
+      // Same as importanceSampleGGX but without the tangent frame
+      const float phi = 2.0f * glm::pi<float>() * Xi.x;
+      const float cosTheta = sqrt((1.0f - Xi.y) /
+                                  (1.0f + (roughness2 * roughness2 - 1.0f) *
+                                              Xi.y));
+      const float sinTheta = sqrt(1.0f - cosTheta * cosTheta);
+      const glm::vec3 H =
+          glm::vec3(sinTheta * cos(phi), sinTheta * sin(phi), cosTheta);
+      const glm::vec3 L = 2.0f * H.z * H - glm::vec3(0.0f, 0.0f, 1.0f);
+
+      const float NdL = glm::clamp(L.z, 0.0f, 1.0f);
+      if (NdL <= 0.0f)
+      {
+        continue;
+      }
+
+      float lod = 0.0f;
+      if (p_UseLod)
+      {
+        const float NdH = glm::clamp(H.z, 0.0f, 1.0f);
+        const float D = D_GGX(NdH, roughness2);
+        const float pdf = D * 0.25f + 0.0001f;
+
+        const float saSample = 1.0f / (float(p_SampleCount) * pdf + 0.0001f);
+        lod = glm::clamp(1.0f /* Bias*/ +
+                             0.5f * log2(saSample / p_TexelSolidAngle),
+                         0.0f, p_MaxLod);
       }
 
-      targetSampler.texel_write(
-          pixelPos, p_FaceIdx, p_MipIdx,
-          glm::vec4(preFilteredColor / totalWeight, 1.0f));
+      dirX.push_back(L.x);
+      dirY.push_back(L.y);
+      dirZ.push_back(NdL);
+      lods.push_back(lod);
+      totalWeight += NdL;
     }
+
+    rcpTotalWeight = 1.0f / totalWeight;
   }
+
+  // The z component is also the weight of the sample
+  _INTR_ARRAY(float) dirX;
+  _INTR_ARRAY(float) dirY;
+  _INTR_ARRAY(float) dirZ;
+  _INTR_ARRAY(float) lods;
+  float rcpTotalWeight;
+};
+
+// <-
+
+_INTR_INLINE void calcTangentFrame(const glm::vec3& p_N, glm::vec3& p_TanX,
+                                   glm::vec3& p_TanY)
+{
+  const glm::vec3 up = abs(p_N.z) < 0.999f ? glm::vec3(0.0f, 0.0f, 1.0f)
+                                           : glm::vec3(1.0f, 0.0f, 0.0f);
+  p_TanX = glm::normalize(glm::cross(up, p_N));
+  p_TanY = glm::cross(p_N, p_TanX);
 }
 
-_INTR_INLINE void _preFilterGGX(const gli::texture_cube& p_Input,
-                                gli::texture_cube& p_Output, uint32_t p_FaceIdx,
-                                uint32_t p_MipIdx, glm::uvec2 p_RangeX,
-                                glm::uvec2 p_RangeY,
-                                const uint32_t* p_SampleCounts,
-                                float p_MinRoughness)
+// <-
+
+_INTR_INLINE glm::vec3 sampleBilinear(const FilterSource& p_Source,
+                                      uint32_t p_LevelIdx, uint32_t p_FaceIdx,
+                                      float p_U, float p_V)
 {
-  gli::fsamplerCube sourceSampler =
-      gli::fsamplerCube(p_Input, gli::WRAP_CLAMP_TO_EDGE);
-  gli::fsamplerCube targetSampler =
-      gli::fsamplerCube(p_Output, gli::WRAP_CLAMP_TO_EDGE);
+  const uint32_t extent = p_Source.extents[p_LevelIdx];
+  const int32_t maxCoord = (int32_t)extent - 1;
+
+  const float x = p_U * extent - 0.5f;
+  const float y = p_V * extent - 0.5f;
+  const float x0f = floor(x);
+  const float y0f = floor(y);
+  const float fx = x - x0f;
+  const float fy = y - y0f;
+
+  const int32_t x0 = glm::clamp((int32_t)x0f, 0, maxCoord);
+  const int32_t x1 = glm::clamp((int32_t)x0f + 1, 0, maxCoord);
+  const int32_t y0 = glm::clamp((int32_t)y0f, 0, maxCoord);
+  const int32_t y1 = glm::clamp((int32_t)y0f + 1, 0, maxCoord);
+
+  const uint32_t base =
+      p_Source.offsets[p_LevelIdx] + p_FaceIdx * extent * extent;
+  const uint32_t i00 = base + y0 * extent + x0;
+  const uint32_t i10 = base + y0 * extent + x1;
+  const uint32_t i01 = base + y1 * extent + x0;
+  const uint32_t i11 = base + y1 * extent + x1;
+
+  glm::vec3 result;
+  for (uint32_t c = 0u; c < 3u; ++c)
+  {
+    const float* plane = p_Source.planes[c].data();
+    const float top = glm::mix(plane[i00], plane[i10], fx);
+    const float bottom = glm::mix(plane[i01], plane[i11], fx);
+    result[c] = glm::mix(top, bottom, fy);
+  }
 
-  glm::uvec2 extent = p_Output.extent(p_MipIdx);
-  const float roughness = p_MinRoughness + float(p_MipIdx) /
-                                               p_Output.max_level() *
-                                               (1.0f - p_MinRoughness);
+  return result;
+}
 
-  const uint32_t sampleCount = p_SampleCounts[p_MipIdx];
+// <-
 
-  for (uint32_t y = p_RangeY.x; y < p_RangeY.y; ++y)
+glm::vec3 filterTexel(const FilterSource& p_Source,
+                      const FilterSampleTable& p_Table, const glm::vec3& p_R)
+{
+  glm::vec3 tanX, tanY;
+  calcTangentFrame(p_R, tanX, tanY);
+
+  glm::vec3 preFilteredColor = glm::vec3(0.0f);
+  for (uint32_t i = 0u; i < (uint32_t)p_Table.dirZ.size(); ++i)
   {
-    for (uint32_t x = p_RangeX.x; x < p_RangeX.y; ++x)
+    const glm::vec3 L = tanX * p_Table.dirX[i] + tanY * p_Table.dirY[i] +
+                        p_R * p_Table.dirZ[i];
+    const glm::vec3 uvs = mapDirectionToUVS(L);
+
+    const uint32_t levelIdx = (uint32_t)p_Table.lods[i];
+    const float levelBlend = p_Table.lods[i] - levelIdx;
+
+    glm::vec3 color =
+        sampleBilinear(p_Source, levelIdx, (uint32_t)uvs.z, uvs.x, uvs.y);
+    if (levelBlend > 0.0f && levelIdx + 1u < p_Source.levelCount)
     {
-      const glm::uvec3 pixelPos = glm::uvec3(x, y, p_FaceIdx);
-      const glm::vec3 R = Rendering::IBL::mapXYSToDirection(pixelPos, extent);
+      color = glm::mix(color, sampleBilinear(p_Source, levelIdx + 1u,
+                                             (uint32_t)uvs.z, uvs.x, uvs.y),
+                       levelBlend);
+    }
 
-      glm::vec3 preFilteredColor = glm::vec3(0.0f);
+    preFilteredColor += color * p_Table.dirZ[i];
+  }
 
-      float totalWeight = 0.0f;
+  return preFilteredColor * p_Table.rcpTotalWeight;
+}
 
-      for (uint32_t i = 0; i < sampleCount; ++i)
-      {
-        const glm::vec2 Xi = Math::hammersley(i, sampleCount);
-        const glm::vec3 H = importanceSampleGGX(Xi, roughness, R);
-        const glm::vec3 L = 2.0f * glm::dot(R, H) * H - R;
-        const float NdL = glm::clamp(glm::dot(R, L), 0.0f, 1.0f);
+// <-
 
-        if (NdL > 0.0f)
-        {
-          const glm::vec3 uvs = mapDirectionToUVS(L);
+_INTR_TARGET_AVX2 _INTR_INLINE void
+sampleBilinearAvx2(const FilterSource& p_Source, uint32_t p_LevelIdx,
+                   __m256i p_FaceIdx, __m256 p_U, __m256 p_V, __m256* p_Color)
+{
+  const uint32_t extent = p_Source.extents[p_LevelIdx];
+  const __m256 extentF = _mm256_set1_ps((float)extent);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256i one = _mm256_set1_epi32(1);
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i maxCoord = _mm256_set1_epi32((int32_t)extent - 1);
+
+  const __m256 x = _mm256_fmsub_ps(p_U, extentF, half);
+  const __m256 y = _mm256_fmsub_ps(p_V, extentF, half);
+  const __m256 x0f = _mm256_floor_ps(x);
+  const __m256 y0f = _mm256_floor_ps(y);
+  const __m256 fx = _mm256_sub_ps(x, x0f);
+  const __m256 fy = _mm256_sub_ps(y, y0f);
+
+  const __m256i x0 = _mm256_cvttps_epi32(x0f);
+  const __m256i y0 = _mm256_cvttps_epi32(y0f);
+  const __m256i x0c = _mm256_min_epi32(_mm256_max_epi32(x0, zero), maxCoord);
+  const __m256i y0c = _mm256_min_epi32(_mm256_max_epi32(y0, zero), maxCoord);
+  const __m256i x1c = _mm256_min_epi32(
+      _mm256_max_epi32(_mm256_add_epi32(x0, one), zero), maxCoord);
+  const __m256i y1c = _mm256_min_epi32(
+      _mm256_max_epi32(_mm256_add_epi32(y0, one), zero), maxCoord);
+
+  const __m256i extentI = _mm256_set1_epi32((int32_t)extent);
+  const __m256i base = _mm256_add_epi32(
+      _mm256_set1_epi32((int32_t)p_Source.offsets[p_LevelIdx]),
+      _mm256_mullo_epi32(p_FaceIdx,
+                         _mm256_set1_epi32((int32_t)(extent * extent))));
+  const __m256i row0 =
+      _mm256_add_epi32(base, _mm256_mullo_epi32(y0c, extentI));
+  const __m256i row1 =
+      _mm256_add_epi32(base, _mm256_mullo_epi32(y1c, extentI));
+
+  const __m256i i00 = _mm256_add_epi32(row0, x0c);
+  const __m256i i10 = _mm256_add_epi32(row0, x1c);
+  const __m256i i01 = _mm256_add_epi32(row1, x0c);
+  const __m256i i11 = _mm256_add_epi32(row1, x1c);
+
+  for (uint32_t c = 0u; c < 3u; ++c)
+  {
+    const float* plane = p_Source.planes[c].data();
 
-          preFilteredColor +=
-              glm::vec3(sourceSampler.texture_lod(uvs, (size_t)uvs.z, 0u)) *
-              NdL;
-          totalWeight += NdL;
-        }
+    const __m256 c00 = _mm256_i32gather_ps(plane, i00, 4);
+    const __m256 c10 = _mm256_i32gather_ps(plane, i10, 4);
+    const __m256 c01 = _mm256_i32gather_ps(plane, i01, 4);
+    const __m256 c11 = _mm256_i32gather_ps(plane, i11, 4);
+
+    const __m256 top = _mm256_fmadd_ps(fx, _mm256_sub_ps(c10, c00), c00);
+    const __m256 bottom = _mm256_fmadd_ps(fx, _mm256_sub_ps(c11, c01), c01);
+    p_Color[c] = _mm256_fmadd_ps(fy, _mm256_sub_ps(bottom, top), top);
+  }
+}
+
+// <-
+
+// Filters eight texels at once - each lane processes a different texel while
+// all lanes evaluate the same sample of the table
+_INTR_TARGET_AVX2 void filterTexelsAvx2(const FilterSource& p_Source,
+                                        const FilterSampleTable& p_Table,
+                                        const glm::vec3* p_R,
+                                        glm::vec4* p_Output)
+{
+  _INTR_ALIGN(32) float frame[9][8];
+  for (uint32_t lane = 0u; lane < 8u; ++lane)
+  {
+    glm::vec3 tanX, tanY;
+    calcTangentFrame(p_R[lane], tanX, tanY);
+
+    for (uint32_t c = 0u; c < 3u; ++c)
+    {
+      frame[c][lane] = tanX[c];
+      frame[3u + c][lane] = tanY[c];
+      frame[6u + c][lane] = p_R[lane][c];
+    }
+  }
+
+  const __m256 tanXx = _mm256_load_ps(frame[0]);
+  const __m256 tanXy = _mm256_load_ps(frame[1]);
+  const __m256 tanXz = _mm256_load_ps(frame[2]);
+  const __m256 tanYx = _mm256_load_ps(frame[3]);
+  const __m256 tanYy = _mm256_load_ps(frame[4]);
+  const __m256 tanYz = _mm256_load_ps(frame[5]);
+  const __m256 rx = _mm256_load_ps(frame[6]);
+  const __m256 ry = _mm256_load_ps(frame[7]);
+  const __m256 rz = _mm256_load_ps(frame[8]);
+
+  const __m256 zero = _mm256_setzero_ps();
+  const __m256 one = _mm256_set1_ps(1.0f);
+  const __m256 half = _mm256_set1_ps(0.5f);
+  const __m256 signMask = _mm256_set1_ps(-0.0f);
+
+  __m256 preFilteredColor[3] = {zero, zero, zero};
+
+  for (uint32_t i = 0u; i < (uint32_t)p_Table.dirZ.size(); ++i)
+  {
+    const __m256 dx = _mm256_set1_ps(p_Table.dirX[i]);
+    const __m256 dy = _mm256_set1_ps(p_Table.dirY[i]);
+    const __m256 dz = _mm256_set1_ps(p_Table.dirZ[i]);
+
+    const __m256 lx = _mm256_fmadd_ps(
+        tanXx, dx, _mm256_fmadd_ps(tanYx, dy, _mm256_mul_ps(rx, dz)));
+    const __m256 ly = _mm256_fmadd_ps(
+        tanXy, dx, _mm256_fmadd_ps(tanYy, dy, _mm256_mul_ps(ry, dz)));
+    const __m256 lz = _mm256_fmadd_ps(
+        tanXz, dx, _mm256_fmadd_ps(tanYz, dy, _mm256_mul_ps(rz, dz)));
+
+    // Vectorized version of mapDirectionToUVS
+    const __m256 ax = _mm256_andnot_ps(signMask, lx);
+    const __m256 ay = _mm256_andnot_ps(signMask, ly);
+    const __m256 az = _mm256_andnot_ps(signMask, lz);
+
+    const __m256 isX =
+        _mm256_and_ps(_mm256_cmp_ps(ax, ay, _CMP_GE_OQ),
+                      _mm256_cmp_ps(ax, az, _CMP_GE_OQ));
+    const __m256 isY =
+        _mm256_andnot_ps(isX, _mm256_cmp_ps(ay, az, _CMP_GE_OQ));
+
+    const __m256 posX = _mm256_cmp_ps(lx, zero, _CMP_GT_OQ);
+    const __m256 posY = _mm256_cmp_ps(ly, zero, _CMP_GT_OQ);
+    const __m256 posZ = _mm256_cmp_ps(lz, zero, _CMP_GT_OQ);
+
+    // +x: (-z, y), -x: (z, y), +y: (x, -z), -y: (x, z), +z: (x, y),
+    // -z: (-x, y)
+    const __m256 uX = _mm256_xor_ps(lz, _mm256_and_ps(posX, signMask));
+    const __m256 vY = _mm256_xor_ps(lz, _mm256_and_ps(posY, signMask));
+    const __m256 uZ = _mm256_xor_ps(lx, _mm256_andnot_ps(posZ, signMask));
+
+    const __m256 faceX = _mm256_blendv_ps(one, zero, posX);
+    const __m256 faceY = _mm256_blendv_ps(_mm256_set1_ps(3.0f),
+                                          _mm256_set1_ps(2.0f), posY);
+    const __m256 faceZ = _mm256_blendv_ps(_mm256_set1_ps(5.0f),
+                                          _mm256_set1_ps(4.0f), posZ);
+
+    const __m256 maxAxis =
+        _mm256_blendv_ps(_mm256_blendv_ps(az, ay, isY), ax, isX);
+    const __m256 u = _mm256_blendv_ps(_mm256_blendv_ps(uZ, lx, isY), uX, isX);
+    const __m256 v = _mm256_blendv_ps(_mm256_blendv_ps(ly, vY, isY), ly, isX);
+    const __m256i faceIdx = _mm256_cvttps_epi32(
+        _mm256_blendv_ps(_mm256_blendv_ps(faceZ, faceY, isY), faceX, isX));
+
+    const __m256 rcpMaxAxis = _mm256_div_ps(one, maxAxis);
+    const __m256 s =
+        _mm256_fmadd_ps(_mm256_mul_ps(u, rcpMaxAxis), half, half);
+    const __m256 t =
+        _mm256_fnmadd_ps(_mm256_mul_ps(v, rcpMaxAxis), half, half);
+
+    // The mip level is the same for all lanes
+    const uint32_t levelIdx = (uint32_t)p_Table.lods[i];
+    const float levelBlend = p_Table.lods[i] - levelIdx;
+
+    __m256 color[3];
+    sampleBilinearAvx2(p_Source, levelIdx, faceIdx, s, t, color);
+
+    if (levelBlend > 0.0f && levelIdx + 1u < p_Source.levelCount)
+    {
+      __m256 nextColor[3];
+      sampleBilinearAvx2(p_Source, levelIdx + 1u, faceIdx, s, t, nextColor);
+
+      const __m256 blend = _mm256_set1_ps(levelBlend);
+      for (uint32_t c = 0u; c < 3u; ++c)
+      {
+        color[c] = _mm256_fmadd_ps(blend, _mm256_sub_ps(nextColor[c], color[c]),
+                                   color[c]);
       }
+    }
 
-      targetSampler.texel_write(
-          pixelPos, p_FaceIdx, p_MipIdx,
-          glm::vec4(preFilteredColor / totalWeight, 1.0f));
+    for (uint32_t c = 0u; c < 3u; ++c)
+    {
+      preFilteredColor[c] = _mm256_fmadd_ps(color[c], dz, preFilteredColor[c]);
     }
   }
+
+  _INTR_ALIGN(32) float result[3][8];
+  const __m256 rcpTotalWeight = _mm256_set1_ps(p_Table.rcpTotalWeight);
+  for (uint32_t c = 0u; c < 3u; ++c)
+  {
+    _mm256_store_ps(result[c],
+                    _mm256_mul_ps(preFilteredColor[c], rcpTotalWeight));
+  }
+
+  for (uint32_t lane = 0u; lane < 8u; ++lane)
+  {
+    p_Output[lane] =
+        glm::vec4(result[0][lane], result[1][lane], result[2][lane], 1.0f);
+  }
 }
 
-enki::TaskScheduler _scheduler;
+// <-
+
+struct PreFilterTile
+{
+  uint32_t mipIdx;
+  uint32_t faceIdx;
+  glm::uvec2 rangeX;
+  glm::uvec2 rangeY;
+};
 
 struct PreFilterParallelTaskSet : enki::ITaskSet
 {
@@ -160,37 +442,223 @@ struct PreFilterParallelTaskSet : enki::ITaskSet
   void ExecuteRange(enki::TaskSetPartition p_Range,
                     uint32_t p_ThreadNum) override
   {
+    _INTR_PROFILE_CPU("IBL", "Pre Filter GGX Tiles");
+
+    const bool avx2Supported = Simd::isAvx2Supported();
 
-    if (_mipIdx == 0u)
+    for (uint32_t tileIdx = p_Range.start; tileIdx < p_Range.end; ++tileIdx)
     {
-      _preFilterGGX(*_input, *_output, _faceIdx, _mipIdx, _rangeX, _rangeY,
-                    _sampleCounts, _minRoughness);
+      const PreFilterTile& tile = _tiles[tileIdx];
+      const FilterSampleTable& table = _sampleTables[tile.mipIdx];
+      const glm::uvec2 extent = _output->extent(tile.mipIdx);
+
+      glm::vec4* outputTexels =
+          (glm::vec4*)_output->data(0u, tile.faceIdx, tile.mipIdx);
+
+      for (uint32_t y = tile.rangeY.x; y < tile.rangeY.y; ++y)
+      {
+        glm::vec4* outputRow = &outputTexels[y * extent.x];
+        uint32_t x = tile.rangeX.x;
+
+        if (avx2Supported)
+        {
+          for (; x + 8u <= tile.rangeX.y; x += 8u)
+          {
+            glm::vec3 R[8];
+            for (uint32_t lane = 0u; lane < 8u; ++lane)
+            {
+              R[lane] = mapXYSToDirection(
+                  glm::uvec3(x + lane, y, tile.faceIdx), extent);
+            }
+
+            filterTexelsAvx2(*_source, table, R, &outputRow[x]);
+          }
+        }
+
+        for (; x < tile.rangeX.y; ++x)
+        {
+          const glm::vec3 R =
+              mapXYSToDirection(glm::uvec3(x, y, tile.faceIdx), extent);
+          outputRow[x] = glm::vec4(filterTexel(*_source, table, R), 1.0f);
+        }
+      }
     }
-    else
+  }
+
+  const FilterSource* _source;
+  const FilterSampleTable* _sampleTables;
+  const PreFilterTile* _tiles;
+  gli::texture_cube* _output;
+};
+
+// <-
+
+// Basis functions times the solid angle of each texel for one cube map
+// resolution - the normalization of the projection is already applied
+struct SHProjectionTable
+{
+  void init(uint32_t p_Extent)
+  {
+    const glm::uvec2 extent = glm::uvec2(p_Extent);
+    weights.resize(6u * p_Extent * p_Extent * 9u);
+
+    float weightSum = 0.0f;
+    uint32_t texelIdx = 0u;
+    for (uint32_t face = 0u; face < 6u; ++face)
     {
-      _preFilterGGXOpt(*_input, *_output, _faceIdx, _mipIdx, _rangeX, _rangeY,
-                       _sampleCounts, _minRoughness);
+      for (uint32_t y = 0u; y < p_Extent; ++y)
+      {
+        for (uint32_t x = 0u; x < p_Extent; ++x)
+        {
+          const glm::vec2 uv0 =
+              (glm::vec2(x, y) + 0.5f) / glm::vec2(extent) * 2.0f - 1.0f;
+
+          const float temp = 1.0f + uv0.x * uv0.x + uv0.y * uv0.y;
+          const float weight = 4.0f / (std::sqrt(temp) * temp);
+
+          const glm::vec3 dir =
+              mapXYSToDirection(glm::uvec3(x, y, face), extent);
+          const SH9 basis = project(dir, glm::vec3(weight));
+
+          for (uint32_t i = 0u; i < 9u; ++i)
+          {
+            weights[texelIdx * 9u + i] = ((const glm::vec3*)&basis)[i].x;
+          }
+
+          weightSum += weight;
+          ++texelIdx;
+        }
+      }
     }
-  };
 
-  const gli::texture_cube* _input;
-  gli::texture_cube* _output;
+    const float normalization = (4.0f * glm::pi<float>()) / weightSum;
+    for (uint32_t i = 0u; i < (uint32_t)weights.size(); ++i)
+    {
+      weights[i] *= normalization;
+    }
+  }
 
-  glm::uvec2 _rangeX;
-  glm::uvec2 _rangeY;
-  uint32_t _mipIdx;
-  const uint32_t* _sampleCounts;
-  uint32_t _faceIdx;
-  float _minRoughness;
+  // Nine weights per texel
+  _INTR_ARRAY(float) weights;
 };
 
-_INTR_ARRAY(PreFilterParallelTaskSet) _preFilterParallelTaskSets;
+_INTR_HASH_MAP(uint32_t, SHProjectionTable*) _shProjectionTables;
+
+const SHProjectionTable* getSHProjectionTable(uint32_t p_Extent)
+{
+  auto table = _shProjectionTables.find(p_Extent);
+  if (table != _shProjectionTables.end())
+  {
+    return table->second;
+  }
+
+  _INTR_PROFILE_CPU("IBL", "Init SH Projection Table");
+
+  SHProjectionTable* newTable;
+  _INTR_NEW(SHProjectionTable, newTable)();
+  newTable->init(p_Extent);
+
+  _shProjectionTables[p_Extent] = newTable;
+  return newTable;
+}
+
+// <-
+
+// Accumulates the weighted RGB(A) texels into the SH coefficients, the alpha
+// channel ends up in the unused fourth lane
+_INTR_INLINE void projectTexels(const glm::vec4* p_Texels,
+                                const float* p_Weights, uint32_t p_Count,
+                                __m128* p_Coefficients)
+{
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    const __m128 color = _mm_loadu_ps(&p_Texels[i].x);
+    const float* weights = &p_Weights[i * 9u];
+
+    for (uint32_t j = 0u; j < 9u; ++j)
+    {
+      p_Coefficients[j] =
+          Simd::simdMadd(color, _mm_set1_ps(weights[j]), p_Coefficients[j]);
+    }
+  }
+}
+
+void projectFace(const gli::texture_cube& p_CubeMap, uint32_t p_FaceIdx,
+                 const SHProjectionTable& p_Table, SH9& p_SH)
+{
+  const uint32_t faceTexelCount =
+      (uint32_t)(p_CubeMap.extent().x * p_CubeMap.extent().y);
+  const float* weights = &p_Table.weights[p_FaceIdx * faceTexelCount * 9u];
+
+  __m128 coefficients[9];
+  for (uint32_t i = 0u; i < 9u; ++i)
+  {
+    coefficients[i] = _mm_setzero_ps();
+  }
+
+  if (p_CubeMap.format() == gli::FORMAT_RGBA32_SFLOAT_PACK32)
+  {
+    projectTexels((const glm::vec4*)p_CubeMap.data(0u, p_FaceIdx, 0u),
+                  weights, faceTexelCount, coefficients);
+  }
+  else
+  {
+    _INTR_ASSERT(p_CubeMap.format() == gli::FORMAT_RGBA16_SFLOAT_PACK16);
+
+    // Convert the half texels in small chunks which stay in the cache
+    const uint32_t* packedTexels =
+        (const uint32_t*)p_CubeMap.data(0u, p_FaceIdx, 0u);
+    _INTR_ALIGN(16) glm::vec4 texels[64];
+
+    for (uint32_t start = 0u; start < faceTexelCount; start += 64u)
+    {
+      const uint32_t count = std::min(faceTexelCount - start, 64u);
+
+      for (uint32_t i = 0u; i < count; ++i)
+      {
+        const uint32_t texelIdx = (start + i) * 2u;
+        texels[i] = glm::vec4(glm::unpackHalf2x16(packedTexels[texelIdx]),
+                              glm::unpackHalf2x16(packedTexels[texelIdx + 1u]));
+      }
+
+      projectTexels(texels, &weights[start * 9u], count, coefficients);
+    }
+  }
+
+  for (uint32_t i = 0u; i < 9u; ++i)
+  {
+    _INTR_ALIGN(16) float coefficient[4];
+    _mm_store_ps(coefficient, coefficients[i]);
+
+    ((glm::vec3*)&p_SH)[i] =
+        glm::vec3(coefficient[0], coefficient[1], coefficient[2]);
+  }
 }
 
-void initCubemapProcessing()
+// <-
+
+struct SHProjectionParallelTaskSet : enki::ITaskSet
 {
-  _scheduler.Initialize();
-  _preFilterParallelTaskSets = _INTR_ARRAY(PreFilterParallelTaskSet)();
+  virtual ~SHProjectionParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("IBL", "Project SH9");
+
+    // One task per face of each cube map
+    for (uint32_t taskIdx = p_Range.start; taskIdx < p_Range.end; ++taskIdx)
+    {
+      const uint32_t cubeMapIdx = taskIdx / 6u;
+      projectFace(_cubeMaps[cubeMapIdx], taskIdx % 6u,
+                  *_tables[cubeMapIdx], _faceSHs[taskIdx]);
+    }
+  }
+
+  const gli::texture_cube* _cubeMaps;
+  const SHProjectionTable* const* _tables;
+  SH9* _faceSHs;
+};
 }
 
 void preFilterGGX(const gli::texture_cube& p_Input, gli::texture_cube& p_Output,
@@ -198,81 +666,141 @@ void preFilterGGX(const gli::texture_cube& p_Input, gli::texture_cube& p_Output,
 {
   _INTR_PROFILE_AUTO("Pre Filter GGX");
 
-  uint32_t jobCount = 0u;
+  _INTR_ASSERT(p_Output.format() == gli::FORMAT_RGBA32_SFLOAT_PACK32 &&
+               "Output has to be a RGBA32F cube map");
+
+  FilterSource source;
+  source.init(p_Input);
+
+  const float resolution = (float)(source.extents[0u] * source.extents[0u]);
+  const float saTexel = 4.0f * glm::pi<float>() / (6.0f * resolution);
+  const uint32_t levelCount = (uint32_t)p_Output.levels();
+
+  _INTR_ARRAY(FilterSampleTable) sampleTables;
+  sampleTables.resize(levelCount);
+
+  _INTR_ARRAY(PreFilterTile) tiles;
   uint32_t totalSampleCount = 0u;
 
-  // Calculate the amount of jobs to dispatch
+  for (uint32_t mipIdx = 0u; mipIdx < levelCount; ++mipIdx)
   {
-    for (uint32_t mipIdx = 0u; mipIdx <= p_Output.max_level(); ++mipIdx)
-    {
-      totalSampleCount += p_Output.extent(mipIdx).x *
-                          p_Output.extent(mipIdx).y * 6u *
-                          p_SampleCounts[mipIdx];
+    const float roughness = p_MinRoughness + float(mipIdx) /
+                                                 p_Output.max_level() *
+                                                 (1.0f - p_MinRoughness);
 
-      const glm::uvec2 blockCount = glm::max(
-          glm::uvec2(p_Output.extent(mipIdx)) / PRE_FILTERING_BLOCK_SIZE, 1u);
+    // The first mip level only samples the full resolution source
+    sampleTables[mipIdx].init(p_SampleCounts[mipIdx], roughness, saTexel,
+                              (float)(source.levelCount - 1u), mipIdx > 0u);
 
-      for (uint32_t faceIdx = 0u; faceIdx <= p_Output.max_face(); ++faceIdx)
+    const glm::uvec2 extent = glm::uvec2(p_Output.extent(mipIdx));
+    totalSampleCount += extent.x * extent.y * 6u * p_SampleCounts[mipIdx];
+
+    // Tiles are multiples of eight texels wide, so rows can be processed
+    // with full AVX2 lanes
+    for (uint32_t faceIdx = 0u; faceIdx <= p_Output.max_face(); ++faceIdx)
+    {
+      for (uint32_t blockY = 0u; blockY < extent.y;
+           blockY += PRE_FILTERING_BLOCK_SIZE)
       {
-        for (uint32_t blockY = 0u; blockY < blockCount.y; ++blockY)
+        for (uint32_t blockX = 0u; blockX < extent.x;
+             blockX += PRE_FILTERING_BLOCK_SIZE)
         {
-          for (uint32_t blockX = 0u; blockX < blockCount.x; ++blockX)
+          PreFilterTile tile;
           {
-            ++jobCount;
+            tile.mipIdx = mipIdx;
+            tile.faceIdx = faceIdx;
+            tile.rangeX = glm::uvec2(
+                blockX, std::min(blockX + PRE_FILTERING_BLOCK_SIZE, extent.x));
+            tile.rangeY = glm::uvec2(
+                blockY, std::min(blockY + PRE_FILTERING_BLOCK_SIZE, extent.y));
           }
+          tiles.push_back(tile);
         }
       }
     }
-    _preFilterParallelTaskSets.resize(jobCount);
   }
 
   _INTR_LOG_INFO("Total amount of samples: %u", totalSampleCount);
 
-  uint32_t jobIdx = 0u;
-  for (uint32_t mipIdx = 0u; mipIdx <= p_Output.max_level(); ++mipIdx)
+  PreFilterParallelTaskSet taskSet;
   {
-    const glm::uvec2 blockCount = glm::max(
-        glm::uvec2(p_Output.extent(mipIdx)) / PRE_FILTERING_BLOCK_SIZE, 1u);
+    taskSet._source = &source;
+    taskSet._sampleTables = sampleTables.data();
+    taskSet._tiles = tiles.data();
+    taskSet._output = &p_Output;
+    taskSet.m_SetSize = (uint32_t)tiles.size();
+  }
 
-    for (uint32_t faceIdx = 0u; faceIdx <= p_Output.max_face(); ++faceIdx)
-    {
-      for (uint32_t blockY = 0u; blockY < blockCount.y; ++blockY)
-      {
-        for (uint32_t blockX = 0u; blockX < blockCount.x; ++blockX)
-        {
-          const glm::uvec2 blockStart =
-              glm::uvec2(blockX * PRE_FILTERING_BLOCK_SIZE,
-                         blockY * PRE_FILTERING_BLOCK_SIZE);
-          const glm::uvec2 blockEnd =
-              glm::min(blockStart + PRE_FILTERING_BLOCK_SIZE,
-                       glm::uvec2(p_Output.extent(mipIdx)));
-
-          PreFilterParallelTaskSet& taskSet =
-              _preFilterParallelTaskSets[jobIdx++];
-          {
-            taskSet._input = &p_Input;
-            taskSet._output = &p_Output;
-            taskSet._rangeX = glm::uvec2(blockStart.x, blockEnd.x);
-            taskSet._rangeY = glm::uvec2(blockStart.y, blockEnd.y);
-            taskSet._mipIdx = mipIdx;
-            taskSet._faceIdx = faceIdx;
-            taskSet._sampleCounts = p_SampleCounts;
-            taskSet._minRoughness = p_MinRoughness;
-          }
+  _INTR_LOG_INFO("Queued %u tiles for pre filtering (AVX2: %s)...",
+                 (uint32_t)tiles.size(),
+                 Simd::isAvx2Supported() ? "true" : "false");
 
-          _scheduler.AddTaskSetToPipe(&taskSet);
-        }
-      }
-    }
+  Application::_scheduler.AddTaskSetToPipe(&taskSet);
+  Application::_scheduler.WaitforTaskSet(&taskSet);
+}
+
+// <-
+
+SH9 project(const gli::texture_cube& p_CubeMap)
+{
+  SH9 result;
+  project(&p_CubeMap, 1u, &result);
+  return result;
+}
+
+// <-
+
+void project(const gli::texture_cube* p_CubeMaps, uint32_t p_Count,
+             SH9* p_SHs)
+{
+  _INTR_PROFILE_AUTO("Project SH9");
+
+  _INTR_ARRAY(gli::texture_cube) cubeMaps;
+  _INTR_ARRAY(const SHProjectionTable*) tables;
+  cubeMaps.resize(p_Count);
+  tables.resize(p_Count);
+
+  // The tables are created on this thread, the kernels read float and half
+  // texels directly and everything else gets converted upfront
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    const gli::format format = p_CubeMaps[i].format();
+    cubeMaps[i] = format == gli::FORMAT_RGBA32_SFLOAT_PACK32 ||
+                          format == gli::FORMAT_RGBA16_SFLOAT_PACK16
+                      ? p_CubeMaps[i]
+                      : gli::convert(p_CubeMaps[i],
+                                     gli::FORMAT_RGBA32_SFLOAT_PACK32);
+
+    _INTR_ASSERT(cubeMaps[i].extent().x == cubeMaps[i].extent().y);
+    tables[i] = getSHProjectionTable((uint32_t)cubeMaps[i].extent().x);
   }
 
-  _INTR_LOG_INFO("Queued %u jobs for pre filtering...",
-                 (uint32_t)_preFilterParallelTaskSets.size());
+  _INTR_ARRAY(SH9) faceSHs;
+  faceSHs.resize(p_Count * 6u);
+
+  SHProjectionParallelTaskSet taskSet;
+  {
+    taskSet._cubeMaps = cubeMaps.data();
+    taskSet._tables = tables.data();
+    taskSet._faceSHs = faceSHs.data();
+    taskSet.m_SetSize = (uint32_t)faceSHs.size();
+  }
 
-  _scheduler.WaitforAll();
-  _preFilterParallelTaskSets.clear();
+  Application::_scheduler.AddTaskSetToPipe(&taskSet);
+  Application::_scheduler.WaitforTaskSet(&taskSet);
+
+  for (uint32_t i = 0u; i < p_Count; ++i)
+  {
+    p_SHs[i] = faceSHs[i * 6u];
+    for (uint32_t faceIdx = 1u; faceIdx < 6u; ++faceIdx)
+    {
+      p_SHs[i] += faceSHs[i * 6u + faceIdx];
+    }
+  }
 }
 
+// <-
+
 void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
                    bool p_CreateResources, float p_Time)
 {
@@ -335,6 +863,28 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
   float prevMaxFps = Settings::Manager::_targetFrameRate;
   Settings::Manager::_targetFrameRate = 0.0f;
 
+  // Irradiance probes are projected to SH in batches
+  _INTR_ARRAY(gli::texture_cube) pendingIrradCubeMaps;
+  Components::IrradianceProbeRefArray pendingIrradProbeRefs;
+
+  auto projectPendingIrradianceProbes = [&]() {
+    if (pendingIrradProbeRefs.empty())
+      return;
+
+    _INTR_ARRAY(SH9) shs;
+    shs.resize(pendingIrradProbeRefs.size());
+    project(pendingIrradCubeMaps.data(), (uint32_t)shs.size(), shs.data());
+
+    for (uint32_t j = 0u; j < shs.size(); ++j)
+    {
+      Components::IrradianceProbeManager::_descSHs(pendingIrradProbeRefs[j])
+          .push_back(shs[j]);
+    }
+
+    pendingIrradCubeMaps.clear();
+    pendingIrradProbeRefs.clear();
+  };
+
   for (uint32_t i = 0u; i < p_NodeRefs.size(); ++i)
   {
     Components::NodeRef nodeRef = p_NodeRefs[i];
@@ -395,12 +945,17 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
         RenderPass::Clustering::_globalSpecularFactor = 0.0f;
       }
 
-      gli::texture_cube texCube;
-
+      // Only specular captures depend on the SHs of all previous probes -
+      // irradiance only probes keep accumulating to full batches
+      if (probeIdx == kSpec && specProbeRef.isValid())
       {
-        gli::texture_cube packedTexCube =
-            gli::texture_cube(gli::FORMAT_RGBA16_SFLOAT_PACK16, cubeMapRes, 1u);
+        projectPendingIrradianceProbes();
+      }
+
+      gli::texture_cube packedTexCube =
+          gli::texture_cube(gli::FORMAT_RGBA16_SFLOAT_PACK16, cubeMapRes, 1u);
 
+      {
         for (uint32_t atlasIdx = 0u; atlasIdx < 6; ++atlasIdx)
         {
           Components::NodeManager::_orientation(camNodeRef) =
@@ -454,15 +1009,18 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
           memcpy(packedTexCube.data(0u, atlasIndexToFaceIdx[atlasIdx], 0u),
                  sceneMemory, faceSizeInBytes);
         }
-
-        texCube = gli::convert(packedTexCube, gli::FORMAT_RGBA32_SFLOAT_PACK32);
       }
 
       if (irradProbeRef.isValid() && probeIdx == kIrrad)
       {
-        // Generate and store SH irrad.
-        Components::IrradianceProbeManager::_descSHs(irradProbeRef)
-            .push_back(Rendering::IBL::project(texCube));
+        // Generate and store SH irrad. (the half texels are read directly)
+        pendingIrradCubeMaps.push_back(packedTexCube);
+        pendingIrradProbeRefs.push_back(irradProbeRef);
+
+        if (pendingIrradProbeRefs.size() >= SH_PROJECTION_BATCH_SIZE)
+        {
+          projectPendingIrradianceProbes();
+        }
       }
 
       if (specProbeRef.isValid() && probeIdx == kSpec)
@@ -475,6 +1033,8 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
         const _INTR_STRING filePath = "media/specular_probes/" + fileName;
         const _INTR_STRING tempFilePath = "media/specular_probes/_" + fileName;
 
+        gli::texture_cube texCube =
+            gli::convert(packedTexCube, gli::FORMAT_RGBA32_SFLOAT_PACK32);
         gli::save_dds(texCube, tempFilePath.c_str());
 
         // Generate blurred mip maps
@@ -531,6 +1091,8 @@ void captureProbes(const Dod::RefArray& p_NodeRefs, bool p_Clear,
     }
   }
 
+  projectPendingIrradianceProbes();
+
   // Cleanup and restore
   BufferManager::destroyResources({readBackBufferRef});
   BufferManager::destroyBuffer(readBackBufferRef);
@@ -24,10 +24,6 @@ namespace Rendering
 {
 namespace IBL
 {
-void initCubemapProcessing();
-
-// <-
-
 // Struct defining a third order SH
 struct SH9
 {
@@ -239,6 +235,8 @@ _INTR_INLINE float D_GGX(float p_NdH, float p_Roughness2)
   return roughness4 / (glm::pi<float>() * denom * denom);
 }
 
+// Pre filters the input cube map (and its mip chain) for increasing roughness
+// values and writes the result to the mip levels of the RGBA32F output
 void preFilterGGX(const gli::texture_cube& p_Input, gli::texture_cube& p_Output,
                   const uint32_t* p_SampleCounts, float p_MinRoughness = 0.05f);
 
@@ -270,39 +268,13 @@ _INTR_INLINE SH9 project(const glm::vec3& p_Direction, const glm::vec3& p_Color)
 
 // <-
 
-_INTR_INLINE SH9 project(const gli::texture_cube& p_CubeMap)
-{
-  gli::texture_cube decCube =
-      gli::convert(p_CubeMap, gli::FORMAT_RGB32_SFLOAT_PACK32);
+// Projects the cube map to SH9 using precomputed per resolution weights
+SH9 project(const gli::texture_cube& p_CubeMap);
 
-  SH9 result;
-  float weightSum = 0.0f;
-  for (uint32_t face = 0; face < 6; ++face)
-  {
-    for (int32_t y = 0; y < decCube.extent().y; ++y)
-    {
-      for (int32_t x = 0; x < decCube.extent().x; ++x)
-      {
-        const glm::vec3 sample =
-            decCube.load<glm::vec3>(gli::uvec2(x, y), face, 0);
-        glm::vec2 uv0 =
-            (glm::vec2(x, y) + 0.5f) / glm::vec2(decCube.extent()) * 2.0f -
-            1.0f;
-
-        const float temp = 1.0f + uv0.x * uv0.x + uv0.y * uv0.y;
-        const float weight = 4.0f / (std::sqrt(temp) * temp);
-
-        const glm::vec3 dir =
-            mapXYSToDirection(glm::uvec3(x, y, face), decCube.extent());
-        result += project(dir, sample) * weight;
-        weightSum += weight;
-      }
-    }
-  }
-
-  result *= (4.0f * glm::pi<float>()) / weightSum;
-  return result;
-}
+// Projects multiple cube maps in parallel, RGBA32F and RGBA16F cube maps are
+// read directly while other formats get converted first
+void project(const gli::texture_cube* p_CubeMaps, uint32_t p_Count,
+             SH9* p_SHs);
 
 // <-
 
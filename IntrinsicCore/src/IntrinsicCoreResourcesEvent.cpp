@@ -0,0 +1,214 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Resources
+{
+namespace
+{
+// Open addressing table mapping the name hashes to event type indices
+std::atomic<uint32_t> _eventTypeHashes[_INTR_MAX_EVENT_TYPE_COUNT];
+EventListenerRefArray _eventListenersPerType[_INTR_MAX_EVENT_TYPE_COUNT];
+
+// One bit per event type which is set while an event of the type is queued
+// and not yet dispatched
+std::atomic<uint32_t> _queuedEventTypeBits[_INTR_MAX_EVENT_TYPE_COUNT / 32u];
+
+// Ring buffer storing the queued events in order
+uint16_t _eventTypeRing[_INTR_MAX_EVENT_COUNT];
+std::atomic<bool> _eventReadyRing[_INTR_MAX_EVENT_COUNT];
+std::atomic<uint32_t> _eventHead;
+std::atomic<uint32_t> _eventTail;
+
+_INTR_INLINE uint32_t getEventTypeIdx(const Name& p_EventName)
+{
+  const uint32_t hash = p_EventName._hash;
+  _INTR_ASSERT(hash != 0u && "Invalid event name");
+
+  uint32_t typeIdx = hash % _INTR_MAX_EVENT_TYPE_COUNT;
+  for (uint32_t i = 0u; i < _INTR_MAX_EVENT_TYPE_COUNT; ++i)
+  {
+    uint32_t typeHash =
+        _eventTypeHashes[typeIdx].load(std::memory_order_acquire);
+
+    if (typeHash == 0u)
+    {
+      // Claim the free slot - a failed exchange returns the hash of the
+      // thread which was faster
+      if (_eventTypeHashes[typeIdx].compare_exchange_strong(
+              typeHash, hash, std::memory_order_acq_rel))
+      {
+        return typeIdx;
+      }
+    }
+
+    if (typeHash == hash)
+    {
+      return typeIdx;
+    }
+
+    typeIdx = (typeIdx + 1u) % _INTR_MAX_EVENT_TYPE_COUNT;
+  }
+
+  _INTR_ASSERT(false && "Max. event type count exceeded");
+  return 0u;
+}
+}
+
+// Static members
+QueuedEventData EventManager::_queuedEventDataRing[_INTR_MAX_EVENT_COUNT];
+
+// <-
+
+void EventManager::init()
+{
+  _INTR_LOG_INFO("Inititializing Event Manager...");
+
+  _eventHead.store(0u);
+  _eventTail.store(0u);
+
+  for (uint32_t i = 0u; i < _INTR_MAX_EVENT_COUNT; ++i)
+  {
+    _eventReadyRing[i].store(false);
+  }
+
+  for (uint32_t i = 0u; i < _INTR_MAX_EVENT_TYPE_COUNT / 32u; ++i)
+  {
+    _queuedEventTypeBits[i].store(0u);
+  }
+}
+
+// <-
+
+EventRef EventManager::_queueEvent(const Name& p_EventName,
+                                   const QueuedEventData* p_EventData,
+                                   bool p_SkipIfExisting)
+{
+  const uint32_t typeIdx = getEventTypeIdx(p_EventName);
+  const uint32_t typeBit = 1u << (typeIdx % 32u);
+
+  const uint32_t previousTypeBits =
+      _queuedEventTypeBits[typeIdx / 32u].fetch_or(typeBit,
+                                                   std::memory_order_acq_rel);
+  if (p_SkipIfExisting && (previousTypeBits & typeBit) != 0u)
+  {
+    return EventRef();
+  }
+
+  const uint32_t eventIdx =
+      _eventHead.fetch_add(1u, std::memory_order_acq_rel);
+  _INTR_ASSERT(eventIdx - _eventTail.load(std::memory_order_acquire) <
+                   _INTR_MAX_EVENT_COUNT &&
+               "Max. queued event count exceeded");
+
+  // Publish the event after all of its data has been written
+  const uint32_t slotIdx = eventIdx % _INTR_MAX_EVENT_COUNT;
+  _eventTypeRing[slotIdx] = (uint16_t)typeIdx;
+  if (p_EventData != nullptr)
+  {
+    _queuedEventDataRing[slotIdx] = *p_EventData;
+  }
+  _eventReadyRing[slotIdx].store(true, std::memory_order_release);
+
+  return EventRef(slotIdx, 0u);
+}
+
+// <-
+
+void EventManager::fireEvents()
+{
+  _INTR_PROFILE_CPU("General", "Fire Events");
+
+  // Events queued by the callbacks are fired in the same call
+  uint32_t eventHead = _eventHead.load(std::memory_order_acquire);
+  while (_eventTail.load(std::memory_order_relaxed) != eventHead)
+  {
+    for (uint32_t eventIdx = _eventTail.load(std::memory_order_relaxed);
+         eventIdx != eventHead; ++eventIdx)
+    {
+      const uint32_t slotIdx = eventIdx % _INTR_MAX_EVENT_COUNT;
+
+      // Wait for events which are still being written by another thread
+      while (!_eventReadyRing[slotIdx].load(std::memory_order_acquire))
+      {
+        std::this_thread::yield();
+      }
+
+      // Clear the queued bit before dispatching, so events of this type
+      // queued from now on are never dropped - at worst an event which is
+      // queued while another one of the same type is pending is duplicated
+      const uint32_t typeIdx = _eventTypeRing[slotIdx];
+      _queuedEventTypeBits[typeIdx / 32u].fetch_and(~(1u << (typeIdx % 32u)),
+                                                    std::memory_order_acq_rel);
+
+      const EventRef eventRef = EventRef(slotIdx, 0u);
+      const EventListenerRefArray& eventListeners =
+          _eventListenersPerType[typeIdx];
+
+      for (uint32_t eventListIdx = 0u; eventListIdx < eventListeners.size();
+           ++eventListIdx)
+      {
+        EventListenerManager::_descEventCallbackFunction(
+            eventListeners[eventListIdx])(eventRef);
+      }
+
+      _eventReadyRing[slotIdx].store(false, std::memory_order_relaxed);
+    }
+
+    _eventTail.store(eventHead, std::memory_order_release);
+    eventHead = _eventHead.load(std::memory_order_acquire);
+  }
+
+  // Events queued concurrently after this point are fired next frame
+}
+
+// <-
+
+EventListenerRef
+EventManager::connect(const Name& p_EventName,
+                      EventCallbackFunction p_CallbackFunction)
+{
+  EventListenerRef eventListener =
+      EventListenerManager::createEventListener(p_EventName);
+  EventListenerManager::_descEventCallbackFunction(eventListener) =
+      p_CallbackFunction;
+
+  _eventListenersPerType[getEventTypeIdx(p_EventName)].push_back(
+      eventListener);
+
+  return eventListener;
+}
+
+// <-
+
+void EventManager::disconnect(EventListenerRef p_EventListener)
+{
+  EventListenerRefArray& eventListeners = _eventListenersPerType
+      [getEventTypeIdx(EventListenerManager::_name(p_EventListener))];
+
+  eventListeners.erase(std::remove(eventListeners.begin(),
+                                   eventListeners.end(), p_EventListener),
+                       eventListeners.end());
+
+  EventListenerManager::destroyEventListener(p_EventListener);
+}
+}
+}
+}
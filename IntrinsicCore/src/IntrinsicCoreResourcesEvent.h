@@ -48,58 +48,33 @@ struct QueuedEventData
   };
 };
 
-struct EventData : Dod::Resources::ResourceDataBase
-{
-  EventData() : Dod::Resources::ResourceDataBase(_INTR_MAX_EVENT_COUNT)
-  {
-    queuedEventData.resize(_INTR_MAX_EVENT_COUNT);
-  }
-
-  // Resources
-  _INTR_ARRAY(QueuedEventData) queuedEventData;
-};
-
+// Queued events are stored in a ring buffer and only identified by their
+// name - queuing events is lock free and can happen on any thread
 struct EventManager
-    : Dod::Resources::ResourceManagerBase<EventData, _INTR_MAX_EVENT_COUNT>
 {
-  static void init()
-  {
-    _INTR_LOG_INFO("Inititializing Event Manager...");
-
-    Dod::Resources::ResourceManagerBase<
-        EventData, _INTR_MAX_EVENT_COUNT>::_initResourceManager();
-  }
+  static void init();
 
   // <-
 
+  // Skips the event if an event with the same name has already been queued
+  // and not fired yet
   _INTR_INLINE static EventRef queueEventIfNotExisting(const Name& p_EventName)
   {
-    for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
-    {
-      if (_name(_activeRefs[i]) == p_EventName)
-      {
-        return Dod::Ref();
-      }
-    }
-
-    return queueEvent(p_EventName);
+    return _queueEvent(p_EventName, nullptr, true);
   }
 
   _INTR_INLINE static EventRef
   queueEventIfNotExisting(const Name& p_EventName,
                           const QueuedEventData& p_EventData)
   {
-    EventRef eventRef = queueEventIfNotExisting(p_EventName);
-    _queuedEventData(eventRef) = p_EventData;
-    return eventRef;
+    return _queueEvent(p_EventName, &p_EventData, true);
   }
 
   // <-
 
   _INTR_INLINE static EventRef queueEvent(const Name& p_EventName)
   {
-    return Dod::Resources::ResourceManagerBase<
-        EventData, _INTR_MAX_EVENT_COUNT>::_createResource(p_EventName);
+    return _queueEvent(p_EventName, nullptr, false);
   }
 
   // <-
@@ -107,69 +82,37 @@ struct EventManager
   _INTR_INLINE static EventRef queueEvent(const Name& p_EventName,
                                           const QueuedEventData& p_EventData)
   {
-    EventRef eventRef = queueEvent(p_EventName);
-    _queuedEventData(eventRef) = p_EventData;
-    return eventRef;
+    return _queueEvent(p_EventName, &p_EventData, false);
   }
 
   // <-
 
-  _INTR_INLINE static void fireEvents()
-  {
-    // Fire events in order (oldest event gets fired first)
-    for (int32_t eventIdx = 0u; eventIdx < (int32_t)_activeRefs.size();
-         ++eventIdx)
-    {
-      EventRef eventRef = _activeRefs[eventIdx];
-
-      EventListenerRefArray& eventListeners =
-          EventListenerManager::_eventListenerMapping[_name(eventRef)];
-
-      for (uint32_t eventListIdx = 0u; eventListIdx < eventListeners.size();
-           ++eventListIdx)
-      {
-        EventListenerRef eventListenerRef = eventListeners[eventListIdx];
-
-        if (EventListenerManager::_name(eventListenerRef) == _name(eventRef))
-        {
-          EventListenerManager::_descEventCallbackFunction(eventListenerRef)(
-              eventRef);
-        }
-      }
-    }
-
-    for (int32_t eventIdx = (uint32_t)_activeRefs.size() - 1u; eventIdx >= 0;
-         --eventIdx)
-    {
-      Dod::Resources::ResourceManagerBase<EventData, _INTR_MAX_EVENT_COUNT>::
-          _destroyResource(_activeRefs[eventIdx]);
-    }
-  }
+  // Fires all queued events in order (oldest event gets fired first); has to
+  // be called on the main thread
+  static void fireEvents();
 
   // <-
 
-  _INTR_INLINE static EventListenerRef
-  connect(const Name& p_EventName, EventCallbackFunction p_CallbackFunction)
-  {
-    EventListenerRef eventListener =
-        EventListenerManager::createEventListener(p_EventName);
-    EventListenerManager::_descEventCallbackFunction(eventListener) =
-        p_CallbackFunction;
-    return eventListener;
-  }
+  // Listeners can only be connected/disconnected on the main thread
+  static EventListenerRef connect(const Name& p_EventName,
+                                  EventCallbackFunction p_CallbackFunction);
+  static void disconnect(EventListenerRef p_EventListener);
 
   // <-
 
-  _INTR_INLINE static void disconnect(EventListenerRef p_EventListener)
-  {
-    EventListenerManager::destroyEventListener(p_EventListener);
-  }
+  static EventRef _queueEvent(const Name& p_EventName,
+                              const QueuedEventData* p_EventData,
+                              bool p_SkipIfExisting);
 
   // Resources
   _INTR_INLINE static QueuedEventData& _queuedEventData(EventRef p_EventRef)
   {
-    return _data.queuedEventData[p_EventRef._id];
+    return _queuedEventDataRing[p_EventRef._id];
   }
+
+  // ->
+
+  static QueuedEventData _queuedEventDataRing[_INTR_MAX_EVENT_COUNT];
 };
 }
 }
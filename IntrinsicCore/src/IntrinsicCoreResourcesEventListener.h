@@ -56,12 +56,9 @@ struct EventListenerManager
 
   _INTR_INLINE static EventListenerRef createEventListener(const Name& p_Name)
   {
-    EventListenerRef ref = Dod::Resources::ResourceManagerBase<
+    return Dod::Resources::ResourceManagerBase<
         EventListenerData,
         _INTR_MAX_EVENT_LISTENER_COUNT>::_createResource(p_Name);
-
-    _eventListenerMapping[p_Name].push_back(ref);
-    return ref;
   }
 
   // <-
@@ -72,19 +69,6 @@ struct EventListenerManager
 
   _INTR_INLINE static void destroyEventListener(EventListenerRef p_Ref)
   {
-    EventListenerRefArray& eventListeners = _eventListenerMapping[_name(p_Ref)];
-
-    for (auto it = eventListeners.begin(); it != eventListeners.end();)
-    {
-      if (*it == p_Ref)
-      {
-        it = eventListeners.erase(it);
-      }
-      {
-        ++it;
-      }
-    }
-
     Dod::Resources::ResourceManagerBase<
         EventListenerData,
         _INTR_MAX_EVENT_LISTENER_COUNT>::_destroyResource(p_Ref);
@@ -96,10 +80,6 @@ struct EventListenerManager
   {
     return _data.descEventCallbackFunction[p_Ref._id];
   }
-
-  // ->
-
-  static _INTR_HASH_MAP(Name, EventListenerRefArray) _eventListenerMapping;
 };
 }
 }
@@ -15,7 +15,8 @@
 // Precompiled header file
 #include "stdafx.h"
 
-//#define USE_NAIVE_CULLING
+// The maximum amount of BVH nodes on the traversal stack
+#define _INTR_BVH_MAX_TRAVERSAL_DEPTH 64u
 
 namespace Intrinsic
 {
@@ -23,6 +24,106 @@ namespace Core
 {
 namespace Resources
 {
+namespace
+{
+// Tests the AABB against all planes in the plane mask. Removes the planes the
+// AABB is fully inside of from the mask and returns false if the AABB is
+// fully outside of any of the planes
+_INTR_INLINE bool testAABB(const Math::FrustumPlanes& p_Planes,
+                           const Math::AABB& p_AABB, uint32_t& p_PlaneMask)
+{
+  const glm::vec3 center = Math::calcAABBCenter(p_AABB);
+  const glm::vec3 halfExtent = Math::calcAABBHalfExtent(p_AABB);
+
+  for (uint32_t i = 0u; i < Math::FrustumPlane::kCount; ++i)
+  {
+    const uint32_t planeBit = 1u << i;
+    if ((p_PlaneMask & planeBit) == 0u)
+    {
+      continue;
+    }
+
+    const float dist = glm::dot(p_Planes.n[i], center) + p_Planes.d[i];
+    const float radius = glm::dot(glm::abs(p_Planes.n[i]), halfExtent);
+
+    if (dist < -radius)
+    {
+      return false;
+    }
+    if (dist >= radius)
+    {
+      p_PlaneMask &= ~planeBit;
+    }
+  }
+
+  return true;
+}
+
+// <-
+
+void cullSubtree(uint32_t p_RootNodeIdx, const Math::FrustumPlanes& p_Planes,
+                 uint32_t p_FrustumMask)
+{
+  struct StackEntry
+  {
+    uint32_t nodeIdx;
+    uint32_t planeMask;
+  };
+
+  const Culling::SphereStreams spheres = Culling::Bvh::getSphereStreams();
+
+  StackEntry stack[_INTR_BVH_MAX_TRAVERSAL_DEPTH];
+  uint32_t stackSize = 0u;
+
+  stack[stackSize++] = {p_RootNodeIdx, (1u << Math::FrustumPlane::kCount) - 1u};
+
+  while (stackSize > 0u)
+  {
+    const StackEntry entry = stack[--stackSize];
+    const Culling::BvhNode& node = Culling::Bvh::_nodes[entry.nodeIdx];
+
+    uint32_t planeMask = entry.planeMask;
+    if (!testAABB(p_Planes, node.aabb, planeMask))
+    {
+      continue;
+    }
+
+    // Fully inside? Accept the whole subtree
+    if (planeMask == 0u)
+    {
+      for (uint32_t i = node.firstItem; i < node.firstItem + node.itemCount;
+           ++i)
+      {
+        Components::NodeManager::_visibilityMask(Culling::Bvh::_items[i]) |=
+            p_FrustumMask;
+      }
+      continue;
+    }
+
+    // Test the spheres of intersecting leaf nodes all at once
+    if (node.firstChild == Dod::kInvalidId)
+    {
+      uint32_t visibleBits = Culling::cullSpheres(spheres, node.firstItem,
+                                                  node.itemCount, p_Planes);
+      while (visibleBits != 0u)
+      {
+        const uint32_t i = Math::calcLowestSetBit(visibleBits);
+        visibleBits &= visibleBits - 1u;
+
+        Components::NodeManager::_visibilityMask(
+            Culling::Bvh::_items[node.firstItem + i]) |= p_FrustumMask;
+      }
+      continue;
+    }
+
+    _INTR_ASSERT(stackSize + 2u <= _INTR_BVH_MAX_TRAVERSAL_DEPTH);
+    stack[stackSize++] = {node.firstChild, planeMask};
+    stack[stackSize++] = {node.firstChild + 1u, planeMask};
+  }
+}
+
+// <-
+
 struct CullingParallelTaskSet : enki::ITaskSet
 {
   virtual ~CullingParallelTaskSet() {}
@@ -32,6 +133,20 @@ struct CullingParallelTaskSet : enki::ITaskSet
   {
     _INTR_PROFILE_CPU("Culling", "Culling Job");
 
+    for (uint32_t rootIdx = p_Range.start; rootIdx < p_Range.end; ++rootIdx)
+    {
+      const Culling::BvhNode& rootNode =
+          Culling::Bvh::_nodes[Culling::Bvh::_taskRoots[rootIdx]];
+
+      // Reset the visibility of all nodes in the subtree
+      for (uint32_t i = rootNode.firstItem;
+           i < rootNode.firstItem + rootNode.itemCount; ++i)
+      {
+        Components::NodeManager::_visibilityMask(Culling::Bvh::_items[i]) =
+            0u;
+      }
+    }
+
     for (uint32_t frustIdx = 0u; frustIdx < _frustums.size(); ++frustIdx)
     {
       Resources::FrustumRef frustumRef = _frustums[frustIdx];
@@ -40,104 +155,17 @@ struct CullingParallelTaskSet : enki::ITaskSet
       const Math::FrustumPlanes& frustumPlanes =
           Resources::FrustumManager::_frustumPlanesViewSpace(frustumRef);
 
-#if !defined(USE_NAIVE_CULLING)
-      const __m128 simdFrustumPlanes[] = {
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kNear].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kFar].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kLeft].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kRight].x),
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kNear].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kFar].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kLeft].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kRight].y),
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kNear].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kFar].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kLeft].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kRight].z),
-          Simd::simdSet(-frustumPlanes.d[Math::FrustumPlane::kNear],
-                        -frustumPlanes.d[Math::FrustumPlane::kFar],
-                        -frustumPlanes.d[Math::FrustumPlane::kLeft],
-                        -frustumPlanes.d[Math::FrustumPlane::kRight]),
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kTop].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kTop].x,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].x),
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kTop].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kTop].y,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].y),
-          Simd::simdSet(-frustumPlanes.n[Math::FrustumPlane::kTop].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kTop].z,
-                        -frustumPlanes.n[Math::FrustumPlane::kBottom].z),
-          Simd::simdSet(-frustumPlanes.d[Math::FrustumPlane::kTop],
-                        -frustumPlanes.d[Math::FrustumPlane::kBottom],
-                        -frustumPlanes.d[Math::FrustumPlane::kTop],
-                        -frustumPlanes.d[Math::FrustumPlane::kBottom])};
-#endif // USE_NAIVE_CULLING
-
-      for (uint32_t nodeIdx = p_Range.start; nodeIdx < p_Range.end; ++nodeIdx)
+      for (uint32_t rootIdx = p_Range.start; rootIdx < p_Range.end; ++rootIdx)
       {
-        Components::NodeRef nodeRef =
-            Components::NodeManager::getActiveResourceAtIndex(nodeIdx);
-        const Math::Sphere& cullingSphere =
-            Components::NodeManager::_worldBoundingSphere(nodeRef);
-        uint32_t& visibilityMask =
-            Components::NodeManager::_visibilityMask(nodeRef);
-
-#if !defined(USE_NAIVE_CULLING)
-        const __m128 s = Simd::simdSet(cullingSphere.p.x, cullingSphere.p.y,
-                                       cullingSphere.p.z, cullingSphere.r);
-        const __m128 xxxx = Simd::simdSplatX(s);
-        const __m128 yyyy = Simd::simdSplatY(s);
-        const __m128 zzzz = Simd::simdSplatZ(s);
-        const __m128 rrrr = Simd::simdSplatW(s);
-
-        __m128 v, r;
-        v = Simd::simdMadd(xxxx, simdFrustumPlanes[0], simdFrustumPlanes[3]);
-        v = Simd::simdMadd(yyyy, simdFrustumPlanes[1], v);
-        v = Simd::simdMadd(zzzz, simdFrustumPlanes[2], v);
-
-        r = _mm_cmpgt_ps(v, rrrr);
-
-        v = Simd::simdMadd(xxxx, simdFrustumPlanes[4], simdFrustumPlanes[7]);
-        v = Simd::simdMadd(yyyy, simdFrustumPlanes[5], v);
-        v = Simd::simdMadd(zzzz, simdFrustumPlanes[6], v);
-
-        r = _mm_or_ps(r, _mm_cmpgt_ps(v, rrrr));
-        r = _mm_or_ps(r, _mm_movehl_ps(r, r));
-        r = _mm_or_ps(r, Simd::simdSplatY(r));
-
-        uint32_t result;
-        _mm_store_ss((float*)&result, r);
-#else
-        uint32_t result = (uint32_t)-1;
-        for (int i = 0; i < Math::FrustumPlane::kCount; ++i)
-        {
-          if (glm::dot(frustumPlanes.n[i], cullingSphere.p) +
-                  frustumPlanes.d[i] <
-              -cullingSphere.r)
-          {
-            result = 0x0;
-            break;
-          }
-        }
-#endif // USE_NAIVE_CULLING
-
-        if ((result & 1u) > 0u)
-        {
-          visibilityMask &= ~frustumMask;
-        }
-        else
-        {
-          visibilityMask |= frustumMask;
-        }
+        cullSubtree(Culling::Bvh::_taskRoots[rootIdx], frustumPlanes,
+                    frustumMask);
       }
     }
   }
 
   FrustumRefArray _frustums;
 } _cullingParallelTaskSet;
+}
 
 void FrustumManager::init()
 {
@@ -153,9 +181,14 @@ void FrustumManager::cullNodes(const FrustumRefArray& p_ActiveFrustums)
 {
   _INTR_PROFILE_CPU("Culling", "Culling");
 
+  Culling::Bvh::update();
+  if (Culling::Bvh::_taskRoots.empty())
+  {
+    return;
+  }
+
   _cullingParallelTaskSet._frustums = p_ActiveFrustums;
-  _cullingParallelTaskSet.m_SetSize =
-      Components::NodeManager::getActiveResourceCount();
+  _cullingParallelTaskSet.m_SetSize = (uint32_t)Culling::Bvh::_taskRoots.size();
 
   Application::_scheduler.AddTaskSetToPipe(&_cullingParallelTaskSet);
   Application::_scheduler.WaitforTaskSet(&_cullingParallelTaskSet);
@@ -60,6 +60,304 @@ _INTR_INLINE void createOrLoadPhysicsMeshes(MeshRef p_MeshRef)
         Physics::System::_pxPhysics->createConvexMesh(fileInput);
   }
 }
+
+// <-
+
+_INTR_INLINE void initSubMeshInfoFromDescription(MeshRef p_MeshRef)
+{
+  const PositionsPerSubMeshArray& positions =
+      MeshManager::_descPositionsPerSubMesh(p_MeshRef);
+  const IndicesPerSubMeshArray& indices =
+      MeshManager::_descIndicesPerSubMesh(p_MeshRef);
+
+  const uint32_t subMeshCount = (uint32_t)positions.size();
+  MeshManager::_aabbPerSubMesh(p_MeshRef).resize(subMeshCount);
+  MeshManager::_vertexCountPerSubMesh(p_MeshRef).resize(subMeshCount);
+  MeshManager::_indexCountPerSubMesh(p_MeshRef).resize(subMeshCount);
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    Math::AABB& aabb = MeshManager::_aabbPerSubMesh(p_MeshRef)[subMeshIdx];
+    Math::initAABB(aabb);
+
+    for (uint32_t posIdx = 0u; posIdx < positions[subMeshIdx].size(); ++posIdx)
+    {
+      Math::mergePointToAABB(aabb, positions[subMeshIdx][posIdx]);
+    }
+
+    MeshManager::_vertexCountPerSubMesh(p_MeshRef)[subMeshIdx] =
+        (uint32_t)positions[subMeshIdx].size();
+    MeshManager::_indexCountPerSubMesh(p_MeshRef)[subMeshIdx] =
+        (uint32_t)indices[subMeshIdx].size();
+  }
+}
+
+// <-
+
+_INTR_INLINE Name getStreamBufferName(MeshStream::Enum p_Stream)
+{
+  switch (p_Stream)
+  {
+  case MeshStream::kPosition:
+    return _N(MeshPositionVb);
+  case MeshStream::kUV0:
+    return _N(MeshUv0Vb);
+  case MeshStream::kNormal:
+    return _N(MeshNormalVb);
+  case MeshStream::kTangent:
+    return _N(MeshTangentVb);
+  case MeshStream::kBinormal:
+    return _N(MeshBinormalVb);
+  case MeshStream::kVertexColor:
+    return _N(MeshVtxColorVb);
+  case MeshStream::kIndex:
+    return _N(MeshIb);
+  }
+
+  return Name();
+}
+
+// <-
+
+_INTR_INLINE R::BufferType::Enum getStreamBufferType(MeshStream::Enum p_Stream,
+                                                     uint32_t p_IndexCount)
+{
+  if (p_Stream == MeshStream::kIndex)
+  {
+    return p_IndexCount <= 0xFFFF ? R::BufferType::kIndex16
+                                  : R::BufferType::kIndex32;
+  }
+
+  return R::BufferType::kVertex;
+}
+
+// <-
+
+_INTR_INLINE uint64_t calcStreamSizeInBytes(uint32_t p_VertexCount,
+                                            uint32_t p_IndexCount,
+                                            MeshStream::Enum p_Stream)
+{
+  switch (p_Stream)
+  {
+  case MeshStream::kPosition:
+  case MeshStream::kNormal:
+  case MeshStream::kTangent:
+  case MeshStream::kBinormal:
+    return (uint64_t)p_VertexCount * sizeof(uint16_t) * 4u;
+  case MeshStream::kUV0:
+    return (uint64_t)p_VertexCount * sizeof(uint16_t) * 2u;
+  case MeshStream::kVertexColor:
+    return (uint64_t)p_VertexCount * sizeof(uint32_t);
+  case MeshStream::kIndex:
+    return (uint64_t)p_IndexCount * (p_IndexCount <= 0xFFFF ? sizeof(uint16_t)
+                                                            : sizeof(uint32_t));
+  }
+
+  return 0u;
+}
+
+// <-
+
+_INTR_INLINE uint32_t calcStreamSizeInBytes(MeshRef p_MeshRef,
+                                            uint32_t p_SubMeshIdx,
+                                            MeshStream::Enum p_Stream)
+{
+  const uint32_t vertexCount =
+      (uint32_t)MeshManager::_descPositionsPerSubMesh(p_MeshRef)[p_SubMeshIdx]
+          .size();
+  const uint32_t indexCount =
+      (uint32_t)MeshManager::_descIndicesPerSubMesh(p_MeshRef)[p_SubMeshIdx]
+          .size();
+
+  return (uint32_t)calcStreamSizeInBytes(vertexCount, indexCount, p_Stream);
+}
+
+// <-
+
+_INTR_INLINE void convertToHalf3(const _INTR_ARRAY(glm::vec3) & p_Source,
+                                 uint16_t* p_Target)
+{
+  for (uint32_t i = 0u; i < p_Source.size(); ++i)
+  {
+    uint32_t packed0 =
+        glm::packHalf2x16(glm::vec2(p_Source[i].x, p_Source[i].y));
+    uint32_t packed1 = glm::packHalf2x16(glm::vec2(p_Source[i].z, 0.0f));
+
+    p_Target[i * 3u] = packed0;
+    p_Target[i * 3u + 1u] = packed0 >> 16u;
+    p_Target[i * 3u + 2u] = packed1;
+  }
+}
+
+// <-
+
+// Converts the given stream to the layout used for the vertex/index buffers
+_INTR_INLINE void convertStream(MeshRef p_MeshRef, uint32_t p_SubMeshIdx,
+                                MeshStream::Enum p_Stream, void* p_Target)
+{
+  switch (p_Stream)
+  {
+  case MeshStream::kPosition:
+    convertToHalf3(
+        MeshManager::_descPositionsPerSubMesh(p_MeshRef)[p_SubMeshIdx],
+        (uint16_t*)p_Target);
+    break;
+  case MeshStream::kNormal:
+    convertToHalf3(MeshManager::_descNormalsPerSubMesh(p_MeshRef)[p_SubMeshIdx],
+                   (uint16_t*)p_Target);
+    break;
+  case MeshStream::kTangent:
+    convertToHalf3(
+        MeshManager::_descTangentsPerSubMesh(p_MeshRef)[p_SubMeshIdx],
+        (uint16_t*)p_Target);
+    break;
+  case MeshStream::kBinormal:
+    convertToHalf3(
+        MeshManager::_descBinormalsPerSubMesh(p_MeshRef)[p_SubMeshIdx],
+        (uint16_t*)p_Target);
+    break;
+  case MeshStream::kUV0:
+  {
+    const _INTR_ARRAY(glm::vec2)& uv0s =
+        MeshManager::_descUV0sPerSubMesh(p_MeshRef)[p_SubMeshIdx];
+    uint16_t* target = (uint16_t*)p_Target;
+
+    for (uint32_t i = 0u; i < uv0s.size(); ++i)
+    {
+      uint32_t packedUv = glm::packHalf2x16(uv0s[i]);
+
+      target[i * 2u] = packedUv;
+      target[i * 2u + 1u] = packedUv >> 16u;
+    }
+  }
+  break;
+  case MeshStream::kVertexColor:
+  {
+    const _INTR_ARRAY(glm::vec4)& vtxColors =
+        MeshManager::_descVertexColorsPerSubMesh(p_MeshRef)[p_SubMeshIdx];
+    uint32_t* target = (uint32_t*)p_Target;
+
+    for (uint32_t i = 0u; i < vtxColors.size(); ++i)
+    {
+      target[i] = Math::convertColorToBGRA(vtxColors[i]);
+    }
+  }
+  break;
+  case MeshStream::kIndex:
+  {
+    const _INTR_ARRAY(uint32_t)& indices =
+        MeshManager::_descIndicesPerSubMesh(p_MeshRef)[p_SubMeshIdx];
+
+    if (indices.size() <= 0xFFFF)
+    {
+      uint16_t* target = (uint16_t*)p_Target;
+      for (uint32_t i = 0u; i < indices.size(); ++i)
+      {
+        target[i] = (uint16_t)indices[i];
+      }
+    }
+    else
+    {
+      memcpy(p_Target, indices.data(), indices.size() * sizeof(uint32_t));
+    }
+  }
+  break;
+  }
+}
+
+// <-
+
+_INTR_INLINE const MeshFileSubMeshHeader&
+getSubMeshHeader(const uint8_t* p_BinaryData, uint32_t p_SubMeshIdx)
+{
+  return ((const MeshFileSubMeshHeader*)(p_BinaryData +
+                                         sizeof(MeshFileHeader)))[p_SubMeshIdx];
+}
+
+// <-
+
+// Hashes the raw contents of the JSON description of a mesh - used to detect
+// binary files which are out of sync with their description
+_INTR_INLINE bool hashDescriptionFile(const char* p_FilePath, uint64_t& p_Hash)
+{
+  Util::MappedFile descFile;
+  if (!Util::mapFile(p_FilePath, descFile))
+  {
+    return false;
+  }
+
+  p_Hash = Math::hash64((const char*)descFile.data,
+                        (std::size_t)descFile.sizeInBytes);
+  Util::unmapFile(descFile);
+
+  return true;
+}
+
+// <-
+
+_INTR_INLINE bool isInFile(uint64_t p_Offset, uint64_t p_SizeInBytes,
+                           uint64_t p_FileSizeInBytes)
+{
+  return p_Offset <= p_FileSizeInBytes &&
+         p_SizeInBytes <= p_FileSizeInBytes - p_Offset;
+}
+
+// <-
+
+// Validates the layout of a mapped binary mesh file - all offsets and sizes
+// have to stay within the mapped range and the streams have to match the
+// vertex and index counts of the sub meshes
+_INTR_INLINE bool isValidBinaryFile(const Util::MappedFile& p_File,
+                                    uint64_t p_DescriptionHash)
+{
+  const uint8_t* binaryData = (const uint8_t*)p_File.data;
+  const uint64_t fileSizeInBytes = p_File.sizeInBytes;
+
+  if (fileSizeInBytes < sizeof(MeshFileHeader))
+  {
+    return false;
+  }
+
+  const MeshFileHeader& header = *(const MeshFileHeader*)binaryData;
+  if (header.magic != _INTR_MESH_FILE_MAGIC ||
+      header.version != _INTR_MESH_FILE_VERSION ||
+      header.sizeInBytes != fileSizeInBytes ||
+      header.descriptionHash != p_DescriptionHash ||
+      !isInFile(sizeof(MeshFileHeader),
+                (uint64_t)header.subMeshCount * sizeof(MeshFileSubMeshHeader),
+                fileSizeInBytes))
+  {
+    return false;
+  }
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < header.subMeshCount;
+       ++subMeshIdx)
+  {
+    const MeshFileSubMeshHeader& subMeshHeader =
+        getSubMeshHeader(binaryData, subMeshIdx);
+
+    if (!isInFile(subMeshHeader.materialNameOffset,
+                  subMeshHeader.materialNameLength, fileSizeInBytes))
+    {
+      return false;
+    }
+
+    for (uint32_t streamIdx = 0u; streamIdx < MeshStream::kCount; ++streamIdx)
+    {
+      if (subMeshHeader.streamSizes[streamIdx] !=
+              calcStreamSizeInBytes(subMeshHeader.vertexCount,
+                                    subMeshHeader.indexCount,
+                                    (MeshStream::Enum)streamIdx) ||
+          !isInFile(subMeshHeader.streamOffsets[streamIdx],
+                    subMeshHeader.streamSizes[streamIdx], fileSizeInBytes))
+      {
+        return false;
+      }
+    }
+  }
+
+  return true;
+}
 }
 
 void MeshManager::init()
@@ -135,273 +433,83 @@ void MeshManager::createResources(const MeshRefArray& p_Meshes)
   for (uint32_t meshIdx = 0u; meshIdx < p_Meshes.size(); ++meshIdx)
   {
     MeshRef meshRef = p_Meshes[meshIdx];
-    const PositionsPerSubMeshArray& positions =
-        _descPositionsPerSubMesh(meshRef);
-    const UVsPerSubMeshArray& uv0s = _descUV0sPerSubMesh(meshRef);
+    const uint8_t* binaryData = (const uint8_t*)_binaryFile(meshRef).data;
     const IndicesPerSubMeshArray& indices = _descIndicesPerSubMesh(meshRef);
-    const NormalsPerSubMeshArray& normals = _descNormalsPerSubMesh(meshRef);
-    const TangentsPerSubMeshArray& tangents = _descTangentsPerSubMesh(meshRef);
-    const BinormalsPerSubMeshArray& binormals =
-        _descBinormalsPerSubMesh(meshRef);
-    const VertexColorsPerSubMeshArray& vtxColors =
-        _descVertexColorsPerSubMesh(meshRef);
     VertexBuffersPerSubMeshArray& vertexBuffers =
         _vertexBuffersPerSubMesh(meshRef);
     IndexBufferPerSubMeshArray& indexBuffers = _indexBufferPerSubMesh(meshRef);
 
-    void* tempIndexBuffer = nullptr;
-    const uint32_t subMeshCount = (uint32_t)positions.size();
+    // Meshes loaded from binary files come with their sub mesh info
+    if (binaryData == nullptr)
+    {
+      initSubMeshInfoFromDescription(meshRef);
+    }
+
+    const uint32_t subMeshCount =
+        (uint32_t)_indexCountPerSubMesh(meshRef).size();
     vertexBuffers.resize(subMeshCount);
     indexBuffers.resize(subMeshCount);
-    _aabbPerSubMesh(meshRef).resize(subMeshCount);
 
     for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
     {
-      // Build AABB
-      {
-        Math::AABB& aabb = _aabbPerSubMesh(meshRef)[subMeshIdx];
-        Math::initAABB(aabb);
-
-        for (uint32_t posIdx = 0u; posIdx < positions[subMeshIdx].size();
-             ++posIdx)
-        {
-          Math::mergePointToAABB(aabb, positions[subMeshIdx][posIdx]);
-        }
-      }
-
-      BufferRef posVertexBuffer =
-          BufferManager::createBuffer(_N(MeshPositionVb));
-      {
-        BufferManager::resetToDefault(posVertexBuffer);
-
-        BufferManager::addResourceFlags(
-            posVertexBuffer, Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(posVertexBuffer) =
-            R::BufferType::kVertex;
-        BufferManager::_descSizeInBytes(posVertexBuffer) =
-            (uint32_t)positions[subMeshIdx].size() * sizeof(uint16_t) * 4u;
-
-        // Convert to half
-        uint16_t* tempBuffer = (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(posVertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
-
-        for (uint32_t i = 0u; i < positions[subMeshIdx].size(); ++i)
-        {
-          uint32_t packedPosition0 = glm::packHalf2x16(glm::vec2(
-              positions[subMeshIdx][i].x, positions[subMeshIdx][i].y));
-          uint32_t packedPosition1 =
-              glm::packHalf2x16(glm::vec2(positions[subMeshIdx][i].z, 0.0f));
-
-          tempBuffer[i * 3u] = packedPosition0;
-          tempBuffer[i * 3u + 1u] = packedPosition0 >> 16u;
-          tempBuffer[i * 3u + 2u] = packedPosition1;
-        }
-        BufferManager::_descInitialData(posVertexBuffer) = tempBuffer;
-
-        buffersToCreate.push_back(posVertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(posVertexBuffer);
-      }
+      const uint32_t indexCount = _indexCountPerSubMesh(meshRef)[subMeshIdx];
 
-      BufferRef uv0VertexBuffer = BufferManager::createBuffer(_N(MeshUv0Vb));
+      for (uint32_t streamIdx = 0u; streamIdx < MeshStream::kCount;
+           ++streamIdx)
       {
-        BufferManager::resetToDefault(uv0VertexBuffer);
+        const MeshStream::Enum stream = (MeshStream::Enum)streamIdx;
 
-        BufferManager::addResourceFlags(
-            uv0VertexBuffer, Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(uv0VertexBuffer) =
-            R::BufferType::kVertex;
-        BufferManager::_descSizeInBytes(uv0VertexBuffer) =
-            (uint32_t)uv0s[subMeshIdx].size() * sizeof(uint16_t) * 2u;
-
-        // Convert to half
-        uint16_t* tempBuffer = (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(uv0VertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
-
-        for (uint32_t i = 0u; i < uv0s[subMeshIdx].size(); ++i)
-        {
-          uint32_t packedUv = glm::packHalf2x16(uv0s[subMeshIdx][i]);
-
-          tempBuffer[i * 2u] = packedUv;
-          tempBuffer[i * 2u + 1u] = packedUv >> 16u;
-        }
-        BufferManager::_descInitialData(uv0VertexBuffer) = tempBuffer;
-
-        buffersToCreate.push_back(uv0VertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(uv0VertexBuffer);
-      }
-
-      BufferRef normalVertexBuffer =
-          BufferManager::createBuffer(_N(MeshNormalVb));
-      {
-        BufferManager::resetToDefault(normalVertexBuffer);
+        BufferRef bufferRef =
+            BufferManager::createBuffer(getStreamBufferName(stream));
+        BufferManager::resetToDefault(bufferRef);
 
         BufferManager::addResourceFlags(
-            normalVertexBuffer,
-            Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(normalVertexBuffer) =
-            R::BufferType::kVertex;
-        BufferManager::_descSizeInBytes(normalVertexBuffer) =
-            (uint32_t)normals[subMeshIdx].size() * sizeof(uint16_t) * 4u;
-
-        // Convert to half
-        uint16_t* tempBuffer = (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(normalVertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
-
-        for (uint32_t i = 0u; i < normals[subMeshIdx].size(); ++i)
-        {
-          uint32_t packedNormal0 = glm::packHalf2x16(
-              glm::vec2(normals[subMeshIdx][i].x, normals[subMeshIdx][i].y));
-          uint32_t packedNormal1 =
-              glm::packHalf2x16(glm::vec2(normals[subMeshIdx][i].z, 0.0f));
-
-          tempBuffer[i * 3u] = packedNormal0;
-          tempBuffer[i * 3u + 1u] = packedNormal0 >> 16u;
-          tempBuffer[i * 3u + 2u] = packedNormal1;
-        }
-        BufferManager::_descInitialData(normalVertexBuffer) = tempBuffer;
-
-        buffersToCreate.push_back(normalVertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(normalVertexBuffer);
-      }
-
-      BufferRef tangentVertexBuffer =
-          BufferManager::createBuffer(_N(MeshTangentVb));
-      {
-        BufferManager::resetToDefault(tangentVertexBuffer);
+            bufferRef, Dod::Resources::ResourceFlags::kResourceVolatile);
+        BufferManager::_descBufferType(bufferRef) =
+            getStreamBufferType(stream, indexCount);
 
-        BufferManager::addResourceFlags(
-            tangentVertexBuffer,
-            Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(tangentVertexBuffer) =
-            R::BufferType::kVertex;
-        BufferManager::_descSizeInBytes(tangentVertexBuffer) =
-            (uint32_t)tangents[subMeshIdx].size() * sizeof(uint16_t) * 4u;
-
-        // Convert to half
-        uint16_t* tempBuffer = (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(tangentVertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
-
-        for (uint32_t i = 0u; i < tangents[subMeshIdx].size(); ++i)
+        if (binaryData != nullptr)
         {
-          uint32_t packedTangent0 = glm::packHalf2x16(
-              glm::vec2(tangents[subMeshIdx][i].x, tangents[subMeshIdx][i].y));
-          uint32_t packedTangent1 =
-              glm::packHalf2x16(glm::vec2(tangents[subMeshIdx][i].z, 0.0f));
-
-          tempBuffer[i * 3u] = packedTangent0;
-          tempBuffer[i * 3u + 1u] = packedTangent0 >> 16u;
-          tempBuffer[i * 3u + 2u] = packedTangent1;
+          // Binary streams are already stored in the final layout
+          const MeshFileSubMeshHeader& subMeshHeader =
+              getSubMeshHeader(binaryData, subMeshIdx);
+
+          BufferManager::_descSizeInBytes(bufferRef) =
+              subMeshHeader.streamSizes[streamIdx];
+          BufferManager::_descInitialData(bufferRef) =
+              (void*)(binaryData + subMeshHeader.streamOffsets[streamIdx]);
         }
-        BufferManager::_descInitialData(tangentVertexBuffer) = tempBuffer;
-
-        buffersToCreate.push_back(tangentVertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(tangentVertexBuffer);
-      }
-
-      BufferRef binormalVertexBuffer =
-          BufferManager::createBuffer(_N(MeshBinormalVb));
-      {
-        BufferManager::resetToDefault(binormalVertexBuffer);
-
-        BufferManager::addResourceFlags(
-            binormalVertexBuffer,
-            Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(binormalVertexBuffer) =
-            R::BufferType::kVertex;
-        BufferManager::_descSizeInBytes(binormalVertexBuffer) =
-            (uint32_t)binormals[subMeshIdx].size() * sizeof(uint16_t) * 4u;
-
-        // Convert to half
-        uint16_t* tempBuffer = (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(binormalVertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
-
-        for (uint32_t i = 0u; i < binormals[subMeshIdx].size(); ++i)
+        else
         {
-          uint32_t packedBinormal0 = glm::packHalf2x16(glm::vec2(
-              binormals[subMeshIdx][i].x, binormals[subMeshIdx][i].y));
-          uint32_t packedBinormal1 =
-              glm::packHalf2x16(glm::vec2(binormals[subMeshIdx][i].z, 0.0f));
-
-          tempBuffer[i * 3u] = packedBinormal0;
-          tempBuffer[i * 3u + 1u] = packedBinormal0 >> 16u;
-          tempBuffer[i * 3u + 2u] = packedBinormal1;
-        }
-        BufferManager::_descInitialData(binormalVertexBuffer) = tempBuffer;
-
-        buffersToCreate.push_back(binormalVertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(binormalVertexBuffer);
-      }
+          BufferManager::_descSizeInBytes(bufferRef) =
+              calcStreamSizeInBytes(meshRef, subMeshIdx, stream);
 
-      BufferRef vtxColorVertexBuffer =
-          BufferManager::createBuffer(_N(MeshVtxColorVb));
-      {
-        BufferManager::resetToDefault(vtxColorVertexBuffer);
-
-        BufferManager::addResourceFlags(
-            vtxColorVertexBuffer,
-            Dod::Resources::ResourceFlags::kResourceVolatile);
-        BufferManager::_descBufferType(vtxColorVertexBuffer) =
-            R::BufferType::kVertex;
-
-        BufferManager::_descSizeInBytes(vtxColorVertexBuffer) =
-            (uint32_t)vtxColors[subMeshIdx].size() * sizeof(uint32_t);
-
-        // Convert color
-        uint32_t* tempBuffer = (uint32_t*)Memory::Tlsf::MainAllocator::allocate(
-            BufferManager::_descSizeInBytes(vtxColorVertexBuffer));
-        tempBuffersToRelease.push_back(tempBuffer);
+          if (stream == MeshStream::kIndex && indexCount > 0xFFFF)
+          {
+            BufferManager::_descInitialData(bufferRef) =
+                (void*)indices[subMeshIdx].data();
+          }
+          else
+          {
+            void* tempBuffer = Memory::Tlsf::MainAllocator::allocate(
+                BufferManager::_descSizeInBytes(bufferRef));
+            tempBuffersToRelease.push_back(tempBuffer);
 
-        for (uint32_t i = 0u; i < vtxColors[subMeshIdx].size(); ++i)
-        {
-          tempBuffer[i] = Math::convertColorToBGRA(vtxColors[subMeshIdx][i]);
+            convertStream(meshRef, subMeshIdx, stream, tempBuffer);
+            BufferManager::_descInitialData(bufferRef) = tempBuffer;
+          }
         }
-        BufferManager::_descInitialData(vtxColorVertexBuffer) = tempBuffer;
 
-        buffersToCreate.push_back(vtxColorVertexBuffer);
-        vertexBuffers[subMeshIdx].push_back(vtxColorVertexBuffer);
-      }
+        buffersToCreate.push_back(bufferRef);
 
-      BufferRef indexBuffer = BufferManager::createBuffer(_N(MeshIb));
-      {
-        BufferManager::resetToDefault(indexBuffer);
-
-        BufferManager::addResourceFlags(
-            indexBuffer, Dod::Resources::ResourceFlags::kResourceVolatile);
-
-        if (indices[subMeshIdx].size() <= 0xFFFF)
+        if (stream == MeshStream::kIndex)
         {
-          uint32_t indexBufferSizeInBytes =
-              (uint16_t)indices[subMeshIdx].size() * sizeof(uint16_t);
-          uint16_t* tempIndexBuffer =
-              (uint16_t*)Memory::Tlsf::MainAllocator::allocate(
-                  indexBufferSizeInBytes);
-          tempBuffersToRelease.push_back(tempIndexBuffer);
-
-          for (uint32_t i = 0u; i < indices[subMeshIdx].size(); ++i)
-          {
-            tempIndexBuffer[i] = (uint16_t)indices[subMeshIdx][i];
-          }
-
-          BufferManager::_descBufferType(indexBuffer) = R::BufferType::kIndex16;
-          BufferManager::_descSizeInBytes(indexBuffer) = indexBufferSizeInBytes;
-          BufferManager::_descInitialData(indexBuffer) = tempIndexBuffer;
+          indexBuffers[subMeshIdx] = bufferRef;
         }
         else
         {
-          BufferManager::_descBufferType(indexBuffer) = R::BufferType::kIndex32;
-          BufferManager::_descSizeInBytes(indexBuffer) =
-              (uint32_t)indices[subMeshIdx].size() * sizeof(uint32_t);
-          BufferManager::_descInitialData(indexBuffer) =
-              (void*)indices[subMeshIdx].data();
+          vertexBuffers[subMeshIdx].push_back(bufferRef);
         }
-
-        buffersToCreate.push_back(indexBuffer);
-        indexBuffers[subMeshIdx] = indexBuffer;
       }
     }
 
@@ -474,6 +582,254 @@ void MeshManager::destroyResources(const MeshRefArray& p_Meshes)
     BufferManager::destroyBuffer(buffersToDestroy[i]);
   }
 }
+
+// <-
+
+void MeshManager::loadFromMultipleFiles(const char* p_Path,
+                                        const char* p_Extension)
+{
+  if (Settings::Manager::_binaryMeshesEnabled)
+  {
+    tinydir_dir dir;
+    if (tinydir_open(&dir, p_Path) == -1)
+    {
+      _INTR_LOG_ERROR("Directory not found while loading binary meshes...");
+      return;
+    }
+
+    while (dir.has_next)
+    {
+      tinydir_file file;
+      if (tinydir_readfile(&dir, &file) == -1)
+      {
+        _INTR_LOG_ERROR("Failed to read file in directory...");
+        tinydir_next(&dir);
+        continue;
+      }
+
+      _INTR_STRING resourceName, extension;
+      StringUtil::extractFileNameAndExtension(file.path, resourceName,
+                                              extension);
+
+      if (extension != _INTR_MESH_FILE_EXTENSION)
+      {
+        tinydir_next(&dir);
+        continue;
+      }
+
+      MeshRef meshRef = createMesh(resourceName);
+      resetToDefault(meshRef);
+
+      const _INTR_STRING descFilePath =
+          _INTR_STRING(p_Path) + resourceName + p_Extension;
+
+      // Fall back to the JSON description if the file is invalid or outdated
+      if (!loadFromBinaryFile(meshRef, file.path, descFilePath.c_str()))
+      {
+        destroyMesh(meshRef);
+      }
+
+      tinydir_next(&dir);
+    }
+
+    tinydir_close(&dir);
+  }
+
+  const uint32_t binaryMeshCount = (uint32_t)_activeRefs.size();
+
+  Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
+      _loadFromMultipleFiles(p_Path, p_Extension, initFromDescriptor,
+                             resetToDefault, true);
+
+  // Compile binary files for all meshes loaded from their JSON description
+  if (Settings::Manager::_binaryMeshesEnabled)
+  {
+    for (uint32_t i = binaryMeshCount; i < _activeRefs.size(); ++i)
+    {
+      saveToBinaryFile(_activeRefs[i], p_Path, p_Extension);
+    }
+  }
+}
+
+// <-
+
+void MeshManager::saveToBinaryFile(MeshRef p_Ref, const char* p_Path,
+                                   const char* p_Extension)
+{
+  // Volatile meshes and meshes loaded from binary files are never written
+  if (hasResourceFlags(p_Ref,
+                       Dod::Resources::ResourceFlags::kResourceVolatile) ||
+      _binaryFile(p_Ref).data != nullptr)
+  {
+    return;
+  }
+
+  // Binary files are tied to the description they have been compiled from
+  const _INTR_STRING descFilePath =
+      _INTR_STRING(p_Path) + _name(p_Ref).getString() + p_Extension;
+
+  uint64_t descriptionHash;
+  if (!hashDescriptionFile(descFilePath.c_str(), descriptionHash))
+  {
+    _INTR_LOG_WARNING("Failed to read mesh description '%s', skipping binary "
+                      "mesh...",
+                      descFilePath.c_str());
+    return;
+  }
+
+  initSubMeshInfoFromDescription(p_Ref);
+
+  const uint32_t subMeshCount = (uint32_t)_indexCountPerSubMesh(p_Ref).size();
+  _INTR_ARRAY(MeshFileSubMeshHeader) subMeshHeaders;
+  subMeshHeaders.resize(subMeshCount);
+  _INTR_ARRAY(_INTR_STRING) materialNames;
+  materialNames.resize(subMeshCount);
+
+  // Calculate the layout of the file
+  uint32_t sizeInBytes = sizeof(MeshFileHeader) +
+                         subMeshCount * sizeof(MeshFileSubMeshHeader);
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    MeshFileSubMeshHeader& subMeshHeader = subMeshHeaders[subMeshIdx];
+    memset(&subMeshHeader, 0u, sizeof(MeshFileSubMeshHeader));
+
+    const Math::AABB& aabb = _aabbPerSubMesh(p_Ref)[subMeshIdx];
+    memcpy(subMeshHeader.aabbMin, &aabb.min, sizeof(float) * 3u);
+    memcpy(subMeshHeader.aabbMax, &aabb.max, sizeof(float) * 3u);
+    subMeshHeader.vertexCount = _vertexCountPerSubMesh(p_Ref)[subMeshIdx];
+    subMeshHeader.indexCount = _indexCountPerSubMesh(p_Ref)[subMeshIdx];
+
+    materialNames[subMeshIdx] =
+        _descMaterialNamesPerSubMesh(p_Ref)[subMeshIdx].getString();
+    subMeshHeader.materialNameOffset = sizeInBytes;
+    subMeshHeader.materialNameLength =
+        (uint32_t)materialNames[subMeshIdx].size();
+    sizeInBytes += subMeshHeader.materialNameLength;
+  }
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    MeshFileSubMeshHeader& subMeshHeader = subMeshHeaders[subMeshIdx];
+
+    for (uint32_t streamIdx = 0u; streamIdx < MeshStream::kCount; ++streamIdx)
+    {
+      sizeInBytes = (sizeInBytes + 15u) & ~15u;
+
+      subMeshHeader.streamOffsets[streamIdx] = sizeInBytes;
+      subMeshHeader.streamSizes[streamIdx] = calcStreamSizeInBytes(
+          p_Ref, subMeshIdx, (MeshStream::Enum)streamIdx);
+      sizeInBytes += subMeshHeader.streamSizes[streamIdx];
+    }
+  }
+
+  // Write the file to memory and to disk in one go
+  uint8_t* fileData =
+      (uint8_t*)Memory::Tlsf::MainAllocator::allocate(sizeInBytes);
+  memset(fileData, 0u, sizeInBytes);
+  {
+    MeshFileHeader& header = *(MeshFileHeader*)fileData;
+    header.magic = _INTR_MESH_FILE_MAGIC;
+    header.version = _INTR_MESH_FILE_VERSION;
+    header.subMeshCount = subMeshCount;
+    header.sizeInBytes = sizeInBytes;
+    header.descriptionHash = descriptionHash;
+
+    for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+    {
+      const MeshFileSubMeshHeader& subMeshHeader = subMeshHeaders[subMeshIdx];
+      memcpy(fileData + sizeof(MeshFileHeader) +
+                 subMeshIdx * sizeof(MeshFileSubMeshHeader),
+             &subMeshHeader, sizeof(MeshFileSubMeshHeader));
+      memcpy(fileData + subMeshHeader.materialNameOffset,
+             materialNames[subMeshIdx].c_str(),
+             subMeshHeader.materialNameLength);
+
+      for (uint32_t streamIdx = 0u; streamIdx < MeshStream::kCount;
+           ++streamIdx)
+      {
+        convertStream(p_Ref, subMeshIdx, (MeshStream::Enum)streamIdx,
+                      fileData + subMeshHeader.streamOffsets[streamIdx]);
+      }
+    }
+  }
+
+  const _INTR_STRING filePath = _INTR_STRING(p_Path) +
+                                _name(p_Ref).getString() +
+                                _INTR_MESH_FILE_EXTENSION;
+
+  FILE* fp = fopen(filePath.c_str(), "wb");
+  if (fp != nullptr)
+  {
+    fwrite(fileData, 1u, sizeInBytes, fp);
+    fclose(fp);
+  }
+  else
+  {
+    _INTR_LOG_WARNING("Failed to save binary mesh to file '%s'...",
+                      filePath.c_str());
+  }
+
+  Memory::Tlsf::MainAllocator::free(fileData);
+}
+
+// <-
+
+bool MeshManager::loadFromBinaryFile(MeshRef p_Ref, const char* p_FilePath,
+                                     const char* p_DescriptionFilePath)
+{
+  // Binary files without a description are stale leftovers
+  uint64_t descriptionHash;
+  if (!hashDescriptionFile(p_DescriptionFilePath, descriptionHash))
+  {
+    _INTR_LOG_WARNING("No description found for binary mesh file '%s'...",
+                      p_FilePath);
+    return false;
+  }
+
+  Util::MappedFile& binaryFile = _binaryFile(p_Ref);
+  if (!Util::mapFile(p_FilePath, binaryFile))
+  {
+    _INTR_LOG_WARNING("Failed to map binary mesh file '%s'...", p_FilePath);
+    return false;
+  }
+
+  if (!isValidBinaryFile(binaryFile, descriptionHash))
+  {
+    _INTR_LOG_WARNING("Binary mesh file '%s' is invalid or outdated...",
+                      p_FilePath);
+    Util::unmapFile(binaryFile);
+    return false;
+  }
+
+  const uint8_t* binaryData = (const uint8_t*)binaryFile.data;
+  const MeshFileHeader& header = *(const MeshFileHeader*)binaryData;
+
+  const uint32_t subMeshCount = header.subMeshCount;
+  _aabbPerSubMesh(p_Ref).resize(subMeshCount);
+  _vertexCountPerSubMesh(p_Ref).resize(subMeshCount);
+  _indexCountPerSubMesh(p_Ref).resize(subMeshCount);
+  _descMaterialNamesPerSubMesh(p_Ref).resize(subMeshCount);
+
+  for (uint32_t subMeshIdx = 0u; subMeshIdx < subMeshCount; ++subMeshIdx)
+  {
+    const MeshFileSubMeshHeader& subMeshHeader =
+        getSubMeshHeader(binaryData, subMeshIdx);
+
+    _aabbPerSubMesh(p_Ref)[subMeshIdx] =
+        Math::AABB(glm::vec3(subMeshHeader.aabbMin[0], subMeshHeader.aabbMin[1],
+                             subMeshHeader.aabbMin[2]),
+                   glm::vec3(subMeshHeader.aabbMax[0], subMeshHeader.aabbMax[1],
+                             subMeshHeader.aabbMax[2]));
+    _vertexCountPerSubMesh(p_Ref)[subMeshIdx] = subMeshHeader.vertexCount;
+    _indexCountPerSubMesh(p_Ref)[subMeshIdx] = subMeshHeader.indexCount;
+    _descMaterialNamesPerSubMesh(p_Ref)[subMeshIdx] =
+        _INTR_STRING((const char*)binaryData + subMeshHeader.materialNameOffset,
+                     subMeshHeader.materialNameLength);
+  }
+
+  return true;
+}
 }
 }
 }
@@ -42,6 +42,53 @@ typedef _INTR_ARRAY(Name) MaterialNamesPerSubMeshArray;
 typedef _INTR_ARRAY(_INTR_ARRAY(Dod::Ref)) VertexBuffersPerSubMeshArray;
 typedef _INTR_ARRAY(Dod::Ref) IndexBufferPerSubMeshArray;
 typedef _INTR_ARRAY(Math::AABB) AABBPerSubMeshArray;
+typedef _INTR_ARRAY(uint32_t) CountPerSubMeshArray;
+
+// Binary mesh files
+#define _INTR_MESH_FILE_EXTENSION ".mesh.bin"
+#define _INTR_MESH_FILE_MAGIC 0x4853454Du // == "MESH"
+#define _INTR_MESH_FILE_VERSION 2u
+
+namespace MeshStream
+{
+enum Enum
+{
+  kPosition,
+  kUV0,
+  kNormal,
+  kTangent,
+  kBinormal,
+  kVertexColor,
+  kIndex,
+
+  kCount
+};
+}
+
+// Layout: header, one sub mesh header per sub mesh, the material names and
+// finally the (16 byte aligned) streams - all streams are stored in the format
+// expected by the vertex and index buffers and can be uploaded as is
+struct MeshFileHeader
+{
+  uint32_t magic;
+  uint32_t version;
+  uint32_t subMeshCount;
+  uint32_t sizeInBytes;
+  // Hash of the JSON description the file has been compiled from
+  uint64_t descriptionHash;
+};
+
+struct MeshFileSubMeshHeader
+{
+  float aabbMin[3];
+  float aabbMax[3];
+  uint32_t vertexCount;
+  uint32_t indexCount;
+  uint32_t materialNameOffset;
+  uint32_t materialNameLength;
+  uint32_t streamOffsets[MeshStream::kCount];
+  uint32_t streamSizes[MeshStream::kCount];
+};
 
 struct MeshData : Dod::Resources::ResourceDataBase
 {
@@ -58,6 +105,9 @@ struct MeshData : Dod::Resources::ResourceDataBase
     vertexBuffersPerSubMesh.resize(_INTR_MAX_MESH_COUNT);
     indexBufferPerSubMesh.resize(_INTR_MAX_MESH_COUNT);
     aabbPerSubMesh.resize(_INTR_MAX_MESH_COUNT);
+    vertexCountPerSubMesh.resize(_INTR_MAX_MESH_COUNT);
+    indexCountPerSubMesh.resize(_INTR_MAX_MESH_COUNT);
+    binaryFile.resize(_INTR_MAX_MESH_COUNT);
 
     pxTriangleMesh.resize(_INTR_MAX_MESH_COUNT);
     pxConvexMesh.resize(_INTR_MAX_MESH_COUNT);
@@ -79,6 +129,9 @@ struct MeshData : Dod::Resources::ResourceDataBase
   _INTR_ARRAY(VertexBuffersPerSubMeshArray) vertexBuffersPerSubMesh;
   _INTR_ARRAY(IndexBufferPerSubMeshArray) indexBufferPerSubMesh;
   _INTR_ARRAY(AABBPerSubMeshArray) aabbPerSubMesh;
+  _INTR_ARRAY(CountPerSubMeshArray) vertexCountPerSubMesh;
+  _INTR_ARRAY(CountPerSubMeshArray) indexCountPerSubMesh;
+  _INTR_ARRAY(Util::MappedFile) binaryFile;
 
   _INTR_ARRAY(physx::PxTriangleMesh*) pxTriangleMesh;
   _INTR_ARRAY(physx::PxConvexMesh*) pxConvexMesh;
@@ -111,12 +164,17 @@ struct MeshManager
     _descVertexColorsPerSubMesh(p_Ref).clear();
     _descMaterialNamesPerSubMesh(p_Ref).clear();
     _aabbPerSubMesh(p_Ref).clear();
+    _vertexCountPerSubMesh(p_Ref).clear();
+    _indexCountPerSubMesh(p_Ref).clear();
+    Util::unmapFile(_binaryFile(p_Ref));
   }
 
   // <-
 
   _INTR_INLINE static void destroyMesh(MeshRef p_Ref)
   {
+    Util::unmapFile(_binaryFile(p_Ref));
+
     Dod::Resources::ResourceManagerBase<
         MeshData, _INTR_MAX_MESH_COUNT>::_destroyResource(p_Ref);
   }
@@ -134,6 +192,9 @@ struct MeshManager
                                                             p_Document);
     if (!p_GenerateDesc)
     {
+      _INTR_ASSERT(_binaryFile(p_Ref).data == nullptr &&
+                   "Meshes loaded from binary files carry no description");
+
       rapidjson::Value positionsPerSubMesh =
           rapidjson::Value(rapidjson::kArrayType);
       rapidjson::Value uv0sPerSubMesh = rapidjson::Value(rapidjson::kArrayType);
@@ -212,7 +273,7 @@ struct MeshManager
         indicesPerSubMesh.PushBack(indices, p_Document.GetAllocator());
 
         rapidjson::Value materialName = rapidjson::Value(
-            _descMaterialNamesPerSubMesh(p_Ref)[subMeshIdx].getString().c_str(),
+            _descMaterialNamesPerSubMesh(p_Ref)[subMeshIdx].getCString(),
             p_Document.GetAllocator());
         materialNamesPerSubMesh.PushBack(materialName,
                                          p_Document.GetAllocator());
@@ -369,9 +430,16 @@ struct MeshManager
   _INTR_INLINE static void saveToMultipleFiles(const char* p_Path,
                                                const char* p_Extension)
   {
+    Dod::Resources::ResourceManagerBase<
+        MeshData, _INTR_MAX_MESH_COUNT>::_deleteRemovedFiles(p_Path,
+                                                             p_Extension);
     Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
-        _saveToMultipleFiles<rapidjson::Writer<rapidjson::FileWriteStream>>(
-            p_Path, p_Extension, compileDescriptor);
+        _deleteRemovedFiles(p_Path, _INTR_MESH_FILE_EXTENSION);
+
+    for (uint32_t i = 0u; i < _activeRefs.size(); ++i)
+    {
+      saveToMultipleFilesSingleResource(_activeRefs[i], p_Path, p_Extension);
+    }
   }
 
   // <-
@@ -380,21 +448,34 @@ struct MeshManager
   saveToMultipleFilesSingleResource(MeshRef p_Ref, const char* p_Path,
                                     const char* p_Extension)
   {
+    // Meshes mapped from binary files carry no description - leave their JSON
+    // description untouched, it stays the source of the binary file
+    if (_binaryFile(p_Ref).data != nullptr)
+    {
+      return;
+    }
+
     Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
         _saveToMultipleFilesSingleResource<
             rapidjson::Writer<rapidjson::FileWriteStream>>(
             p_Ref, p_Path, p_Extension, compileDescriptor);
+
+    saveToBinaryFile(p_Ref, p_Path, p_Extension);
   }
 
   // <-
 
-  _INTR_INLINE static void loadFromMultipleFiles(const char* p_Path,
-                                                 const char* p_Extension)
-  {
-    Dod::Resources::ResourceManagerBase<MeshData, _INTR_MAX_MESH_COUNT>::
-        _loadFromMultipleFiles(p_Path, p_Extension, initFromDescriptor,
-                               resetToDefault);
-  }
+  // Loads all meshes from the given path - meshes available as binary files
+  // are mapped directly, all others are parsed from their JSON description
+  static void loadFromMultipleFiles(const char* p_Path,
+                                    const char* p_Extension);
+
+  // <-
+
+  static void saveToBinaryFile(MeshRef p_Ref, const char* p_Path,
+                               const char* p_Extension);
+  static bool loadFromBinaryFile(MeshRef p_Ref, const char* p_FilePath,
+                                 const char* p_DescriptionFilePath);
 
   // <-
 
@@ -468,6 +549,19 @@ struct MeshManager
   {
     return _data.aabbPerSubMesh[p_Ref._id];
   }
+  _INTR_INLINE static CountPerSubMeshArray&
+  _vertexCountPerSubMesh(MeshRef p_Ref)
+  {
+    return _data.vertexCountPerSubMesh[p_Ref._id];
+  }
+  _INTR_INLINE static CountPerSubMeshArray& _indexCountPerSubMesh(MeshRef p_Ref)
+  {
+    return _data.indexCountPerSubMesh[p_Ref._id];
+  }
+  _INTR_INLINE static Util::MappedFile& _binaryFile(MeshRef p_Ref)
+  {
+    return _data.binaryFile[p_Ref._id];
+  }
 
   _INTR_INLINE static physx::PxTriangleMesh*& _pxTriangleMesh(MeshRef p_Ref)
   {
@@ -0,0 +1,80 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+std::atomic<uint32_t> ScratchAllocator::_frameIdx(0u);
+std::atomic<bool> ScratchAllocator::_fallbackWarningIssued(false);
+thread_local ScratchAllocator::ThreadScratch*
+    ScratchAllocator::_threadScratch = nullptr;
+
+// <-
+
+void ScratchAllocator::initThreadScratch()
+{
+  const uint32_t sizeInBytes = _INTR_SCRATCH_SIZE_IN_MB * 1024u * 1024u;
+
+  _INTR_NEW(ThreadScratch, _threadScratch)();
+  _threadScratch->memory = (uint8_t*)Tlsf::MainAllocator::allocate(
+      sizeInBytes * _INTR_SCRATCH_BUFFER_COUNT);
+
+  // Forces initializing the allocator on the first allocation
+  _threadScratch->frameIdx = (uint32_t)-1;
+}
+
+// <-
+
+void* ScratchAllocator::allocateFallback(uint32_t p_Size, uint32_t p_Alignment)
+{
+  if (!_fallbackWarningIssued.exchange(true, std::memory_order_relaxed))
+  {
+    _INTR_LOG_WARNING("Scratch memory exhausted, falling back to the main "
+                      "allocator...");
+  }
+
+  // Over allocate so the memory can be aligned manually
+  uint8_t* mem =
+      (uint8_t*)Tlsf::MainAllocator::allocate(p_Size + p_Alignment - 1u);
+
+  const uint32_t bufferIdx =
+      _threadScratch->frameIdx % _INTR_SCRATCH_BUFFER_COUNT;
+  _threadScratch->fallbackAllocations[bufferIdx].push_back(mem);
+
+  return (void*)(((uintptr_t)mem + p_Alignment - 1u) &
+                 ~(uintptr_t)(p_Alignment - 1u));
+}
+
+// <-
+
+void ScratchAllocator::releaseFallbackAllocations(uint32_t p_BufferIdx)
+{
+  _INTR_ARRAY(void*)& allocations =
+      _threadScratch->fallbackAllocations[p_BufferIdx];
+
+  for (uint32_t i = 0u; i < allocations.size(); ++i)
+  {
+    Tlsf::MainAllocator::free(allocations[i]);
+  }
+  allocations.clear();
+}
+}
+}
+}
@@ -0,0 +1,166 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+// Number of frames a scratch allocation stays valid
+#define _INTR_SCRATCH_BUFFER_COUNT 2u
+#define _INTR_SCRATCH_SIZE_IN_MB 8u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace Memory
+{
+// Per thread bump allocator for temporary memory which is released
+// wholesale at the end of the frame. Memory is never freed individually and
+// must not be accessed after the next frame has ended. Allocations exceeding
+// the remaining scratch memory (e.g. while loading, where no frames end) are
+// served by the main allocator and released with the scratch buffer
+struct ScratchAllocator
+{
+  _INTR_INLINE static void* allocate(uint32_t p_Size, uint32_t p_Alignment)
+  {
+    ThreadScratch& scratch = getThreadScratch();
+
+    if (p_Size > scratch.allocator.size() ||
+        !scratch.allocator.fits(p_Size, p_Alignment))
+    {
+      return allocateFallback(p_Size, p_Alignment);
+    }
+
+    return scratch.memory + scratch.allocator.allocate(p_Size, p_Alignment);
+  }
+
+  // <-
+
+  // Called by the task manager after all work of the current frame is done
+  _INTR_INLINE static void onFrameEnded()
+  {
+    _frameIdx.fetch_add(1u, std::memory_order_release);
+  }
+
+private:
+  struct ThreadScratch
+  {
+    uint8_t* memory;
+    LinearOffsetAllocator allocator;
+    uint32_t frameIdx;
+
+    _INTR_ARRAY(void*) fallbackAllocations[_INTR_SCRATCH_BUFFER_COUNT];
+  };
+
+  // <-
+
+  _INTR_INLINE static ThreadScratch& getThreadScratch()
+  {
+    if (_threadScratch == nullptr)
+    {
+      initThreadScratch();
+    }
+
+    // Switch to the next buffer the first time the thread allocates in a
+    // new frame
+    const uint32_t frameIdx = _frameIdx.load(std::memory_order_acquire);
+    if (_threadScratch->frameIdx != frameIdx)
+    {
+      const uint32_t sizeInBytes = _INTR_SCRATCH_SIZE_IN_MB * 1024u * 1024u;
+      const uint32_t bufferIdx = frameIdx % _INTR_SCRATCH_BUFFER_COUNT;
+
+      _threadScratch->allocator.init(sizeInBytes, bufferIdx * sizeInBytes);
+      _threadScratch->frameIdx = frameIdx;
+
+      if (!_threadScratch->fallbackAllocations[bufferIdx].empty())
+      {
+        releaseFallbackAllocations(bufferIdx);
+      }
+    }
+
+    return *_threadScratch;
+  }
+
+  // <-
+
+  static void initThreadScratch();
+  static void* allocateFallback(uint32_t p_Size, uint32_t p_Alignment);
+  static void releaseFallbackAllocations(uint32_t p_BufferIdx);
+
+  static std::atomic<uint32_t> _frameIdx;
+  static std::atomic<bool> _fallbackWarningIssued;
+  static thread_local ThreadScratch* _threadScratch;
+};
+
+// <-
+
+template <class T> class ScratchStlAllocator
+{
+public:
+  typedef T value_type;
+  typedef T* pointer;
+  typedef const T* const_pointer;
+  typedef T& reference;
+  typedef const T& const_reference;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+
+  template <class U> struct rebind
+  {
+    typedef ScratchStlAllocator<U> other;
+  };
+
+  pointer address(reference value) const { return &value; }
+  const_pointer address(const_reference value) const { return &value; }
+
+  ScratchStlAllocator() throw() {}
+  ScratchStlAllocator(const ScratchStlAllocator&) throw() {}
+  template <class U> ScratchStlAllocator(const ScratchStlAllocator<U>&) throw()
+  {
+  }
+  ~ScratchStlAllocator() throw() {}
+
+  size_type max_size() const throw()
+  {
+    return std::numeric_limits<size_type>::max() / sizeof(T);
+  }
+
+  pointer allocate(size_type num, const void* = 0)
+  {
+    return (T*)Memory::ScratchAllocator::allocate((uint32_t)num * sizeof(T),
+                                                  (uint32_t)alignof(T));
+  }
+
+  void construct(pointer p, const T& value) { new ((void*)p) T(value); }
+
+  void destroy(pointer p) { p->~T(); }
+
+  // Released at the end of the frame
+  void deallocate(pointer p, size_type num) {}
+};
+
+template <class T1, class T2>
+bool operator==(const ScratchStlAllocator<T1>&,
+                const ScratchStlAllocator<T2>&) throw()
+{
+  return true;
+}
+template <class T1, class T2>
+bool operator!=(const ScratchStlAllocator<T1>&,
+                const ScratchStlAllocator<T2>&) throw()
+{
+  return false;
+}
+}
+}
+}
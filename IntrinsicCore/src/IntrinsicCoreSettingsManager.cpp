@@ -40,6 +40,7 @@ _INTR_STRING Manager::_materialPassConfig = "material_pass_config.json";
 float Manager::_controllerDeadZone = 0.25f;
 bool Manager::_invertHorizontalCameraAxis = false;
 bool Manager::_invertVerticalCameraAxis = false;
+bool Manager::_binaryMeshesEnabled = true;
 
 namespace
 {
@@ -47,10 +48,10 @@ template <typename T>
 _INTR_INLINE void readSetting(rapidjson::Document& p_Doc, const Name& p_Name,
                               T& p_Target)
 {
-  if (p_Doc.HasMember(p_Name.getString().c_str()))
+  if (p_Doc.HasMember(p_Name.getCString()))
   {
-    p_Target = p_Doc[p_Name.getString().c_str()].Get<T>();
-    _INTR_LOG_INFO("%s = '%s'", p_Name.getString().c_str(),
+    p_Target = p_Doc[p_Name.getCString()].Get<T>();
+    _INTR_LOG_INFO("%s = '%s'", p_Name.getCString(),
                    StringUtil::toString(p_Target).c_str());
   }
 }
@@ -59,10 +60,10 @@ template <>
 _INTR_INLINE void readSetting(rapidjson::Document& p_Doc, const Name& p_Name,
                               _INTR_STRING& p_Target)
 {
-  if (p_Doc.HasMember(p_Name.getString().c_str()))
+  if (p_Doc.HasMember(p_Name.getCString()))
   {
-    p_Target = p_Doc[p_Name.getString().c_str()].GetString();
-    _INTR_LOG_INFO("%s = '%s'", p_Name.getString().c_str(), p_Target.c_str());
+    p_Target = p_Doc[p_Name.getCString()].GetString();
+    _INTR_LOG_INFO("%s = '%s'", p_Name.getCString(), p_Target.c_str());
   }
 }
 }
@@ -116,6 +117,7 @@ void Manager::loadSettings()
     readSetting(doc, _N(invertHorizontalCameraAxis),
                 _invertHorizontalCameraAxis);
     readSetting(doc, _N(invertVerticalCameraAxis), _invertVerticalCameraAxis);
+    readSetting(doc, _N(binaryMeshesEnabled), _binaryMeshesEnabled);
   }
 
   _INTR_LOG_POP();
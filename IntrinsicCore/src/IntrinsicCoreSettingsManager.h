@@ -70,6 +70,7 @@ struct Manager
   static float _controllerDeadZone;
   static bool _invertHorizontalCameraAxis;
   static bool _invertVerticalCameraAxis;
+  static bool _binaryMeshesEnabled;
   static _INTR_STRING _rendererConfig;
   static _INTR_STRING _materialPassConfig;
 };
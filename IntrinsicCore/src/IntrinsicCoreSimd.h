@@ -50,6 +50,60 @@ _INTR_INLINE __m128 simdMadd(__m128 a, __m128 b, __m128 c)
 {
   return _mm_add_ps(_mm_mul_ps(a, b), c);
 }
+
+// <-
+
+_INTR_INLINE void cpuid(int p_Info[4], int p_Leaf, int p_SubLeaf)
+{
+#if defined(_WIN32)
+  __cpuidex(p_Info, p_Leaf, p_SubLeaf);
+#else
+  __cpuid_count(p_Leaf, p_SubLeaf, p_Info[0], p_Info[1], p_Info[2],
+                p_Info[3]);
+#endif // _WIN32
+}
+
+// <-
+
+_INTR_INLINE uint64_t xgetbv(uint32_t p_Register)
+{
+#if defined(_WIN32)
+  return _xgetbv(p_Register);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(p_Register));
+  return ((uint64_t)edx << 32u) | eax;
+#endif // _WIN32
+}
+
+// <-
+
+// Returns true if the CPU and the OS support AVX2 and FMA3
+_INTR_INLINE bool isAvx2Supported()
+{
+  static const bool avx2Supported = []() {
+    int info[4];
+    cpuid(info, 0, 0);
+    if (info[0] < 7)
+      return false;
+
+    cpuid(info, 1, 0);
+    const bool fma = (info[2] & (1 << 12)) != 0;
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!fma || !osxsave || !avx)
+      return false;
+
+    // The OS has to save the XMM and YMM registers on context switches
+    if ((xgetbv(0u) & 0x06u) != 0x06u)
+      return false;
+
+    cpuid(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+  }();
+
+  return avx2Supported;
+}
 }
 }
 }
@@ -0,0 +1,247 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Core
+{
+void TaskGraphNode::ExecuteRange(enki::TaskSetPartition p_Range,
+                                 uint32_t p_ThreadNum)
+{
+  graph->executeNode(*this, p_ThreadNum);
+}
+
+// <-
+
+uint32_t TaskGraph::addNode(const char* p_Name, uint32_t p_ReadMask,
+                            uint32_t p_WriteMask,
+                            const TaskGraphFunction& p_Function,
+                            uint32_t p_Flags)
+{
+  _INTR_ASSERT(_nodeCount < _INTR_MAX_TASK_GRAPH_NODE_COUNT &&
+               "Too many task graph nodes");
+
+  const uint32_t nodeIdx = _nodeCount++;
+
+  TaskGraphNode& node = _nodes[nodeIdx];
+  node.graph = this;
+  node.name = p_Name;
+  node.function = p_Function;
+  node.readMask = p_ReadMask;
+  node.writeMask = p_WriteMask;
+  node.flags = p_Flags;
+  node.predecessorMask = 0u;
+  node.successorMask = 0u;
+  node.predecessorCount = 0u;
+  node.startInMicroseconds = 0u;
+  node.durationInMicroseconds = 0u;
+  node.threadIdx = 0u;
+
+  for (uint32_t i = 0u; i < nodeIdx; ++i)
+  {
+    TaskGraphNode& prevNode = _nodes[i];
+
+    const bool conflicting =
+        (prevNode.writeMask & (p_ReadMask | p_WriteMask)) != 0u ||
+        (prevNode.readMask & p_WriteMask) != 0u;
+    if (conflicting)
+    {
+      prevNode.successorMask |= 1ull << nodeIdx;
+      node.predecessorMask |= 1ull << i;
+      ++node.predecessorCount;
+    }
+  }
+
+  if ((p_Flags & TaskGraphNodeFlags::kMainThreadOnly) != 0u)
+  {
+    _mainThreadNodeMask |= 1ull << nodeIdx;
+  }
+
+  return nodeIdx;
+}
+
+// <-
+
+void TaskGraph::execute()
+{
+  _INTR_PROFILE_CPU("General", "Execute Task Graph");
+
+  _startInMicroseconds = TimingHelper::getMicroseconds();
+
+  for (uint32_t i = 0u; i < _nodeCount; ++i)
+  {
+    TaskGraphNode& node = _nodes[i];
+    node.pendingPredecessorCount.store(node.predecessorCount);
+    node.started.store(false);
+  }
+
+  // Kick all nodes without dependencies
+  for (uint32_t i = 0u; i < _nodeCount; ++i)
+  {
+    TaskGraphNode& node = _nodes[i];
+    if (node.predecessorCount == 0u &&
+        (_mainThreadNodeMask & (1ull << i)) == 0u)
+    {
+      node.started.store(true);
+      Application::_scheduler.AddTaskSetToPipe(&node);
+    }
+  }
+
+  uint64_t pendingMainThreadNodes = _mainThreadNodeMask;
+  while (pendingMainThreadNodes != 0u)
+  {
+    bool executedNode = false;
+
+    uint64_t mainThreadNodes = pendingMainThreadNodes;
+    while (mainThreadNodes != 0u)
+    {
+      const uint32_t nodeIdx = Math::calcLowestSetBit64(mainThreadNodes);
+      mainThreadNodes &= mainThreadNodes - 1u;
+
+      TaskGraphNode& node = _nodes[nodeIdx];
+      if (node.pendingPredecessorCount.load(std::memory_order_acquire) == 0u)
+      {
+        node.started.store(true, std::memory_order_relaxed);
+        executeNode(node, 0u);
+        pendingMainThreadNodes &= ~(1ull << nodeIdx);
+        executedNode = true;
+      }
+    }
+
+    // Wait for the node blocking the next main thread node and help out with
+    // other tasks in the meantime
+    if (!executedNode)
+    {
+      TaskGraphNode* blockingNode = findBlockingNode(
+          Math::calcLowestSetBit64(pendingMainThreadNodes));
+      if (blockingNode != nullptr)
+      {
+        Application::_scheduler.WaitforTaskSet(blockingNode);
+      }
+    }
+  }
+
+  // Wait for the remaining nodes - this also makes sure enkiTS is done with
+  // all task sets before they are reused
+  for (uint32_t i = 0u; i < _nodeCount; ++i)
+  {
+    if ((_mainThreadNodeMask & (1ull << i)) == 0u)
+    {
+      Application::_scheduler.WaitforTaskSet(&_nodes[i]);
+    }
+  }
+}
+
+// <-
+
+void TaskGraph::executeNode(TaskGraphNode& p_Node, uint32_t p_ThreadIdx)
+{
+  const uint64_t start = TimingHelper::getMicroseconds();
+
+  p_Node.function();
+
+  p_Node.startInMicroseconds = start - _startInMicroseconds;
+  p_Node.durationInMicroseconds = TimingHelper::getMicroseconds() - start;
+  p_Node.threadIdx = p_ThreadIdx;
+
+  uint64_t successors = p_Node.successorMask;
+  while (successors != 0u)
+  {
+    const uint32_t nodeIdx = Math::calcLowestSetBit64(successors);
+    successors &= successors - 1u;
+
+    TaskGraphNode& successor = _nodes[nodeIdx];
+    const bool ready = successor.pendingPredecessorCount.fetch_sub(
+                           1u, std::memory_order_acq_rel) == 1u;
+
+    // Main thread only nodes are picked up by the main thread
+    if (ready && (_mainThreadNodeMask & (1ull << nodeIdx)) == 0u)
+    {
+      successor.started.store(true, std::memory_order_relaxed);
+      Application::_scheduler.AddTaskSetToPipe(&successor);
+    }
+  }
+}
+
+// <-
+
+TaskGraphNode* TaskGraph::findBlockingNode(uint32_t p_NodeIdx)
+{
+  uint64_t predecessors = _nodes[p_NodeIdx].predecessorMask;
+  while (predecessors != 0u)
+  {
+    const uint32_t nodeIdx = Math::calcLowestSetBit64(predecessors);
+    predecessors &= predecessors - 1u;
+
+    TaskGraphNode& predecessor = _nodes[nodeIdx];
+
+    // Nodes which haven't been started yet are blocked by their own
+    // predecessors, main thread nodes are done once they've been started
+    if (!predecessor.started.load(std::memory_order_acquire))
+    {
+      TaskGraphNode* blockingNode = findBlockingNode(nodeIdx);
+      if (blockingNode != nullptr)
+      {
+        return blockingNode;
+      }
+    }
+    else if ((_mainThreadNodeMask & (1ull << nodeIdx)) == 0u &&
+             !predecessor.GetIsComplete())
+    {
+      return &predecessor;
+    }
+  }
+
+  return nullptr;
+}
+
+// <-
+
+void TaskGraph::dump() const
+{
+  _INTR_LOG_INFO("Task graph with %u nodes:", _nodeCount);
+  _INTR_LOG_PUSH();
+
+  for (uint32_t i = 0u; i < _nodeCount; ++i)
+  {
+    const TaskGraphNode& node = _nodes[i];
+
+    _INTR_STRING dependencies;
+    for (uint32_t j = 0u; j < i; ++j)
+    {
+      if ((node.predecessorMask & (1ull << j)) != 0u)
+      {
+        dependencies += dependencies.empty() ? "" : ", ";
+        dependencies += _nodes[j].name;
+      }
+    }
+
+    _INTR_LOG_INFO("#%u '%s'%s: reads 0x%x, writes 0x%x, depends on [%s], "
+                   "started at %.2f ms, took %.2f ms on thread %u",
+                   i, node.name,
+                   (node.flags & TaskGraphNodeFlags::kMainThreadOnly) != 0u
+                       ? " (main thread)"
+                       : "",
+                   node.readMask, node.writeMask, dependencies.c_str(),
+                   node.startInMicroseconds * 0.001f,
+                   node.durationInMicroseconds * 0.001f, node.threadIdx);
+  }
+
+  _INTR_LOG_POP();
+}
+}
+}
@@ -0,0 +1,122 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#define _INTR_MAX_TASK_GRAPH_NODE_COUNT 64u
+
+namespace Intrinsic
+{
+namespace Core
+{
+namespace TaskGraphNodeFlags
+{
+enum Flags
+{
+  // The node is executed on the thread calling "TaskGraph::execute"
+  kMainThreadOnly = 0x01u
+};
+}
+
+typedef std::function<void()> TaskGraphFunction;
+
+// <-
+
+struct TaskGraph;
+
+struct TaskGraphNode : enki::ITaskSet
+{
+  virtual ~TaskGraphNode() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override;
+
+  TaskGraph* graph;
+  const char* name;
+  TaskGraphFunction function;
+  uint32_t readMask;
+  uint32_t writeMask;
+  uint32_t flags;
+
+  uint64_t predecessorMask;
+  uint64_t successorMask;
+  uint32_t predecessorCount;
+
+  std::atomic<uint32_t> pendingPredecessorCount;
+  std::atomic<bool> started;
+
+  // Timings of the last execution (relative to the start of the graph)
+  uint64_t startInMicroseconds;
+  uint64_t durationInMicroseconds;
+  uint32_t threadIdx;
+};
+
+// <-
+
+// Executes a fixed set of nodes on the enkiTS workers. Each node declares
+// the data it reads and writes as bitmasks and depends on all previously
+// added nodes it has a read/write or write/write conflict with. Nodes
+// without conflicts run in parallel. The thread executing the graph runs
+// the main thread only nodes and helps out with the remaining ones
+struct TaskGraph
+{
+  TaskGraph()
+      : _nodeCount(0u), _mainThreadNodeMask(0u), _startInMicroseconds(0u)
+  {
+  }
+
+  // <-
+
+  uint32_t addNode(const char* p_Name, uint32_t p_ReadMask,
+                   uint32_t p_WriteMask, const TaskGraphFunction& p_Function,
+                   uint32_t p_Flags = 0u);
+
+  // <-
+
+  void execute();
+
+  // <-
+
+  // Logs all nodes with their dependencies and the timings of the last
+  // execution
+  void dump() const;
+
+  // <-
+
+  _INTR_INLINE uint32_t getNodeCount() const { return _nodeCount; }
+
+  // <-
+
+  _INTR_INLINE const TaskGraphNode& getNode(uint32_t p_NodeIdx) const
+  {
+    _INTR_ASSERT(p_NodeIdx < _nodeCount);
+    return _nodes[p_NodeIdx];
+  }
+
+private:
+  friend struct TaskGraphNode;
+
+  void executeNode(TaskGraphNode& p_Node, uint32_t p_ThreadIdx);
+
+  // Returns a running worker node the given node (indirectly) depends on
+  TaskGraphNode* findBlockingNode(uint32_t p_NodeIdx);
+
+  TaskGraphNode _nodes[_INTR_MAX_TASK_GRAPH_NODE_COUNT];
+  uint32_t _nodeCount;
+  uint64_t _mainThreadNodeMask;
+
+  uint64_t _startInMicroseconds;
+};
+}
+}
@@ -28,27 +28,111 @@ namespace
 float _stepAccum = 0.0f;
 const float _stepSize = 0.016f;
 
-struct PhysicsUpdateTaskSet : enki::ITaskSet
+TaskGraph _taskGraph;
+float _modDeltaT = 0.0f;
+
+// <-
+
+void updatePhysics()
 {
-  virtual ~PhysicsUpdateTaskSet() {}
+  _stepAccum += _modDeltaT;
 
-  void ExecuteRange(enki::TaskSetPartition p_Range,
-                    uint32_t p_ThreadNum) override
+  while (_stepAccum > _stepSize)
   {
-    const float modDeltaT =
-        TaskManager::_lastDeltaT * TaskManager::_timeModulator;
-    _stepAccum += modDeltaT;
+    Physics::System::dispatchSimulation(_modDeltaT);
+    Physics::System::syncSimulation();
 
-    while (_stepAccum > _stepSize)
-    {
-      Physics::System::dispatchSimulation(modDeltaT);
-      Physics::System::syncSimulation();
+    _stepAccum -= _modDeltaT;
+  }
+}
 
-      _stepAccum -= modDeltaT;
-    }
-  };
+// <-
 
-} _physicsUpdateTaskSet;
+void initTaskGraph()
+{
+  using namespace FrameData;
+
+  // Events and input
+  _taskGraph.addNode("Pump Events", 0u, kInput,
+                     []() {
+                       _INTR_PROFILE_CPU("TaskManager", "Pump Events");
+
+                       Input::System::reset();
+                       SystemEventProvider::SDL::pumpEvents();
+                     },
+                     TaskGraphNodeFlags::kMainThreadOnly);
+
+  // Game state update (the benchmark game state controls the time of day)
+  _taskGraph.addNode(
+      "Game States", kInput, kScene | kNodes | kEvents | kWorld,
+      []() { GameStates::Manager::update(_modDeltaT); },
+      TaskGraphNodeFlags::kMainThreadOnly);
+
+  // Scripts
+  _taskGraph.addNode("Scripts", kInput, kScene | kNodes | kEvents | kWorld,
+                     []() {
+                       Components::ScriptManager::tickScripts(
+                           Components::ScriptManager::_activeRefs,
+                           _modDeltaT);
+                     },
+                     TaskGraphNodeFlags::kMainThreadOnly);
+
+  // Physics
+  _taskGraph.addNode(
+      "Update From Physics Results", kScene, kNodes | kPhysics | kRendering,
+      []() {
+        _INTR_PROFILE_CPU("TaskManager", "Update From Physics Results");
+
+        Components::RigidBodyManager::updateNodesFromActors(
+            Components::RigidBodyManager::_activeRefs);
+        Components::RigidBodyManager::updateActorsFromNodes(
+            Components::RigidBodyManager::_activeRefs);
+        Physics::System::renderLineDebugGeometry();
+      });
+
+  // Swarms
+  _taskGraph.addNode("Swarms", kScene, kNodes, []() {
+    _INTR_PROFILE_CPU("TaskManager", "Swarms");
+
+    Components::SwarmManager::simulateSwarms(
+        Components::SwarmManager::_activeRefs, _modDeltaT);
+  });
+
+  // Update the world transforms of all nodes which changed this frame
+  _taskGraph.addNode("Update Transforms", 0u, kNodes, []() {
+    Components::NodeManager::updateDirtyTransforms();
+  });
+
+  // Update the day/night cycle
+  _taskGraph.addNode("Day/Night Cycle", 0u, kWorld, []() {
+    World::updateDayNightCycle(_modDeltaT);
+  });
+
+  // Post effect system
+  _taskGraph.addNode("Blend Post Effects", kScene | kNodes, kPostEffects,
+                     []() {
+                       Components::PostEffectVolumeManager::blendPostEffects(
+                           Components::PostEffectVolumeManager::_activeRefs);
+                     });
+
+  // Fire events
+  _taskGraph.addNode("Fire Events", 0u, kScene | kNodes | kEvents,
+                     []() { Resources::EventManager::fireEvents(); },
+                     TaskGraphNodeFlags::kMainThreadOnly);
+
+  // Process physics during rendering
+  _taskGraph.addNode("Physics Simulation", kScene, kPhysics, updatePhysics);
+
+  // Rendering
+  _taskGraph.addNode(
+      "Render Frame", kScene | kNodes | kWorld | kPostEffects, kRendering,
+      []() {
+        _INTR_PROFILE_CPU("TaskManager", "Rendering Tasks");
+
+        R::RenderProcess::Default::renderFrame(_modDeltaT);
+      },
+      TaskGraphNodeFlags::kMainThreadOnly);
+}
 }
 
 // Static members
@@ -86,81 +170,25 @@ void TaskManager::executeTasks()
   // Avoid very high deltaTs due to stalls
   _lastDeltaT = std::min(_lastDeltaT, 0.1f);
 
-  const float modDeltaT = _lastDeltaT * _timeModulator;
-  _totalTimePassed += modDeltaT;
+  _modDeltaT = _lastDeltaT * _timeModulator;
+  _totalTimePassed += _modDeltaT;
   _lastUpdate = TimingHelper::getMicroseconds();
 
+  if (_taskGraph.getNodeCount() == 0u)
   {
-    _INTR_PROFILE_CPU("TaskManager", "Non-Rendering Tasks");
-
-    // Events and input
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Pump Events");
-
-      Input::System::reset();
-      SystemEventProvider::SDL::pumpEvents();
-    }
-
-    // Game state update
-    {
-      GameStates::Manager::update(modDeltaT);
-    }
-
-    // Scripts
-    {
-      Components::ScriptManager::tickScripts(
-          Components::ScriptManager::_activeRefs, modDeltaT);
-    }
-
-    // Physics
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Update From Physics Results");
-
-      Components::RigidBodyManager::updateNodesFromActors(
-          Components::RigidBodyManager::_activeRefs);
-      Components::RigidBodyManager::updateActorsFromNodes(
-          Components::RigidBodyManager::_activeRefs);
-      Physics::System::renderLineDebugGeometry();
-    }
-
-    // Swarms
-    {
-      _INTR_PROFILE_CPU("TaskManager", "Swarms");
-
-      Components::SwarmManager::simulateSwarms(
-          Components::SwarmManager::_activeRefs, modDeltaT);
-    }
-
-    // Update the day/night cycle
-    {
-      World::updateDayNightCycle(modDeltaT);
-    }
-
-    // Post effect system
-    {
-      Components::PostEffectVolumeManager::blendPostEffects(
-          Components::PostEffectVolumeManager::_activeRefs);
-    }
-
-    // Fire events
-    {
-      Resources::EventManager::fireEvents();
-    }
+    initTaskGraph();
   }
 
-  {
-    _INTR_PROFILE_CPU("TaskManager", "Rendering Tasks");
-
-    // Process physics during rendering
-    Application::_scheduler.AddTaskSetToPipe(&_physicsUpdateTaskSet);
-
-    // Rendering
-    R::RenderProcess::Default::renderFrame(modDeltaT);
+  _taskGraph.execute();
 
-    Application::_scheduler.WaitforTaskSet(&_physicsUpdateTaskSet);
-  }
+  // Release all temporary memory allocated during this frame
+  Memory::ScratchAllocator::onFrameEnded();
 
   ++_frameCounter;
 }
+
+// <-
+
+void TaskManager::dumpTaskGraph() { _taskGraph.dump(); }
 }
 }
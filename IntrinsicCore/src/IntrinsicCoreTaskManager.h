@@ -18,10 +18,31 @@ namespace Intrinsic
 {
 namespace Core
 {
+// Data accessed by the nodes of the frame task graph
+namespace FrameData
+{
+enum Flags
+{
+  kInput = 0x01u,
+  kScene = 0x02u,
+  kNodes = 0x04u,
+  kPhysics = 0x08u,
+  kWorld = 0x10u,
+  kPostEffects = 0x20u,
+  kEvents = 0x40u,
+  kRendering = 0x80u
+};
+}
+
+// <-
+
 struct TaskManager
 {
   static void executeTasks();
 
+  // Logs the frame task graph including the timings of the last frame
+  static void dumpTaskGraph();
+
   static float _lastDeltaT;
   static float _totalTimePassed;
   static uint32_t _frameCounter;
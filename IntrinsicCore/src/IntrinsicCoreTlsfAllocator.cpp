@@ -23,8 +23,255 @@ namespace Memory
 {
 namespace Tlsf
 {
-Allocator* MainAllocator::_allocator = nullptr;
+namespace
+{
+struct FreeBlockStatistics
+{
+  uint64_t freeBytes;
+  uint64_t largestFreeBlock;
+};
+
+// <-
+
+void collectFreeBlockStatistics(void* p_Ptr, size_t p_Size, int p_Used,
+                                void* p_User)
+{
+  if (p_Used)
+  {
+    return;
+  }
+
+  FreeBlockStatistics* stats = (FreeBlockStatistics*)p_User;
+  stats->freeBytes += p_Size;
+  stats->largestFreeBlock =
+      std::max(stats->largestFreeBlock, (uint64_t)p_Size);
+}
+}
+
+// <-
+
+bool Heap::addPool(uint32_t p_MinSize)
+{
+  const uint32_t poolCount = _poolCount.load(std::memory_order_relaxed);
+  const uint64_t minPoolSize =
+      (uint64_t)p_MinSize + tlsf_pool_overhead() + tlsf_alloc_overhead();
+
+  // Round up to whole pages
+  const uint64_t poolSize =
+      (std::max(minPoolSize,
+                (uint64_t)_INTR_TLSF_THREAD_HEAP_SIZE_IN_MB * 1024u * 1024u) +
+       4095u) &
+      ~4095ull;
+
+  if (poolCount >= _INTR_TLSF_MAX_POOL_COUNT ||
+      minPoolSize > tlsf_block_size_max() || poolSize > (uint32_t)-1)
+  {
+    return false;
+  }
+
+  void* mem = ::malloc((size_t)poolSize);
+  if (mem == nullptr)
+  {
+    return false;
+  }
+
+  pool_t pool = tlsf_add_pool(_allocator._memoryPool, mem, (size_t)poolSize);
+  if (pool == nullptr)
+  {
+    ::free(mem);
+    return false;
+  }
+
+  Pool& newPool = _pools[poolCount];
+  newPool.mem = mem;
+  newPool.size = (uint32_t)poolSize;
+  newPool.pool = pool;
+  _poolCount.store(poolCount + 1u, std::memory_order_release);
+
+  return true;
+}
+
+// <-
+
+void Heap::calcStatistics(HeapStatistics& p_Statistics) const
+{
+  p_Statistics.sizeInBytes = 0u;
+  p_Statistics.bytesInUse = _bytesInUse.load(std::memory_order_relaxed);
+  p_Statistics.peakBytesInUse =
+      _peakBytesInUse.load(std::memory_order_relaxed);
+
+  const uint32_t poolCount = _poolCount.load(std::memory_order_acquire);
+  for (uint32_t i = 0u; i < poolCount; ++i)
+  {
+    p_Statistics.sizeInBytes += _pools[i].size;
+  }
+  p_Statistics.fragmentation = 0.0f;
+}
+
+// <-
+
+void Heap::calcFragmentation(HeapStatistics& p_Statistics) const
+{
+  FreeBlockStatistics freeBlockStats = {};
+
+  const uint32_t poolCount = _poolCount.load(std::memory_order_acquire);
+  for (uint32_t i = 0u; i < poolCount; ++i)
+  {
+    tlsf_walk_pool(_pools[i].pool, collectFreeBlockStatistics,
+                   &freeBlockStats);
+  }
+
+  p_Statistics.fragmentation =
+      freeBlockStats.freeBytes > 0u
+          ? 1.0f - freeBlockStats.largestFreeBlock /
+                       (float)freeBlockStats.freeBytes
+          : 0.0f;
+}
+
+// <-
+
+Heap* MainAllocator::_heaps = nullptr;
+std::atomic<uint32_t> MainAllocator::_heapCount(0u);
+std::atomic<uint32_t> MainAllocator::_orphanedHeapMask(0u);
 std::once_flag MainAllocator::_onceFlag;
+thread_local MainAllocator::ThreadHeap MainAllocator::_threadHeap;
+
+static_assert(_INTR_TLSF_MAX_HEAP_COUNT <= 32u,
+              "The orphaned heaps are tracked in a 32 bit mask");
+
+// <-
+
+MainAllocator::ThreadHeap::~ThreadHeap()
+{
+  if (idx < _INTR_TLSF_MAX_HEAP_COUNT)
+  {
+    // Memory of the heap still in use is handed back via the remote free list
+    // until another thread takes over the heap
+    _orphanedHeapMask.fetch_or(1u << idx, std::memory_order_release);
+  }
+
+  // Allocations during the remaining thread shutdown use the fallback
+  idx = _INTR_TLSF_MAX_HEAP_COUNT;
+}
+
+// <-
+
+void MainAllocator::initThreadHeap()
+{
+  _INTR_TLSF_INIT_ON_DEMAND();
+
+  // Take over the heap of an exited thread if available
+  uint32_t orphanedHeapMask =
+      _orphanedHeapMask.load(std::memory_order_acquire);
+  while (orphanedHeapMask != 0u)
+  {
+    const uint32_t heapIdx = Math::calcLowestSetBit(orphanedHeapMask);
+    if (_orphanedHeapMask.compare_exchange_weak(
+            orphanedHeapMask, orphanedHeapMask & ~(1u << heapIdx),
+            std::memory_order_acquire, std::memory_order_acquire))
+    {
+      _threadHeap.idx = heapIdx;
+      return;
+    }
+  }
+
+  const uint32_t heapIdx = _heapCount.fetch_add(1u);
+  if (heapIdx >= _INTR_TLSF_MAX_HEAP_COUNT)
+  {
+    // All slots are taken by running threads
+    _threadHeap.idx = _INTR_TLSF_MAX_HEAP_COUNT;
+    return;
+  }
+
+  const uint32_t sizeInMB =
+      heapIdx == 0u ? _INTR_TLSF_SIZE_IN_MB : _INTR_TLSF_THREAD_HEAP_SIZE_IN_MB;
+  _heaps[heapIdx].init(sizeInMB * 1024u * 1024u);
+
+  _threadHeap.idx = heapIdx;
+}
+
+// <-
+
+Heap* MainAllocator::findHeap(const void* p_Mem)
+{
+  const uint32_t heapCount = getHeapCount();
+  for (uint32_t i = 0u; i < heapCount; ++i)
+  {
+    if (_heaps[i].contains(p_Mem))
+    {
+      return &_heaps[i];
+    }
+  }
+
+  return nullptr;
+}
+
+// <-
+
+void MainAllocator::getHeapStatistics(uint32_t p_HeapIdx,
+                                      HeapStatistics& p_Statistics)
+{
+  _INTR_ASSERT(p_HeapIdx < getHeapCount());
+
+  const Heap& heap = _heaps[p_HeapIdx];
+  if (!heap._initialized.load(std::memory_order_acquire))
+  {
+    p_Statistics = {};
+    return;
+  }
+
+  heap.calcStatistics(p_Statistics);
+  if (p_HeapIdx == _threadHeap.idx)
+  {
+    heap.calcFragmentation(p_Statistics);
+  }
+}
+
+// <-
+
+void MainAllocator::updateMemoryStats()
+{
+#if defined(_INTR_PROFILING_ENABLED)
+  static MicroProfileToken tokens[_INTR_TLSF_MAX_HEAP_COUNT][4u];
+  static uint32_t initializedTokenCount = 0u;
+
+  const uint32_t heapCount = getHeapCount();
+  for (; initializedTokenCount < heapCount; ++initializedTokenCount)
+  {
+    static char charBuffer[128];
+    sprintf(charBuffer, "TLSF Heap %u/Size (MB)", initializedTokenCount);
+    tokens[initializedTokenCount][0] = MicroProfileGetCounterToken(charBuffer);
+
+    sprintf(charBuffer, "TLSF Heap %u/In Use (MB)", initializedTokenCount);
+    tokens[initializedTokenCount][1] = MicroProfileGetCounterToken(charBuffer);
+
+    sprintf(charBuffer, "TLSF Heap %u/Peak (MB)", initializedTokenCount);
+    tokens[initializedTokenCount][2] = MicroProfileGetCounterToken(charBuffer);
+
+    sprintf(charBuffer, "TLSF Heap %u/Fragmentation (%%)",
+            initializedTokenCount);
+    tokens[initializedTokenCount][3] = MicroProfileGetCounterToken(charBuffer);
+  }
+
+  for (uint32_t heapIdx = 0u; heapIdx < heapCount; ++heapIdx)
+  {
+    HeapStatistics stats;
+    getHeapStatistics(heapIdx, stats);
+
+    MicroProfileCounterSet(
+        tokens[heapIdx][0],
+        (uint64_t)Math::bytesToMegaBytes((uint32_t)stats.sizeInBytes));
+    MicroProfileCounterSet(
+        tokens[heapIdx][1],
+        (uint64_t)Math::bytesToMegaBytes((uint32_t)stats.bytesInUse));
+    MicroProfileCounterSet(
+        tokens[heapIdx][2],
+        (uint64_t)Math::bytesToMegaBytes((uint32_t)stats.peakBytesInUse));
+    MicroProfileCounterSet(tokens[heapIdx][3],
+                           (uint64_t)(stats.fragmentation * 100.0f));
+  }
+#endif // _INTR_PROFILING_ENABLED
+}
 }
 }
 }
@@ -14,11 +14,16 @@
 
 #pragma once
 
+// Size of the heap of the first thread allocating memory (usually the main
+// thread) and of the heaps of all other threads. Heaps running out of memory
+// grow by pools of at least the thread heap size
 #define _INTR_TLSF_SIZE_IN_MB 256u
+#define _INTR_TLSF_THREAD_HEAP_SIZE_IN_MB 64u
+#define _INTR_TLSF_MAX_HEAP_COUNT 32u
+#define _INTR_TLSF_MAX_POOL_COUNT 16u
 #define _INTR_TLSF_INIT_ON_DEMAND()                                            \
-  std::call_once(_onceFlag, []() {                                             \
-    _allocator = new Allocator(_INTR_TLSF_SIZE_IN_MB * 1024u * 1024u);         \
-  });
+  std::call_once(_onceFlag,                                                    \
+                 []() { _heaps = new Heap[_INTR_TLSF_MAX_HEAP_COUNT](); });
 
 namespace Intrinsic
 {
@@ -81,20 +86,266 @@ struct Allocator
   void* _mem;
 };
 
+struct HeapStatistics
+{
+  uint64_t sizeInBytes;
+  uint64_t bytesInUse;
+  uint64_t peakBytesInUse;
+
+  // Zero if all free memory is available as a single block, approaches one
+  // the more the free memory is scattered across smaller blocks
+  float fragmentation;
+};
+
+// <-
+
+// TLSF heap owned by a single thread. Other threads hand back memory via a
+// lock-free list which is processed by the owning thread
+struct Heap
+{
+  struct Pool
+  {
+    void* mem;
+    uint32_t size;
+    pool_t pool;
+  };
+
+  // <-
+
+  _INTR_INLINE void init(uint32_t p_Size)
+  {
+    _allocator = Allocator(p_Size);
+    _pools[0].mem = _allocator._mem;
+    _pools[0].size = p_Size;
+    _pools[0].pool = tlsf_get_pool(_allocator._memoryPool);
+    _poolCount.store(1u, std::memory_order_relaxed);
+    _remoteFreeList = nullptr;
+    _bytesInUse = 0u;
+    _peakBytesInUse = 0u;
+
+    _initialized.store(true, std::memory_order_release);
+  }
+
+  // <-
+
+  _INTR_INLINE bool contains(const void* p_Mem) const
+  {
+    if (!_initialized.load(std::memory_order_acquire))
+    {
+      return false;
+    }
+
+    const uint32_t poolCount = _poolCount.load(std::memory_order_acquire);
+    for (uint32_t i = 0u; i < poolCount; ++i)
+    {
+      const Pool& pool = _pools[i];
+      if (p_Mem >= pool.mem && p_Mem < (const uint8_t*)pool.mem + pool.size)
+      {
+        return true;
+      }
+    }
+
+    return false;
+  }
+
+  // <-
+
+  // Returns nullptr if the heap is exhausted and can't grow any further
+  _INTR_INLINE void* allocate(uint32_t p_Size)
+  {
+    processRemoteFrees();
+
+    void* mem = tlsf_malloc(_allocator._memoryPool, p_Size);
+    if (mem == nullptr && addPool(p_Size))
+    {
+      mem = tlsf_malloc(_allocator._memoryPool, p_Size);
+    }
+
+    if (mem == nullptr)
+    {
+      return nullptr;
+    }
+
+    const uint64_t bytesInUse =
+        _bytesInUse.load(std::memory_order_relaxed) + tlsf_block_size(mem);
+    _bytesInUse.store(bytesInUse, std::memory_order_relaxed);
+    if (bytesInUse > _peakBytesInUse.load(std::memory_order_relaxed))
+    {
+      _peakBytesInUse.store(bytesInUse, std::memory_order_relaxed);
+    }
+
+    return mem;
+  }
+
+  // <-
+
+  // Has to be called by the owning thread
+  _INTR_INLINE void free(void* p_Mem)
+  {
+    _bytesInUse.store(_bytesInUse.load(std::memory_order_relaxed) -
+                          tlsf_block_size(p_Mem),
+                      std::memory_order_relaxed);
+    _allocator.free(p_Mem);
+  }
+
+  // <-
+
+  // Can be called from any thread, the memory is released the next time the
+  // owning thread allocates memory
+  _INTR_INLINE void freeRemote(void* p_Mem)
+  {
+    void* head = _remoteFreeList.load(std::memory_order_relaxed);
+    do
+    {
+      *(void**)p_Mem = head;
+    } while (!_remoteFreeList.compare_exchange_weak(
+        head, p_Mem, std::memory_order_release, std::memory_order_relaxed));
+  }
+
+  // <-
+
+  bool addPool(uint32_t p_MinSize);
+
+  // <-
+
+  _INTR_INLINE void processRemoteFrees()
+  {
+    if (_remoteFreeList.load(std::memory_order_relaxed) == nullptr)
+    {
+      return;
+    }
+
+    void* mem = _remoteFreeList.exchange(nullptr, std::memory_order_acquire);
+    while (mem != nullptr)
+    {
+      void* next = *(void**)mem;
+      free(mem);
+      mem = next;
+    }
+  }
+
+  // <-
+
+  // Doesn't include the fragmentation, calculating it has to happen on the
+  // owning thread
+  void calcStatistics(HeapStatistics& p_Statistics) const;
+  void calcFragmentation(HeapStatistics& p_Statistics) const;
+
+  Allocator _allocator;
+
+  // Only appended to by the owning thread
+  Pool _pools[_INTR_TLSF_MAX_POOL_COUNT];
+  std::atomic<uint32_t> _poolCount;
+
+  std::atomic<void*> _remoteFreeList;
+  std::atomic<uint64_t> _bytesInUse;
+  std::atomic<uint64_t> _peakBytesInUse;
+  std::atomic<bool> _initialized;
+};
+
+// <-
+
+// Allocates from a TLSF heap owned by the calling thread, so threads never
+// have to synchronize when allocating memory. Memory freed by a thread not
+// owning the corresponding heap is queued up and released by the owner. The
+// heaps of exited threads are handed to the next new thread
 struct MainAllocator
 {
-  static void* allocate(uint32_t p_Size)
+  _INTR_INLINE static void* allocate(uint32_t p_Size)
   {
-    _INTR_TLSF_INIT_ON_DEMAND();
+    Heap* threadHeap = getThreadHeap();
+
+    void* mem = threadHeap != nullptr ? threadHeap->allocate(p_Size) : nullptr;
+    if (mem == nullptr)
+    {
+      // Fall back to the system allocator if all heap slots are taken or the
+      // heap can't grow any further
+      mem = ::malloc(p_Size);
+      _INTR_ASSERT(mem && "Allocation failed");
+    }
+
+    return mem;
+  }
+
+  // <-
+
+  _INTR_INLINE static void free(void* p_Mem)
+  {
+    _INTR_ASSERT(p_Mem && "Tried to free nullptr");
+
+    const uint32_t threadHeapIdx = _threadHeap.idx;
+    if (threadHeapIdx < _INTR_TLSF_MAX_HEAP_COUNT &&
+        _heaps[threadHeapIdx].contains(p_Mem))
+    {
+      _heaps[threadHeapIdx].free(p_Mem);
+      return;
+    }
 
-    return _allocator->allocate(p_Size);
+    Heap* heap = findHeap(p_Mem);
+    if (heap != nullptr)
+    {
+      heap->freeRemote(p_Mem);
+      return;
+    }
+
+    // Allocated by the fallback
+    ::free(p_Mem);
+  }
+
+  // <-
+
+  _INTR_INLINE static uint32_t getHeapCount()
+  {
+    return std::min(_heapCount.load(std::memory_order_acquire),
+                    _INTR_TLSF_MAX_HEAP_COUNT);
   }
 
-  static void free(void* p_Mem) { _allocator->free(p_Mem); }
+  // <-
+
+  // The fragmentation is only calculated for the heap owned by the calling
+  // thread, walking the blocks of other heaps would race with their owners
+  static void getHeapStatistics(uint32_t p_HeapIdx,
+                                HeapStatistics& p_Statistics);
+
+  // <-
+
+  // Updates the profiler counters of all heaps
+  static void updateMemoryStats();
 
 private:
-  static Allocator* _allocator;
+  // Hands the heap back once the thread exits
+  struct ThreadHeap
+  {
+    ~ThreadHeap();
+
+    // Set to _INTR_TLSF_MAX_HEAP_COUNT if the thread has no heap
+    uint32_t idx = (uint32_t)-1;
+  };
+
+  // <-
+
+  _INTR_INLINE static Heap* getThreadHeap()
+  {
+    if (_threadHeap.idx == (uint32_t)-1)
+    {
+      initThreadHeap();
+    }
+
+    return _threadHeap.idx < _INTR_TLSF_MAX_HEAP_COUNT
+               ? &_heaps[_threadHeap.idx]
+               : nullptr;
+  }
+
+  // <-
+
+  static void initThreadHeap();
+  static Heap* findHeap(const void* p_Mem);
+
+  static Heap* _heaps;
+  static std::atomic<uint32_t> _heapCount;
+  static std::atomic<uint32_t> _orphanedHeapMask;
   static std::once_flag _onceFlag;
+  static thread_local ThreadHeap _threadHeap;
 };
 }
 }
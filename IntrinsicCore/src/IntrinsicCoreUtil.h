@@ -31,6 +31,116 @@ _INTR_INLINE bool fileExists(const char* p_FilePath)
 
   return false;
 }
+
+// <-
+
+struct MappedFile
+{
+  MappedFile()
+      : data(nullptr), sizeInBytes(0u), fileHandle(nullptr),
+        mappingHandle(nullptr)
+  {
+  }
+
+  void* data;
+  uint64_t sizeInBytes;
+
+  void* fileHandle;
+  void* mappingHandle;
+};
+
+// <-
+
+// Maps the given file read-only into the address space of the process
+_INTR_INLINE bool mapFile(const char* p_FilePath, MappedFile& p_MappedFile)
+{
+  p_MappedFile = MappedFile();
+
+#if defined(_WIN32)
+  HANDLE file = CreateFileA(p_FilePath, GENERIC_READ, FILE_SHARE_READ, NULL,
+                            OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (file == INVALID_HANDLE_VALUE)
+  {
+    return false;
+  }
+
+  LARGE_INTEGER fileSize;
+  if (!GetFileSizeEx(file, &fileSize) || fileSize.QuadPart == 0u)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0u, 0u, NULL);
+  if (mapping == NULL)
+  {
+    CloseHandle(file);
+    return false;
+  }
+
+  void* data = MapViewOfFile(mapping, FILE_MAP_READ, 0u, 0u, 0u);
+  if (data == nullptr)
+  {
+    CloseHandle(mapping);
+    CloseHandle(file);
+    return false;
+  }
+
+  p_MappedFile.data = data;
+  p_MappedFile.sizeInBytes = (uint64_t)fileSize.QuadPart;
+  p_MappedFile.fileHandle = file;
+  p_MappedFile.mappingHandle = mapping;
+#else
+  const int file = open(p_FilePath, O_RDONLY);
+  if (file == -1)
+  {
+    return false;
+  }
+
+  struct stat fileStat;
+  if (fstat(file, &fileStat) == -1 || fileStat.st_size == 0)
+  {
+    close(file);
+    return false;
+  }
+
+  void* data =
+      mmap(nullptr, (size_t)fileStat.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+
+  // The mapping stays valid after closing the descriptor
+  close(file);
+
+  if (data == MAP_FAILED)
+  {
+    return false;
+  }
+
+  p_MappedFile.data = data;
+  p_MappedFile.sizeInBytes = (uint64_t)fileStat.st_size;
+#endif // _WIN32
+
+  return true;
+}
+
+// <-
+
+_INTR_INLINE void unmapFile(MappedFile& p_MappedFile)
+{
+  if (p_MappedFile.data == nullptr)
+  {
+    return;
+  }
+
+#if defined(_WIN32)
+  UnmapViewOfFile(p_MappedFile.data);
+  CloseHandle((HANDLE)p_MappedFile.mappingHandle);
+  CloseHandle((HANDLE)p_MappedFile.fileHandle);
+#else
+  munmap(p_MappedFile.data, (size_t)p_MappedFile.sizeInBytes);
+#endif // _WIN32
+
+  p_MappedFile = MappedFile();
+}
 }
 }
 }
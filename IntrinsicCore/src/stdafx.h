@@ -18,6 +18,12 @@
 #if defined(_WIN32)
 #define NOMINMAX
 #include "windows.h"
+#else
+// POSIX includes
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #endif // _WIN32
 
 // GLM and GLI related includes
@@ -57,6 +63,14 @@
 // Sparsepp
 #include "sparsepp/spp.h"
 
+// SIMD related includes
+#include <immintrin.h>
+#if defined(_WIN32)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif // _WIN32
+
 // STL related includes
 #include "stdint.h"
 #include "assert.h"
@@ -155,6 +169,7 @@ namespace CComponents = Intrinsic::Core::Components;
 #include "IntrinsicCoreSettingsManager.h"
 #include "IntrinsicCoreLockFreeStack.h"
 #include "IntrinsicCoreLinearOffsetAllocator.h"
+#include "IntrinsicCoreScratchAllocator.h"
 #include "IntrinsicCoreLockFreeFixedBlockAllocator.h"
 #include "IntrinsicCoreStringUtil.h"
 #include "IntrinsicCoreUtil.h"
@@ -175,6 +190,8 @@ namespace CComponents = Intrinsic::Core::Components;
 #include "IntrinsicCoreResourcesFrustum.h"
 #include "IntrinsicCoreResourcesMesh.h"
 #include "IntrinsicCoreComponentsNode.h"
+#include "IntrinsicCoreCullingKernel.h"
+#include "IntrinsicCoreCullingBvh.h"
 #include "IntrinsicCoreComponentsMesh.h"
 #include "IntrinsicCoreComponentsSwarm.h"
 #include "IntrinsicCoreComponentsRigidBody.h"
@@ -192,6 +209,7 @@ namespace CComponents = Intrinsic::Core::Components;
 #include "IntrinsicCoreComponentsPostEffectVolume.h"
 #include "IntrinsicCoreRenderingSkyModel.h"
 
+#include "IntrinsicCoreTaskGraph.h"
 #include "IntrinsicCoreTaskManager.h"
 #include "IntrinsicCorePhysicsSystem.h"
 #include "IntrinsicCoreInputSystem.h"
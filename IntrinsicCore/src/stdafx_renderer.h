@@ -40,6 +40,7 @@
 #include "IntrinsicRendererSamplers.h"
 #include "IntrinsicRendererGpuMemoryManager.h"
 #include "IntrinsicRendererRenderSystem.h"
+#include "IntrinsicRendererUploadQueue.h"
 #include "IntrinsicRendererRenderProcessUniformManager.h"
 #include "IntrinsicRendererRenderProcess.h"
 #include "IntrinsicRendererDebugging.h"
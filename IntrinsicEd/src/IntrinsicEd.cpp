@@ -74,6 +74,9 @@ IntrinsicEd::IntrinsicEd(QWidget* parent) : QMainWindow(parent)
   // Loading settings file
   Settings::Manager::loadSettings();
 
+  // The editor relies on the editable JSON description of meshes
+  Settings::Manager::_binaryMeshesEnabled = false;
+
   // Initializes event system
   Application::initEventSystem();
 
@@ -82,7 +85,6 @@ IntrinsicEd::IntrinsicEd(QWidget* parent) : QMainWindow(parent)
 
   // Initializes Intrinsic
   Application::init(GetModuleHandle(NULL), (void*)_ui.viewPort->winId());
-  Rendering::IBL::initCubemapProcessing();
 
   // Activate editing game state
   GameStates::Manager::activate(GameStates::GameState::kEditing);
@@ -269,6 +271,9 @@ IntrinsicEd::IntrinsicEd(QWidget* parent) : QMainWindow(parent)
   QObject::connect(_ui.actionRecompile_Shaders, SIGNAL(triggered()), this,
                    SLOT(onRecompileShaders()));
 
+  QObject::connect(_ui.actionDump_Task_Graph, SIGNAL(triggered()), this,
+                   SLOT(onDumpTaskGraph()));
+
   _editingView = new QDockWidget();
   _editingView->setObjectName("editingView");
   addDockWidget(Qt::RightDockWidgetArea, _editingView);
@@ -888,6 +893,8 @@ void IntrinsicEd::onRecompileShaders()
   GpuProgramManager::compileAllShaders(true);
 }
 
+void IntrinsicEd::onDumpTaskGraph() { TaskManager::dumpTaskGraph(); }
+
 void IntrinsicEd::onSettingsFileChanged(const QString&)
 {
   _settingsUpdatePending = true;
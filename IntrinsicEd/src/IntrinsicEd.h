@@ -103,6 +103,7 @@ public slots:
   void onOpenMicroprofile();
   void onCompileShaders();
   void onRecompileShaders();
+  void onDumpTaskGraph();
   void onSettingsFileChanged(const QString&);
   void onCaptureAllProbes();
 
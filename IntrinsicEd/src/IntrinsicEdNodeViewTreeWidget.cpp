@@ -101,7 +101,7 @@ void IntrinsicEdNodeViewTreeWidget::onPopulateNodeTree()
     const Name& name = Entity::EntityManager::_name(entityRef);
 
     QTreeWidgetItem* item = nullptr;
-    QString nodeTitle = name.getString().c_str();
+    QString nodeTitle = name.getCString();
 
     if (!Components::NodeManager::_parent(nodeRef).isValid())
     {
@@ -415,8 +415,7 @@ void IntrinsicEdNodeViewTreeWidget::createNode(QTreeWidgetItem* p_Parent)
 
       item->setText(0, Entity::EntityManager::_name(
                            Components::NodeManager::_entity(nodeRef))
-                           .getString()
-                           .c_str());
+                           .getCString());
       item->setIcon(0, QIcon(":/Icons/target"));
     }
     else
@@ -427,8 +426,7 @@ void IntrinsicEdNodeViewTreeWidget::createNode(QTreeWidgetItem* p_Parent)
 
       item->setText(0, Entity::EntityManager::_name(
                            Components::NodeManager::_entity(nodeRef))
-                           .getString()
-                           .c_str());
+                           .getCString());
       item->setIcon(0, QIcon(":/Icons/globe"));
     }
 
@@ -619,7 +617,7 @@ void IntrinsicEdNodeViewTreeWidget::onItemChanged(QTreeWidgetItem* item,
       {
         Entity::EntityManager::rename(entityRef, newName);
         item->setText(
-            0, Entity::EntityManager::_name(entityRef).getString().c_str());
+            0, Entity::EntityManager::_name(entityRef).getCString());
       }
     }
   }
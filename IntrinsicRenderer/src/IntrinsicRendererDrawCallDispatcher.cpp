@@ -21,6 +21,76 @@ namespace Renderer
 {
 namespace
 {
+struct BindCounts
+{
+  uint32_t pipelineBinds;
+  uint32_t descriptorSetBinds;
+  uint32_t vertexBufferBinds;
+};
+
+// <-
+
+struct RenderPassBindStatistics
+{
+  BindCounts countsPerFrame;
+
+  uint64_t pipelineBindsCounter;
+  uint64_t descriptorSetBindsCounter;
+  uint64_t vertexBufferBindsCounter;
+  bool countersCreated;
+};
+
+RenderPassBindStatistics _bindStatsPerRenderPass[_INTR_MAX_RENDER_PASS_COUNT];
+
+// <-
+
+_INTR_INLINE bool
+areVertexBuffersEqual(Resources::DrawCallRef p_DrawCallRef,
+                      Resources::DrawCallRef p_PrevDrawCallRef)
+{
+  const _INTR_ARRAY(VkBuffer)& vtxBuffers =
+      Resources::DrawCallManager::_vertexBuffers(p_DrawCallRef);
+  const _INTR_ARRAY(VkBuffer)& prevVtxBuffers =
+      Resources::DrawCallManager::_vertexBuffers(p_PrevDrawCallRef);
+
+  return vtxBuffers == prevVtxBuffers &&
+         Resources::DrawCallManager::_vertexBufferOffsets(p_DrawCallRef) ==
+             Resources::DrawCallManager::_vertexBufferOffsets(
+                 p_PrevDrawCallRef);
+}
+
+// <-
+
+_INTR_INLINE bool
+areDescriptorSetsEqual(Resources::DrawCallRef p_DrawCallRef,
+                       Resources::DrawCallRef p_PrevDrawCallRef)
+{
+  return Resources::DrawCallManager::_vkDescriptorSet(p_DrawCallRef) ==
+             Resources::DrawCallManager::_vkDescriptorSet(p_PrevDrawCallRef) &&
+         Resources::DrawCallManager::_dynamicOffsets(p_DrawCallRef) ==
+             Resources::DrawCallManager::_dynamicOffsets(p_PrevDrawCallRef);
+}
+
+// <-
+
+void createBindCounters(RenderPassBindStatistics& p_Stats,
+                        Resources::RenderPassRef p_RenderPass)
+{
+  const _INTR_STRING prefix =
+      "Draw Call Binds/" +
+      Resources::RenderPassManager::_name(p_RenderPass).getString();
+
+  p_Stats.pipelineBindsCounter =
+      _INTR_PROFILE_COUNTER_GET_TOKEN((prefix + "/Pipelines").c_str());
+  p_Stats.descriptorSetBindsCounter =
+      _INTR_PROFILE_COUNTER_GET_TOKEN((prefix + "/Descriptor Sets").c_str());
+  p_Stats.vertexBufferBindsCounter =
+      _INTR_PROFILE_COUNTER_GET_TOKEN((prefix + "/Vertex Buffers").c_str());
+  p_Stats.countersCreated = true;
+}
+
+// <-
+
 struct DrawCallParallelTaskSet : enki::ITaskSet
 {
   void ExecuteRange(enki::TaskSetPartition p_Range, uint32_t p_ThreadNum)
@@ -36,6 +106,10 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
         *RenderSystem::getSecondaryCommandBuffers(_secondaryCmdBufferIdx);
 
     VkPipeline currentPipeline = VK_NULL_HANDLE;
+    VkBuffer currentIndexBuffer = VK_NULL_HANDLE;
+    Resources::DrawCallRef prevDrawCallRef;
+    _bindCounts = {};
+    uint32_t skippedDrawCallCount = 0u;
 
     for (uint32_t dcIdx = _rangeStart; dcIdx < _rangeEnd; ++dcIdx)
     {
@@ -49,28 +123,50 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
 
       VkPipeline newPipeline =
           Resources::PipelineManager::_vkPipeline(pipelineRef);
-      if (newPipeline != currentPipeline)
+
+      // Skip draw calls whose pipeline is still being created
+      if (newPipeline == VK_NULL_HANDLE)
+      {
+        ++skippedDrawCallCount;
+        continue;
+      }
+
+      const bool pipelineChanged = newPipeline != currentPipeline;
+      if (pipelineChanged)
       {
         vkCmdBindPipeline(secondCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                           newPipeline);
         currentPipeline = newPipeline;
+        ++_bindCounts.pipelineBinds;
       }
 
-      VkDescriptorSet descSets[2] = {
-          Resources::DrawCallManager::_vkDescriptorSet(drawCallRef),
-          Resources::ImageManager::_globalTextureDescriptorSet};
+      const bool prevDrawCallValid = prevDrawCallRef.isValid();
 
-      _INTR_ASSERT(Resources::DrawCallManager::_vkDescriptorSet(drawCallRef));
-      vkCmdBindDescriptorSets(
-          secondCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
-          Resources::PipelineLayoutManager::_vkPipelineLayout(
-              pipelineLayoutRef),
-          0u, 2u, descSets,
-          (uint32_t)Resources::DrawCallManager::_dynamicOffsets(drawCallRef)
-              .size(),
-          Resources::DrawCallManager::_dynamicOffsets(drawCallRef).data());
+      // The pipeline layout might change with the pipeline, so always rebind
+      // the descriptor sets in this case
+      if (pipelineChanged || !prevDrawCallValid ||
+          !areDescriptorSetsEqual(drawCallRef, prevDrawCallRef))
+      {
+        VkDescriptorSet descSets[2] = {
+            Resources::DrawCallManager::_vkDescriptorSet(drawCallRef),
+            Resources::ImageManager::_globalTextureDescriptorSet};
+
+        _INTR_ASSERT(
+            Resources::DrawCallManager::_vkDescriptorSet(drawCallRef));
+        vkCmdBindDescriptorSets(
+            secondCmdBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
+            Resources::PipelineLayoutManager::_vkPipelineLayout(
+                pipelineLayoutRef),
+            0u, 2u, descSets,
+            (uint32_t)Resources::DrawCallManager::_dynamicOffsets(drawCallRef)
+                .size(),
+            Resources::DrawCallManager::_dynamicOffsets(drawCallRef).data());
+        ++_bindCounts.descriptorSetBinds;
+      }
 
       // Bind vertex buffers
+      if (!prevDrawCallValid ||
+          !areVertexBuffersEqual(drawCallRef, prevDrawCallRef))
       {
         _INTR_ARRAY(VkBuffer)& vtxBuffers =
             Resources::DrawCallManager::_vertexBuffers(drawCallRef);
@@ -78,8 +174,11 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
             secondCmdBuffer, 0u, (uint32_t)vtxBuffers.size(), vtxBuffers.data(),
             Resources::DrawCallManager::_vertexBufferOffsets(drawCallRef)
                 .data());
+        ++_bindCounts.vertexBufferBinds;
       }
 
+      prevDrawCallRef = drawCallRef;
+
       // Draw
       {
         Resources::BufferRef indexBufferRef =
@@ -91,22 +190,29 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
                       BufferType::kIndex16
                   ? VK_INDEX_TYPE_UINT16
                   : VK_INDEX_TYPE_UINT32;
-          vkCmdBindIndexBuffer(
-              secondCmdBuffer,
-              Resources::BufferManager::_vkBuffer(indexBufferRef),
-              Resources::DrawCallManager::_indexBufferOffset(drawCallRef),
-              indexType);
+          VkBuffer indexBuffer =
+              Resources::BufferManager::_vkBuffer(indexBufferRef);
+
+          // Index buffer offsets are always zero for now
+          if (indexBuffer != currentIndexBuffer)
+          {
+            vkCmdBindIndexBuffer(
+                secondCmdBuffer, indexBuffer,
+                Resources::DrawCallManager::_indexBufferOffset(drawCallRef),
+                indexType);
+            currentIndexBuffer = indexBuffer;
+          }
           vkCmdDrawIndexed(
               secondCmdBuffer,
               Resources::DrawCallManager::_descIndexCount(drawCallRef),
-              Resources::DrawCallManager::_descInstanceCount(drawCallRef), 0u,
+              Resources::DrawCallManager::_instanceCount(drawCallRef), 0u,
               0u, 0u);
         }
         else
         {
           vkCmdDraw(secondCmdBuffer,
                     Resources::DrawCallManager::_descVertexCount(drawCallRef),
-                    Resources::DrawCallManager::_descInstanceCount(drawCallRef),
+                    Resources::DrawCallManager::_instanceCount(drawCallRef),
                     0u, 0u);
         }
 
@@ -115,6 +221,7 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
     }
 
     RenderSystem::endSecondaryCommandBuffer(_secondaryCmdBufferIdx);
+    DrawCallDispatcher::_skippedDrawCallCount += skippedDrawCallCount;
   }
 
   uint32_t _secondaryCmdBufferIdx;
@@ -124,6 +231,8 @@ struct DrawCallParallelTaskSet : enki::ITaskSet
 
   uint32_t _rangeStart;
   uint32_t _rangeEnd;
+
+  BindCounts _bindCounts;
 };
 
 DrawCallParallelTaskSet _tasks[_INTR_VK_SECONDARY_COMMAND_BUFFER_COUNT] = {};
@@ -131,6 +240,7 @@ uint32_t _activeTaskCount = 0u;
 }
 
 std::atomic<uint32_t> DrawCallDispatcher::_dispatchedDrawCallCount;
+std::atomic<uint32_t> DrawCallDispatcher::_skippedDrawCallCount;
 uint32_t DrawCallDispatcher::_totalDispatchedDrawCallCountPerFrame = 0u;
 uint32_t DrawCallDispatcher::_totalDispatchCallsPerFrame = 0u;
 
@@ -184,6 +294,14 @@ void DrawCallDispatcher::queueDrawCalls(Core::Dod::RefArray& p_DrawCalls,
   {
     _INTR_PROFILE_CPU("General", "Wait For Draw Calls");
 
+    RenderPassBindStatistics& bindStats =
+        _bindStatsPerRenderPass[p_RenderPass._id];
+    if (!bindStats.countersCreated)
+    {
+      createBindCounters(bindStats, p_RenderPass);
+    }
+    BindCounts& bindCounts = bindStats.countsPerFrame;
+
     for (uint32_t taskIdx = firstTaskIndex;
          taskIdx < firstTaskIndex + tasksQueued; ++taskIdx)
     {
@@ -191,6 +309,11 @@ void DrawCallDispatcher::queueDrawCalls(Core::Dod::RefArray& p_DrawCalls,
       vkCmdExecuteCommands(primaryCmdBuffer, 1u,
                            RenderSystem::getSecondaryCommandBuffers(
                                _tasks[taskIdx]._secondaryCmdBufferIdx));
+
+      const BindCounts& taskBindCounts = _tasks[taskIdx]._bindCounts;
+      bindCounts.pipelineBinds += taskBindCounts.pipelineBinds;
+      bindCounts.descriptorSetBinds += taskBindCounts.descriptorSetBinds;
+      bindCounts.vertexBufferBinds += taskBindCounts.vertexBufferBinds;
     }
   }
 
@@ -206,10 +329,32 @@ void DrawCallDispatcher::onFrameEnded()
                             _totalDispatchedDrawCallCountPerFrame);
   _INTR_PROFILE_COUNTER_SET("Total Draw Call Dispatch Calls",
                             _totalDispatchCallsPerFrame);
+  _INTR_PROFILE_COUNTER_SET("Skipped Draw Calls (Pipeline Not Ready)",
+                            _skippedDrawCallCount);
 
   _totalDispatchCallsPerFrame = 0u;
   _totalDispatchedDrawCallCountPerFrame = 0u;
+  _skippedDrawCallCount = 0u;
   _activeTaskCount = 0u;
+
+  for (uint32_t i = 0u; i < _INTR_MAX_RENDER_PASS_COUNT; ++i)
+  {
+    RenderPassBindStatistics& bindStats = _bindStatsPerRenderPass[i];
+    if (!bindStats.countersCreated)
+    {
+      continue;
+    }
+
+    _INTR_PROFILE_COUNTER_TOKEN_SET(bindStats.pipelineBindsCounter,
+                                    bindStats.countsPerFrame.pipelineBinds);
+    _INTR_PROFILE_COUNTER_TOKEN_SET(
+        bindStats.descriptorSetBindsCounter,
+        bindStats.countsPerFrame.descriptorSetBinds);
+    _INTR_PROFILE_COUNTER_TOKEN_SET(bindStats.vertexBufferBindsCounter,
+                                    bindStats.countsPerFrame.vertexBufferBinds);
+
+    bindStats.countsPerFrame = {};
+  }
 }
 }
 }
@@ -26,6 +26,8 @@ struct DrawCallDispatcher
                              Core::Dod::Ref p_Framebuffer);
 
   static std::atomic<uint32_t> _dispatchedDrawCallCount;
+  // Draw calls skipped because their pipeline was not created yet
+  static std::atomic<uint32_t> _skippedDrawCallCount;
   static uint32_t _totalDispatchedDrawCallCountPerFrame;
   static uint32_t _totalDispatchCallsPerFrame;
 };
@@ -161,6 +161,7 @@ enum Enum
   kUniformBuffer,
   kUniformBufferDynamic,
   kStorageBuffer,
+  kStorageBufferDynamic,
 
   kImageAndSamplerCombined,
   kSampledImage,
@@ -171,7 +172,7 @@ enum Enum
   kCount,
 
   kRangeStartBuffer = kUniformBuffer,
-  kRangeEndBuffer = kStorageBuffer,
+  kRangeEndBuffer = kStorageBufferDynamic,
   kRangeStartImage = kImageAndSamplerCombined,
   kRangeEndImage = kStorageImage
 };
@@ -235,6 +236,8 @@ enum Enum
   kPerFrameFragment,
   kPerFrameVertex,
 
+  kPerViewVertex,
+
   kInvalidUbo,
 
   kCount,
@@ -253,7 +256,8 @@ namespace RenderOrder
 enum Enum
 {
   kFrontToBack,
-  kBackToFront
+  kBackToFront,
+  kStateFirst
 };
 }
 
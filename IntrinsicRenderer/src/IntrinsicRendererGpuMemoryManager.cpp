@@ -168,6 +168,24 @@ GpuMemoryManager::allocateOffset(MemoryPoolType::Enum p_MemoryPoolType,
 
 // <-
 
+GpuMemoryAllocationInfo GpuMemoryManager::allocatePersistentOffset(
+    MemoryPoolType::Enum p_MemoryPoolType, uint32_t p_Size,
+    uint32_t p_Alignment, uint32_t p_MemoryTypeFlags)
+{
+  const GpuMemoryAllocationInfo allocInfo = allocateOffset(
+      p_MemoryPoolType, p_Size, p_Alignment, p_MemoryTypeFlags);
+
+  // Move the offset the page gets reset to behind the allocation
+  Core::Memory::LinearOffsetAllocator& allocator =
+      _memoryPools[p_MemoryPoolType][allocInfo._pageIdx]._allocator;
+  const uint32_t persistentEnd = allocator.currentOffset();
+  allocator.init(_INTR_GPU_PAGE_SIZE_IN_BYTES - persistentEnd, persistentEnd);
+
+  return allocInfo;
+}
+
+// <-
+
 void GpuMemoryManager::updateMemoryStats()
 {
 #if defined(_INTR_PROFILING_ENABLED)
@@ -39,6 +39,13 @@ struct GpuMemoryManager
   static GpuMemoryAllocationInfo
   allocateOffset(MemoryPoolType::Enum p_MemoryPoolType, uint32_t p_Size,
                  uint32_t p_Alignment, uint32_t p_MemoryTypeFlags);
+
+  // Allocates memory which is not affected by later resets of the pool
+  static GpuMemoryAllocationInfo
+  allocatePersistentOffset(MemoryPoolType::Enum p_MemoryPoolType,
+                           uint32_t p_Size, uint32_t p_Alignment,
+                           uint32_t p_MemoryTypeFlags);
+
   // <-
 
   _INTR_INLINE static void resetPool(MemoryPoolType::Enum p_MemoryPoolType)
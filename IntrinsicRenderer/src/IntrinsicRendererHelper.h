@@ -198,6 +198,8 @@ mapBindingTypeToVkDescriptorType(BindingType::Enum p_BindingType)
     return VK_DESCRIPTOR_TYPE_SAMPLER;
   case BindingType::kStorageBuffer:
     return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+  case BindingType::kStorageBufferDynamic:
+    return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
   case BindingType::kStorageImage:
     return VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
   default:
@@ -767,6 +769,26 @@ mapBlendState(const _INTR_STRING& p_BlendSate)
   _INTR_ASSERT(false && "Blend state not supported/found");
   return BlendStates::kDefault;
 }
+
+// <-
+
+_INTR_INLINE static RenderOrder::Enum
+mapRenderOrder(const _INTR_STRING& p_RenderOrder)
+{
+  static _INTR_HASH_MAP(Name, RenderOrder::Enum) renderOrders = {
+      {"FrontToBack", RenderOrder::kFrontToBack},
+      {"BackToFront", RenderOrder::kBackToFront},
+      {"StateFirst", RenderOrder::kStateFirst}};
+
+  auto renderOrder = renderOrders.find(p_RenderOrder);
+  if (renderOrder != renderOrders.end())
+  {
+    return renderOrder->second;
+  }
+
+  _INTR_ASSERT(false && "Render order not supported/found");
+  return RenderOrder::kFrontToBack;
+}
 }
 }
 }
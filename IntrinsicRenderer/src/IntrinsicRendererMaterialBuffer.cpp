@@ -21,7 +21,6 @@ namespace Renderer
 {
 // Static members
 Resources::BufferRef MaterialBuffer::_materialBuffer;
-Resources::BufferRef MaterialBuffer::_materialStagingBuffer;
 
 _INTR_ARRAY(uint32_t) MaterialBuffer::_materialBufferEntries;
 
@@ -41,23 +40,6 @@ void MaterialBuffer::init()
     buffersToCreate.push_back(_materialBuffer);
   }
 
-  _materialStagingBuffer =
-      BufferManager::createBuffer(_N(_MaterialStagingBuffer));
-  {
-    BufferManager::resetToDefault(_materialStagingBuffer);
-    BufferManager::addResourceFlags(
-        _materialStagingBuffer,
-        Dod::Resources::ResourceFlags::kResourceVolatile);
-
-    BufferManager::_descBufferType(_materialStagingBuffer) =
-        BufferType::kStorage;
-    BufferManager::_descMemoryPoolType(_materialStagingBuffer) =
-        MemoryPoolType::kStaticStagingBuffers;
-    BufferManager::_descSizeInBytes(_materialStagingBuffer) =
-        sizeof(MaterialBufferEntry);
-    buffersToCreate.push_back(_materialStagingBuffer);
-  }
-
   BufferManager::createResources(buffersToCreate);
 
   _materialBufferEntries.clear();
@@ -57,33 +57,16 @@ struct MaterialBuffer
   updateMaterialBufferEntry(const uint32_t p_Index,
                             const MaterialBufferEntry& p_MaterialBufferEntry)
   {
-    // Update staging buffer
-    {
-      memcpy(BufferManager::getGpuMemory(_materialStagingBuffer),
-             &p_MaterialBufferEntry, sizeof(MaterialBufferEntry));
-    }
-
-    // ... and copy to device
-    VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
-    VkBufferCopy bufferCopy = {};
-    {
-      bufferCopy.dstOffset = p_Index * sizeof(MaterialBufferEntry);
-      bufferCopy.srcOffset = 0u;
-      bufferCopy.size = sizeof(MaterialBufferEntry);
-    }
-
-    vkCmdCopyBuffer(copyCmd, BufferManager::_vkBuffer(_materialStagingBuffer),
-                    BufferManager::_vkBuffer(_materialBuffer), 1u, &bufferCopy);
-
-    RenderSystem::flushTemporaryCommandBuffer();
+    UploadQueue::uploadBuffer(BufferManager::_vkBuffer(_materialBuffer),
+                              p_Index * sizeof(MaterialBufferEntry),
+                              &p_MaterialBufferEntry,
+                              sizeof(MaterialBufferEntry));
   }
 
   static BufferRef _materialBuffer;
 
 private:
   static _INTR_ARRAY(uint32_t) _materialBufferEntries;
-  static BufferRef _materialStagingBuffer;
 };
 }
 }
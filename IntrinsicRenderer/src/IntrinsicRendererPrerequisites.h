@@ -38,6 +38,18 @@
   (_INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES *                                 \
    _INTR_VK_PER_MATERIAL_BLOCK_COUNT)
 
+// Per instance storage used by the instanced material passes
+#define _INTR_VK_MAX_INSTANCE_COUNT_PER_DRAW_CALL 128u
+#define _INTR_VK_PER_INSTANCE_STORAGE_SIZE_IN_BYTES (8u * 1024u * 1024u)
+#define _INTR_VK_PER_INSTANCE_STORAGE_ALIGNMENT_IN_BYTES 256u
+// The bound range always covers the max. instance count, so reserve space for
+// the largest possible range behind the last allocation
+#define _INTR_VK_PER_INSTANCE_STORAGE_MEMORY_IN_BYTES                          \
+  (_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT *                                   \
+       _INTR_VK_PER_INSTANCE_STORAGE_SIZE_IN_BYTES +                           \
+   _INTR_VK_PER_INSTANCE_BLOCK_LARGE_SIZE_IN_BYTES *                           \
+       _INTR_VK_MAX_INSTANCE_COUNT_PER_DRAW_CALL)
+
 #define _INTR_PSSM_SPLIT_COUNT 4u
 #define _INTR_MAX_SHADOW_MAP_COUNT 4u
 #define _INTR_MAX_FRUSTUMS_PER_FRAME_COUNT 16u
@@ -350,7 +350,7 @@ void Bloom::init()
   }
   pipelinesToCreate.push_back(_blurYPipelineRef);
 
-  PipelineManager::createResources(pipelinesToCreate);
+  PipelineManager::createResourcesAsync(pipelinesToCreate);
 }
 
 // <-
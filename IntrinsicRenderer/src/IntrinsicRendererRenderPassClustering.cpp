@@ -25,6 +25,13 @@
 #define MAX_SPEC_PROBES_PER_CLUSTER (8u + 2u)
 #define MAX_DECALS_PER_CLUSTER (64u + 2u)
 
+// +1 for the word count in front of the masks
+#define MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER (MAX_LIGHT_COUNT / 32u + 1u)
+
+// Stores one bit per light and cluster instead of the light index lists, has
+// to match the define in "lib_clustering.glsl"
+//#define USE_LIGHT_BITMASKS
+
 #define GRID_DEPTH_SLICE_COUNT 24u
 #define GRID_SIZE_Y 8u
 #define GRID_SIZE_X 16u
@@ -135,6 +142,31 @@ Decal* _decalBufferMemory = nullptr;
 
 uint32_t _depthSliceDirtyMask = 0u;
 
+// Conservative cluster ranges covered by the bounding spheres of the items
+struct ClusterBounds
+{
+  uint8_t minX;
+  uint8_t minY;
+  uint8_t minZ;
+  uint8_t maxX;
+  uint8_t maxY;
+  uint8_t maxZ;
+};
+
+_INTR_ARRAY(ClusterBounds) _lightBounds;
+_INTR_ARRAY(ClusterBounds) _irradProbeBounds;
+_INTR_ARRAY(ClusterBounds) _specProbeBounds;
+_INTR_ARRAY(ClusterBounds) _decalBounds;
+
+// Bounding spheres of the lights as a structure of arrays for the SIMD tests,
+// padded so the kernels can always read eight spheres at once
+_INTR_ARRAY(float) _lightSphereX;
+_INTR_ARRAY(float) _lightSphereY;
+_INTR_ARRAY(float) _lightSphereZ;
+_INTR_ARRAY(float) _lightSphereRadius;
+
+bool _lightBitmasks = false;
+
 // <-
 
 struct LightingPerInstanceData
@@ -173,6 +205,23 @@ const uint32_t _totalSpecGridSize =
     _totalClusterCount * MAX_SPEC_PROBES_PER_CLUSTER;
 const uint32_t _totalDecalGridSize =
     _totalClusterCount * MAX_DECALS_PER_CLUSTER;
+const uint32_t _totalLightMaskGridSize =
+    _totalClusterCount * MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER;
+
+// The light index buffer stores either the index lists or the bitmasks
+const uint32_t _lightIndexListsSizeInBytes =
+    _totalLightGridSize * (uint32_t)sizeof(uint16_t);
+const uint32_t _lightBitmasksSizeInBytes =
+    _totalLightMaskGridSize * (uint32_t)sizeof(uint32_t);
+#if defined(USE_LIGHT_BITMASKS)
+const uint32_t _lightIndexBufferSizeInBytes = _lightBitmasksSizeInBytes;
+#else
+const uint32_t _lightIndexBufferSizeInBytes = _lightIndexListsSizeInBytes;
+#endif // USE_LIGHT_BITMASKS
+
+// Size of the memory backing "_lightIndexBufferGpuMemory", the CPU fallback
+// used for testing fits both layouts
+uint32_t _lightIndexMemorySizeInBytes = 0u;
 
 // <-
 
@@ -250,6 +299,212 @@ _INTR_INLINE Math::AABB2 calcAABBForGridPos(glm::uvec3 p_GridPos,
   return {aabbCenter, aabbHalfExtent};
 }
 
+_INTR_INLINE glm::vec2 calcHalfExtentForDepthSlice(uint32_t p_DepthSlice)
+{
+  const glm::vec4& nearFar = _lightingPerInstanceData.nearFar;
+  const glm::vec4& nearFarWidthHeight =
+      _lightingPerInstanceData.nearFarWidthHeight;
+
+  const float rayPos = (calcGridDepthSlice(p_DepthSlice + 1u) - nearFar.x) /
+                       (nearFar.y - nearFar.x);
+
+  return glm::mix(glm::vec2(nearFarWidthHeight.x, nearFarWidthHeight.y),
+                  glm::vec2(nearFarWidthHeight.z, nearFarWidthHeight.w),
+                  rayPos) *
+         0.5f;
+}
+
+_INTR_INLINE glm::vec2 calcClusterPos(glm::vec2 p_PosVS,
+                                      glm::vec2 p_HalfExtent)
+{
+  return (p_PosVS / p_HalfExtent * 0.5f + 0.5f) *
+         glm::vec2(_gridRes.x, _gridRes.y);
+}
+
+// Projects the bounding sphere to a conservative range of clusters
+_INTR_INLINE void calcClusterBounds(const glm::vec4& p_PosAndRadiusVS,
+                                    ClusterBounds& p_Bounds)
+{
+  // Empty range
+  p_Bounds.minZ = 1u;
+  p_Bounds.maxZ = 0u;
+
+  const glm::vec3 center = glm::vec3(p_PosAndRadiusVS);
+  const float radius = p_PosAndRadiusVS.w;
+
+  const float minDepth = -center.z - radius;
+  const float maxDepth = -center.z + radius;
+  if (maxDepth < 0.0f || minDepth > calcGridDepthSlice(_gridRes.z))
+  {
+    return;
+  }
+
+  // Widened by one slice to stay conservative for spheres touching the slice
+  // boundaries, the inversion of the depth distribution isn't exact
+  const uint32_t minZ = std::min(
+      (uint32_t)std::max(
+          glm::pow(std::max(minDepth, 0.0f) * _gridDepthSliceScaleRcp,
+                   1.0f / _gridDepthExp) -
+              1.0f,
+          0.0f),
+      _gridRes.z - 1u);
+  const uint32_t maxZ =
+      std::min((uint32_t)glm::pow(maxDepth * _gridDepthSliceScaleRcp,
+                                  1.0f / _gridDepthExp) +
+                   1u,
+               _gridRes.z - 1u);
+
+  // The extent of the depth slices grows with the depth, so the clusters
+  // covered in any of the slices are bounded by the first and the last slice
+  const glm::vec2 minHalfExtent = calcHalfExtentForDepthSlice(minZ);
+  const glm::vec2 maxHalfExtent = calcHalfExtentForDepthSlice(maxZ);
+
+  const glm::vec2 minPosVS = glm::vec2(center) - radius;
+  const glm::vec2 maxPosVS = glm::vec2(center) + radius;
+
+  const glm::vec2 minCluster =
+      glm::min(calcClusterPos(minPosVS, minHalfExtent),
+               calcClusterPos(minPosVS, maxHalfExtent));
+  const glm::vec2 maxCluster =
+      glm::max(calcClusterPos(maxPosVS, minHalfExtent),
+               calcClusterPos(maxPosVS, maxHalfExtent));
+
+  const glm::vec2 gridRes = glm::vec2(_gridRes.x, _gridRes.y);
+  if (glm::any(glm::lessThan(maxCluster, glm::vec2(0.0f))) ||
+      glm::any(glm::greaterThanEqual(minCluster, gridRes)))
+  {
+    return;
+  }
+
+  const glm::uvec2 minClusterIdx =
+      glm::uvec2(glm::clamp(minCluster, glm::vec2(0.0f), gridRes - 1.0f));
+  const glm::uvec2 maxClusterIdx =
+      glm::uvec2(glm::clamp(maxCluster, glm::vec2(0.0f), gridRes - 1.0f));
+
+  p_Bounds.minX = (uint8_t)minClusterIdx.x;
+  p_Bounds.minY = (uint8_t)minClusterIdx.y;
+  p_Bounds.minZ = (uint8_t)minZ;
+  p_Bounds.maxX = (uint8_t)maxClusterIdx.x;
+  p_Bounds.maxY = (uint8_t)maxClusterIdx.y;
+  p_Bounds.maxZ = (uint8_t)maxZ;
+}
+
+// <-
+
+struct BinningParallelTaskSet : enki::ITaskSet
+{
+  virtual ~BinningParallelTaskSet() = default;
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Lighting", "Bin Lights And Probes");
+
+    // Lights are followed by irradiance probes, specular probes and decals
+    for (uint32_t i = p_Range.start; i < p_Range.end; ++i)
+    {
+      uint32_t idx = i;
+      if (idx < _currentLightCount)
+      {
+        calcClusterBounds(_lightBufferMemory[idx].posAndRadiusVS,
+                          _lightBounds[idx]);
+        continue;
+      }
+
+      idx -= _currentLightCount;
+      if (idx < _currentIrradProbeCount)
+      {
+        calcClusterBounds(_irradProbeBufferMemory[idx].posAndRadiusVS,
+                          _irradProbeBounds[idx]);
+        continue;
+      }
+
+      idx -= _currentIrradProbeCount;
+      if (idx < _currentSpecProbeCount)
+      {
+        calcClusterBounds(_specProbeBufferMemory[idx].posAndRadiusVS,
+                          _specProbeBounds[idx]);
+        continue;
+      }
+
+      idx -= _currentSpecProbeCount;
+      calcClusterBounds(_decalBufferMemory[idx].posAndRadiusVS,
+                        _decalBounds[idx]);
+    }
+  }
+} _binningTaskSet;
+
+// <-
+
+// Scatters the items covering the given row of clusters into the per cluster
+// index lists, the items are tested against the covered clusters only
+template <class ItemType, uint32_t MaxItemCountPerCluster>
+_INTR_INLINE void
+scatterItemsToClusterRow(const _INTR_ARRAY(uint16_t) & p_AvailableItems,
+                         const ItemType* p_Items,
+                         const _INTR_ARRAY(ClusterBounds) & p_Bounds,
+                         uint32_t p_Y, const Math::AABB2* p_ClusterAABBs,
+                         uint16_t (*p_IdxBuffers)[MaxItemCountPerCluster])
+{
+  for (uint32_t x = 0u; x < _gridRes.x; ++x)
+  {
+    (uint32_t&)p_IdxBuffers[x][0] = 0u;
+  }
+
+  for (uint32_t i = 0u; i < p_AvailableItems.size(); ++i)
+  {
+    const uint32_t itemIdx = p_AvailableItems[i];
+    const ClusterBounds& bounds = p_Bounds[itemIdx];
+
+    if (p_Y < bounds.minY || p_Y > bounds.maxY)
+    {
+      continue;
+    }
+
+    const ItemType& item = p_Items[itemIdx];
+    const Math::Sphere sphere = {glm::vec3(item.posAndRadiusVS),
+                                 item.posAndRadiusVS.w};
+
+    for (uint32_t x = bounds.minX; x <= bounds.maxX; ++x)
+    {
+      uint32_t& itemCount = (uint32_t&)p_IdxBuffers[x][0];
+
+      if (itemCount < MaxItemCountPerCluster - 2u &&
+          Math::calcIntersectSphereAABB(sphere, p_ClusterAABBs[x]))
+      {
+        p_IdxBuffers[x][itemCount + 2u] = itemIdx;
+        ++itemCount;
+      }
+    }
+  }
+}
+
+template <uint32_t MaxItemCountPerCluster>
+_INTR_INLINE void
+writeClusterRow(uint16_t* p_IdxBufferGpuMemory, uint32_t p_Y, uint32_t p_Z,
+                uint16_t (*p_IdxBuffers)[MaxItemCountPerCluster])
+{
+  for (uint32_t x = 0u; x < _gridRes.x; ++x)
+  {
+    const uint32_t clusterIdx =
+        calcClusterIndex(glm::uvec3(x, p_Y, p_Z), MaxItemCountPerCluster);
+    const uint32_t itemCount = (uint32_t&)p_IdxBuffers[x][0];
+
+    memcpy(&p_IdxBufferGpuMemory[clusterIdx], p_IdxBuffers[x],
+           sizeof(uint16_t) * (itemCount + 2u));
+  }
+}
+
+// <-
+
+_INTR_INLINE Culling::SphereStreams getLightSphereStreams()
+{
+  return {_lightSphereX.data(), _lightSphereY.data(), _lightSphereZ.data(),
+          _lightSphereRadius.data()};
+}
+
+// <-
+
 struct CullingParallelTaskSet : enki::ITaskSet
 {
   virtual ~CullingParallelTaskSet() = default;
@@ -259,357 +514,541 @@ struct CullingParallelTaskSet : enki::ITaskSet
   {
     _INTR_PROFILE_CPU("Lighting", "Cull Lights And Probes For Depth Slice");
 
-    uint16_t tempIrradIdxBuffer[MAX_IRRAD_PROBES_PER_CLUSTER];
-    uint16_t tempSpecIdxBuffer[MAX_SPEC_PROBES_PER_CLUSTER];
-    uint16_t tempLightIdxBuffer[MAX_LIGHT_COUNT_PER_CLUSTER];
-    uint16_t tempDecalIdxBuffer[MAX_DECALS_PER_CLUSTER];
-
     for (uint32_t y = p_Range.start; y < p_Range.end; ++y)
     {
-      for (uint32_t x = 0u; x < _gridRes.x; ++x)
+      if (_bruteForce)
+      {
+        cullRowBruteForce(y);
+      }
+      else
       {
-        const glm::uvec3 gridPos = glm::uvec3(x, y, _z);
+        cullRow(y);
+      }
+    }
+  }
 
-        const Math::AABB2 clusterAABB = calcAABBForGridPos(
-            gridPos, _lightingPerInstanceData.nearFarWidthHeight,
-            _lightingPerInstanceData.nearFar);
+  void cullRow(uint32_t p_Y)
+  {
+    Math::AABB2 clusterAABBs[GRID_SIZE_X];
+    for (uint32_t x = 0u; x < _gridRes.x; ++x)
+    {
+      clusterAABBs[x] = calcAABBForGridPos(
+          glm::uvec3(x, p_Y, _z), _lightingPerInstanceData.nearFarWidthHeight,
+          _lightingPerInstanceData.nearFar);
+    }
 
-        const uint32_t lightClusterIndex =
-            calcClusterIndex(gridPos, MAX_LIGHT_COUNT_PER_CLUSTER);
-        const uint32_t irradProbeClusterIdx =
-            calcClusterIndex(gridPos, MAX_IRRAD_PROBES_PER_CLUSTER);
-        const uint32_t specProbeClusterIdx =
-            calcClusterIndex(gridPos, MAX_SPEC_PROBES_PER_CLUSTER);
-        const uint32_t decalClusterIdx =
-            calcClusterIndex(gridPos, MAX_DECALS_PER_CLUSTER);
-
-        uint32_t& lightCount = (uint32_t&)tempLightIdxBuffer[0];
-        lightCount = 0u;
+    if (_lightBitmasks)
+    {
+      // Lights of the depth slice covering the row
+      uint32_t rowLightBits[MAX_LIGHT_COUNT / 32u];
+      memset(rowLightBits, 0x00,
+             sizeof(uint32_t) * ((_currentLightCount + 31u) / 32u));
 
-        for (uint32_t i = 0u; i < _availableLights.size() &&
-                              lightCount < MAX_LIGHT_COUNT_PER_CLUSTER - 2u;
-             ++i)
+      for (uint32_t i = 0u; i < _availableLights.size(); ++i)
+      {
+        const uint32_t lightIdx = _availableLights[i];
+        const ClusterBounds& bounds = _lightBounds[lightIdx];
+
+        if (p_Y >= bounds.minY && p_Y <= bounds.maxY)
         {
-          uint32_t lidx = _availableLights[i];
-          const Light& light = _lightBufferMemory[lidx];
-          if (Math::calcIntersectSphereAABB(
-                  {glm::vec3(light.posAndRadiusVS), light.posAndRadiusVS.w},
-                  clusterAABB))
-          {
-            const uint32_t idx = lightCount + 2u;
-            tempLightIdxBuffer[idx] = lidx;
-            ++lightCount;
-          }
+          rowLightBits[lightIdx / 32u] |= 1u << (lightIdx % 32u);
         }
+      }
+
+      cullLightsRow(p_Y, clusterAABBs, rowLightBits);
+    }
+    else
+    {
+      uint16_t lightIdxBuffers[GRID_SIZE_X][MAX_LIGHT_COUNT_PER_CLUSTER];
 
-        uint32_t& irradProbeCount = (uint32_t&)tempIrradIdxBuffer[0];
-        irradProbeCount = 0u;
+      scatterItemsToClusterRow(_availableLights, _lightBufferMemory,
+                               _lightBounds, p_Y, clusterAABBs,
+                               lightIdxBuffers);
+      writeClusterRow(_lightIndexBufferGpuMemory, p_Y, _z, lightIdxBuffers);
+    }
+
+    uint16_t irradIdxBuffers[GRID_SIZE_X][MAX_IRRAD_PROBES_PER_CLUSTER];
+    uint16_t specIdxBuffers[GRID_SIZE_X][MAX_SPEC_PROBES_PER_CLUSTER];
+    uint16_t decalIdxBuffers[GRID_SIZE_X][MAX_DECALS_PER_CLUSTER];
+
+    scatterItemsToClusterRow(_availableIrradProbes, _irradProbeBufferMemory,
+                             _irradProbeBounds, p_Y, clusterAABBs,
+                             irradIdxBuffers);
+    scatterItemsToClusterRow(_availableSpecProbes, _specProbeBufferMemory,
+                             _specProbeBounds, p_Y, clusterAABBs,
+                             specIdxBuffers);
+    scatterItemsToClusterRow(_availableDecals, _decalBufferMemory,
+                             _decalBounds, p_Y, clusterAABBs, decalIdxBuffers);
+
+    writeClusterRow(_irradProbeIndexBufferGpuMemory, p_Y, _z, irradIdxBuffers);
+    writeClusterRow(_specProbeIndexBufferGpuMemory, p_Y, _z, specIdxBuffers);
+    writeClusterRow(_decalIndexBufferGpuMemory, p_Y, _z, decalIdxBuffers);
+  }
+
+  // Tests the lights set in "p_AvailableLightBits" against the clusters of
+  // the row, 32 lights at a time
+  void cullLightsRow(uint32_t p_Y, const Math::AABB2* p_ClusterAABBs,
+                     const uint32_t* p_AvailableLightBits)
+  {
+    const Culling::SphereStreams spheres = getLightSphereStreams();
+    const uint32_t wordCount = (_currentLightCount + 31u) / 32u;
 
-        for (uint32_t i = 0u;
-             i < _availableIrradProbes.size() &&
-             irradProbeCount < MAX_IRRAD_PROBES_PER_CLUSTER - 2u;
-             ++i)
+    for (uint32_t x = 0u; x < _gridRes.x; ++x)
+    {
+      const glm::uvec3 gridPos = glm::uvec3(x, p_Y, _z);
+
+      if (_lightBitmasks)
+      {
+        uint32_t lightMask[MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER];
+        uint32_t& usedWordCount = lightMask[0];
+        usedWordCount = 0u;
+
+        for (uint32_t w = 0u; w < wordCount; ++w)
         {
-          uint32_t iidx = _availableIrradProbes[i];
-          const IrradProbe& probe = _irradProbeBufferMemory[iidx];
-          if (Math::calcIntersectSphereAABB(
-                  {glm::vec3(probe.posAndRadiusVS), probe.posAndRadiusVS.w},
-                  clusterAABB))
+          uint32_t lightBits = p_AvailableLightBits[w];
+          if (lightBits != 0u)
           {
-            const uint32_t idx = irradProbeCount + 2u;
-            tempIrradIdxBuffer[idx] = iidx;
-            ++irradProbeCount;
+            lightBits &= Culling::intersectSpheresAABB(
+                spheres, w * 32u, std::min(32u, _currentLightCount - w * 32u),
+                p_ClusterAABBs[x]);
           }
+
+          lightMask[w + 1u] = lightBits;
+          usedWordCount = lightBits != 0u ? w + 1u : usedWordCount;
         }
 
-        uint32_t& specProbeCount = (uint32_t&)tempSpecIdxBuffer[0];
-        specProbeCount = 0u;
+        // Trailing empty words are neither written nor read
+        const uint32_t clusterIdx =
+            calcClusterIndex(gridPos, MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER);
+        memcpy(&((uint32_t*)_lightIndexBufferGpuMemory)[clusterIdx], lightMask,
+               sizeof(uint32_t) * (usedWordCount + 1u));
+      }
+      else
+      {
+        uint16_t lightIdxBuffer[MAX_LIGHT_COUNT_PER_CLUSTER];
+        uint32_t& lightCount = (uint32_t&)lightIdxBuffer[0];
+        lightCount = 0u;
 
-        for (uint32_t i = 0u; i < _availableSpecProbes.size() &&
-                              specProbeCount < MAX_SPEC_PROBES_PER_CLUSTER - 2u;
-             ++i)
+        for (uint32_t w = 0u;
+             w < wordCount && lightCount < MAX_LIGHT_COUNT_PER_CLUSTER - 2u;
+             ++w)
         {
-          uint32_t sidx = _availableSpecProbes[i];
-          const SpecProbe& probe = _specProbeBufferMemory[sidx];
-          if (Math::calcIntersectSphereAABB(
-                  {glm::vec3(probe.posAndRadiusVS), probe.posAndRadiusVS.w},
-                  clusterAABB))
+          uint32_t lightBits = p_AvailableLightBits[w];
+          if (lightBits == 0u)
           {
-            const uint32_t idx = specProbeCount + 2u;
-            tempSpecIdxBuffer[idx] = sidx;
-            ++specProbeCount;
+            continue;
+          }
+
+          lightBits &= Culling::intersectSpheresAABB(
+              spheres, w * 32u, std::min(32u, _currentLightCount - w * 32u),
+              p_ClusterAABBs[x]);
+
+          while (lightBits != 0u &&
+                 lightCount < MAX_LIGHT_COUNT_PER_CLUSTER - 2u)
+          {
+            lightIdxBuffer[lightCount + 2u] =
+                w * 32u + Math::calcLowestSetBit(lightBits);
+            lightBits &= lightBits - 1u;
+            ++lightCount;
           }
         }
 
-        uint32_t& decalCount = (uint32_t&)tempDecalIdxBuffer[0];
-        decalCount = 0u;
+        const uint32_t clusterIdx =
+            calcClusterIndex(gridPos, MAX_LIGHT_COUNT_PER_CLUSTER);
+        memcpy(&_lightIndexBufferGpuMemory[clusterIdx], lightIdxBuffer,
+               sizeof(uint16_t) * (lightCount + 2u));
+      }
+    }
+  }
 
-        for (uint32_t i = 0u; i < _availableDecals.size() &&
-                              decalCount < MAX_DECALS_PER_CLUSTER - 2u;
-             ++i)
+  // Tests all items intersecting the depth slice against every cluster
+  void cullRowBruteForce(uint32_t p_Y)
+  {
+    Math::AABB2 clusterAABBs[GRID_SIZE_X];
+    for (uint32_t x = 0u; x < _gridRes.x; ++x)
+    {
+      clusterAABBs[x] = calcAABBForGridPos(
+          glm::uvec3(x, p_Y, _z), _lightingPerInstanceData.nearFarWidthHeight,
+          _lightingPerInstanceData.nearFar);
+    }
+
+    cullLightsRow(p_Y, clusterAABBs, _availableLightBits.data());
+
+    uint16_t tempIrradIdxBuffer[MAX_IRRAD_PROBES_PER_CLUSTER];
+    uint16_t tempSpecIdxBuffer[MAX_SPEC_PROBES_PER_CLUSTER];
+    uint16_t tempDecalIdxBuffer[MAX_DECALS_PER_CLUSTER];
+
+    const uint32_t y = p_Y;
+    for (uint32_t x = 0u; x < _gridRes.x; ++x)
+    {
+      const glm::uvec3 gridPos = glm::uvec3(x, y, _z);
+      const Math::AABB2& clusterAABB = clusterAABBs[x];
+
+      const uint32_t irradProbeClusterIdx =
+          calcClusterIndex(gridPos, MAX_IRRAD_PROBES_PER_CLUSTER);
+      const uint32_t specProbeClusterIdx =
+          calcClusterIndex(gridPos, MAX_SPEC_PROBES_PER_CLUSTER);
+      const uint32_t decalClusterIdx =
+          calcClusterIndex(gridPos, MAX_DECALS_PER_CLUSTER);
+
+      uint32_t& irradProbeCount = (uint32_t&)tempIrradIdxBuffer[0];
+      irradProbeCount = 0u;
+
+      for (uint32_t i = 0u;
+           i < _availableIrradProbes.size() &&
+           irradProbeCount < MAX_IRRAD_PROBES_PER_CLUSTER - 2u;
+           ++i)
+      {
+        uint32_t iidx = _availableIrradProbes[i];
+        const IrradProbe& probe = _irradProbeBufferMemory[iidx];
+        if (Math::calcIntersectSphereAABB(
+                {glm::vec3(probe.posAndRadiusVS), probe.posAndRadiusVS.w},
+                clusterAABB))
         {
-          uint32_t didx = _availableDecals[i];
-          const Decal& decal = _decalBufferMemory[didx];
+          const uint32_t idx = irradProbeCount + 2u;
+          tempIrradIdxBuffer[idx] = iidx;
+          ++irradProbeCount;
+        }
+      }
 
-          if (Math::calcIntersectSphereAABB(
-                  {glm::vec3(decal.posAndRadiusVS), decal.posAndRadiusVS.w},
-                  clusterAABB))
-          {
-            const uint32_t idx = decalCount + 2u;
-            tempDecalIdxBuffer[idx] = didx;
-            ++decalCount;
-          }
+      uint32_t& specProbeCount = (uint32_t&)tempSpecIdxBuffer[0];
+      specProbeCount = 0u;
+
+      for (uint32_t i = 0u; i < _availableSpecProbes.size() &&
+                            specProbeCount < MAX_SPEC_PROBES_PER_CLUSTER - 2u;
+           ++i)
+      {
+        uint32_t sidx = _availableSpecProbes[i];
+        const SpecProbe& probe = _specProbeBufferMemory[sidx];
+        if (Math::calcIntersectSphereAABB(
+                {glm::vec3(probe.posAndRadiusVS), probe.posAndRadiusVS.w},
+                clusterAABB))
+        {
+          const uint32_t idx = specProbeCount + 2u;
+          tempSpecIdxBuffer[idx] = sidx;
+          ++specProbeCount;
         }
+      }
 
-        memcpy(&_irradProbeIndexBufferGpuMemory[irradProbeClusterIdx],
-               tempIrradIdxBuffer, sizeof(uint16_t) * (irradProbeCount + 2u));
-        memcpy(&_specProbeIndexBufferGpuMemory[specProbeClusterIdx],
-               tempSpecIdxBuffer, sizeof(uint16_t) * (specProbeCount + 2u));
-        memcpy(&_lightIndexBufferGpuMemory[lightClusterIndex],
-               tempLightIdxBuffer, sizeof(uint16_t) * (lightCount + 2u));
-        memcpy(&_decalIndexBufferGpuMemory[decalClusterIdx], tempDecalIdxBuffer,
-               sizeof(uint16_t) * (decalCount + 2u));
+      uint32_t& decalCount = (uint32_t&)tempDecalIdxBuffer[0];
+      decalCount = 0u;
+
+      for (uint32_t i = 0u; i < _availableDecals.size() &&
+                            decalCount < MAX_DECALS_PER_CLUSTER - 2u;
+           ++i)
+      {
+        uint32_t didx = _availableDecals[i];
+        const Decal& decal = _decalBufferMemory[didx];
+
+        if (Math::calcIntersectSphereAABB(
+                {glm::vec3(decal.posAndRadiusVS), decal.posAndRadiusVS.w},
+                clusterAABB))
+        {
+          const uint32_t idx = decalCount + 2u;
+          tempDecalIdxBuffer[idx] = didx;
+          ++decalCount;
+        }
       }
+
+      memcpy(&_irradProbeIndexBufferGpuMemory[irradProbeClusterIdx],
+             tempIrradIdxBuffer, sizeof(uint16_t) * (irradProbeCount + 2u));
+      memcpy(&_specProbeIndexBufferGpuMemory[specProbeClusterIdx],
+             tempSpecIdxBuffer, sizeof(uint16_t) * (specProbeCount + 2u));
+      memcpy(&_decalIndexBufferGpuMemory[decalClusterIdx], tempDecalIdxBuffer,
+             sizeof(uint16_t) * (decalCount + 2u));
     }
   }
 
   uint32_t _z;
+  bool _bruteForce;
   _INTR_ARRAY(uint16_t) _availableLights;
   _INTR_ARRAY(uint16_t) _availableIrradProbes;
   _INTR_ARRAY(uint16_t) _availableDecals;
   _INTR_ARRAY(uint16_t) _availableSpecProbes;
+
+  // One bit per available light, only used for brute force culling
+  _INTR_ARRAY(uint32_t) _availableLightBits;
 } _cullingTaskSets[GRID_DEPTH_SLICE_COUNT];
 
-_INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
+uint32_t _activeTaskSets[GRID_DEPTH_SLICE_COUNT];
+uint32_t _activeTaskSetCount = 0u;
+
+// <-
+
+_INTR_INLINE void writeItemBuffers(Components::CameraRef p_CameraRef)
 {
-  _INTR_PROFILE_CPU("Clustered", "Cull And Write Buffers");
+  _INTR_PROFILE_CPU("Clustered", "Write Buffers");
 
-  // TODO: Add frustum culling broad phase
+  _currentLightCount = 0u;
+  for (uint32_t i = 0u; i < Components::LightManager::_activeRefs.size(); ++i)
   {
-    _INTR_PROFILE_CPU("Clustered", "Write Buffers");
+    Components::LightRef lightRef = Components::LightManager::_activeRefs[i];
+    Components::NodeRef lightNodeRef =
+        Components::NodeManager::getComponentForEntity(
+            Components::LightManager::_entity(lightRef));
+
+    const glm::vec3 lightPosVS =
+        Components::CameraManager::_viewMatrix(p_CameraRef) *
+        glm::vec4(Components::NodeManager::_worldPosition(lightNodeRef), 1.0);
+    _lightBufferMemory[_currentLightCount] = {
+        glm::vec4(lightPosVS,
+                  Components::LightManager::_descRadius(lightRef)),
+        glm::vec4(Components::LightManager::_descColor(lightRef),
+                  Components::LightManager::_descIntensity(lightRef)),
+        glm::vec4(Components::LightManager::_descTemperature(lightRef))};
+    ++_currentLightCount;
+  }
 
-    _currentLightCount = 0u;
-    for (uint32_t i = 0u; i < Components::LightManager::_activeRefs.size(); ++i)
+  _currentDecalCount = 0u;
+  for (uint32_t i = 0u; i < Components::DecalManager::_activeRefs.size(); ++i)
+  {
+    Components::DecalRef decalRef = Components::DecalManager::_activeRefs[i];
+    Components::NodeRef decalNodeRef =
+        Components::NodeManager::getComponentForEntity(
+            Components::DecalManager::_entity(decalRef));
+
+    const glm::vec3 decalHalfExtent =
+        Components::DecalManager::_descHalfExtent(decalRef) *
+        Components::NodeManager::_worldSize(decalNodeRef);
+    const glm::vec3 decalWorldPos =
+        Components::NodeManager::_worldPosition(decalNodeRef);
+    const glm::quat decalWorldOrientation =
+        Components::NodeManager::_worldOrientation(decalNodeRef);
+
+    const glm::vec3 right =
+        decalWorldOrientation * glm::vec3(decalHalfExtent.x, 0.0f, 0.0f);
+    const glm::vec3 up =
+        decalWorldOrientation * glm::vec3(0.0f, decalHalfExtent.y, 0.0f);
+    const glm::vec3 forward =
+        decalWorldOrientation *
+        glm::vec3(0.0f, 0.0f, -decalHalfExtent.z * 2.0f);
+
+    const Math::AABB decalAABB = Math::AABB(
+        decalWorldPos - right - up, decalWorldPos + forward + right + up);
+
+    const glm::mat4 decalViewMatrix =
+        glm::lookAt(decalWorldPos, decalWorldPos + forward, up);
+    const glm::mat4 decalProjectionMatrix =
+        glm::ortho(-decalHalfExtent.x, decalHalfExtent.x, -decalHalfExtent.y,
+                   decalHalfExtent.y, 0.01f, decalHalfExtent.z * 2.0f);
+
+    Decal decal;
     {
-      Components::LightRef lightRef = Components::LightManager::_activeRefs[i];
-      Components::NodeRef lightNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::LightManager::_entity(lightRef));
+      decal.posAndRadiusVS =
+          Components::CameraManager::_viewMatrix(p_CameraRef) *
+          glm::vec4(Math::calcAABBCenter(decalAABB), 1.0);
 
-      const glm::vec3 lightPosVS =
+      decal.normalVS = glm::normalize(
+          Components::CameraManager::_viewMatrix(p_CameraRef) *
+          glm::vec4(decalWorldOrientation * glm::vec3(0.0f, 0.0f, 1.0f),
+                    0.0));
+      decal.tangentVS = glm::normalize(
           Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(lightNodeRef), 1.0);
-      _lightBufferMemory[_currentLightCount] = {
-          glm::vec4(lightPosVS,
-                    Components::LightManager::_descRadius(lightRef)),
-          glm::vec4(Components::LightManager::_descColor(lightRef),
-                    Components::LightManager::_descIntensity(lightRef)),
-          glm::vec4(Components::LightManager::_descTemperature(lightRef))};
-      ++_currentLightCount;
+          glm::vec4(decalWorldOrientation * glm::vec3(0.0f, 1.0f, 0.0f),
+                    0.0));
+      decal.binormalVS = glm::normalize(
+          Components::CameraManager::_viewMatrix(p_CameraRef) *
+          glm::vec4(decalWorldOrientation * glm::vec3(1.0f, 0.0f, 0.0f),
+                    0.0));
+
+      decal.uvTransform =
+          Components::DecalManager::_descUVTransform(decalRef);
+      decal.posAndRadiusVS.w =
+          glm::length(Math::calcAABBHalfExtent(decalAABB));
+      decal.viewProjMatrix =
+          (decalProjectionMatrix * decalViewMatrix) *
+          Components::CameraManager::_inverseViewMatrix(p_CameraRef);
+      decal.textureIds = glm::uvec4(
+          ImageManager::getTextureId(ImageManager::getResourceByName(
+              Components::DecalManager::_descAlbedoTextureName(decalRef))),
+          ImageManager::getTextureId(ImageManager::getResourceByName(
+              Components::DecalManager::_descNormalTextureName(decalRef))),
+          ImageManager::getTextureId(ImageManager::getResourceByName(
+              Components::DecalManager::_descPBRTextureName(decalRef))),
+          0u);
     }
+    _decalBufferMemory[_currentDecalCount] = decal;
 
-    _currentDecalCount = 0u;
-    for (uint32_t i = 0u; i < Components::DecalManager::_activeRefs.size(); ++i)
-    {
-      Components::DecalRef decalRef = Components::DecalManager::_activeRefs[i];
-      Components::NodeRef decalNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::DecalManager::_entity(decalRef));
-
-      const glm::vec3 decalHalfExtent =
-          Components::DecalManager::_descHalfExtent(decalRef) *
-          Components::NodeManager::_worldSize(decalNodeRef);
-      const glm::vec3 decalWorldPos =
-          Components::NodeManager::_worldPosition(decalNodeRef);
-      const glm::quat decalWorldOrientation =
-          Components::NodeManager::_worldOrientation(decalNodeRef);
-
-      const glm::vec3 right =
-          decalWorldOrientation * glm::vec3(decalHalfExtent.x, 0.0f, 0.0f);
-      const glm::vec3 up =
-          decalWorldOrientation * glm::vec3(0.0f, decalHalfExtent.y, 0.0f);
-      const glm::vec3 forward =
-          decalWorldOrientation *
-          glm::vec3(0.0f, 0.0f, -decalHalfExtent.z * 2.0f);
-
-      const Math::AABB decalAABB = Math::AABB(
-          decalWorldPos - right - up, decalWorldPos + forward + right + up);
-
-      const glm::mat4 decalViewMatrix =
-          glm::lookAt(decalWorldPos, decalWorldPos + forward, up);
-      const glm::mat4 decalProjectionMatrix =
-          glm::ortho(-decalHalfExtent.x, decalHalfExtent.x, -decalHalfExtent.y,
-                     decalHalfExtent.y, 0.01f, decalHalfExtent.z * 2.0f);
-
-      Decal decal;
-      {
-        decal.posAndRadiusVS =
-            Components::CameraManager::_viewMatrix(p_CameraRef) *
-            glm::vec4(Math::calcAABBCenter(decalAABB), 1.0);
-
-        decal.normalVS = glm::normalize(
-            Components::CameraManager::_viewMatrix(p_CameraRef) *
-            glm::vec4(decalWorldOrientation * glm::vec3(0.0f, 0.0f, 1.0f),
-                      0.0));
-        decal.tangentVS = glm::normalize(
-            Components::CameraManager::_viewMatrix(p_CameraRef) *
-            glm::vec4(decalWorldOrientation * glm::vec3(0.0f, 1.0f, 0.0f),
-                      0.0));
-        decal.binormalVS = glm::normalize(
-            Components::CameraManager::_viewMatrix(p_CameraRef) *
-            glm::vec4(decalWorldOrientation * glm::vec3(1.0f, 0.0f, 0.0f),
-                      0.0));
-
-        decal.uvTransform =
-            Components::DecalManager::_descUVTransform(decalRef);
-        decal.posAndRadiusVS.w =
-            glm::length(Math::calcAABBHalfExtent(decalAABB));
-        decal.viewProjMatrix =
-            (decalProjectionMatrix * decalViewMatrix) *
-            Components::CameraManager::_inverseViewMatrix(p_CameraRef);
-        decal.textureIds = glm::uvec4(
-            ImageManager::getTextureId(ImageManager::getResourceByName(
-                Components::DecalManager::_descAlbedoTextureName(decalRef))),
-            ImageManager::getTextureId(ImageManager::getResourceByName(
-                Components::DecalManager::_descNormalTextureName(decalRef))),
-            ImageManager::getTextureId(ImageManager::getResourceByName(
-                Components::DecalManager::_descPBRTextureName(decalRef))),
-            0u);
-      }
-      _decalBufferMemory[_currentDecalCount] = decal;
+    ++_currentDecalCount;
+  }
 
-      ++_currentDecalCount;
-    }
+  // Write test lights, limited to the size of the light buffer
+  for (uint32_t i = 0u;
+       i < _testLights.size() && _currentLightCount < MAX_LIGHT_COUNT; ++i)
+  {
+    _lightBufferMemory[_currentLightCount] = _testLights[i].light;
+    ++_currentLightCount;
+  }
+
+  // Sort probes by priority
+  // TODO: Could be done once if a priority changes
+  _currentIrradProbeCount = 0u;
+  _currentSpecProbeCount = 0u;
+
+  Components::IrradianceProbeManager::sortByPriority(
+      Components::IrradianceProbeManager::_activeRefs);
+  Components::SpecularProbeManager::sortByPriority(
+      Components::SpecularProbeManager::_activeRefs);
 
-    // Write test lights
-    for (uint32_t i = 0u; i < _testLights.size(); ++i)
+  for (uint32_t i = 0u;
+       i < Components::IrradianceProbeManager::_activeRefs.size(); ++i)
+  {
+    Components::IrradianceProbeRef irradProbeRef =
+        Components::IrradianceProbeManager::_activeRefs[i];
+    Components::NodeRef irradNodeRef =
+        Components::NodeManager::getComponentForEntity(
+            Components::IrradianceProbeManager::_entity(irradProbeRef));
+    const _INTR_ARRAY(Rendering::IBL::SH9)& shs =
+        Components::IrradianceProbeManager::_descSHs(irradProbeRef);
+
+    if (shs.size() < 2)
     {
-      _lightBufferMemory[_currentLightCount] = _testLights[i].light;
-      ++_currentLightCount;
+      continue;
     }
 
-    // Sort probes by priority
-    // TODO: Could be done once if a priority changes
-    _currentIrradProbeCount = 0u;
-    _currentSpecProbeCount = 0u;
+    const glm::vec3 irradProbePosVS =
+        Components::CameraManager::_viewMatrix(p_CameraRef) *
+        glm::vec4(Components::NodeManager::_worldPosition(irradNodeRef), 1.0);
+    _irradProbeBufferMemory[_currentIrradProbeCount].posAndRadiusVS =
+        glm::vec4(
+            irradProbePosVS,
+            Components::IrradianceProbeManager::_descRadius(irradProbeRef));
+    _irradProbeBufferMemory[_currentIrradProbeCount].data0 = glm::vec4(
+        Components::IrradianceProbeManager::_descFalloffRangePerc(
+            irradProbeRef),
+        Components::IrradianceProbeManager::_descFalloffExp(irradProbeRef),
+        0.0f, 0.0f);
+
+    // Blend SHs according to the time of day
+    Rendering::IBL::SH9 blendedSH;
+    {
+      const uint32_t leftIdx =
+          std::min((uint32_t)(World::_currentTime * shs.size()),
+                   (uint32_t)shs.size() - 1u);
 
-    Components::IrradianceProbeManager::sortByPriority(
-        Components::IrradianceProbeManager::_activeRefs);
-    Components::SpecularProbeManager::sortByPriority(
-        Components::SpecularProbeManager::_activeRefs);
+      const float leftPerc = leftIdx / (float)shs.size();
+      const float rightPerc = (leftIdx + 1u) / (float)shs.size();
 
-    for (uint32_t i = 0u;
-         i < Components::IrradianceProbeManager::_activeRefs.size(); ++i)
-    {
-      Components::IrradianceProbeRef irradProbeRef =
-          Components::IrradianceProbeManager::_activeRefs[i];
-      Components::NodeRef irradNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::IrradianceProbeManager::_entity(irradProbeRef));
-      const _INTR_ARRAY(Rendering::IBL::SH9)& shs =
-          Components::IrradianceProbeManager::_descSHs(irradProbeRef);
-
-      if (shs.size() < 2)
-      {
-        continue;
-      }
+      const float interp =
+          (World::_currentTime - leftPerc) / (rightPerc - leftPerc);
 
-      const glm::vec3 irradProbePosVS =
-          Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(irradNodeRef), 1.0);
-      _irradProbeBufferMemory[_currentIrradProbeCount].posAndRadiusVS =
-          glm::vec4(
-              irradProbePosVS,
-              Components::IrradianceProbeManager::_descRadius(irradProbeRef));
-      _irradProbeBufferMemory[_currentIrradProbeCount].data0 = glm::vec4(
-          Components::IrradianceProbeManager::_descFalloffRangePerc(
-              irradProbeRef),
-          Components::IrradianceProbeManager::_descFalloffExp(irradProbeRef),
-          0.0f, 0.0f);
-
-      // Blend SHs according to the time of day
-      Rendering::IBL::SH9 blendedSH;
-      {
-        const uint32_t leftIdx =
-            std::min((uint32_t)(World::_currentTime * shs.size()),
-                     (uint32_t)shs.size() - 1u);
+      const Rendering::IBL::SH9& left = shs[leftIdx];
+      const Rendering::IBL::SH9& right = shs[(leftIdx + 1u) % shs.size()];
 
-        const float leftPerc = leftIdx / (float)shs.size();
-        const float rightPerc = (leftIdx + 1u) / (float)shs.size();
+      blendedSH = Rendering::IBL::blend(left, right, interp);
+    }
 
-        const float interp =
-            (World::_currentTime - leftPerc) / (rightPerc - leftPerc);
+    memcpy(_irradProbeBufferMemory[_currentIrradProbeCount].shData,
+           &blendedSH, sizeof(Rendering::IBL::SH9));
+    ++_currentIrradProbeCount;
+  }
 
-        const Rendering::IBL::SH9& left = shs[leftIdx];
-        const Rendering::IBL::SH9& right = shs[(leftIdx + 1u) % shs.size()];
+  for (uint32_t i = 0u;
+       i < Components::SpecularProbeManager::_activeRefs.size(); ++i)
+  {
+    Components::SpecularProbeRef specProbeRef =
+        Components::SpecularProbeManager::_activeRefs[i];
 
-        blendedSH = Rendering::IBL::blend(left, right, interp);
-      }
+    Components::NodeRef specNodeRef =
+        Components::NodeManager::getComponentForEntity(
+            Components::SpecularProbeManager::_entity(specProbeRef));
+
+    SpecProbe& probe = _specProbeBufferMemory[_currentSpecProbeCount];
+    _INTR_ARRAY(Name)& texNames =
+        Components::SpecularProbeManager::_descSpecularTextureNames(
+            specProbeRef);
+    _INTR_ASSERT(texNames.size() <= 8u);
 
-      memcpy(_irradProbeBufferMemory[_currentIrradProbeCount].shData,
-             &blendedSH, sizeof(Rendering::IBL::SH9));
-      ++_currentIrradProbeCount;
+    if (texNames.size() < 2)
+    {
+      continue;
     }
 
-    for (uint32_t i = 0u;
-         i < Components::SpecularProbeManager::_activeRefs.size(); ++i)
+    const glm::vec3 specProbePosVS =
+        Components::CameraManager::_viewMatrix(p_CameraRef) *
+        glm::vec4(Components::NodeManager::_worldPosition(specNodeRef), 1.0);
+    probe.posAndRadiusVS = glm::vec4(
+        specProbePosVS,
+        Components::SpecularProbeManager::_descRadius(specProbeRef));
+    probe.data0 = glm::vec4(
+        Components::SpecularProbeManager::_descFalloffRangePerc(specProbeRef),
+        Components::SpecularProbeManager::_descFalloffExp(specProbeRef),
+        (float)texNames.size(),
+        *((float*)&Components::SpecularProbeManager::_flags(specProbeRef)));
+    probe.minExtentWS = glm::vec4(
+        Components::NodeManager::_worldPosition(specNodeRef) +
+            Components::SpecularProbeManager::_descMinExtent(specProbeRef),
+        0.0f);
+    probe.maxExtentWS = glm::vec4(
+        Components::NodeManager::_worldPosition(specNodeRef) +
+            Components::SpecularProbeManager::_descMaxExtent(specProbeRef),
+        0.0f);
+
+    uint32_t texId = 0;
+    for (Name texName : texNames)
     {
-      Components::SpecularProbeRef specProbeRef =
-          Components::SpecularProbeManager::_activeRefs[i];
+      ImageRef imageRef = ImageManager::_getResourceByName(texName);
 
-      Components::NodeRef specNodeRef =
-          Components::NodeManager::getComponentForEntity(
-              Components::SpecularProbeManager::_entity(specProbeRef));
+      probe.textureIds[texId / 4u][texId % 4u] =
+          imageRef.isValid() ? ImageManager::getTextureId(imageRef) : 0u;
+      ++texId;
+    }
 
-      SpecProbe& probe = _specProbeBufferMemory[_currentSpecProbeCount];
-      _INTR_ARRAY(Name)& texNames =
-          Components::SpecularProbeManager::_descSpecularTextureNames(
-              specProbeRef);
-      _INTR_ASSERT(texNames.size() <= 8u);
+    ++_currentSpecProbeCount;
+  }
+}
 
-      if (texNames.size() < 2)
-      {
-        continue;
-      }
+// <-
 
-      const glm::vec3 specProbePosVS =
-          Components::CameraManager::_viewMatrix(p_CameraRef) *
-          glm::vec4(Components::NodeManager::_worldPosition(specNodeRef), 1.0);
-      probe.posAndRadiusVS = glm::vec4(
-          specProbePosVS,
-          Components::SpecularProbeManager::_descRadius(specProbeRef));
-      probe.data0 = glm::vec4(
-          Components::SpecularProbeManager::_descFalloffRangePerc(specProbeRef),
-          Components::SpecularProbeManager::_descFalloffExp(specProbeRef),
-          (float)texNames.size(),
-          *((float*)&Components::SpecularProbeManager::_flags(specProbeRef)));
-      probe.minExtentWS = glm::vec4(
-          Components::NodeManager::_worldPosition(specNodeRef) +
-              Components::SpecularProbeManager::_descMinExtent(specProbeRef),
-          0.0f);
-      probe.maxExtentWS = glm::vec4(
-          Components::NodeManager::_worldPosition(specNodeRef) +
-              Components::SpecularProbeManager::_descMaxExtent(specProbeRef),
-          0.0f);
-
-      uint32_t texId = 0;
-      for (Name texName : texNames)
-      {
-        ImageRef imageRef = ImageManager::_getResourceByName(texName);
+_INTR_INLINE void kickCullingJobs(bool p_BruteForce, bool p_LightBitmasks)
+{
+  _INTR_ASSERT(_currentLightCount <= MAX_LIGHT_COUNT &&
+               "Max. light count exceeded");
 
-        probe.textureIds[texId / 4u][texId % 4u] =
-            imageRef.isValid() ? ImageManager::getTextureId(imageRef) : 0u;
-        ++texId;
-      }
+  // The light cluster layout changes, so all depth slices have to be reset
+  if (p_LightBitmasks != _lightBitmasks)
+  {
+    _lightBitmasks = p_LightBitmasks;
+    _depthSliceDirtyMask = (1u << GRID_DEPTH_SLICE_COUNT) - 1u;
+  }
+
+  // Structure of arrays copy of the light bounding spheres
+  {
+    _lightSphereX.resize(MAX_LIGHT_COUNT + 8u);
+    _lightSphereY.resize(MAX_LIGHT_COUNT + 8u);
+    _lightSphereZ.resize(MAX_LIGHT_COUNT + 8u);
+    _lightSphereRadius.resize(MAX_LIGHT_COUNT + 8u);
 
-      ++_currentSpecProbeCount;
+    for (uint32_t i = 0u; i < _currentLightCount; ++i)
+    {
+      const glm::vec4& posAndRadiusVS = _lightBufferMemory[i].posAndRadiusVS;
+      _lightSphereX[i] = posAndRadiusVS.x;
+      _lightSphereY[i] = posAndRadiusVS.y;
+      _lightSphereZ[i] = posAndRadiusVS.z;
+      _lightSphereRadius[i] = posAndRadiusVS.w;
+    }
+  }
+
+  if (!p_BruteForce)
+  {
+    _lightBounds.resize(_currentLightCount);
+    _irradProbeBounds.resize(_currentIrradProbeCount);
+    _specProbeBounds.resize(_currentSpecProbeCount);
+    _decalBounds.resize(_currentDecalCount);
+
+    _binningTaskSet.m_SetSize = _currentLightCount + _currentIrradProbeCount +
+                                _currentSpecProbeCount + _currentDecalCount;
+
+    if (_binningTaskSet.m_SetSize > 0u)
+    {
+      Application::_scheduler.AddTaskSetToPipe(&_binningTaskSet);
+      Application::_scheduler.WaitforTaskSet(&_binningTaskSet);
     }
   }
 
   // Find objects intersecting the depth slices and kick jobs for populated
   // ones
-  _INTR_ARRAY(uint32_t) _activeTaskSets;
-  _activeTaskSets.reserve(GRID_DEPTH_SLICE_COUNT);
+  _activeTaskSetCount = 0u;
   {
     _INTR_PROFILE_CPU("Lighting", "Find Slice And Kick Jobs");
 
@@ -617,60 +1056,118 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
     {
       CullingParallelTaskSet& taskSet = _cullingTaskSets[z];
       taskSet._z = z;
+      taskSet._bruteForce = p_BruteForce;
       taskSet.m_SetSize = GRID_SIZE_Y;
       taskSet._availableLights.clear();
       taskSet._availableIrradProbes.clear();
       taskSet._availableDecals.clear();
       taskSet._availableSpecProbes.clear();
+      taskSet._availableLightBits.clear();
+    }
+
+    if (p_BruteForce)
+    {
+      for (uint32_t z = 0u; z < _gridRes.z; ++z)
+      {
+        CullingParallelTaskSet& taskSet = _cullingTaskSets[z];
+
+        const Math::AABB2 depthSliceAABB = calcAABBForDepthSlice(
+            z, _lightingPerInstanceData.nearFarWidthHeight,
+            _lightingPerInstanceData.nearFar);
+
+        taskSet._availableLightBits.resize((_currentLightCount + 31u) / 32u,
+                                           0u);
+        for (uint32_t i = 0u; i < _currentLightCount; ++i)
+        {
+          const Light& light = _lightBufferMemory[i];
+          if (Math::calcIntersectSphereAABB(
+                  {glm::vec3(light.posAndRadiusVS), light.posAndRadiusVS.w},
+                  depthSliceAABB))
+          {
+            taskSet._availableLights.push_back(i);
+            taskSet._availableLightBits[i / 32u] |= 1u << (i % 32u);
+          }
+        }
 
-      const Math::AABB2 depthSliceAABB =
-          calcAABBForDepthSlice(z, _lightingPerInstanceData.nearFarWidthHeight,
-                                _lightingPerInstanceData.nearFar);
+        for (uint32_t i = 0u; i < _currentIrradProbeCount; ++i)
+        {
+          const IrradProbe& irradProbe = _irradProbeBufferMemory[i];
+          if (Math::calcIntersectSphereAABB(
+                  {glm::vec3(irradProbe.posAndRadiusVS),
+                   irradProbe.posAndRadiusVS.w},
+                  depthSliceAABB))
+          {
+            taskSet._availableIrradProbes.push_back(i);
+          }
+        }
 
+        for (uint32_t i = 0u; i < _currentSpecProbeCount; ++i)
+        {
+          const SpecProbe& specProbe = _specProbeBufferMemory[i];
+          if (Math::calcIntersectSphereAABB(
+                  {glm::vec3(specProbe.posAndRadiusVS),
+                   specProbe.posAndRadiusVS.w},
+                  depthSliceAABB))
+          {
+            taskSet._availableSpecProbes.push_back(i);
+          }
+        }
+
+        for (uint32_t i = 0u; i < _currentDecalCount; ++i)
+        {
+          const Decal& decal = _decalBufferMemory[i];
+
+          if (Math::calcIntersectSphereAABB(
+                  {glm::vec3(decal.posAndRadiusVS), decal.posAndRadiusVS.w},
+                  depthSliceAABB))
+          {
+            taskSet._availableDecals.push_back(i);
+          }
+        }
+      }
+    }
+    else
+    {
+      // Append the items to the depth slices covered by their cluster bounds,
+      // keeping the items ordered
       for (uint32_t i = 0u; i < _currentLightCount; ++i)
       {
-        const Light& light = _lightBufferMemory[i];
-        if (Math::calcIntersectSphereAABB(
-                {glm::vec3(light.posAndRadiusVS), light.posAndRadiusVS.w},
-                depthSliceAABB))
+        for (uint32_t z = _lightBounds[i].minZ; z <= _lightBounds[i].maxZ; ++z)
         {
-          taskSet._availableLights.push_back(i);
+          _cullingTaskSets[z]._availableLights.push_back(i);
         }
       }
 
       for (uint32_t i = 0u; i < _currentIrradProbeCount; ++i)
       {
-        const IrradProbe& irradProbe = _irradProbeBufferMemory[i];
-        if (Math::calcIntersectSphereAABB({glm::vec3(irradProbe.posAndRadiusVS),
-                                           irradProbe.posAndRadiusVS.w},
-                                          depthSliceAABB))
+        for (uint32_t z = _irradProbeBounds[i].minZ;
+             z <= _irradProbeBounds[i].maxZ; ++z)
         {
-          taskSet._availableIrradProbes.push_back(i);
+          _cullingTaskSets[z]._availableIrradProbes.push_back(i);
         }
       }
 
       for (uint32_t i = 0u; i < _currentSpecProbeCount; ++i)
       {
-        const SpecProbe& specProbe = _specProbeBufferMemory[i];
-        if (Math::calcIntersectSphereAABB({glm::vec3(specProbe.posAndRadiusVS),
-                                           specProbe.posAndRadiusVS.w},
-                                          depthSliceAABB))
+        for (uint32_t z = _specProbeBounds[i].minZ;
+             z <= _specProbeBounds[i].maxZ; ++z)
         {
-          taskSet._availableSpecProbes.push_back(i);
+          _cullingTaskSets[z]._availableSpecProbes.push_back(i);
         }
       }
 
       for (uint32_t i = 0u; i < _currentDecalCount; ++i)
       {
-        const Decal& decal = _decalBufferMemory[i];
-
-        if (Math::calcIntersectSphereAABB(
-                {glm::vec3(decal.posAndRadiusVS), decal.posAndRadiusVS.w},
-                depthSliceAABB))
+        for (uint32_t z = _decalBounds[i].minZ; z <= _decalBounds[i].maxZ; ++z)
         {
-          taskSet._availableDecals.push_back(i);
+          _cullingTaskSets[z]._availableDecals.push_back(i);
         }
       }
+    }
+
+    for (uint32_t z = 0u; z < _gridRes.z; ++z)
+    {
+      CullingParallelTaskSet& taskSet = _cullingTaskSets[z];
 
       if (!taskSet._availableLights.empty() ||
           !taskSet._availableSpecProbes.empty() ||
@@ -678,7 +1175,7 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
           !taskSet._availableDecals.empty())
       {
         Application::_scheduler.AddTaskSetToPipe(&taskSet);
-        _activeTaskSets.push_back(z);
+        _activeTaskSets[_activeTaskSetCount++] = z;
         _depthSliceDirtyMask |= 1u << z;
       }
       else if ((_depthSliceDirtyMask & (1u << z)) > 0u)
@@ -692,6 +1189,8 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
 
             const glm::uint32_t lightClusterIdx =
                 calcClusterIndex(cluster, MAX_LIGHT_COUNT_PER_CLUSTER);
+            const glm::uint32_t lightMaskClusterIdx = calcClusterIndex(
+                cluster, MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER);
             const glm::uint32_t specProbeClusterIdx =
                 calcClusterIndex(cluster, MAX_SPEC_PROBES_PER_CLUSTER);
             const glm::uint32_t irradProbeClusterIdx =
@@ -699,7 +1198,15 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
             const glm::uint32_t decalClusterIdx =
                 calcClusterIndex(cluster, MAX_DECALS_PER_CLUSTER);
 
-            (uint32_t&)_lightIndexBufferGpuMemory[lightClusterIdx] = 0u;
+            if (_lightBitmasks)
+            {
+              ((uint32_t*)_lightIndexBufferGpuMemory)[lightMaskClusterIdx] =
+                  0u;
+            }
+            else
+            {
+              (uint32_t&)_lightIndexBufferGpuMemory[lightClusterIdx] = 0u;
+            }
             (uint32_t&)_irradProbeIndexBufferGpuMemory[irradProbeClusterIdx] =
                 0u;
             (uint32_t&)_specProbeIndexBufferGpuMemory[specProbeClusterIdx] = 0u;
@@ -711,6 +1218,34 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
       }
     }
   }
+}
+
+// <-
+
+_INTR_INLINE void waitForCullingJobs()
+{
+  _INTR_PROFILE_CPU("Lighting", "Wait For Jobs");
+
+  for (uint32_t i = 0u; i < _activeTaskSetCount; ++i)
+  {
+    CullingParallelTaskSet& taskSet = _cullingTaskSets[_activeTaskSets[i]];
+    Application::_scheduler.WaitforTaskSet(&taskSet);
+  }
+}
+
+// <-
+
+_INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
+{
+  _INTR_PROFILE_CPU("Clustered", "Cull And Write Buffers");
+
+  // TODO: Add frustum culling broad phase
+  writeItemBuffers(p_CameraRef);
+#if defined(USE_LIGHT_BITMASKS)
+  kickCullingJobs(false, true);
+#else
+  kickCullingJobs(false, false);
+#endif // USE_LIGHT_BITMASKS
 
   memcpy(_lightBufferGpuMemory, _lightBufferMemory,
          _currentLightCount * sizeof(Light));
@@ -721,15 +1256,7 @@ _INTR_INLINE void cullAndWriteBuffers(Components::CameraRef p_CameraRef)
   memcpy(_decalBufferGpuMemory, _decalBufferMemory,
          _currentDecalCount * sizeof(Decal));
 
-  {
-    _INTR_PROFILE_CPU("Lighting", "Wait For Jobs");
-
-    for (uint32_t i = 0u; i < _activeTaskSets.size(); ++i)
-    {
-      CullingParallelTaskSet& taskSet = _cullingTaskSets[_activeTaskSets[i]];
-      Application::_scheduler.WaitforTaskSet(&taskSet);
-    }
-  }
+  waitForCullingJobs();
 }
 
 // <-
@@ -939,7 +1466,7 @@ void Clustering::init()
 
   PipelineLayoutManager::createResources(pipelineLayoutsToCreate);
   RenderPassManager::createResources(renderpassesToCreate);
-  PipelineManager::createResources(pipelinesToCreate);
+  PipelineManager::createResourcesAsync(pipelinesToCreate);
 
   _INTR_ARRAY(BufferRef) buffersToCreate;
 
@@ -969,7 +1496,7 @@ void Clustering::init()
       BufferManager::_descMemoryPoolType(_lightIndexBuffer) =
           MemoryPoolType::kStaticStagingBuffers;
       BufferManager::_descSizeInBytes(_lightIndexBuffer) =
-          _totalLightGridSize * sizeof(uint16_t);
+          _lightIndexBufferSizeInBytes;
       buffersToCreate.push_back(_lightIndexBuffer);
     }
 
@@ -1071,8 +1598,8 @@ void Clustering::init()
       _lightBufferGpuMemory = (Light*)BufferManager::getGpuMemory(_lightBuffer);
       _lightIndexBufferGpuMemory =
           (uint16_t*)BufferManager::getGpuMemory(_lightIndexBuffer);
-      memset(_lightIndexBufferGpuMemory, 0x00,
-             sizeof(uint16_t) * _totalLightGridSize);
+      memset(_lightIndexBufferGpuMemory, 0x00, _lightIndexBufferSizeInBytes);
+      _lightIndexMemorySizeInBytes = _lightIndexBufferSizeInBytes;
 
       _lightBufferMemory = (Light*)malloc(_totalLightGridSize * sizeof(Light));
     }
@@ -1406,15 +1933,14 @@ void Clustering::destroy() {}
 
 namespace
 {
-void spawnAndSimulateTestLights(Components::CameraRef p_CameraRef)
+void spawnAndSimulateTestLights(const glm::mat4& p_ViewMatrix,
+                                uint32_t p_TestLightCount)
 {
-  // Spawn lights if none are there yet
-  if (_testLights.empty())
+  // (Re-)Spawn lights if the count changed
+  if (_testLights.size() != p_TestLightCount)
   {
-    static uint32_t testLightCount = 4096u * 4u;
-
-    _testLights.resize(testLightCount);
-    for (uint32_t i = 0u; i < testLightCount; ++i)
+    _testLights.resize(p_TestLightCount);
+    for (uint32_t i = 0u; i < p_TestLightCount; ++i)
     {
       TestLight& light = _testLights[i];
       light.spawnPos =
@@ -1438,14 +1964,120 @@ void spawnAndSimulateTestLights(Components::CameraRef p_CameraRef)
                                          TaskManager::_totalTimePassed * 0.1f),
         light.spawnPos.z);
 
-    light.light.posAndRadiusVS = glm::vec4(
-        glm::vec3(Components::CameraManager::_viewMatrix(p_CameraRef) *
-                  glm::vec4(worldPos, 1.0f)),
-        light.light.posAndRadiusVS.w);
+    light.light.posAndRadiusVS =
+        glm::vec4(glm::vec3(p_ViewMatrix * glm::vec4(worldPos, 1.0f)),
+                  light.light.posAndRadiusVS.w);
   }
 }
+
+// <-
+
+void updateGridParameters(const glm::mat4& p_InverseProjectionMatrix,
+                          float p_NearPlane, float p_FarPlane)
+{
+  _lightingPerInstanceData.nearFar =
+      glm::vec4(p_NearPlane, p_FarPlane, 0.0f, 0.0f);
+
+  Math::FrustumCorners viewSpaceCorners;
+  Math::extractFrustumsCorners(p_InverseProjectionMatrix, viewSpaceCorners);
+
+  _lightingPerInstanceData.nearFarWidthHeight = glm::vec4(
+      viewSpaceCorners.c[3].x - viewSpaceCorners.c[2].x /* Near Width */,
+      viewSpaceCorners.c[2].y - viewSpaceCorners.c[1].y /* Near Height */,
+      viewSpaceCorners.c[7].x - viewSpaceCorners.c[6].x /* Far Width */,
+      viewSpaceCorners.c[6].y - viewSpaceCorners.c[5].y /* Far Height */);
+}
+}
+
+// <-
+
+uint32_t Clustering::binTestLights(uint32_t p_TestLightCount,
+                                   const glm::mat4& p_ViewMatrix,
+                                   const glm::mat4& p_ProjectionMatrix,
+                                   float p_NearPlane, float p_FarPlane,
+                                   bool p_BruteForce, bool p_LightBitmasks)
+{
+  _INTR_PROFILE_CPU("Lighting", "Bin Test Lights");
+
+  // Fall back to CPU memory if the renderer isn't initialized
+  if (_lightBufferMemory == nullptr)
+  {
+    _lightBufferMemory = (Light*)malloc(_totalLightGridSize * sizeof(Light));
+    _lightIndexMemorySizeInBytes =
+        std::max(_lightIndexListsSizeInBytes, _lightBitmasksSizeInBytes);
+    _lightIndexBufferGpuMemory =
+        (uint16_t*)calloc(_lightIndexMemorySizeInBytes, 1u);
+    _irradProbeIndexBufferGpuMemory =
+        (uint16_t*)calloc(_totalIrradGridSize, sizeof(uint16_t));
+    _specProbeIndexBufferGpuMemory =
+        (uint16_t*)calloc(_totalSpecGridSize, sizeof(uint16_t));
+    _decalIndexBufferGpuMemory =
+        (uint16_t*)calloc(_totalDecalGridSize, sizeof(uint16_t));
+  }
+
+  _INTR_ASSERT(p_TestLightCount <= MAX_LIGHT_COUNT &&
+               "Max. light count exceeded");
+
+  // The light index buffer of the renderer only fits the layout in use
+  const uint32_t requiredSizeInBytes = p_LightBitmasks
+                                           ? _lightBitmasksSizeInBytes
+                                           : _lightIndexListsSizeInBytes;
+  if (requiredSizeInBytes > _lightIndexMemorySizeInBytes)
+  {
+    _INTR_ASSERT(false && "Light index buffer too small for this layout");
+    return 0u;
+  }
+
+  spawnAndSimulateTestLights(p_ViewMatrix, p_TestLightCount);
+  updateGridParameters(glm::inverse(p_ProjectionMatrix), p_NearPlane,
+                       p_FarPlane);
+
+  _currentLightCount = 0u;
+  for (uint32_t i = 0u; i < _testLights.size(); ++i)
+  {
+    _lightBufferMemory[_currentLightCount++] = _testLights[i].light;
+  }
+  _currentIrradProbeCount = 0u;
+  _currentSpecProbeCount = 0u;
+  _currentDecalCount = 0u;
+
+  kickCullingJobs(p_BruteForce, p_LightBitmasks);
+  waitForCullingJobs();
+
+  uint32_t lightIdxCount = 0u;
+  for (uint32_t z = 0u; z < _gridRes.z; ++z)
+  {
+    for (uint32_t y = 0u; y < _gridRes.y; ++y)
+    {
+      for (uint32_t x = 0u; x < _gridRes.x; ++x)
+      {
+        const glm::uvec3 cluster = glm::uvec3(x, y, z);
+
+        if (p_LightBitmasks)
+        {
+          const uint32_t* lightMask =
+              &((uint32_t*)_lightIndexBufferGpuMemory)[calcClusterIndex(
+                  cluster, MAX_LIGHT_MASK_WORD_COUNT_PER_CLUSTER)];
+
+          for (uint32_t w = 0u; w < lightMask[0]; ++w)
+          {
+            lightIdxCount += Math::calcBitCount(lightMask[w + 1u]);
+          }
+        }
+        else
+        {
+          lightIdxCount += (uint32_t&)_lightIndexBufferGpuMemory
+              [calcClusterIndex(cluster, MAX_LIGHT_COUNT_PER_CLUSTER)];
+        }
+      }
+    }
+  }
+
+  return lightIdxCount;
 }
 
+// <-
+
 void Clustering::render(float p_DeltaT, Components::CameraRef p_CameraRef)
 {
   _INTR_PROFILE_CPU("Render Pass", "Render Clustering");
@@ -1459,7 +2091,8 @@ void Clustering::render(float p_DeltaT, Components::CameraRef p_CameraRef)
 
     if (Entity::EntityManager::_name(rootEntityRef) == _N(LightingTest))
     {
-      spawnAndSimulateTestLights(p_CameraRef);
+      spawnAndSimulateTestLights(
+          Components::CameraManager::_viewMatrix(p_CameraRef), 4096u * 4u);
     }
     else
     {
@@ -1467,23 +2100,10 @@ void Clustering::render(float p_DeltaT, Components::CameraRef p_CameraRef)
     }
   }
 
-  // Update global per instance data
-  {
-    _lightingPerInstanceData.nearFar = glm::vec4(
-        Components::CameraManager::_descNearPlane(p_CameraRef),
-        Components::CameraManager::_descFarPlane(p_CameraRef), 0.0f, 0.0f);
-
-    Math::FrustumCorners viewSpaceCorners;
-    Math::extractFrustumsCorners(
-        Components::CameraManager::_inverseProjectionMatrix(p_CameraRef),
-        viewSpaceCorners);
-
-    _lightingPerInstanceData.nearFarWidthHeight = glm::vec4(
-        viewSpaceCorners.c[3].x - viewSpaceCorners.c[2].x /* Near Width */,
-        viewSpaceCorners.c[2].y - viewSpaceCorners.c[1].y /* Near Height */,
-        viewSpaceCorners.c[7].x - viewSpaceCorners.c[6].x /* Far Width */,
-        viewSpaceCorners.c[6].y - viewSpaceCorners.c[5].y /* Far Height */);
-  }
+  updateGridParameters(
+      Components::CameraManager::_inverseProjectionMatrix(p_CameraRef),
+      Components::CameraManager::_descNearPlane(p_CameraRef),
+      Components::CameraManager::_descFarPlane(p_CameraRef));
 
   cullAndWriteBuffers(p_CameraRef);
 
@@ -29,6 +29,16 @@ struct Clustering
 
   static void render(float p_DeltaT, Components::CameraRef p_CameraRef);
 
+  // CPU only binning of the given amount of animated test lights, returns the
+  // total amount of lights assigned to the clusters. "p_BruteForce" tests
+  // every light against all clusters of the intersected depth slices and
+  // "p_LightBitmasks" writes bitmasks instead of index lists
+  static uint32_t binTestLights(uint32_t p_TestLightCount,
+                                const glm::mat4& p_ViewMatrix,
+                                const glm::mat4& p_ProjectionMatrix,
+                                float p_NearPlane, float p_FarPlane,
+                                bool p_BruteForce, bool p_LightBitmasks);
+
   static float _globalIrradianceFactor;
   static float _globalSpecularFactor;
 };
@@ -342,7 +342,7 @@ void Debug::onReinitRendering()
     drawCallsToCreate.push_back(drawCallLine);
   }
 
-  PipelineManager::createResources(pipelinesToCreate);
+  PipelineManager::createResourcesAsync(pipelinesToCreate);
   DrawCallManager::createResources(drawCallsToCreate);
 
   _albedoImageRef = ImageManager::getResourceByName(_N(GBufferAlbedo));
@@ -94,7 +94,7 @@ void GenericFullscreen::init(const rapidjson::Value& p_RenderPassDesc)
   pipelinesToCreate.push_back(_pipelineRef);
 
   PipelineLayoutManager::createResources(pipelineLayoutsToCreate);
-  PipelineManager::createResources(pipelinesToCreate);
+  PipelineManager::createResourcesAsync(pipelinesToCreate);
 
   // Draw calls
   _drawCallRef = DrawCallManager::createDrawCall(_name);
@@ -30,22 +30,16 @@ void GenericMesh::init(const rapidjson::Value& p_RenderPassDesc)
   const rapidjson::Value& materialPassDescs =
       p_RenderPassDesc["materialPasses"];
 
+  _renderOrder =
+      Helper::mapRenderOrder(p_RenderPassDesc["renderOrder"].GetString());
+
   for (uint32_t i = 0u; i < materialPassDescs.Size(); ++i)
   {
-    _materialPassNames.push_back(materialPassDescs[i].GetString());
-  }
+    const _INTR_STRING materialPassName = materialPassDescs[i].GetString();
 
-  if (p_RenderPassDesc["renderOrder"] == "FrontToBack")
-  {
-    _renderOrder = RenderOrder::kFrontToBack;
-  }
-  else if (p_RenderPassDesc["renderOrder"] == "BackToFront")
-  {
-    _renderOrder = RenderOrder::kBackToFront;
-  }
-  else
-  {
-    _INTR_ASSERT(false && "Unknown render order");
+    _materialPassNames.push_back(materialPassName);
+    DrawCallManager::_renderOrderPerMaterialPassName[materialPassName] =
+        _renderOrder;
   }
 }
 
@@ -55,6 +49,12 @@ void GenericMesh::destroy()
 {
   Base::destroy();
 
+  for (uint32_t i = 0u; i < _materialPassNames.size(); ++i)
+  {
+    DrawCallManager::_renderOrderPerMaterialPassName.erase(
+        _materialPassNames[i]);
+  }
+
   _materialPassIds.clear();
   _materialPassNames.clear();
 }
@@ -91,10 +91,7 @@ void GenericMesh::render(float p_DeltaT, Components::CameraRef p_CameraRef)
         .copy(visibleDrawCalls);
   }
 
-  if (_renderOrder == RenderOrder::kFrontToBack)
-    DrawCallManager::sortDrawCallsFrontToBack(visibleDrawCalls);
-  else if (_renderOrder == RenderOrder::kBackToFront)
-    DrawCallManager::sortDrawCallsBackToFront(visibleDrawCalls);
+  DrawCallManager::sortDrawCalls(visibleDrawCalls);
 
   // Update per mesh uniform data
   {
@@ -278,19 +278,14 @@ void Shadow::render(float p_DeltaT, Components::CameraRef p_CameraRef)
     static DrawCallRefArray visibleDrawCalls;
     visibleDrawCalls.clear();
 
-    RenderProcess::Default::getVisibleDrawCalls(
-        p_CameraRef, frustumIdx, MaterialManager::getMaterialPassId(_N(Shadow)))
-        .copy(visibleDrawCalls);
-    RenderProcess::Default::getVisibleDrawCalls(
-        p_CameraRef, frustumIdx,
-        MaterialManager::getMaterialPassId(_N(ShadowFoliage)))
-        .copy(visibleDrawCalls);
-    RenderProcess::Default::getVisibleDrawCalls(
-        p_CameraRef, frustumIdx,
-        MaterialManager::getMaterialPassId(_N(ShadowGrass)))
-        .copy(visibleDrawCalls);
-
-    DrawCallManager::sortDrawCallsFrontToBack(visibleDrawCalls);
+    for (uint32_t i = 0u; i < shadowMaterialPassCount; ++i)
+    {
+      RenderProcess::Default::getVisibleDrawCalls(p_CameraRef, frustumIdx,
+                                                  shadowMaterialPassIds[i])
+          .copy(visibleDrawCalls);
+    }
+
+    DrawCallManager::sortDrawCalls(visibleDrawCalls);
 
     // Update per mesh uniform data
     {
@@ -505,7 +505,7 @@ void VolumetricLighting::init()
   }
 
   PipelineLayoutManager::createResources(pipelineLayoutsToCreate);
-  PipelineManager::createResources(pipelinesToCreate);
+  PipelineManager::createResourcesAsync(pipelinesToCreate);
 
   ImageRefArray imgsToCreate;
   ComputeCallRefArray computeCallsToCreate;
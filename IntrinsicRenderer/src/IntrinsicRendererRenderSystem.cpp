@@ -27,6 +27,10 @@ bool _swapChainUpdatePending = false;
 const float _timeBetweenSwapChainUpdates = 1.0f;
 float _timePassedSinceLastSwapChainUpdate = _timeBetweenSwapChainUpdates;
 
+const float _timeBetweenPipelineCacheSaves = 30.0f;
+float _timePassedSinceLastPipelineCacheSave = 0.0f;
+size_t _savedPipelineCacheSize = 0u;
+
 VkPhysicalDeviceProperties _vkPhysicalDeviceProps;
 VkPhysicalDeviceFeatures _vkPhysicalDeviceFeatures;
 
@@ -45,6 +49,78 @@ _INTR_STRING getPipelineCacheFilePath()
 {
   return "media/pipeline_caches/" + getPipelineCacheUUID() + ".pc";
 }
+
+// Checks the header (VK_PIPELINE_CACHE_HEADER_VERSION_ONE) of the pipeline
+// cache data against the current device and driver
+bool isPipelineCacheDataValid(const _INTR_ARRAY(uint8_t) & p_Data)
+{
+  const uint32_t headerSize = 4u * sizeof(uint32_t) + VK_UUID_SIZE;
+  if (p_Data.size() < headerSize)
+  {
+    return false;
+  }
+
+  uint32_t header[4];
+  memcpy(header, p_Data.data(), sizeof(header));
+
+  return header[0] >= headerSize &&
+         header[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+         header[2] == _vkPhysicalDeviceProps.vendorID &&
+         header[3] == _vkPhysicalDeviceProps.deviceID &&
+         memcmp(&p_Data[sizeof(header)],
+                _vkPhysicalDeviceProps.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
+
+void savePipelineCache()
+{
+  _INTR_PROFILE_CPU("Render System", "Save Pipeline Cache");
+
+  _INTR_ARRAY(uint8_t) pipelineData;
+
+  size_t pipelineDataSize;
+  VkResult result =
+      vkGetPipelineCacheData(RenderSystem::_vkDevice,
+                             RenderSystem::_vkPipelineCache, &pipelineDataSize,
+                             nullptr);
+  _INTR_VK_CHECK_RESULT(result);
+
+  pipelineData.resize(pipelineDataSize);
+  result = vkGetPipelineCacheData(RenderSystem::_vkDevice,
+                                  RenderSystem::_vkPipelineCache,
+                                  &pipelineDataSize, pipelineData.data());
+  _INTR_VK_CHECK_RESULT(result);
+
+  _INTR_STRING pipelineCachePath = getPipelineCacheFilePath();
+  _INTR_OFSTREAM of(pipelineCachePath.c_str(), std::ofstream::binary);
+  of.write((const char*)pipelineData.data(), pipelineDataSize);
+  of.close();
+
+  _savedPipelineCacheSize = pipelineDataSize;
+}
+
+// Saves the pipeline cache if new pipelines have been added since the last
+// save
+void updatePipelineCache()
+{
+  _timePassedSinceLastPipelineCacheSave += TaskManager::_lastDeltaT;
+  if (_timePassedSinceLastPipelineCacheSave < _timeBetweenPipelineCacheSaves)
+  {
+    return;
+  }
+  _timePassedSinceLastPipelineCacheSave = 0.0f;
+
+  size_t pipelineDataSize;
+  VkResult result =
+      vkGetPipelineCacheData(RenderSystem::_vkDevice,
+                             RenderSystem::_vkPipelineCache, &pipelineDataSize,
+                             nullptr);
+  _INTR_VK_CHECK_RESULT(result);
+
+  if (pipelineDataSize != _savedPipelineCacheSize)
+  {
+    savePipelineCache();
+  }
+}
 }
 
 // Public static members
@@ -119,6 +195,7 @@ void RenderSystem::init(void* p_PlatformHandle, void* p_PlatformWindow)
 
   {
     GpuMemoryManager::init();
+    UploadQueue::init();
     Samplers::init();
     initManagers();
   }
@@ -196,20 +273,10 @@ void RenderSystem::init(void* p_PlatformHandle, void* p_PlatformWindow)
 
 void RenderSystem::shutdown()
 {
-  _INTR_ARRAY(uint8_t) pipelineData;
-
-  size_t pipelineDataSize;
-  vkGetPipelineCacheData(_vkDevice, _vkPipelineCache, &pipelineDataSize,
-                         nullptr);
+  UploadQueue::destroy();
+  PipelineManager::waitForPendingResources();
 
-  pipelineData.resize(pipelineDataSize);
-  vkGetPipelineCacheData(_vkDevice, _vkPipelineCache, &pipelineDataSize,
-                         pipelineData.data());
-
-  _INTR_STRING pipelineCachePath = getPipelineCacheFilePath();
-  _INTR_OFSTREAM of(pipelineCachePath.c_str(), std::ofstream::binary);
-  of.write((const char*)pipelineData.data(), pipelineData.size());
-  of.close();
+  savePipelineCache();
 }
 
 // <-
@@ -297,8 +364,9 @@ void RenderSystem::reinitRendering()
   Components::MeshManager::createResources(
       Components::MeshManager::_activeRefs);
 
-  // Recreate all pipelines (to update the view port size)
-  PipelineManager::createAllResources();
+  // Recreate all pipelines (to update the view port size) - the pipelines of
+  // the render passes and material passes have already been queued above
+  PipelineManager::createAllResourcesAsync();
 }
 
 // <-
@@ -313,6 +381,12 @@ void RenderSystem::dispatchComputeCall(Dod::Ref p_ComputeCall,
       ComputeCallManager::_descDimensions(p_ComputeCall);
 
   VkPipeline newPipeline = PipelineManager::_vkPipeline(pipelineRef);
+  if (newPipeline == VK_NULL_HANDLE)
+  {
+    ++DrawCallDispatcher::_skippedDrawCallCount;
+    return;
+  }
+
   vkCmdBindPipeline(p_CommandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE,
                     newPipeline);
 
@@ -340,6 +414,12 @@ void RenderSystem::dispatchDrawCall(Dod::Ref p_DrawCall,
       PipelineManager::_descPipelineLayout(pipelineRef);
 
   VkPipeline newPipeline = PipelineManager::_vkPipeline(pipelineRef);
+  if (newPipeline == VK_NULL_HANDLE)
+  {
+    ++DrawCallDispatcher::_skippedDrawCallCount;
+    return;
+  }
+
   vkCmdBindPipeline(p_CommandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS,
                     newPipeline);
 
@@ -1075,6 +1155,15 @@ void RenderSystem::initVkPipelineCache()
 
   ifs.close();
 
+  // Never feed data created by a different device or driver to the driver
+  if (!pipelineCacheData.empty() &&
+      !isPipelineCacheDataValid(pipelineCacheData))
+  {
+    _INTR_LOG_WARNING("Pipeline cache is outdated, discarding it...");
+    pipelineCacheData.clear();
+  }
+  _savedPipelineCacheSize = pipelineCacheData.size();
+
   VkPipelineCacheCreateInfo pipelineCache = {};
   {
     pipelineCache.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
@@ -1338,6 +1427,8 @@ void RenderSystem::beginFrame()
 
   {
     releaseQueuedResources();
+    PipelineManager::updatePendingResources();
+    updatePipelineCache();
   }
 
   {
@@ -1368,6 +1459,7 @@ void RenderSystem::beginFrame()
 
   UniformManager::onFrameEnded();
   DrawCallDispatcher::onFrameEnded();
+  DrawCallManager::onFrameEnded();
 }
 
 // <-
@@ -1385,6 +1477,11 @@ void RenderSystem::endFrame()
     endPrimaryCommandBuffer();
   }
 
+  {
+    // Submit all uploads issued since the last frame ahead of the frame
+    UploadQueue::flush();
+  }
+
   {
     _INTR_PROFILE_CPU("Render System", "Queue Submit");
 
@@ -1429,6 +1526,7 @@ void RenderSystem::endFrame()
   }
 
   GpuMemoryManager::updateMemoryStats();
+  Memory::Tlsf::MainAllocator::updateMemoryStats();
 }
 }
 }
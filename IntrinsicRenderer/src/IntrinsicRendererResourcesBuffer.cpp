@@ -23,11 +23,6 @@ namespace Resources
 {
 void BufferManager::createResources(const BufferRefArray& p_Buffers)
 {
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
-  _INTR_ARRAY(VkBuffer) stagingBuffersToDestroy;
-  stagingBuffersToDestroy.reserve(p_Buffers.size());
-
   for (uint32_t i = 0u; i < p_Buffers.size(); ++i)
   {
     BufferRef bufferRef = p_Buffers[i];
@@ -89,58 +84,19 @@ void BufferManager::createResources(const BufferRefArray& p_Buffers)
     void* initialData = _descInitialData(bufferRef);
     if (initialData)
     {
-      VkBufferCreateInfo stagingBufferCreateInfo = bufferCreateInfo;
-      {
-        stagingBufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-      }
-
-      VkBuffer stagingBuffer;
-      result = vkCreateBuffer(RenderSystem::_vkDevice, &stagingBufferCreateInfo,
-                              nullptr, &stagingBuffer);
-      _INTR_VK_CHECK_RESULT(result);
-
-      VkMemoryRequirements stagingMemReqs;
-      vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                    &stagingMemReqs);
-
-      const GpuMemoryAllocationInfo stagingGpuAllocInfo =
-          GpuMemoryManager::allocateOffset(
-              MemoryPoolType::kVolatileStagingBuffers,
-              (uint32_t)stagingMemReqs.size, (uint32_t)stagingMemReqs.alignment,
-              stagingMemReqs.memoryTypeBits);
-
-      result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                                  stagingGpuAllocInfo._vkDeviceMemory,
-                                  stagingGpuAllocInfo._offset);
-      _INTR_VK_CHECK_RESULT(result);
-
-      // Copy initial data to staging memory
+      if (memoryAllocationInfo._mappedMemory != nullptr)
       {
-        memcpy(stagingGpuAllocInfo._mappedMemory, initialData,
+        // Host visible buffers can be initialized directly
+        memcpy(memoryAllocationInfo._mappedMemory, initialData,
                _descSizeInBytes(bufferRef));
       }
-
-      VkBufferCopy bufferCopy = {};
+      else
       {
-        bufferCopy.dstOffset = 0u;
-        bufferCopy.srcOffset = 0u;
-        bufferCopy.size = _descSizeInBytes(bufferRef);
+        UploadQueue::uploadBuffer(buffer, 0u, initialData,
+                                  _descSizeInBytes(bufferRef));
       }
-
-      // Finally copy from the staging buffer to the actual buffer
-      vkCmdCopyBuffer(copyCmd, stagingBuffer, buffer, 1u, &bufferCopy);
     }
   }
-
-  RenderSystem::flushTemporaryCommandBuffer();
-
-  for (uint32_t i = 0u; i < stagingBuffersToDestroy.size(); ++i)
-  {
-    vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffersToDestroy[i],
-                    nullptr);
-  }
-
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
 }
 }
 }
@@ -26,6 +26,179 @@ namespace Resources
 // Static members
 _INTR_ARRAY(_INTR_ARRAY(DrawCallRef))
 DrawCallManager::_drawCallsPerMaterialPass;
+DrawCallRefArray DrawCallManager::_instancedDrawCalls;
+uint32_t DrawCallManager::_drawCallCountBeforeInstancingPerFrame = 0u;
+uint32_t DrawCallManager::_drawCallCountAfterInstancingPerFrame = 0u;
+RenderOrder::Enum DrawCallManager::_renderOrderPerMaterialPass
+    [_INTR_MAX_MATERIAL_PASS_COUNT] = {};
+_INTR_HASH_MAP(Name, RenderOrder::Enum)
+DrawCallManager::_renderOrderPerMaterialPassName;
+
+// <-
+
+namespace
+{
+Algorithm::SortKeyValuePairArray _sortPairs;
+Algorithm::SortKeyValuePairArray _sortPairsTemp;
+
+_INTR_HASH_MAP(uint64_t, uint32_t) _openBatchPerInstancingKey;
+_INTR_ARRAY(uint32_t) _batchIdxPerDrawCall;
+_INTR_ARRAY(DrawCallRef) _batchLeadDrawCalls;
+_INTR_ARRAY(uint32_t) _batchInstanceCounts;
+
+// Layout of the 64 bit instancing key (most significant bits first)
+//
+// pass (8) | material (16) | index buffer (20) | vertex buffer (20)
+//
+// The buffers are unique per sub mesh, so draw calls with the same key can
+// share the pipeline, descriptor set and mesh buffers
+_INTR_INLINE uint64_t calcInstancingKey(DrawCallRef p_DrawCall)
+{
+  const _INTR_ARRAY(BufferRef)& vtxBuffers =
+      DrawCallManager::_descVertexBuffers(p_DrawCall);
+  const BufferRef vtxBufferRef =
+      !vtxBuffers.empty() ? vtxBuffers[0] : BufferRef();
+
+  return ((uint64_t)DrawCallManager::_descMaterialPass(p_DrawCall) << 56u) |
+         ((uint64_t)(DrawCallManager::_descMaterial(p_DrawCall)._id & 0xFFFFu)
+          << 40u) |
+         ((uint64_t)(DrawCallManager::_descIndexBuffer(p_DrawCall)._id &
+                     0xFFFFFu)
+          << 20u) |
+         (uint64_t)(vtxBufferRef._id & 0xFFFFFu);
+}
+}
+
+// <-
+
+void DrawCallManager::sortDrawCalls(DrawCallRefArray& p_RefArray)
+{
+  _INTR_PROFILE_CPU("General", "Sort Draw Calls");
+
+  // Gather the keys once so the sort itself only touches linear memory
+  _sortPairs.resize(p_RefArray.size());
+  for (uint32_t i = 0u; i < p_RefArray.size(); ++i)
+  {
+    const DrawCallRef drawCallRef = p_RefArray[i];
+
+    Algorithm::SortKeyValuePair& pair = _sortPairs[i];
+    pair.key = _sortingHash(drawCallRef);
+    pair.value = drawCallRef;
+  }
+
+  Algorithm::radixSort(_sortPairs, _sortPairsTemp);
+
+  for (uint32_t i = 0u; i < p_RefArray.size(); ++i)
+  {
+    p_RefArray[i] = _sortPairs[i].value;
+  }
+}
+
+// <-
+
+void DrawCallManager::batchInstancedDrawCalls(DrawCallRefArray& p_RefArray)
+{
+  _INTR_PROFILE_CPU("General", "Batch Instanced Draw Calls");
+
+  const uint32_t dcCount = (uint32_t)p_RefArray.size();
+  _drawCallCountBeforeInstancingPerFrame += dcCount;
+
+  _openBatchPerInstancingKey.clear();
+  _batchLeadDrawCalls.clear();
+  _batchInstanceCounts.clear();
+  _batchIdxPerDrawCall.resize(dcCount);
+
+  // Assign the draw calls to batches, a batch is closed as soon as it reaches
+  // the max. instance count
+  for (uint32_t dcIdx = 0u; dcIdx < dcCount; ++dcIdx)
+  {
+    const DrawCallRef drawCallRef = p_RefArray[dcIdx];
+    const uint8_t materialPass = _descMaterialPass(drawCallRef);
+
+    if (!MaterialManager::_materialPasses[materialPass].instanced)
+    {
+      _instanceCount(drawCallRef) = _descInstanceCount(drawCallRef);
+      _batchIdxPerDrawCall[dcIdx] = (uint32_t)-1;
+      continue;
+    }
+
+    const uint64_t key = calcInstancingKey(drawCallRef);
+    auto openBatch = _openBatchPerInstancingKey.find(key);
+
+    if (openBatch == _openBatchPerInstancingKey.end() ||
+        _batchInstanceCounts[openBatch->second] ==
+            _INTR_VK_MAX_INSTANCE_COUNT_PER_DRAW_CALL)
+    {
+      const uint32_t batchIdx = (uint32_t)_batchLeadDrawCalls.size();
+      _batchLeadDrawCalls.push_back(drawCallRef);
+      _batchInstanceCounts.push_back(0u);
+      _openBatchPerInstancingKey[key] = batchIdx;
+      _batchIdxPerDrawCall[dcIdx] = batchIdx;
+    }
+    else
+    {
+      _batchIdxPerDrawCall[dcIdx] = openBatch->second;
+    }
+
+    ++_batchInstanceCounts[_batchIdxPerDrawCall[dcIdx]];
+  }
+
+  // Prefix sum over the instance counts to place the instances of each batch
+  // next to each other
+  uint32_t instanceCount = 0u;
+  for (uint32_t batchIdx = 0u; batchIdx < _batchLeadDrawCalls.size();
+       ++batchIdx)
+  {
+    const DrawCallRef leadDrawCallRef = _batchLeadDrawCalls[batchIdx];
+    _firstInstanceIdx(leadDrawCallRef) = instanceCount;
+    _instanceCount(leadDrawCallRef) = 0u;
+
+    instanceCount += _batchInstanceCounts[batchIdx];
+  }
+  _instancedDrawCalls.resize(instanceCount);
+
+  // Scatter the instances and keep the first draw call of each batch at the
+  // position of its first instance to retain the sort order
+  uint32_t keptDcCount = 0u;
+  for (uint32_t dcIdx = 0u; dcIdx < dcCount; ++dcIdx)
+  {
+    const DrawCallRef drawCallRef = p_RefArray[dcIdx];
+    const uint32_t batchIdx = _batchIdxPerDrawCall[dcIdx];
+
+    if (batchIdx == (uint32_t)-1)
+    {
+      p_RefArray[keptDcCount++] = drawCallRef;
+      continue;
+    }
+
+    const DrawCallRef leadDrawCallRef = _batchLeadDrawCalls[batchIdx];
+    uint32_t& leadInstanceCount = _instanceCount(leadDrawCallRef);
+    _instancedDrawCalls[_firstInstanceIdx(leadDrawCallRef) +
+                        leadInstanceCount] = drawCallRef;
+    ++leadInstanceCount;
+
+    if (leadDrawCallRef == drawCallRef)
+    {
+      p_RefArray[keptDcCount++] = drawCallRef;
+    }
+  }
+  p_RefArray.resize(keptDcCount);
+
+  _drawCallCountAfterInstancingPerFrame += keptDcCount;
+}
+
+// <-
+
+void DrawCallManager::onFrameEnded()
+{
+  _INTR_PROFILE_COUNTER_SET("Draw Calls Before Instancing",
+                            _drawCallCountBeforeInstancingPerFrame);
+  _INTR_PROFILE_COUNTER_SET("Draw Calls After Instancing",
+                            _drawCallCountAfterInstancingPerFrame);
+
+  _drawCallCountBeforeInstancingPerFrame = 0u;
+  _drawCallCountAfterInstancingPerFrame = 0u;
+}
 
 // <-
 
@@ -48,6 +221,19 @@ void DrawCallManager::createResources(const DrawCallRefArray& p_DrawCalls)
     descSet = Resources::PipelineLayoutManager::allocateAndWriteDescriptorSet(
         pipelineLayout, bindInfos);
 
+    // Draw calls sharing the same state end up next to each other when
+    // sorted, see "updateSortingHash"
+    {
+      const BufferRef meshBufferRef = !descVtxBuffers.empty()
+                                          ? descVtxBuffers[0]
+                                          : _descIndexBuffer(drawCallRef);
+
+      _stateSortingKey(drawCallRef) =
+          ((uint64_t)(pipelineRef._id & 0xFFFu) << 24u) |
+          ((uint64_t)(_descMaterial(drawCallRef)._id & 0xFFFu) << 12u) |
+          (uint64_t)(meshBufferRef._id & 0xFFFu);
+    }
+
     // Defaults for now
     _indexBufferOffset(drawCallRef) = 0ull;
     _vertexBufferOffsets(drawCallRef).resize(descVtxBuffers.size());
@@ -58,12 +244,16 @@ void DrawCallManager::createResources(const DrawCallRefArray& p_DrawCalls)
       vtxBuffers[i] = BufferManager::_vkBuffer(descVtxBuffers[i]);
     }
 
+    _instanceCount(drawCallRef) = _descInstanceCount(drawCallRef);
+    _firstInstanceIdx(drawCallRef) = 0u;
+
     uint32_t dynamicOffsetCount = 0u;
     for (uint32_t bindIdx = 0u; bindIdx < (uint32_t)bindInfos.size(); ++bindIdx)
     {
       BindingInfo& bindInfo = bindInfos[bindIdx];
 
-      if (bindInfo.bindingType == BindingType::kUniformBufferDynamic)
+      if (bindInfo.bindingType == BindingType::kUniformBufferDynamic ||
+          bindInfo.bindingType == BindingType::kStorageBufferDynamic)
       {
         ++dynamicOffsetCount;
       }
@@ -191,18 +381,14 @@ DrawCallRef DrawCallManager::createDrawCallForMesh(
     _descPipeline(drawCallMesh) = MaterialManager::_materialPassPipelines
         [MaterialManager::_materialPasses[p_MaterialPass].pipelineIdx];
 
-    _INTR_ASSERT(PipelineManager::_vkPipeline(_descPipeline(drawCallMesh)));
-
     _descVertexBuffers(drawCallMesh) =
         MeshManager::_vertexBuffersPerSubMesh(p_Mesh)[p_SubMeshIdx];
     _descIndexBuffer(drawCallMesh) =
         MeshManager::_indexBufferPerSubMesh(p_Mesh)[p_SubMeshIdx];
     _descVertexCount(drawCallMesh) =
-        (uint32_t)MeshManager::_descPositionsPerSubMesh(p_Mesh)[p_SubMeshIdx]
-            .size();
+        MeshManager::_vertexCountPerSubMesh(p_Mesh)[p_SubMeshIdx];
     _descIndexCount(drawCallMesh) =
-        (uint32_t)MeshManager::_descIndicesPerSubMesh(p_Mesh)[p_SubMeshIdx]
-            .size();
+        MeshManager::_indexCountPerSubMesh(p_Mesh)[p_SubMeshIdx];
     _descMaterial(drawCallMesh) = p_Material;
     _descMaterialPass(drawCallMesh) = p_MaterialPass;
 
@@ -245,6 +431,22 @@ DrawCallRef DrawCallManager::createDrawCallForMesh(
                   ? sizeof(PerMaterialDataFragment)
                   : sizeof(PerMaterialDataVertex));
         }
+        else if (entry.resourceName == _N(PerInstance) &&
+                 MaterialManager::_materialPasses[p_MaterialPass].instanced)
+        {
+          // The range has to cover the max. instance count, the per draw
+          // call allocations are placed using the dynamic offsets
+          DrawCallManager::bindBuffer(
+              drawCallMesh, entry.slotName, entry.shaderStage,
+              UniformManager::_perInstanceStorageBuffer,
+              entry.shaderStage == GpuProgramType::kFragment
+                  ? UboType::kPerInstanceFragment
+                  : UboType::kPerInstanceVertex,
+              (entry.shaderStage == GpuProgramType::kFragment
+                   ? p_PerInstanceDataFragmentSize
+                   : p_PerInstanceDataVertexSize) *
+                  _INTR_VK_MAX_INSTANCE_COUNT_PER_DRAW_CALL);
+        }
         else if (entry.resourceName == _N(PerInstance))
         {
           DrawCallManager::bindBuffer(
@@ -257,6 +459,13 @@ DrawCallRef DrawCallManager::createDrawCallForMesh(
                   ? p_PerInstanceDataFragmentSize
                   : p_PerInstanceDataVertexSize);
         }
+        else if (entry.resourceName == _N(PerView))
+        {
+          DrawCallManager::bindBuffer(
+              drawCallMesh, entry.slotName, entry.shaderStage,
+              UniformManager::_perInstanceUniformBuffer,
+              UboType::kPerViewVertex, sizeof(PerViewDataVertex));
+        }
         else if (entry.resourceName == _N(PerFrame))
         {
           DrawCallManager::bindBuffer(
@@ -45,7 +45,10 @@ struct DrawCallData : Dod::Resources::ResourceDataBase
     vkDescriptorSet.resize(_INTR_MAX_DRAW_CALL_COUNT);
     vertexBufferOffsets.resize(_INTR_MAX_DRAW_CALL_COUNT);
     indexBufferOffset.resize(_INTR_MAX_DRAW_CALL_COUNT);
+    stateSortingKey.resize(_INTR_MAX_DRAW_CALL_COUNT);
     sortingHash.resize(_INTR_MAX_DRAW_CALL_COUNT);
+    instanceCount.resize(_INTR_MAX_DRAW_CALL_COUNT);
+    firstInstanceIdx.resize(_INTR_MAX_DRAW_CALL_COUNT);
   }
 
   // Description
@@ -67,7 +70,10 @@ struct DrawCallData : Dod::Resources::ResourceDataBase
   _INTR_ARRAY(_INTR_ARRAY(VkDeviceSize)) vertexBufferOffsets;
   _INTR_ARRAY(_INTR_ARRAY(VkBuffer)) vertexBuffers;
   _INTR_ARRAY(VkDeviceSize) indexBufferOffset;
-  _INTR_ARRAY(uint32_t) sortingHash;
+  _INTR_ARRAY(uint64_t) stateSortingKey;
+  _INTR_ARRAY(uint64_t) sortingHash;
+  _INTR_ARRAY(uint32_t) instanceCount;
+  _INTR_ARRAY(uint32_t) firstInstanceIdx;
 };
 
 struct DrawCallManager
@@ -141,6 +147,23 @@ struct DrawCallManager
           _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex] = RenderProcess::
               UniformManager::getDynamicOffsetForPerFrameDataFragment();
         }
+        else if (bindInfo.bufferData.uboType == UboType::kPerViewVertex)
+        {
+          _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex] =
+              UniformManager::_perViewDataVertexOffset;
+        }
+
+        ++dynamicOffsetIndex;
+      }
+      else if (bindInfo.bindingType == BindingType::kStorageBufferDynamic)
+      {
+        // The bound range covers the max. instance count, but only the
+        // instances of this draw call are allocated
+        UniformManager::allocatePerInstanceStorageMemory(
+            bindInfo.bufferData.rangeInBytes /
+                _INTR_VK_MAX_INSTANCE_COUNT_PER_DRAW_CALL *
+                _instanceCount(p_DrawCall),
+            _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex]);
 
         ++dynamicOffsetIndex;
       }
@@ -162,14 +185,19 @@ struct DrawCallManager
 
   // <-
 
-  _INTR_INLINE static void
+  // Writes the per instance data to the given instance of the draw call, the
+  // instance index is only used for draw calls using the per instance storage.
+  // Returns the amount of bytes written
+  _INTR_INLINE static uint32_t
   updateUniformMemory(DrawCallRef p_DrawCall, void* p_PerInstanceDataVertex,
                       uint32_t p_PerInstanceDataVertexSize,
                       void* p_PerInstanceDataFragment,
-                      uint32_t p_PerInstanceDataFragmentSize)
+                      uint32_t p_PerInstanceDataFragmentSize,
+                      uint32_t p_InstanceIdx = 0u)
   {
     _INTR_ARRAY(BindingInfo)& bindInfos = _descBindInfos(p_DrawCall);
 
+    uint32_t writtenBytes = 0u;
     uint32_t dynamicOffsetIndex = 0u;
     for (uint32_t bIdx = 0u; bIdx < bindInfos.size(); ++bIdx)
     {
@@ -184,17 +212,48 @@ struct DrawCallManager
         {
           uint8_t* gpuMem = &UniformManager::_perInstanceMemory[dynamicOffset];
           memcpy(gpuMem, p_PerInstanceDataVertex, p_PerInstanceDataVertexSize);
+          writtenBytes += p_PerInstanceDataVertexSize;
         }
         else if (bindInfo.bufferData.uboType == UboType::kPerInstanceFragment)
         {
           uint8_t* gpuMem = &UniformManager::_perInstanceMemory[dynamicOffset];
           memcpy(gpuMem, p_PerInstanceDataFragment,
                  p_PerInstanceDataFragmentSize);
+          writtenBytes += p_PerInstanceDataFragmentSize;
+        }
+
+        ++dynamicOffsetIndex;
+      }
+      else if (bindInfo.bindingType == BindingType::kStorageBufferDynamic)
+      {
+        const uint32_t dynamicOffset =
+            _dynamicOffsets(p_DrawCall)[dynamicOffsetIndex];
+
+        if (bindInfo.bufferData.uboType == UboType::kPerInstanceVertex)
+        {
+          const uint32_t instanceOffset =
+              dynamicOffset + p_InstanceIdx * p_PerInstanceDataVertexSize;
+          uint8_t* gpuMem =
+              &UniformManager::_perInstanceStorageMemory[instanceOffset];
+          memcpy(gpuMem, p_PerInstanceDataVertex, p_PerInstanceDataVertexSize);
+          writtenBytes += p_PerInstanceDataVertexSize;
+        }
+        else if (bindInfo.bufferData.uboType == UboType::kPerInstanceFragment)
+        {
+          const uint32_t instanceOffset =
+              dynamicOffset + p_InstanceIdx * p_PerInstanceDataFragmentSize;
+          uint8_t* gpuMem =
+              &UniformManager::_perInstanceStorageMemory[instanceOffset];
+          memcpy(gpuMem, p_PerInstanceDataFragment,
+                 p_PerInstanceDataFragmentSize);
+          writtenBytes += p_PerInstanceDataFragmentSize;
         }
 
         ++dynamicOffsetIndex;
       }
     }
+
+    return writtenBytes;
   }
 
   // <-
@@ -217,11 +276,50 @@ struct DrawCallManager
 
   // <-
 
+  // Layout of the 64 bit sorting hash (most significant bits first)
+  //
+  // Front to back: pass (8) | coarse depth (10) | state (36) | fine depth (10)
+  // Back to front: pass (8) | inverted depth (20) | state (36)
+  // State first:   pass (8) | state (36) | depth (20)
+  //
+  // The state is made up of the pipeline (12), material (12) and mesh
+  // buffers (12). The render order is defined per material pass
   _INTR_INLINE static void updateSortingHash(DrawCallRef p_DrawCall,
-                                             float p_DistToCamera2)
+                                             float p_DistToCamera)
   {
-    _sortingHash(p_DrawCall) =
-        (_descMaterialPass(p_DrawCall) << 16u) | (uint16_t)p_DistToCamera2;
+    const uint8_t materialPass = _descMaterialPass(p_DrawCall);
+    const uint64_t stateKey = _stateSortingKey(p_DrawCall);
+    const uint64_t depth = quantizeSortingDepth(p_DistToCamera);
+
+    uint64_t hash = (uint64_t)materialPass << 56u;
+    switch (_renderOrderPerMaterialPass[materialPass])
+    {
+    case RenderOrder::kFrontToBack:
+      hash |= ((depth >> 10u) << 46u) | (stateKey << 10u) | (depth & 0x3FFu);
+      break;
+    case RenderOrder::kBackToFront:
+      hash |= ((~depth & 0xFFFFFu) << 36u) | stateKey;
+      break;
+    case RenderOrder::kStateFirst:
+      hash |= (stateKey << 20u) | depth;
+      break;
+    }
+
+    _sortingHash(p_DrawCall) = hash;
+  }
+
+  // <-
+
+  // Quantizes the given (positive) depth to 20 bits. The bit pattern of
+  // positive floats grows monotonically with their value, so dropping the
+  // lower mantissa bits results in a logarithmic distribution
+  _INTR_INLINE static uint32_t quantizeSortingDepth(float p_Depth)
+  {
+    const float depth = std::max(p_Depth, 0.0f);
+
+    uint32_t depthBits;
+    memcpy(&depthBits, &depth, sizeof(uint32_t));
+    return depthBits >> 11u;
   }
 
   // <-
@@ -383,39 +481,17 @@ struct DrawCallManager
 
   // <-
 
-  _INTR_INLINE static void
-  sortDrawCallsFrontToBack(DrawCallRefArray& p_RefArray)
-  {
-    _INTR_PROFILE_CPU("General", "Sort Draw Calls");
+  // Sorts the draw calls by their sorting hash using a key/value radix sort
+  static void sortDrawCalls(DrawCallRefArray& p_RefArray);
 
-    struct Comparator
-    {
-      bool operator()(const Dod::Ref& a, const Dod::Ref& b) const
-      {
-        return _sortingHash(a) < _sortingHash(b);
-      }
-    } comp;
+  // Merges the draw calls of instanced material passes sharing the same mesh,
+  // sub mesh and material into a single instanced draw call. Only the first
+  // draw call of each batch is kept in the given array, the draw calls of
+  // all instances are stored in "_instancedDrawCalls"
+  static void batchInstancedDrawCalls(DrawCallRefArray& p_RefArray);
 
-    Algorithm::parallelSort<Dod::Ref, Comparator>(p_RefArray, comp);
-  }
-
-  // <-
-
-  _INTR_INLINE static void
-  sortDrawCallsBackToFront(DrawCallRefArray& p_RefArray)
-  {
-    _INTR_PROFILE_CPU("General", "Sort Draw Calls");
-
-    struct Comparator
-    {
-      bool operator()(const Dod::Ref& a, const Dod::Ref& b) const
-      {
-        return _sortingHash(a) > _sortingHash(b);
-      }
-    } comp;
-
-    Algorithm::parallelSort<Dod::Ref, Comparator>(p_RefArray, comp);
-  }
+  // Publishes the instancing statistics of the finished frame
+  static void onFrameEnded();
 
   // <-
 
@@ -477,7 +553,11 @@ struct DrawCallManager
   }
 
   // Resources
-  _INTR_INLINE static uint32_t& _sortingHash(DrawCallRef p_Ref)
+  _INTR_INLINE static uint64_t& _stateSortingKey(DrawCallRef p_Ref)
+  {
+    return _data.stateSortingKey[p_Ref._id];
+  }
+  _INTR_INLINE static uint64_t& _sortingHash(DrawCallRef p_Ref)
   {
     return _data.sortingHash[p_Ref._id];
   }
@@ -502,9 +582,27 @@ struct DrawCallManager
   {
     return _data.vkDescriptorSet[p_Ref._id];
   }
+  _INTR_INLINE static uint32_t& _instanceCount(DrawCallRef p_Ref)
+  {
+    return _data.instanceCount[p_Ref._id];
+  }
+  _INTR_INLINE static uint32_t& _firstInstanceIdx(DrawCallRef p_Ref)
+  {
+    return _data.firstInstanceIdx[p_Ref._id];
+  }
 
   // Static members
   static _INTR_ARRAY(_INTR_ARRAY(DrawCallRef)) _drawCallsPerMaterialPass;
+  static DrawCallRefArray _instancedDrawCalls;
+  static uint32_t _drawCallCountBeforeInstancingPerFrame;
+  static uint32_t _drawCallCountAfterInstancingPerFrame;
+  static RenderOrder::Enum
+      _renderOrderPerMaterialPass[_INTR_MAX_MATERIAL_PASS_COUNT];
+
+  // Render orders requested by the render passes, resolved to material pass
+  // IDs when the material pass config is loaded
+  static _INTR_HASH_MAP(Name, RenderOrder::Enum)
+      _renderOrderPerMaterialPassName;
 };
 }
 }
@@ -24,9 +24,12 @@ namespace Resources
 // Global variables
 // ->
 
+#define _INTR_SHADER_CACHE_MAGIC 0x48535449u
+#define _INTR_SHADER_CACHE_VERSION 1u
+
 _INTR_STRING _shaderPath = "assets/shaders/";
 _INTR_STRING _shaderCachePath = "media/shaders/";
-_INTR_STRING _shaderCacheFilePath = _shaderCachePath + "ShaderCache.json";
+_INTR_STRING _shaderCacheFilePath = _shaderCachePath + "ShaderCache.bin";
 
 class GlslangIncluder : public glslang::TShader::Includer
 {
@@ -65,105 +68,302 @@ public:
 } _includer;
 
 TBuiltInResource _defaultResource;
-rapidjson::Document _shaderCache = rapidjson::Document(rapidjson::kObjectType);
-// <-
 
-bool isShaderUpToDate(uint32_t p_ShaderHash, const char* p_GpuProgramName)
+// Compiled SPIR-V by hash of the fully preprocessed source
+_INTR_HASH_MAP(uint64_t, SpirvBuffer) _shaderCache;
+// Cache key of the last successful compilation by GPU program name
+_INTR_HASH_MAP(uint32_t, uint64_t) _shaderCacheKeys;
+// Seed for all cache keys, covers the compiler and the cache version
+uint64_t _shaderCacheBasis = 0u;
+
+namespace ShaderCompileStatus
 {
-  if (_shaderCache.HasMember(p_GpuProgramName))
-  {
-    return _shaderCache[p_GpuProgramName].GetUint() == p_ShaderHash;
-  }
+enum Enum
+{
+  kUpToDate,
+  kCompiled,
+  kSourceNotFound,
+  kFailed
+};
+}
+
+struct ShaderCompileResult
+{
+  ShaderCompileStatus::Enum status;
+  uint64_t cacheKey;
+  _INTR_STRING log;
+};
 
-  return false;
+// <-
+
+void initShaderCacheBasis()
+{
+  const _INTR_STRING compilerVersion =
+      StringUtil::toString(_INTR_SHADER_CACHE_VERSION) + ";" +
+      glslang::GetGlslVersionString() + ";" +
+      StringUtil::toString(spv::Version) + ";" +
+      StringUtil::toString(spv::Revision);
+
+  _shaderCacheBasis =
+      Math::hash64(compilerVersion.c_str(), compilerVersion.length());
 }
 
+// <-
+
 void loadShaderCache()
 {
-  FILE* fp = fopen(_shaderCacheFilePath.c_str(), "rb");
+  _INTR_IFSTREAM ifs(_shaderCacheFilePath.c_str(), std::ifstream::binary);
 
-  if (fp == nullptr)
+  if (!ifs)
   {
     _INTR_LOG_WARNING("Shader cache not available...");
     return;
   }
 
-  char* readBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+  uint32_t header[4] = {};
+  ifs.read((char*)header, sizeof(header));
+
+  if (!ifs || header[0] != _INTR_SHADER_CACHE_MAGIC ||
+      header[1] != _INTR_SHADER_CACHE_VERSION)
+  {
+    _INTR_LOG_WARNING("Shader cache is outdated, discarding it...");
+    return;
+  }
+
+  const uint32_t programCount = header[2];
+  const uint32_t entryCount = header[3];
+
+  for (uint32_t i = 0u; i < programCount && ifs; ++i)
+  {
+    uint32_t nameHash;
+    uint64_t cacheKey;
+    ifs.read((char*)&nameHash, sizeof(uint32_t));
+    ifs.read((char*)&cacheKey, sizeof(uint64_t));
+
+    _shaderCacheKeys[nameHash] = cacheKey;
+  }
+
+  for (uint32_t i = 0u; i < entryCount && ifs; ++i)
+  {
+    uint64_t cacheKey;
+    uint32_t wordCount;
+    ifs.read((char*)&cacheKey, sizeof(uint64_t));
+    ifs.read((char*)&wordCount, sizeof(uint32_t));
+
+    SpirvBuffer& spirvBuffer = _shaderCache[cacheKey];
+    spirvBuffer.resize(wordCount);
+    ifs.read((char*)spirvBuffer.data(), wordCount * sizeof(uint32_t));
+  }
+
+  if (!ifs)
   {
-    rapidjson::FileReadStream is(fp, readBuffer, 65536u);
-    _shaderCache.ParseStream(is);
-    fclose(fp);
+    _INTR_LOG_WARNING("Shader cache is corrupt, discarding it...");
+    _shaderCache.clear();
+    _shaderCacheKeys.clear();
   }
-  Memory::Tlsf::MainAllocator::free(readBuffer);
 }
 
+// <-
+
 void saveShaderCache()
 {
-  FILE* fp = fopen(_shaderCacheFilePath.c_str(), "wb");
+  _INTR_OFSTREAM of(_shaderCacheFilePath.c_str(), std::ofstream::binary);
 
-  if (fp == nullptr)
+  if (!of)
   {
     _INTR_LOG_ERROR("Failed to save shader cache...");
     return;
   }
 
-  char* writeBuffer = (char*)Memory::Tlsf::MainAllocator::allocate(65536u);
+  // Only keep the entries which are still referenced by a GPU program
+  _INTR_ARRAY(uint64_t) cacheKeys;
+  for (auto it = _shaderCacheKeys.begin(); it != _shaderCacheKeys.end(); ++it)
   {
-    rapidjson::FileWriteStream os(fp, writeBuffer, 65536u);
-    rapidjson::PrettyWriter<rapidjson::FileWriteStream> writer(os);
-    _shaderCache.Accept(writer);
-    fclose(fp);
+    if (_shaderCache.find(it->second) != _shaderCache.end())
+    {
+      cacheKeys.push_back(it->second);
+    }
   }
-  Memory::Tlsf::MainAllocator::free(writeBuffer);
-}
+  std::sort(cacheKeys.begin(), cacheKeys.end());
+  cacheKeys.erase(std::unique(cacheKeys.begin(), cacheKeys.end()),
+                  cacheKeys.end());
 
-void addShaderToCache(uint32_t p_ShaderHash, const char* p_GpuProgramName,
-                      const SpirvBuffer& p_SpirvBuffer)
-{
-  if (_shaderCache.HasMember(p_GpuProgramName))
+  const uint32_t header[4] = {
+      _INTR_SHADER_CACHE_MAGIC, _INTR_SHADER_CACHE_VERSION,
+      (uint32_t)_shaderCacheKeys.size(), (uint32_t)cacheKeys.size()};
+  of.write((const char*)header, sizeof(header));
+
+  for (auto it = _shaderCacheKeys.begin(); it != _shaderCacheKeys.end(); ++it)
   {
-    _shaderCache[p_GpuProgramName].SetUint(p_ShaderHash);
+    of.write((const char*)&it->first, sizeof(uint32_t));
+    of.write((const char*)&it->second, sizeof(uint64_t));
   }
-  else
+
+  for (uint32_t i = 0u; i < cacheKeys.size(); ++i)
   {
-    rapidjson::Value fileName =
-        rapidjson::Value(p_GpuProgramName, _shaderCache.GetAllocator());
-    _shaderCache.AddMember(fileName, p_ShaderHash, _shaderCache.GetAllocator());
+    const SpirvBuffer& spirvBuffer = _shaderCache[cacheKeys[i]];
+    const uint32_t wordCount = (uint32_t)spirvBuffer.size();
+
+    of.write((const char*)&cacheKeys[i], sizeof(uint64_t));
+    of.write((const char*)&wordCount, sizeof(uint32_t));
+    of.write((const char*)spirvBuffer.data(), wordCount * sizeof(uint32_t));
   }
 
-  _INTR_STRING cacheFileName = _shaderCachePath + p_GpuProgramName + ".cached";
-  _INTR_OFSTREAM of(cacheFileName.c_str(), std::ofstream::binary);
-  of.write((const char*)p_SpirvBuffer.data(),
-           p_SpirvBuffer.size() * sizeof(uint32_t));
   of.close();
+}
+
+// <-
+
+bool loadShaderFromCache(uint32_t p_NameHash, SpirvBuffer& p_SpirvBuffer)
+{
+  auto keyIt = _shaderCacheKeys.find(p_NameHash);
+  if (keyIt == _shaderCacheKeys.end())
+  {
+    return false;
+  }
+
+  auto spirvIt = _shaderCache.find(keyIt->second);
+  if (spirvIt == _shaderCache.end())
+  {
+    return false;
+  }
 
-  saveShaderCache();
+  p_SpirvBuffer = spirvIt->second;
+  return true;
 }
 
-void loadShaderFromCache(const char* p_GpuProgranName,
-                         SpirvBuffer& p_SpirvBuffer)
+// <-
+
+// Compiles a single GPU program or retrieves it from the cache, safe to be
+// called from multiple threads as long as the cache is not modified
+void compileGpuProgram(GpuProgramRef p_Ref, bool p_ForceRecompile,
+                       ShaderCompileResult& p_Result)
 {
-  _INTR_STRING cacheFileName = _shaderCachePath + p_GpuProgranName + ".cached";
-  _INTR_IFSTREAM ifs(cacheFileName.c_str(), std::ifstream::binary);
+  p_Result.status = ShaderCompileStatus::kFailed;
+  p_Result.cacheKey = 0u;
+  p_Result.log.clear();
+
+  SpirvBuffer& spirvBuffer = GpuProgramManager::_spirvBuffer(p_Ref);
+  spirvBuffer.clear();
+
+  const _INTR_STRING filePath =
+      _shaderPath + GpuProgramManager::_descGpuProgramName(p_Ref);
+
+  _INTR_FSTREAM inFileStream =
+      _INTR_FSTREAM(filePath.c_str(), std::ios::in | std::ios::binary);
+
+  if (!inFileStream)
+  {
+    p_Result.status = ShaderCompileStatus::kSourceNotFound;
+    return;
+  }
+
+  _INTR_OSTRINGSTREAM contents;
+  contents << inFileStream.rdbuf();
+  inFileStream.close();
+  _INTR_STRING glslString = contents.str();
+
+  // Add pre processor defines
+  {
+    _INTR_ARRAY(_INTR_STRING) preProcessorDefines;
+    StringUtil::split(GpuProgramManager::_descPreprocessorDefines(p_Ref), ";",
+                      preProcessorDefines);
+
+    _INTR_STRING defineStr;
+    for (uint32_t i = 0u; i < preProcessorDefines.size(); ++i)
+    {
+      defineStr += preProcessorDefines[i] + "\n";
+    }
+
+    StringUtil::replace(glslString, "/* __PREPROCESSOR DEFINES__ */",
+                        defineStr);
+  }
+
+  const EShLanguage stage = Helper::mapGpuProgramTypeToEshLang(
+      (GpuProgramType::Enum)GpuProgramManager::_descGpuProgramType(p_Ref));
+  const EShMessages messages =
+      (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
+  const char* glslStringChar = glslString.c_str();
+
+  // Run the pre processor so the cache key covers all included files
+  std::string preprocessedGlsl;
+  {
+    glslang::TShader shader(stage);
+    shader.setStrings(&glslStringChar, 1);
+
+    if (!shader.preprocess(&_defaultResource, 100, ECoreProfile, false, false,
+                           messages, &preprocessedGlsl, _includer))
+    {
+      p_Result.log = shader.getInfoLog();
+      return;
+    }
+  }
 
-  ifs.seekg(0, ifs.end);
-  std::streamoff size = ifs.tellg();
-  ifs.seekg(0);
+  uint64_t cacheKey = Math::hash64((const char*)&stage, sizeof(stage),
+                                   _shaderCacheBasis);
+  cacheKey = Math::hash64(preprocessedGlsl.c_str(), preprocessedGlsl.length(),
+                          cacheKey);
+  p_Result.cacheKey = cacheKey;
 
-  if (size != -1)
+  if (!p_ForceRecompile)
   {
-    p_SpirvBuffer.resize((size_t)size / sizeof(uint32_t));
-    ifs.read((char*)p_SpirvBuffer.data(), size);
+    auto cacheIt = _shaderCache.find(cacheKey);
+    if (cacheIt != _shaderCache.end())
+    {
+      spirvBuffer = cacheIt->second;
+      p_Result.status = ShaderCompileStatus::kUpToDate;
+      return;
+    }
   }
-  else
+
+  glslang::TShader shader(stage);
+  glslang::TProgram program;
+  shader.setStrings(&glslStringChar, 1);
+
+  if (!shader.parse(&_defaultResource, 100, ECoreProfile, false, false,
+                    messages, _includer))
+  {
+    p_Result.log = _INTR_STRING(shader.getInfoLog()) + shader.getInfoDebugLog();
+    return;
+  }
+
+  program.addShader(&shader);
+
+  if (!program.link(messages))
   {
-    _INTR_LOG_WARNING("Shader cache file '%s' not found!",
-                      cacheFileName.c_str());
+    p_Result.log =
+        _INTR_STRING(program.getInfoLog()) + program.getInfoDebugLog();
+    return;
   }
 
-  ifs.close();
+  p_Result.log = _INTR_STRING(shader.getInfoLog()) + shader.getInfoDebugLog();
+
+  glslang::GlslangToSpv(*program.getIntermediate(stage), spirvBuffer);
+  p_Result.status = ShaderCompileStatus::kCompiled;
 }
 
+// <-
+
+struct ShaderCompileParallelTaskSet : enki::ITaskSet
+{
+  virtual ~ShaderCompileParallelTaskSet() {}
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Resources", "Compile GPU Programs");
+
+    for (uint32_t i = p_Range.start; i < p_Range.end; ++i)
+    {
+      compileGpuProgram((*_refs)[i], _forceRecompile, (*_results)[i]);
+    }
+  }
+
+  const GpuProgramRefArray* _refs;
+  _INTR_ARRAY(ShaderCompileResult) * _results;
+  bool _forceRecompile;
+};
+
 void GpuProgramManager::init()
 {
   _INTR_LOG_INFO("Inititializing GPU Program Manager...");
@@ -206,6 +406,7 @@ void GpuProgramManager::init()
 
   glslang::InitializeProcess();
   Helper::initResource(_defaultResource);
+  initShaderCacheBasis();
   loadShaderCache();
 }
 
@@ -232,9 +433,9 @@ void GpuProgramManager::reflectPipelineLayout(
       if (glsl.get_decoration(res.id, spv::DecorationDescriptorSet) != 0u)
         continue;
 
-      const bool isDynamic = res.name == "PerInstance" ||
-                             res.name == "PerMaterial" ||
-                             res.name == "PerFrame";
+      const bool isDynamic =
+          res.name == "PerInstance" || res.name == "PerMaterial" ||
+          res.name == "PerFrame" || res.name == "PerView";
 
       BindingDescription bd;
       {
@@ -297,10 +498,14 @@ void GpuProgramManager::reflectPipelineLayout(
       if (glsl.get_decoration(res.id, spv::DecorationDescriptorSet) != 0u)
         continue;
 
+      // Per instance data of instanced draw calls
+      const bool isDynamic = res.name == "PerInstance";
+
       BindingDescription bd;
       {
         bd.name = res.name.c_str();
-        bd.bindingType = BindingType::kStorageBuffer;
+        bd.bindingType = isDynamic ? BindingType::kStorageBufferDynamic
+                                   : BindingType::kStorageBuffer;
         bd.binding = glsl.get_decoration(res.id, spv::DecorationBinding);
         bd.poolCount = p_PoolCount;
         bd.shaderStage = GpuProgramManager::_descGpuProgramType(gpuProgramRef);
@@ -326,117 +531,73 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
 {
   _INTR_LOG_INFO("Loading/Compiling GPU Programs...");
 
+  _INTR_ARRAY(ShaderCompileResult) results;
+  results.resize(p_Refs.size());
+
+  // Compile all GPU programs in parallel
+  {
+    ShaderCompileParallelTaskSet taskSet;
+    taskSet._refs = &p_Refs;
+    taskSet._results = &results;
+    taskSet._forceRecompile = p_ForceRecompile;
+    taskSet.m_SetSize = (uint32_t)p_Refs.size();
+
+    Application::_scheduler.AddTaskSetToPipe(&taskSet);
+    Application::_scheduler.WaitforTaskSet(&taskSet);
+  }
+
+  // Update the cache and report the results
   GpuProgramRefArray changedGpuPrograms;
+  bool cacheChanged = false;
 
   for (uint32_t gpIdx = 0u; gpIdx < p_Refs.size(); ++gpIdx)
   {
     GpuProgramRef ref = p_Refs[gpIdx];
-    const _INTR_STRING gpuProgramName =
-        "gpu_program_" + StringUtil::toString(_name(ref)._hash);
+    const ShaderCompileResult& result = results[gpIdx];
+    const uint32_t nameHash = _name(ref)._hash;
 
-    SpirvBuffer& spirvBuffer = _spirvBuffer(ref);
-    spirvBuffer.clear();
-
-    EShLanguage stage = Helper::mapGpuProgramTypeToEshLang(
-        (GpuProgramType::Enum)_descGpuProgramType(ref));
-    glslang::TShader shader(stage);
-    glslang::TProgram program;
-
-    const EShMessages messages =
-        (EShMessages)(EShMsgSpvRules | EShMsgVulkanRules);
-
-    const _INTR_STRING& fileName = _descGpuProgramName(ref);
-    _INTR_STRING filePath = _shaderPath + fileName;
-
-    _INTR_FSTREAM inFileStream =
-        _INTR_FSTREAM(filePath.c_str(), std::ios::in | std::ios::binary);
-    _INTR_STRING glslString;
-    uint32_t shaderHash = 0u;
-
-    if (inFileStream)
+    switch (result.status)
     {
-      _INTR_OSTRINGSTREAM contents;
-      contents << inFileStream.rdbuf();
-      inFileStream.close();
-      glslString = contents.str();
-
-      // Add pre processor defines
+    case ShaderCompileStatus::kUpToDate:
+      break;
+    case ShaderCompileStatus::kCompiled:
+      _INTR_LOG_INFO("Compiled GPU program '%s'...",
+                     _descGpuProgramName(ref).c_str());
+      if (!result.log.empty())
       {
-        _INTR_ARRAY(_INTR_STRING) preProcessorDefines;
-        StringUtil::split(_descPreprocessorDefines(ref), ";",
-                          preProcessorDefines);
-
-        _INTR_STRING defineStr;
-        for (uint32_t i = 0u; i < preProcessorDefines.size(); ++i)
-        {
-          _INTR_LOG_INFO("Adding preprocessor #define '%s'...",
-                         preProcessorDefines[i].c_str());
-          defineStr += preProcessorDefines[i] + "\n";
-        }
-
-        StringUtil::replace(glslString, "/* __PREPROCESSOR DEFINES__ */",
-                            defineStr);
+        _INTR_LOG_WARNING("%s", result.log.c_str());
       }
 
-      shaderHash =
-          Math::hash(glslString.c_str(), sizeof(char) * glslString.length());
-
-      if (!p_ForceRecompile)
-      {
-        if (isShaderUpToDate(shaderHash, gpuProgramName.c_str()))
-        {
-          loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
-          continue;
-        }
-      }
-    }
-    else
-    {
+      _shaderCache[result.cacheKey] = _spirvBuffer(ref);
+      changedGpuPrograms.push_back(ref);
+      break;
+    case ShaderCompileStatus::kSourceNotFound:
       _INTR_LOG_WARNING(
           "Shader for GPU program '%s' not found, trying to load from cache...",
           _descGpuProgramName(ref).c_str());
-      loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
+      loadShaderFromCache(nameHash, _spirvBuffer(ref));
       continue;
-    }
-
-    _INTR_LOG_INFO("Compiling GPU program '%s'...",
-                   _descGpuProgramName(ref).c_str());
-
-    const char* glslStringChar = glslString.c_str();
-    shader.setStrings(&glslStringChar, 1);
-
-    if (!shader.parse(&_defaultResource, 100, ECoreProfile, false, false,
-                      messages, _includer))
-    {
-      _INTR_LOG_WARNING("Parsing of GPU program failed...");
-      _INTR_LOG_WARNING(shader.getInfoLog());
-      _INTR_LOG_WARNING(shader.getInfoDebugLog());
+    case ShaderCompileStatus::kFailed:
+      _INTR_LOG_WARNING("Compiling GPU program '%s' failed...",
+                        _descGpuProgramName(ref).c_str());
+      _INTR_LOG_WARNING("%s", result.log.c_str());
 
       // Try to load the previous shader from the cache
-      loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
+      loadShaderFromCache(nameHash, _spirvBuffer(ref));
       continue;
     }
 
-    program.addShader(&shader);
-
-    if (!program.link(messages))
+    auto keyIt = _shaderCacheKeys.find(nameHash);
+    if (keyIt == _shaderCacheKeys.end() || keyIt->second != result.cacheKey)
     {
-      _INTR_LOG_WARNING("Linking of GPU program failed...");
-      _INTR_LOG_WARNING(shader.getInfoLog());
-      _INTR_LOG_WARNING(shader.getInfoDebugLog());
-
-      // Try to load the previous shader from the cache
-      loadShaderFromCache(gpuProgramName.c_str(), spirvBuffer);
-      continue;
+      _shaderCacheKeys[nameHash] = result.cacheKey;
+      cacheChanged = true;
     }
+  }
 
-    _INTR_LOG_WARNING(shader.getInfoLog());
-    _INTR_LOG_WARNING(shader.getInfoDebugLog());
-
-    glslang::GlslangToSpv(*program.getIntermediate(stage), spirvBuffer);
-    addShaderToCache(shaderHash, gpuProgramName.c_str(), spirvBuffer);
-
-    changedGpuPrograms.push_back(ref);
+  if (cacheChanged)
+  {
+    saveShaderCache();
   }
 
   // Update all pipelines which reference this GPU program
@@ -466,11 +627,11 @@ void GpuProgramManager::compileShaders(GpuProgramRefArray p_Refs,
 
   if (p_UpdateResources)
   {
-    PipelineManager::destroyResources(changedPipelines);
     GpuProgramManager::destroyResources(changedGpuPrograms);
-
     GpuProgramManager::createResources(changedGpuPrograms);
-    PipelineManager::createResources(changedPipelines);
+
+    // The previous pipelines stay in use until their replacements are ready
+    PipelineManager::createResourcesAsync(changedPipelines);
   }
 }
 
@@ -541,6 +702,31 @@ void GpuProgramManager::createResources(const GpuProgramRefArray& p_Refs)
   }
 }
 
+// <-
+
+void GpuProgramManager::destroyResources(const GpuProgramRefArray& p_Refs)
+{
+  // Pipelines which are still being created read the shader modules and the
+  // shader stage infos
+  PipelineManager::waitForPendingResources(p_Refs);
+
+  for (uint32_t i = 0u; i < p_Refs.size(); ++i)
+  {
+    GpuProgramRef ref = p_Refs[i];
+    VkShaderModule shaderModule = _vkShaderModule(ref);
+
+    if (shaderModule != VK_NULL_HANDLE)
+    {
+      vkDestroyShaderModule(RenderSystem::_vkDevice, shaderModule, nullptr);
+
+      VkShaderModule nullModule = VK_NULL_HANDLE;
+      _vkShaderModule(ref) = nullModule;
+    }
+
+    _spirvBuffer(ref).clear();
+  }
+}
+
 // <-
 }
 }
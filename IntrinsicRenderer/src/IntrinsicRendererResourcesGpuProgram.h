@@ -202,24 +202,7 @@ struct GpuProgramManager
 
   // <-
 
-  _INTR_INLINE static void destroyResources(const GpuProgramRefArray& p_Refs)
-  {
-    for (uint32_t i = 0u; i < p_Refs.size(); ++i)
-    {
-      GpuProgramRef ref = p_Refs[i];
-      VkShaderModule shaderModule = _vkShaderModule(ref);
-
-      if (shaderModule != VK_NULL_HANDLE)
-      {
-        vkDestroyShaderModule(RenderSystem::_vkDevice, shaderModule, nullptr);
-
-        VkShaderModule nullModule = VK_NULL_HANDLE;
-        _vkShaderModule(ref) = nullModule;
-      }
-
-      _spirvBuffer(ref).clear();
-    }
-  }
+  static void destroyResources(const GpuProgramRefArray& p_Refs);
 
   // <-
 
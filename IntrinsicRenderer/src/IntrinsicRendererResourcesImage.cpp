@@ -486,40 +486,6 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
   ImageManager::_descArrayLayerCount(p_Ref) = 1u;
   ImageManager::_descImageFlags(p_Ref) = ImageFlags::kUsageSampled;
 
-  VkBuffer stagingBuffer;
-
-  VkBufferCreateInfo bufferCreateInfo = {};
-  {
-    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferCreateInfo.pNext = nullptr;
-    bufferCreateInfo.size = texCube.size();
-    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  }
-
-  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
-                                   nullptr, &stagingBuffer);
-  _INTR_VK_CHECK_RESULT(result);
-  VkMemoryRequirements stagingMemReqs;
-  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                &stagingMemReqs);
-
-  GpuMemoryAllocationInfo stagingGpuAllocInfo =
-      GpuMemoryManager::allocateOffset(MemoryPoolType::kVolatileStagingBuffers,
-                                       (uint32_t)stagingMemReqs.size,
-                                       (uint32_t)stagingMemReqs.alignment,
-                                       stagingMemReqs.memoryTypeBits);
-
-  result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                              stagingGpuAllocInfo._vkDeviceMemory,
-                              stagingGpuAllocInfo._offset);
-  _INTR_VK_CHECK_RESULT(result);
-
-  uint8_t* data = stagingGpuAllocInfo._mappedMemory;
-  {
-    memcpy(data, texCube.data(), texCube.size());
-  }
-
   _INTR_ARRAY(VkBufferImageCopy) bufferCopyRegions;
   uint32_t offset = 0;
 
@@ -571,8 +537,8 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
   }
 
   VkImage& vkImage = ImageManager::_vkImage(p_Ref);
-  result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo, nullptr,
-                         &vkImage);
+  VkResult result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo,
+                                  nullptr, &vkImage);
   _INTR_VK_CHECK_RESULT(result);
 
   VkMemoryRequirements memReqs;
@@ -585,31 +551,16 @@ void createTextureFromFileCubemap(ImageRef p_Ref, gli::texture& p_Texture)
                              memoryAllocationInfo._offset);
   _INTR_VK_CHECK_RESULT(result);
 
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
   VkImageSubresourceRange subresourceRange = {};
   subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   subresourceRange.baseMipLevel = 0;
   subresourceRange.levelCount = mipLevels;
   subresourceRange.layerCount = faces;
 
-  Helper::insertImageMemoryBarrier(copyCmd, vkImage, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                   subresourceRange);
-
-  vkCmdCopyBufferToImage(copyCmd, stagingBuffer, vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                         static_cast<uint32_t>(bufferCopyRegions.size()),
-                         bufferCopyRegions.data());
-
-  Helper::insertImageMemoryBarrier(
-      copyCmd, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-
-  RenderSystem::flushTemporaryCommandBuffer();
-
-  vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffer, nullptr);
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
+  UploadQueue::uploadImage(vkImage, subresourceRange,
+                           bufferCopyRegions.data(),
+                           (uint32_t)bufferCopyRegions.size(), texCube.data(),
+                           (uint32_t)texCube.size());
 
   VkImageViewCreateInfo view = {};
   {
@@ -662,41 +613,6 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
   ImageManager::_descArrayLayerCount(p_Ref) = 1u;
   ImageManager::_descImageFlags(p_Ref) = ImageFlags::kUsageSampled;
 
-  VkBuffer stagingBuffer;
-
-  VkBufferCreateInfo bufferCreateInfo = {};
-  {
-    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferCreateInfo.pNext = nullptr;
-    bufferCreateInfo.size = tex2D.size();
-    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-  }
-
-  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
-                                   nullptr, &stagingBuffer);
-  _INTR_VK_CHECK_RESULT(result);
-
-  VkMemoryRequirements stagingMemReqs;
-  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, stagingBuffer,
-                                &stagingMemReqs);
-
-  GpuMemoryAllocationInfo stagingGpuAllocInfo =
-      GpuMemoryManager::allocateOffset(MemoryPoolType::kVolatileStagingBuffers,
-                                       (uint32_t)stagingMemReqs.size,
-                                       (uint32_t)stagingMemReqs.alignment,
-                                       stagingMemReqs.memoryTypeBits);
-
-  result = vkBindBufferMemory(RenderSystem::_vkDevice, stagingBuffer,
-                              stagingGpuAllocInfo._vkDeviceMemory,
-                              stagingGpuAllocInfo._offset);
-  _INTR_VK_CHECK_RESULT(result);
-
-  uint8_t* data = stagingGpuAllocInfo._mappedMemory;
-  {
-    memcpy(data, tex2D.data(), tex2D.size());
-  }
-
   _INTR_ARRAY(VkBufferImageCopy) bufferCopyRegions;
   uint32_t offset = 0;
 
@@ -744,8 +660,8 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
   }
 
   VkImage& vkImage = ImageManager::_vkImage(p_Ref);
-  result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo, nullptr,
-                         &vkImage);
+  VkResult result = vkCreateImage(RenderSystem::_vkDevice, &imageCreateInfo,
+                                  nullptr, &vkImage);
   _INTR_VK_CHECK_RESULT(result);
 
   VkMemoryRequirements memReqs;
@@ -758,31 +674,16 @@ void createTextureFromFile2D(ImageRef p_Ref, gli::texture& p_Texture)
                              memoryAllocationInfo._offset);
   _INTR_VK_CHECK_RESULT(result);
 
-  VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
   VkImageSubresourceRange subresourceRange = {};
   subresourceRange.aspectMask = VK_IMAGE_ASPECT_COLOR_BIT;
   subresourceRange.baseMipLevel = 0;
   subresourceRange.levelCount = mipLevels;
   subresourceRange.layerCount = 1;
 
-  Helper::insertImageMemoryBarrier(copyCmd, vkImage, VK_IMAGE_LAYOUT_UNDEFINED,
-                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                                   subresourceRange);
-
-  vkCmdCopyBufferToImage(copyCmd, stagingBuffer, vkImage,
-                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-                         static_cast<uint32_t>(bufferCopyRegions.size()),
-                         bufferCopyRegions.data());
-
-  Helper::insertImageMemoryBarrier(
-      copyCmd, vkImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
-      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, subresourceRange);
-
-  RenderSystem::flushTemporaryCommandBuffer();
-
-  vkDestroyBuffer(RenderSystem::_vkDevice, stagingBuffer, nullptr);
-  GpuMemoryManager::resetPool(MemoryPoolType::kVolatileStagingBuffers);
+  UploadQueue::uploadImage(vkImage, subresourceRange,
+                           bufferCopyRegions.data(),
+                           (uint32_t)bufferCopyRegions.size(), tex2D.data(),
+                           (uint32_t)tex2D.size());
 
   VkImageViewCreateInfo view = {};
   {
@@ -477,15 +477,42 @@ void MaterialManager::loadMaterialPassConfig()
           matPass.pipelineIdx = (uint8_t)(_materialPassPipelines.size() - 1u);
         }
 
+        if (materialPassDesc.HasMember("instanced"))
+        {
+          matPass.instanced = materialPassDesc["instanced"].GetBool();
+        }
+
         _materialPasses.push_back(matPass);
-        _materialPassMapping[materialPassName] =
-            (uint8_t)(_materialPasses.size() - 1u);
+        const uint8_t materialPassId = (uint8_t)(_materialPasses.size() - 1u);
+        _materialPassMapping[materialPassName] = materialPassId;
+
+        // Render orders set for the material pass take precedence over the
+        // ones requested by the render passes
+        RenderOrder::Enum renderOrder = RenderOrder::kFrontToBack;
+        if (materialPassDesc.HasMember("renderOrder"))
+        {
+          renderOrder = Helper::mapRenderOrder(
+              materialPassDesc["renderOrder"].GetString());
+        }
+        else
+        {
+          auto requestedRenderOrder =
+              DrawCallManager::_renderOrderPerMaterialPassName.find(
+                  materialPassName);
+          if (requestedRenderOrder !=
+              DrawCallManager::_renderOrderPerMaterialPassName.end())
+          {
+            renderOrder = requestedRenderOrder->second;
+          }
+        }
+        DrawCallManager::_renderOrderPerMaterialPass[materialPassId] =
+            renderOrder;
       }
     }
   }
 
   PipelineLayoutManager::createResources(_materialPassPipelineLayouts);
-  PipelineManager::createResources(_materialPassPipelines);
+  PipelineManager::createResourcesAsync(_materialPassPipelines);
 
   DrawCallManager::_drawCallsPerMaterialPass.resize(_materialPasses.size());
 }
@@ -58,6 +58,8 @@ struct MaterialPass
   uint8_t pipelineIdx;
   uint8_t pipelineLayoutIdx;
   uint8_t boundResoucesIdx;
+  // Batches draw calls sharing the same mesh and material to instanced ones
+  bool instanced;
 };
 
 struct BoundResourceEntry
@@ -21,11 +21,35 @@ namespace Renderer
 {
 namespace Resources
 {
-void createGraphicsPipeline(PipelineRef p_PipelineRef)
+void updateAbsoluteDimensions(PipelineRef p_PipelineRef)
+{
+  glm::uvec2& dimScissor =
+      PipelineManager::_descAbsoluteScissorDimensions(p_PipelineRef);
+  if (PipelineManager::_descScissorRenderSize(p_PipelineRef) !=
+      RenderSize::kCustom)
+  {
+    dimScissor = RenderSystem::getAbsoluteRenderSize(
+        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
+            p_PipelineRef));
+  }
+
+  glm::uvec2& dimViewport =
+      PipelineManager::_descAbsoluteViewportDimensions(p_PipelineRef);
+  if (PipelineManager::_descViewportRenderSize(p_PipelineRef) !=
+      RenderSize::kCustom)
+  {
+    dimViewport = RenderSystem::getAbsoluteRenderSize(
+        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
+            p_PipelineRef));
+  }
+}
+
+// <-
+
+void createGraphicsPipeline(PipelineRef p_PipelineRef, VkPipeline& p_Pipeline)
 {
   _INTR_ARRAY(uint8_t)& blendStates =
       PipelineManager::_descBlendStates(p_PipelineRef);
-  VkPipeline& pipeline = PipelineManager::_vkPipeline(p_PipelineRef);
 
   _INTR_ARRAY(VkPipelineColorBlendAttachmentState) blendAttachmentStates;
   for (uint32_t i = 0u; i < (uint32_t)blendStates.size(); ++i)
@@ -48,25 +72,10 @@ void createGraphicsPipeline(PipelineRef p_PipelineRef)
     cb.blendConstants[3] = 1.0f;
   }
 
-  glm::uvec2& dimScissor =
+  const glm::uvec2& dimScissor =
       PipelineManager::_descAbsoluteScissorDimensions(p_PipelineRef);
-  if (PipelineManager::_descScissorRenderSize(p_PipelineRef) !=
-      RenderSize::kCustom)
-  {
-    dimScissor = RenderSystem::getAbsoluteRenderSize(
-        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
-            p_PipelineRef));
-  }
-
-  glm::uvec2& dimViewport =
+  const glm::uvec2& dimViewport =
       PipelineManager::_descAbsoluteViewportDimensions(p_PipelineRef);
-  if (PipelineManager::_descViewportRenderSize(p_PipelineRef) !=
-      RenderSize::kCustom)
-  {
-    dimViewport = RenderSystem::getAbsoluteRenderSize(
-        (RenderSize::Enum)PipelineManager::_descScissorRenderSize(
-            p_PipelineRef));
-  }
 
   VkViewport viewport = {};
   {
@@ -189,16 +198,14 @@ void createGraphicsPipeline(PipelineRef p_PipelineRef)
 
   VkResult result = vkCreateGraphicsPipelines(
       RenderSystem::_vkDevice, RenderSystem::_vkPipelineCache, 1u,
-      &pipelineCreateInfo, nullptr, &pipeline);
+      &pipelineCreateInfo, nullptr, &p_Pipeline);
   _INTR_VK_CHECK_RESULT(result);
 }
 
 // <-
 
-void createComputePipeline(PipelineRef p_PipelineRef)
+void createComputePipeline(PipelineRef p_PipelineRef, VkPipeline& p_Pipeline)
 {
-  VkPipeline& pipeline = PipelineManager::_vkPipeline(p_PipelineRef);
-
   PipelineLayoutRef pipLayout =
       PipelineManager::_descPipelineLayout(p_PipelineRef);
   GpuProgramRef cp = PipelineManager::_descComputeProgram(p_PipelineRef);
@@ -218,25 +225,253 @@ void createComputePipeline(PipelineRef p_PipelineRef)
 
   VkResult result = vkCreateComputePipelines(
       RenderSystem::_vkDevice, RenderSystem::_vkPipelineCache, 1u,
-      &pipelineCreateInfo, nullptr, &pipeline);
+      &pipelineCreateInfo, nullptr, &p_Pipeline);
   _INTR_VK_CHECK_RESULT(result);
 }
 
+// <-
+
+void createPipeline(PipelineRef p_PipelineRef, VkPipeline& p_Pipeline)
+{
+  if (PipelineManager::_descComputeProgram(p_PipelineRef).isValid())
+  {
+    createComputePipeline(p_PipelineRef, p_Pipeline);
+  }
+  else
+  {
+    createGraphicsPipeline(p_PipelineRef, p_Pipeline);
+  }
+}
+
+// <-
+
+namespace
+{
+struct PipelineCreationParallelTaskSet : enki::ITaskSet
+{
+  virtual ~PipelineCreationParallelTaskSet() = default;
+
+  void ExecuteRange(enki::TaskSetPartition p_Range,
+                    uint32_t p_ThreadNum) override
+  {
+    _INTR_PROFILE_CPU("Renderer", "Create Pipelines");
+
+    // All workers share the same pipeline cache, access to it is
+    // synchronized by the driver
+    for (uint32_t i = p_Range.start; i < p_Range.end; ++i)
+    {
+      createPipeline(_pipelines[i], _vkPipelines[i]);
+    }
+  }
+
+  void init(const PipelineRefArray& p_Pipelines)
+  {
+    _pipelines = p_Pipelines;
+    _vkPipelines.resize(p_Pipelines.size());
+    _creationRequestIds.resize(p_Pipelines.size());
+
+    for (uint32_t i = 0u; i < (uint32_t)p_Pipelines.size(); ++i)
+    {
+      PipelineRef pipelineRef = p_Pipelines[i];
+
+      // The absolute dimensions depend on the current render size and have
+      // to be resolved on the calling thread
+      updateAbsoluteDimensions(pipelineRef);
+
+      _vkPipelines[i] = VK_NULL_HANDLE;
+      _creationRequestIds[i] =
+          ++PipelineManager::_creationRequestId(pipelineRef);
+    }
+
+    m_SetSize = (uint32_t)p_Pipelines.size();
+  }
+
+  PipelineRefArray _pipelines;
+  _INTR_ARRAY(VkPipeline) _vkPipelines;
+  _INTR_ARRAY(uint32_t) _creationRequestIds;
+};
+
+_INTR_ARRAY(PipelineCreationParallelTaskSet*) _pendingTaskSets;
+
+// <-
+
+void publishPipelines(const PipelineCreationParallelTaskSet& p_TaskSet)
+{
+  for (uint32_t i = 0u; i < (uint32_t)p_TaskSet._pipelines.size(); ++i)
+  {
+    PipelineRef pipelineRef = p_TaskSet._pipelines[i];
+    VkPipeline pipeline = p_TaskSet._vkPipelines[i];
+
+    // Drop the results of requests which have been superseded or whose
+    // pipelines have been destroyed in the meantime
+    if (!PipelineManager::isAlive(pipelineRef) ||
+        PipelineManager::_creationRequestId(pipelineRef) !=
+            p_TaskSet._creationRequestIds[i])
+    {
+      if (pipeline != VK_NULL_HANDLE)
+      {
+        RenderSystem::releaseResource(_N(VkPipeline), (void*)pipeline,
+                                      nullptr);
+      }
+      continue;
+    }
+
+    // Pipelines which get recreated stay in use until the new one is ready
+    VkPipeline& currentPipeline = PipelineManager::_vkPipeline(pipelineRef);
+    if (currentPipeline != VK_NULL_HANDLE)
+    {
+      RenderSystem::releaseResource(_N(VkPipeline), (void*)currentPipeline,
+                                    nullptr);
+    }
+    currentPipeline = pipeline;
+  }
+}
+}
+
+// <-
+
 void PipelineManager::createResources(const PipelineRefArray& p_Pipelines)
 {
-  for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
+  if (p_Pipelines.empty())
+  {
+    return;
+  }
+
+  PipelineCreationParallelTaskSet taskSet;
+  taskSet.init(p_Pipelines);
+
+  Application::_scheduler.AddTaskSetToPipe(&taskSet);
+  Application::_scheduler.WaitforTaskSet(&taskSet);
+
+  publishPipelines(taskSet);
+}
+
+// <-
+
+void PipelineManager::createResourcesAsync(const PipelineRefArray& p_Pipelines)
+{
+  if (p_Pipelines.empty())
   {
-    RenderPassRef pipelineRef = p_Pipelines[i];
+    return;
+  }
+
+  PipelineCreationParallelTaskSet* taskSet;
+  _INTR_NEW(PipelineCreationParallelTaskSet, taskSet)();
+  taskSet->init(p_Pipelines);
+
+  Application::_scheduler.AddTaskSetToPipe(taskSet);
+  _pendingTaskSets.push_back(taskSet);
+}
 
-    if (_descComputeProgram(pipelineRef).isValid())
+// <-
+
+void PipelineManager::createAllResourcesAsync()
+{
+  bool pending[_INTR_MAX_PIPELINE_COUNT] = {};
+  for (uint32_t i = 0u; i < (uint32_t)_pendingTaskSets.size(); ++i)
+  {
+    const PipelineCreationParallelTaskSet* taskSet = _pendingTaskSets[i];
+
+    for (uint32_t j = 0u; j < (uint32_t)taskSet->_pipelines.size(); ++j)
     {
-      createComputePipeline(pipelineRef);
+      PipelineRef pipelineRef = taskSet->_pipelines[j];
+      if (isAlive(pipelineRef) && _creationRequestId(pipelineRef) ==
+                                      taskSet->_creationRequestIds[j])
+      {
+        pending[pipelineRef._id] = true;
+      }
     }
-    else
+  }
+
+  PipelineRefArray pipelinesToCreate;
+  for (uint32_t i = 0u; i < (uint32_t)_activeRefs.size(); ++i)
+  {
+    PipelineRef pipelineRef = _activeRefs[i];
+    if (!pending[pipelineRef._id])
     {
-      createGraphicsPipeline(pipelineRef);
+      pipelinesToCreate.push_back(pipelineRef);
     }
   }
+
+  // The previous pipelines might not be compatible with the recreated render
+  // passes anymore - draw calls using them are skipped until they're ready
+  destroyResources(pipelinesToCreate);
+  createResourcesAsync(pipelinesToCreate);
+}
+
+// <-
+
+void PipelineManager::updatePendingResources()
+{
+  _INTR_PROFILE_CPU("Renderer", "Update Pending Pipelines");
+
+  for (auto it = _pendingTaskSets.begin(); it != _pendingTaskSets.end();)
+  {
+    PipelineCreationParallelTaskSet* taskSet = *it;
+
+    if (!taskSet->GetIsComplete())
+    {
+      ++it;
+      continue;
+    }
+
+    publishPipelines(*taskSet);
+
+    _INTR_DELETE(PipelineCreationParallelTaskSet, taskSet);
+    it = _pendingTaskSets.erase(it);
+  }
+}
+
+// <-
+
+void PipelineManager::waitForPendingResources()
+{
+  for (uint32_t i = 0u; i < (uint32_t)_pendingTaskSets.size(); ++i)
+  {
+    Application::_scheduler.WaitforTaskSet(_pendingTaskSets[i]);
+  }
+
+  updatePendingResources();
+}
+
+// <-
+
+void PipelineManager::waitForPendingResources(const Dod::RefArray& p_Refs)
+{
+  for (uint32_t i = 0u; i < (uint32_t)_pendingTaskSets.size(); ++i)
+  {
+    PipelineCreationParallelTaskSet* taskSet = _pendingTaskSets[i];
+
+    bool referenced = false;
+    for (uint32_t j = 0u;
+         j < (uint32_t)taskSet->_pipelines.size() && !referenced; ++j)
+    {
+      PipelineRef pipelineRef = taskSet->_pipelines[j];
+
+      for (uint32_t k = 0u; k < (uint32_t)p_Refs.size(); ++k)
+      {
+        Dod::Ref ref = p_Refs[k];
+
+        if (pipelineRef == ref || _descPipelineLayout(pipelineRef) == ref ||
+            _descRenderPass(pipelineRef) == ref ||
+            _descVertexProgram(pipelineRef) == ref ||
+            _descFragmentProgram(pipelineRef) == ref ||
+            _descGeometryProgram(pipelineRef) == ref ||
+            _descComputeProgram(pipelineRef) == ref)
+        {
+          referenced = true;
+          break;
+        }
+      }
+    }
+
+    if (referenced)
+    {
+      Application::_scheduler.WaitforTaskSet(taskSet);
+    }
+  }
+
+  updatePendingResources();
 }
 }
 }
@@ -46,7 +46,8 @@ struct PipelineData : Dod::Resources::ResourceDataBase
     descAbsoluteScissorDimensions.resize(_INTR_MAX_PIPELINE_COUNT);
     descAbsoluteViewportDimensions.resize(_INTR_MAX_PIPELINE_COUNT);
 
-    vkPipeline.resize(_INTR_MAX_RENDER_PASS_COUNT);
+    vkPipeline.resize(_INTR_MAX_PIPELINE_COUNT);
+    creationRequestId.resize(_INTR_MAX_PIPELINE_COUNT);
   }
 
   // Description
@@ -70,6 +71,7 @@ struct PipelineData : Dod::Resources::ResourceDataBase
 
   // Resources
   _INTR_ARRAY(VkPipeline) vkPipeline;
+  _INTR_ARRAY(uint32_t) creationRequestId;
 };
 
 struct PipelineManager
@@ -162,6 +164,7 @@ struct PipelineManager
 
   _INTR_INLINE static void createAllResources()
   {
+    waitForPendingResources();
     destroyResources(_activeRefs);
     createResources(_activeRefs);
   }
@@ -170,6 +173,25 @@ struct PipelineManager
 
   static void createResources(const PipelineRefArray& p_Pipelines);
 
+  // Creates the pipelines on the worker threads without blocking - the
+  // pipelines become available in one of the following calls to
+  // updatePendingResources and draw calls using them are skipped until then
+  static void createResourcesAsync(const PipelineRefArray& p_Pipelines);
+  // Recreates all pipelines which are not already pending asynchronously
+  static void createAllResourcesAsync();
+  static void updatePendingResources();
+  static void waitForPendingResources();
+  // Only waits for the pending pipelines which are or reference one of the
+  // given pipelines, pipeline layouts, render passes or GPU programs
+  static void waitForPendingResources(const Dod::RefArray& p_Refs);
+
+  // <-
+
+  _INTR_INLINE static bool isReady(PipelineRef p_Ref)
+  {
+    return _vkPipeline(p_Ref) != VK_NULL_HANDLE;
+  }
+
   // <-
 
   _INTR_INLINE static void destroyResources(const PipelineRefArray& p_Pipelines)
@@ -179,6 +201,9 @@ struct PipelineManager
       PipelineRef ref = p_Pipelines[i];
       VkPipeline& pipeline = _vkPipeline(ref);
 
+      // Discard the results of pending asynchronous creations
+      ++_creationRequestId(ref);
+
       if (pipeline != VK_NULL_HANDLE)
       {
         RenderSystem::releaseResource(_N(VkPipeline), (void*)pipeline, nullptr);
@@ -192,6 +217,8 @@ struct PipelineManager
   _INTR_INLINE static void
   destroyPipelinesAndResources(const PipelineRefArray& p_Pipelines)
   {
+    // Pending creations read the descriptions of the pipelines
+    waitForPendingResources(p_Pipelines);
     destroyResources(p_Pipelines);
 
     for (uint32_t i = 0u; i < p_Pipelines.size(); ++i)
@@ -270,6 +297,10 @@ struct PipelineManager
   {
     return _data.vkPipeline[p_Ref._id];
   }
+  _INTR_INLINE static uint32_t& _creationRequestId(PipelineRef p_Ref)
+  {
+    return _data.creationRequestId[p_Ref._id];
+  }
 };
 }
 }
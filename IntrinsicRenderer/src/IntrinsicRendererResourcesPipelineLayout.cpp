@@ -123,6 +123,9 @@ void PipelineLayoutManager::createResources(
 void PipelineLayoutManager::destroyResources(
     const PipelineLayoutRefArray& p_PipelineLayouts)
 {
+  // Pipelines which are still being created reference the layouts
+  PipelineManager::waitForPendingResources(p_PipelineLayouts);
+
   for (uint32_t i = 0u; i < p_PipelineLayouts.size(); ++i)
   {
     PipelineLayoutRef ref = p_PipelineLayouts[i];
@@ -194,7 +197,7 @@ VkDescriptorSet PipelineLayoutManager::allocateAndWriteDescriptorSet(
     _INTR_ARRAY(VkDescriptorImageInfo) imageInfos;
     _INTR_ARRAY(VkDescriptorBufferInfo) bufferInfos;
 
-    writes.resize(p_BindInfos.size());
+    writes.reserve(p_BindInfos.size());
     imageInfos.resize(p_BindInfos.size());
     bufferInfos.resize(p_BindInfos.size());
 
@@ -202,11 +205,20 @@ VkDescriptorSet PipelineLayoutManager::allocateAndWriteDescriptorSet(
     {
       const BindingInfo& info = p_BindInfos[i];
 
-      writes[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-      writes[i].pNext = nullptr;
-      writes[i].dstSet = descSet;
-      writes[i].descriptorCount = 1u;
-      writes[i].descriptorType = Helper::mapBindingTypeToVkDescriptorType(
+      // Skip the holes of non contiguous bindings
+      if (!info.resource.isValid())
+      {
+        continue;
+      }
+
+      writes.push_back({});
+      VkWriteDescriptorSet& write = writes.back();
+
+      write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+      write.pNext = nullptr;
+      write.dstSet = descSet;
+      write.descriptorCount = 1u;
+      write.descriptorType = Helper::mapBindingTypeToVkDescriptorType(
           (BindingType::Enum)info.bindingType);
 
       if (info.bindingType >= BindingType::kRangeStartBuffer &&
@@ -217,7 +229,7 @@ VkDescriptorSet PipelineLayoutManager::allocateAndWriteDescriptorSet(
         bufferInfo.offset = 0u;
         bufferInfo.range = info.bufferData.rangeInBytes;
 
-        writes[i].pBufferInfo = &bufferInfo;
+        write.pBufferInfo = &bufferInfo;
       }
       else if (info.bindingType >= BindingType::kRangeStartImage &&
                info.bindingType <= BindingType::kRangeEndImage)
@@ -266,11 +278,11 @@ VkDescriptorSet PipelineLayoutManager::allocateAndWriteDescriptorSet(
           imageInfo.sampler = Samplers::samplers[info.imageData.samplerIdx];
         }
 
-        writes[i].pImageInfo = &imageInfo;
+        write.pImageInfo = &imageInfo;
       }
 
-      writes[i].dstArrayElement = 0u;
-      writes[i].dstBinding = info.binding;
+      write.dstArrayElement = 0u;
+      write.dstBinding = info.binding;
     }
 
     vkUpdateDescriptorSets(RenderSystem::_vkDevice, (uint32_t)writes.size(),
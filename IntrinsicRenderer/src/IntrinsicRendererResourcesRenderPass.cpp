@@ -118,6 +118,27 @@ void RenderPassManager::createResources(
     _INTR_VK_CHECK_RESULT(result);
   }
 }
+
+// <-
+
+void RenderPassManager::destroyResources(
+    const RenderPassRefArray& p_RenderPasses)
+{
+  // Pipelines which are still being created reference the render passes
+  PipelineManager::waitForPendingResources(p_RenderPasses);
+
+  for (uint32_t i = 0u; i < p_RenderPasses.size(); ++i)
+  {
+    RenderPassRef ref = p_RenderPasses[i];
+    VkRenderPass& renderPass = _vkRenderPass(ref);
+
+    if (renderPass != VK_NULL_HANDLE)
+    {
+      vkDestroyRenderPass(RenderSystem::_vkDevice, renderPass, nullptr);
+      renderPass = VK_NULL_HANDLE;
+    }
+  }
+}
 }
 }
 }
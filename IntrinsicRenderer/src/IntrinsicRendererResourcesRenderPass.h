@@ -121,22 +121,7 @@ struct RenderPassManager
   }
 
   static void createResources(const RenderPassRefArray& p_RenderPasses);
-
-  _INTR_INLINE static void
-  destroyResources(const RenderPassRefArray& p_RenderPasses)
-  {
-    for (uint32_t i = 0u; i < p_RenderPasses.size(); ++i)
-    {
-      RenderPassRef ref = p_RenderPasses[i];
-      VkRenderPass& renderPass = _vkRenderPass(ref);
-
-      if (renderPass != VK_NULL_HANDLE)
-      {
-        vkDestroyRenderPass(RenderSystem::_vkDevice, renderPass, nullptr);
-        renderPass = VK_NULL_HANDLE;
-      }
-    }
-  }
+  static void destroyResources(const RenderPassRefArray& p_RenderPasses);
 
   // <-
 
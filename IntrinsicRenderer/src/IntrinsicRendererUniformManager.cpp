@@ -27,6 +27,7 @@ BufferRef _perMaterialUniformBuffer;
 BufferRef _perFrameUniformBuffer;
 
 uint8_t* UniformManager::_perInstanceMemory = nullptr;
+uint8_t* UniformManager::_perInstanceStorageMemory = nullptr;
 uint8_t* UniformManager::_perFrameMemory = nullptr;
 Memory::Tlsf::Allocator _perMaterialAllocator;
 
@@ -43,11 +44,16 @@ Memory::LockFreeFixedBlockAllocator<
 Memory::LockFreeFixedBlockAllocator<_INTR_VK_PER_MATERIAL_BLOCK_COUNT,
                                     _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES>
     UniformManager::_perMaterialAllocator;
+std::atomic<uint32_t> UniformManager::_perInstanceStorageOffsets
+    [_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
 
 BufferRef UniformManager::_perInstanceUniformBuffer;
+BufferRef UniformManager::_perInstanceStorageBuffer;
 BufferRef UniformManager::_perFrameUniformBuffer;
+
+uint32_t UniformManager::_perViewDataVertexOffset = 0u;
+std::atomic<uint32_t> UniformManager::_perInstanceDataUploadedBytes;
 BufferRef UniformManager::_perMaterialUniformBuffer;
-BufferRef UniformManager::_perMaterialStagingUniformBuffer;
 
 // <-
 
@@ -75,6 +81,23 @@ void UniformManager::init()
     buffersToCreate.push_back(_perInstanceUniformBuffer);
   }
 
+  _perInstanceStorageBuffer =
+      BufferManager::createBuffer(_N(_PerInstanceStorageBuffer));
+  {
+    BufferManager::resetToDefault(_perInstanceStorageBuffer);
+    BufferManager::addResourceFlags(
+        _perInstanceStorageBuffer,
+        Dod::Resources::ResourceFlags::kResourceVolatile);
+
+    BufferManager::_descMemoryPoolType(_perInstanceStorageBuffer) =
+        MemoryPoolType::kStaticStagingBuffers;
+    BufferManager::_descBufferType(_perInstanceStorageBuffer) =
+        BufferType::kStorage;
+    BufferManager::_descSizeInBytes(_perInstanceStorageBuffer) =
+        _INTR_VK_PER_INSTANCE_STORAGE_MEMORY_IN_BYTES;
+    buffersToCreate.push_back(_perInstanceStorageBuffer);
+  }
+
   _perMaterialUniformBuffer =
       BufferManager::createBuffer(_N(_PerMaterialConstantBuffer));
   {
@@ -90,24 +113,6 @@ void UniformManager::init()
     buffersToCreate.push_back(_perMaterialUniformBuffer);
   }
 
-  // Staging buffer used to update the per material buffer data
-  _perMaterialStagingUniformBuffer =
-      BufferManager::createBuffer(_N(_PerMaterialStagingConstantBuffer));
-  {
-    BufferManager::resetToDefault(_perMaterialStagingUniformBuffer);
-    BufferManager::addResourceFlags(
-        _perMaterialStagingUniformBuffer,
-        Dod::Resources::ResourceFlags::kResourceVolatile);
-
-    BufferManager::_descMemoryPoolType(_perMaterialStagingUniformBuffer) =
-        MemoryPoolType::kStaticStagingBuffers;
-    BufferManager::_descBufferType(_perMaterialStagingUniformBuffer) =
-        BufferType::kUniform;
-    BufferManager::_descSizeInBytes(_perMaterialStagingUniformBuffer) =
-        _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES;
-    buffersToCreate.push_back(_perMaterialStagingUniformBuffer);
-  }
-
   // Per frame data
   _perFrameUniformBuffer =
       BufferManager::createBuffer(_N(PerFrameConstantBuffer));
@@ -131,6 +136,8 @@ void UniformManager::init()
 
   // Get host memory
   _perInstanceMemory = BufferManager::getGpuMemory(_perInstanceUniformBuffer);
+  _perInstanceStorageMemory =
+      BufferManager::getGpuMemory(_perInstanceStorageBuffer);
   _perFrameMemory = BufferManager::getGpuMemory(_perFrameUniformBuffer);
 
   // Initializes per instance data memory blocks
@@ -152,6 +159,9 @@ void UniformManager::init()
   _INTR_LOG_INFO(
       "Allocated %.2f MB of per instance uniform memory...",
       Math::bytesToMegaBytes(_INTR_VK_PER_INSTANCE_UNIFORM_MEMORY_IN_BYTES));
+  _INTR_LOG_INFO(
+      "Allocated %.2f MB of per instance storage memory...",
+      Math::bytesToMegaBytes(_INTR_VK_PER_INSTANCE_STORAGE_MEMORY_IN_BYTES));
 
   // ... and the per material ones
   {
@@ -173,6 +183,11 @@ void UniformManager::onFrameEnded()
 
   _perInstanceAllocatorSmall[bufferIdx].reset();
   _perInstanceAllocatorLarge[bufferIdx].reset();
+  _perInstanceStorageOffsets[bufferIdx] = 0u;
+
+  _INTR_PROFILE_COUNTER_SET("Per Instance Data Uploaded (Bytes)",
+                            _perInstanceDataUploadedBytes);
+  _perInstanceDataUploadedBytes = 0u;
 }
 }
 }
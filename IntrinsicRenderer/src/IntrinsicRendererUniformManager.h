@@ -20,6 +20,13 @@ namespace Intrinsic
 {
 namespace Renderer
 {
+// Data shared by all mesh draw calls rendered for a single view
+struct PerViewDataVertex
+{
+  glm::mat4 viewProjMatrix;
+  glm::mat4 viewMatrix;
+};
+
 struct UniformManager
 {
   static void init();
@@ -51,6 +58,41 @@ struct UniformManager
 
   // <-
 
+  // Allocates linearly from the per instance storage of the current frame
+  _INTR_INLINE static uint8_t*
+  allocatePerInstanceStorageMemory(uint32_t p_Size, uint32_t& p_Offset)
+  {
+    const uint32_t bufferIdx = R::RenderSystem::_backbufferIndex %
+                               _INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT;
+
+    const uint32_t alignedSize =
+        (p_Size + _INTR_VK_PER_INSTANCE_STORAGE_ALIGNMENT_IN_BYTES - 1u) &
+        ~(_INTR_VK_PER_INSTANCE_STORAGE_ALIGNMENT_IN_BYTES - 1u);
+    const uint32_t offset =
+        _perInstanceStorageOffsets[bufferIdx].fetch_add(alignedSize);
+    _INTR_ASSERT(offset + alignedSize <=
+                     _INTR_VK_PER_INSTANCE_STORAGE_SIZE_IN_BYTES &&
+                 "Per instance storage exhausted");
+
+    p_Offset = bufferIdx * _INTR_VK_PER_INSTANCE_STORAGE_SIZE_IN_BYTES + offset;
+    return &_perInstanceStorageMemory[p_Offset];
+  }
+
+  // <-
+
+  // Writes the per view data used by all draw calls updated afterwards
+  _INTR_INLINE static void
+  updatePerViewData(const PerViewDataVertex& p_PerViewDataVertex)
+  {
+    uint8_t* gpuMem = allocatePerInstanceDataMemory(sizeof(PerViewDataVertex),
+                                                    _perViewDataVertexOffset);
+    memcpy(gpuMem, &p_PerViewDataVertex, sizeof(PerViewDataVertex));
+
+    _perInstanceDataUploadedBytes += sizeof(PerViewDataVertex);
+  }
+
+  // <-
+
   _INTR_INLINE static uint32_t allocatePerMaterialDataMemory()
   {
     return _perMaterialAllocator.allocate().memoryOffset;
@@ -68,39 +110,26 @@ struct UniformManager
   _INTR_INLINE static void
   updatePerMaterialDataMemory(void* p_Data, uint32_t p_Size, uint32_t p_Offset)
   {
-    // Update staging memory
-    {
-      memcpy(BufferManager::getGpuMemory(_perMaterialStagingUniformBuffer),
-             p_Data, p_Size);
-    }
-
-    // ... and copy to device
-    VkCommandBuffer copyCmd = RenderSystem::beginTemporaryCommandBuffer();
-
-    VkBufferCopy bufferCopy = {};
-    {
-      bufferCopy.dstOffset = p_Offset;
-      bufferCopy.srcOffset = 0u;
-      bufferCopy.size = p_Size;
-    }
-
-    vkCmdCopyBuffer(
-        copyCmd, BufferManager::_vkBuffer(_perMaterialStagingUniformBuffer),
-        BufferManager::_vkBuffer(_perMaterialUniformBuffer), 1u, &bufferCopy);
-
-    RenderSystem::flushTemporaryCommandBuffer();
+    UploadQueue::uploadBuffer(
+        BufferManager::_vkBuffer(_perMaterialUniformBuffer), p_Offset, p_Data,
+        p_Size);
   }
 
   // <-
 
   // Static members
   static uint8_t* _perInstanceMemory;
+  static uint8_t* _perInstanceStorageMemory;
   static uint8_t* _perFrameMemory;
 
   static BufferRef _perInstanceUniformBuffer;
+  static BufferRef _perInstanceStorageBuffer;
   static BufferRef _perMaterialUniformBuffer;
   static BufferRef _perFrameUniformBuffer;
 
+  static uint32_t _perViewDataVertexOffset;
+  static std::atomic<uint32_t> _perInstanceDataUploadedBytes;
+
 private:
   static Memory::LockFreeFixedBlockAllocator<
       _INTR_VK_PER_INSTANCE_BLOCK_SMALL_COUNT,
@@ -114,8 +143,8 @@ private:
       _INTR_VK_PER_MATERIAL_BLOCK_COUNT,
       _INTR_VK_PER_MATERIAL_BLOCK_SIZE_IN_BYTES>
       _perMaterialAllocator;
-
-  static BufferRef _perMaterialStagingUniformBuffer;
+  static std::atomic<uint32_t>
+      _perInstanceStorageOffsets[_INTR_VK_PER_INSTANCE_DATA_BUFFER_COUNT];
 };
 }
 }
@@ -0,0 +1,557 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+// Precompiled header file
+#include "stdafx.h"
+
+namespace Intrinsic
+{
+namespace Renderer
+{
+// Static members
+VkCommandPool UploadQueue::_vkCommandPool = VK_NULL_HANDLE;
+VkBuffer UploadQueue::_vkStagingBuffer = VK_NULL_HANDLE;
+uint8_t* UploadQueue::_stagingMemory = nullptr;
+
+uint32_t UploadQueue::_stagingHead = 0u;
+uint32_t UploadQueue::_stagingTail = 0u;
+
+UploadBatch UploadQueue::_batches[_INTR_UPLOAD_QUEUE_BATCH_COUNT] = {};
+uint32_t UploadQueue::_currentBatchIdx = 0u;
+uint32_t UploadQueue::_oldestBatchIdx = 0u;
+bool UploadQueue::_currentBatchRecording = false;
+
+_INTR_ARRAY(VkBufferCopy) UploadQueue::_pendingBufferCopies;
+VkBuffer UploadQueue::_pendingDstBuffer = VK_NULL_HANDLE;
+
+UploadToken UploadQueue::_nextToken = 1u;
+UploadToken UploadQueue::_completedToken = 0u;
+
+// <-
+
+void UploadQueue::init()
+{
+  _INTR_LOG_INFO("Initializing Upload Queue...");
+
+  {
+    VkCommandPoolCreateInfo commandPoolCreateInfo = {};
+    {
+      commandPoolCreateInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+      commandPoolCreateInfo.pNext = nullptr;
+      commandPoolCreateInfo.queueFamilyIndex =
+          RenderSystem::_vkGraphicsAndComputeQueueFamilyIndex;
+      commandPoolCreateInfo.flags =
+          VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT |
+          VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    }
+
+    VkResult result =
+        vkCreateCommandPool(RenderSystem::_vkDevice, &commandPoolCreateInfo,
+                            nullptr, &_vkCommandPool);
+    _INTR_VK_CHECK_RESULT(result);
+  }
+
+  for (uint32_t batchIdx = 0u; batchIdx < _INTR_UPLOAD_QUEUE_BATCH_COUNT;
+       ++batchIdx)
+  {
+    UploadBatch& batch = _batches[batchIdx];
+
+    VkCommandBufferAllocateInfo cmd = {};
+    {
+      cmd.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+      cmd.pNext = nullptr;
+      cmd.commandPool = _vkCommandPool;
+      cmd.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+      cmd.commandBufferCount = 1u;
+    }
+
+    VkResult result = vkAllocateCommandBuffers(RenderSystem::_vkDevice, &cmd,
+                                               &batch._vkCommandBuffer);
+    _INTR_VK_CHECK_RESULT(result);
+
+    VkFenceCreateInfo fenceInfo = {};
+    {
+      fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+      fenceInfo.pNext = nullptr;
+    }
+
+    result = vkCreateFence(RenderSystem::_vkDevice, &fenceInfo, nullptr,
+                           &batch._vkFence);
+    _INTR_VK_CHECK_RESULT(result);
+
+    batch._token = 0u;
+    batch._stagingEnd = 0u;
+    batch._inFlight = false;
+  }
+
+  // Staging ring buffer
+  {
+    VkBufferCreateInfo bufferCreateInfo = {};
+    {
+      bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+      bufferCreateInfo.pNext = nullptr;
+      bufferCreateInfo.size = _INTR_UPLOAD_QUEUE_STAGING_SIZE_IN_BYTES;
+      bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+      bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    }
+
+    VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
+                                     nullptr, &_vkStagingBuffer);
+    _INTR_VK_CHECK_RESULT(result);
+
+    VkMemoryRequirements memReqs;
+    vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, _vkStagingBuffer,
+                                  &memReqs);
+
+    // The ring stays alive while the rest of the pool is reset
+    const GpuMemoryAllocationInfo allocInfo =
+        GpuMemoryManager::allocatePersistentOffset(
+            MemoryPoolType::kVolatileStagingBuffers, (uint32_t)memReqs.size,
+            (uint32_t)memReqs.alignment, memReqs.memoryTypeBits);
+
+    result = vkBindBufferMemory(RenderSystem::_vkDevice, _vkStagingBuffer,
+                                allocInfo._vkDeviceMemory, allocInfo._offset);
+    _INTR_VK_CHECK_RESULT(result);
+
+    _stagingMemory = allocInfo._mappedMemory;
+    _INTR_ASSERT(_stagingMemory != nullptr);
+  }
+
+  _pendingBufferCopies.reserve(1024u);
+}
+
+// <-
+
+void UploadQueue::destroy()
+{
+  waitForCompletion(flush());
+
+  for (uint32_t batchIdx = 0u; batchIdx < _INTR_UPLOAD_QUEUE_BATCH_COUNT;
+       ++batchIdx)
+  {
+    vkDestroyFence(RenderSystem::_vkDevice, _batches[batchIdx]._vkFence,
+                   nullptr);
+  }
+
+  vkDestroyBuffer(RenderSystem::_vkDevice, _vkStagingBuffer, nullptr);
+  vkDestroyCommandPool(RenderSystem::_vkDevice, _vkCommandPool, nullptr);
+}
+
+// <-
+
+UploadToken UploadQueue::uploadBuffer(VkBuffer p_DstBuffer,
+                                      uint32_t p_DstOffset, const void* p_Data,
+                                      uint32_t p_Size)
+{
+  if (p_Size > _INTR_UPLOAD_QUEUE_MAX_RING_UPLOAD_SIZE_IN_BYTES)
+  {
+    VkCommandBuffer copyCmd = beginBatch();
+    recordPendingBufferCopies();
+
+    VkBuffer stagingBuffer;
+    uint8_t* stagingMemory =
+        allocateDedicatedStagingMemory(p_Size, stagingBuffer);
+    memcpy(stagingMemory, p_Data, p_Size);
+
+    VkBufferCopy bufferCopy = {};
+    {
+      bufferCopy.srcOffset = 0u;
+      bufferCopy.dstOffset = p_DstOffset;
+      bufferCopy.size = p_Size;
+    }
+    vkCmdCopyBuffer(copyCmd, stagingBuffer, p_DstBuffer, 1u, &bufferCopy);
+
+    return _nextToken;
+  }
+
+  uint32_t stagingOffset;
+  uint8_t* stagingMemory = allocateStagingMemory(
+      p_Size, _INTR_UPLOAD_QUEUE_STAGING_ALIGNMENT_IN_BYTES, stagingOffset);
+  memcpy(stagingMemory, p_Data, p_Size);
+
+  beginBatch();
+
+  // Copies to the same buffer are merged to a single command
+  if (_pendingDstBuffer != p_DstBuffer)
+  {
+    recordPendingBufferCopies();
+    _pendingDstBuffer = p_DstBuffer;
+  }
+
+  VkBufferCopy bufferCopy = {};
+  {
+    bufferCopy.srcOffset = stagingOffset;
+    bufferCopy.dstOffset = p_DstOffset;
+    bufferCopy.size = p_Size;
+  }
+  _pendingBufferCopies.push_back(bufferCopy);
+
+  return _nextToken;
+}
+
+// <-
+
+UploadToken UploadQueue::uploadImage(VkImage p_DstImage,
+                                     const VkImageSubresourceRange& p_Range,
+                                     const VkBufferImageCopy* p_Regions,
+                                     uint32_t p_RegionCount,
+                                     const void* p_Data, uint32_t p_Size)
+{
+  VkBuffer stagingBuffer = _vkStagingBuffer;
+  uint32_t stagingOffset = 0u;
+  uint8_t* stagingMemory;
+
+  if (p_Size > _INTR_UPLOAD_QUEUE_MAX_RING_UPLOAD_SIZE_IN_BYTES)
+  {
+    beginBatch();
+    stagingMemory = allocateDedicatedStagingMemory(p_Size, stagingBuffer);
+  }
+  else
+  {
+    stagingMemory = allocateStagingMemory(
+        p_Size, _INTR_UPLOAD_QUEUE_STAGING_ALIGNMENT_IN_BYTES, stagingOffset);
+  }
+  memcpy(stagingMemory, p_Data, p_Size);
+
+  VkCommandBuffer copyCmd = beginBatch();
+  recordPendingBufferCopies();
+
+  _INTR_SCRATCH_ARRAY(VkBufferImageCopy) regions;
+  regions.insert(regions.end(), p_Regions, p_Regions + p_RegionCount);
+  for (uint32_t i = 0u; i < p_RegionCount; ++i)
+  {
+    regions[i].bufferOffset += stagingOffset;
+  }
+
+  Helper::insertImageMemoryBarrier(copyCmd, p_DstImage,
+                                   VK_IMAGE_LAYOUT_UNDEFINED,
+                                   VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                   p_Range);
+
+  vkCmdCopyBufferToImage(copyCmd, stagingBuffer, p_DstImage,
+                         VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, p_RegionCount,
+                         regions.data());
+
+  Helper::insertImageMemoryBarrier(
+      copyCmd, p_DstImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+      VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL, p_Range);
+
+  return _nextToken;
+}
+
+// <-
+
+UploadToken UploadQueue::flush()
+{
+  if (!_currentBatchRecording)
+  {
+    return _nextToken - 1u;
+  }
+
+  _INTR_PROFILE_CPU("Render System", "Flush Upload Queue");
+
+  UploadBatch& batch = _batches[_currentBatchIdx];
+  recordPendingBufferCopies();
+
+  // Make the uploaded data visible to all following submissions
+  VkMemoryBarrier memoryBarrier = {};
+  {
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.pNext = nullptr;
+    memoryBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    memoryBarrier.dstAccessMask =
+        VK_ACCESS_MEMORY_READ_BIT | VK_ACCESS_MEMORY_WRITE_BIT;
+  }
+  vkCmdPipelineBarrier(batch._vkCommandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT, 0u, 1u,
+                       &memoryBarrier, 0u, nullptr, 0u, nullptr);
+
+  VkResult result = vkEndCommandBuffer(batch._vkCommandBuffer);
+  _INTR_VK_CHECK_RESULT(result);
+
+  VkSubmitInfo submitInfo = {};
+  {
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.pNext = nullptr;
+    submitInfo.commandBufferCount = 1u;
+    submitInfo.pCommandBuffers = &batch._vkCommandBuffer;
+  }
+
+  result = vkQueueSubmit(RenderSystem::_vkQueue, 1u, &submitInfo,
+                         batch._vkFence);
+  _INTR_VK_CHECK_RESULT(result);
+
+  batch._token = _nextToken++;
+  batch._stagingEnd = _stagingHead;
+  batch._inFlight = true;
+
+  _currentBatchIdx = (_currentBatchIdx + 1u) % _INTR_UPLOAD_QUEUE_BATCH_COUNT;
+  _currentBatchRecording = false;
+
+  return batch._token;
+}
+
+// <-
+
+bool UploadQueue::isComplete(UploadToken p_Token)
+{
+  if (p_Token <= _completedToken)
+  {
+    return true;
+  }
+
+  retireCompletedBatches(false);
+  return p_Token <= _completedToken;
+}
+
+// <-
+
+void UploadQueue::waitForCompletion(UploadToken p_Token)
+{
+  if (p_Token >= _nextToken)
+  {
+    p_Token = flush();
+  }
+
+  while (!isComplete(p_Token))
+  {
+    retireCompletedBatches(true);
+  }
+}
+
+// <-
+
+VkCommandBuffer UploadQueue::beginBatch()
+{
+  UploadBatch& batch = _batches[_currentBatchIdx];
+
+  if (_currentBatchRecording)
+  {
+    return batch._vkCommandBuffer;
+  }
+
+  while (batch._inFlight)
+  {
+    retireCompletedBatches(true);
+  }
+
+  VkCommandBufferBeginInfo cmdBufInfo = {};
+  {
+    cmdBufInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    cmdBufInfo.pNext = nullptr;
+    cmdBufInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    cmdBufInfo.pInheritanceInfo = nullptr;
+  }
+  VkResult result = vkBeginCommandBuffer(batch._vkCommandBuffer, &cmdBufInfo);
+  _INTR_VK_CHECK_RESULT(result);
+
+  // Wait for all previous submissions to stop accessing the destinations
+  vkCmdPipelineBarrier(batch._vkCommandBuffer,
+                       VK_PIPELINE_STAGE_ALL_COMMANDS_BIT,
+                       VK_PIPELINE_STAGE_TRANSFER_BIT, 0u, 0u, nullptr, 0u,
+                       nullptr, 0u, nullptr);
+
+  _currentBatchRecording = true;
+  return batch._vkCommandBuffer;
+}
+
+// <-
+
+void UploadQueue::recordPendingBufferCopies()
+{
+  if (!_pendingBufferCopies.empty())
+  {
+    vkCmdCopyBuffer(_batches[_currentBatchIdx]._vkCommandBuffer,
+                    _vkStagingBuffer, _pendingDstBuffer,
+                    (uint32_t)_pendingBufferCopies.size(),
+                    _pendingBufferCopies.data());
+    _pendingBufferCopies.clear();
+  }
+
+  _pendingDstBuffer = VK_NULL_HANDLE;
+}
+
+// <-
+
+void UploadQueue::retireCompletedBatches(bool p_WaitForOldest)
+{
+  bool wait = p_WaitForOldest;
+
+  while (_batches[_oldestBatchIdx]._inFlight)
+  {
+    UploadBatch& batch = _batches[_oldestBatchIdx];
+
+    VkResult result = VK_SUCCESS;
+    if (wait)
+    {
+      _INTR_PROFILE_CPU("Render System", "Wait For Upload Batch");
+
+      do
+      {
+        result = vkWaitForFences(RenderSystem::_vkDevice, 1u, &batch._vkFence,
+                                 VK_TRUE, UINT64_MAX);
+      } while (result == VK_TIMEOUT);
+      wait = false;
+    }
+    else
+    {
+      result = vkGetFenceStatus(RenderSystem::_vkDevice, batch._vkFence);
+      if (result == VK_NOT_READY)
+      {
+        break;
+      }
+    }
+    _INTR_VK_CHECK_RESULT(result);
+
+    result = vkResetFences(RenderSystem::_vkDevice, 1u, &batch._vkFence);
+    _INTR_VK_CHECK_RESULT(result);
+
+    _completedToken = batch._token;
+    _stagingTail = batch._stagingEnd;
+    batch._inFlight = false;
+
+    for (uint32_t i = 0u; i < batch._dedicatedStagingBuffers.size(); ++i)
+    {
+      vkDestroyBuffer(RenderSystem::_vkDevice,
+                      batch._dedicatedStagingBuffers[i], nullptr);
+      vkFreeMemory(RenderSystem::_vkDevice, batch._dedicatedStagingMemory[i],
+                   nullptr);
+    }
+    batch._dedicatedStagingBuffers.clear();
+    batch._dedicatedStagingMemory.clear();
+
+    _oldestBatchIdx = (_oldestBatchIdx + 1u) % _INTR_UPLOAD_QUEUE_BATCH_COUNT;
+  }
+}
+
+// <-
+
+bool UploadQueue::tryAllocateStagingMemory(uint32_t p_Size,
+                                           uint32_t p_Alignment,
+                                           uint32_t& p_Offset)
+{
+  // Rewind if no staging memory is referenced anymore
+  if (!_batches[_oldestBatchIdx]._inFlight && !_currentBatchRecording)
+  {
+    _stagingHead = 0u;
+    _stagingTail = 0u;
+  }
+
+  const uint32_t alignedHead =
+      (_stagingHead + p_Alignment - 1u) & ~(p_Alignment - 1u);
+
+  // The head never catches up with the tail, so head == tail always means
+  // that the ring is empty
+  if (_stagingHead >= _stagingTail)
+  {
+    if (alignedHead + p_Size <= _INTR_UPLOAD_QUEUE_STAGING_SIZE_IN_BYTES)
+    {
+      p_Offset = alignedHead;
+      _stagingHead = alignedHead + p_Size;
+      return true;
+    }
+
+    // Wrap around
+    if (p_Size < _stagingTail)
+    {
+      p_Offset = 0u;
+      _stagingHead = p_Size;
+      return true;
+    }
+  }
+  else if (alignedHead + p_Size < _stagingTail)
+  {
+    p_Offset = alignedHead;
+    _stagingHead = alignedHead + p_Size;
+    return true;
+  }
+
+  return false;
+}
+
+// <-
+
+uint8_t* UploadQueue::allocateStagingMemory(uint32_t p_Size,
+                                            uint32_t p_Alignment,
+                                            uint32_t& p_Offset)
+{
+  _INTR_ASSERT(p_Size <= _INTR_UPLOAD_QUEUE_MAX_RING_UPLOAD_SIZE_IN_BYTES &&
+               "Upload exceeds the maximum size for the staging ring buffer");
+
+  while (!tryAllocateStagingMemory(p_Size, p_Alignment, p_Offset))
+  {
+    // Submit the pending uploads so their staging memory can be reclaimed
+    flush();
+    retireCompletedBatches(true);
+  }
+
+  return &_stagingMemory[p_Offset];
+}
+// <-
+
+// Oversized uploads would never fit in the ring - they get their own host
+// visible buffer which is attached to the batch currently recording
+uint8_t* UploadQueue::allocateDedicatedStagingMemory(uint32_t p_Size,
+                                                     VkBuffer& p_Buffer)
+{
+  _INTR_ASSERT(_currentBatchRecording);
+  UploadBatch& batch = _batches[_currentBatchIdx];
+
+  VkBufferCreateInfo bufferCreateInfo = {};
+  {
+    bufferCreateInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferCreateInfo.pNext = nullptr;
+    bufferCreateInfo.size = p_Size;
+    bufferCreateInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
+    bufferCreateInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+  }
+
+  VkResult result = vkCreateBuffer(RenderSystem::_vkDevice, &bufferCreateInfo,
+                                   nullptr, &p_Buffer);
+  _INTR_VK_CHECK_RESULT(result);
+
+  VkMemoryRequirements memReqs;
+  vkGetBufferMemoryRequirements(RenderSystem::_vkDevice, p_Buffer, &memReqs);
+
+  VkMemoryAllocateInfo memAllocInfo = {};
+  {
+    memAllocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    memAllocInfo.pNext = nullptr;
+    memAllocInfo.allocationSize = memReqs.size;
+    memAllocInfo.memoryTypeIndex = Helper::computeGpuMemoryTypeIdx(
+        memReqs.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                    VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+  }
+
+  VkDeviceMemory vkDeviceMemory;
+  result = vkAllocateMemory(RenderSystem::_vkDevice, &memAllocInfo, nullptr,
+                            &vkDeviceMemory);
+  _INTR_VK_CHECK_RESULT(result);
+
+  result = vkBindBufferMemory(RenderSystem::_vkDevice, p_Buffer,
+                              vkDeviceMemory, 0u);
+  _INTR_VK_CHECK_RESULT(result);
+
+  uint8_t* mappedMemory;
+  result = vkMapMemory(RenderSystem::_vkDevice, vkDeviceMemory, 0u,
+                       memReqs.size, 0u, (void**)&mappedMemory);
+  _INTR_VK_CHECK_RESULT(result);
+
+  batch._dedicatedStagingBuffers.push_back(p_Buffer);
+  batch._dedicatedStagingMemory.push_back(vkDeviceMemory);
+
+  return mappedMemory;
+}
+}
+}
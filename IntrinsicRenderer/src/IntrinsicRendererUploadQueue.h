@@ -0,0 +1,111 @@
+// Copyright 2017 Benjamin Glatzel
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#pragma once
+
+#define _INTR_UPLOAD_QUEUE_STAGING_SIZE_IN_BYTES (64u * 1024u * 1024u)
+#define _INTR_UPLOAD_QUEUE_STAGING_ALIGNMENT_IN_BYTES 16u
+#define _INTR_UPLOAD_QUEUE_BATCH_COUNT 4u
+// Uploads exceeding this size bypass the ring and use a dedicated staging
+// buffer
+#define _INTR_UPLOAD_QUEUE_MAX_RING_UPLOAD_SIZE_IN_BYTES                       \
+  (_INTR_UPLOAD_QUEUE_STAGING_SIZE_IN_BYTES / 2u)
+
+namespace Intrinsic
+{
+namespace Renderer
+{
+// Token identifying a batch of uploads, can be polled for completion
+typedef uint64_t UploadToken;
+
+struct UploadBatch
+{
+  VkCommandBuffer _vkCommandBuffer;
+  VkFence _vkFence;
+  UploadToken _token;
+  uint32_t _stagingEnd;
+  bool _inFlight;
+
+  // Released as soon as the batch completed
+  _INTR_ARRAY(VkBuffer) _dedicatedStagingBuffers;
+  _INTR_ARRAY(VkDeviceMemory) _dedicatedStagingMemory;
+};
+
+// Accumulates copies from a ring buffered staging area and records them to a
+// single transfer command buffer which is submitted once per frame (or load
+// batch). Not thread safe - uploads have to be issued from the main thread.
+struct UploadQueue
+{
+  static void init();
+  static void destroy();
+
+  // <-
+
+  static UploadToken uploadBuffer(VkBuffer p_DstBuffer, uint32_t p_DstOffset,
+                                  const void* p_Data, uint32_t p_Size);
+  static UploadToken uploadImage(VkImage p_DstImage,
+                                 const VkImageSubresourceRange& p_Range,
+                                 const VkBufferImageCopy* p_Regions,
+                                 uint32_t p_RegionCount, const void* p_Data,
+                                 uint32_t p_Size);
+
+  // <-
+
+  // Submits all pending uploads and returns the token of the submitted batch
+  static UploadToken flush();
+
+  // Returns true if all uploads associated with the given token completed
+  static bool isComplete(UploadToken p_Token);
+  static void waitForCompletion(UploadToken p_Token);
+
+  // <-
+
+  _INTR_INLINE static UploadToken getPendingToken() { return _nextToken; }
+  _INTR_INLINE static bool hasPendingUploads()
+  {
+    return _currentBatchRecording;
+  }
+
+private:
+  static uint8_t* allocateStagingMemory(uint32_t p_Size,
+                                        uint32_t p_Alignment,
+                                        uint32_t& p_Offset);
+  static bool tryAllocateStagingMemory(uint32_t p_Size, uint32_t p_Alignment,
+                                       uint32_t& p_Offset);
+  static uint8_t* allocateDedicatedStagingMemory(uint32_t p_Size,
+                                                 VkBuffer& p_Buffer);
+  static VkCommandBuffer beginBatch();
+  static void recordPendingBufferCopies();
+  static void retireCompletedBatches(bool p_WaitForOldest);
+
+  static VkCommandPool _vkCommandPool;
+  static VkBuffer _vkStagingBuffer;
+  static uint8_t* _stagingMemory;
+
+  static uint32_t _stagingHead;
+  static uint32_t _stagingTail;
+
+  static UploadBatch _batches[_INTR_UPLOAD_QUEUE_BATCH_COUNT];
+  static uint32_t _currentBatchIdx;
+  static uint32_t _oldestBatchIdx;
+  static bool _currentBatchRecording;
+
+  static _INTR_ARRAY(VkBufferCopy) _pendingBufferCopies;
+  static VkBuffer _pendingDstBuffer;
+
+  static UploadToken _nextToken;
+  static UploadToken _completedToken;
+};
+}
+}
@@ -31,6 +31,25 @@
            uboPerMaterial.uvOffsetScale.y)
 #define UV0(_uv0) vec2(_uv0.x, (1.0 - _uv0.y))
 
+#if defined(INSTANCED)
+struct PerInstanceDataFragment
+{
+  vec4 colorTint;
+  vec4 camParams;
+  vec4 data0;
+};
+
+// Stores the data of all instances of the draw call, the instance index is
+// passed on by the vertex shader
+#define PER_INSTANCE_UBO                                                       \
+  layout(location = 5) flat in uint inInstanceIdx;                             \
+  layout(std430, binding = 1) readonly buffer PerInstance                      \
+                                                                               \
+  {                                                                            \
+    PerInstanceDataFragment perInstanceData[];                                 \
+  }
+#define uboPerInstance perInstanceData[inInstanceIdx]
+#else
 #define PER_INSTANCE_UBO                                                       \
   layout(binding = 1) uniform PerInstance                                      \
                                                                                \
@@ -41,6 +60,7 @@
     vec4 data1;                                                                \
   }                                                                            \
   uboPerInstance
+#endif // INSTANCED
 
 #define PER_MATERIAL_UBO                                                       \
   layout(binding = 2) uniform PerMaterial                                      \
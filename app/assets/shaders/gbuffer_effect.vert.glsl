@@ -23,6 +23,7 @@
 out gl_PerVertex { vec4 gl_Position; };
 
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 INPUT();
 
 layout(location = 0) out vec3 outNormal;
@@ -34,20 +35,18 @@ layout(location = 5) out vec4 outPosition;
 
 void main()
 {
-  const vec3 worldNormal =
-      (uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
+  const mat4 worldMatrix = WORLD_MATRIX;
+  const mat4 worldViewMatrix = uboPerView.viewMatrix * worldMatrix;
+
+  const vec3 worldNormal = (worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
   const vec3 worldPos =
-      (uboPerInstance.worldMatrix * vec4(inPosition.xyz, 1.0)).xyz +
+      (worldMatrix * vec4(inPosition.xyz, 1.0)).xyz +
       worldNormal * 0.1; // Offset the effect from the other passes
-  gl_Position = outPosition =
-      uboPerInstance.viewProjMatrix * vec4(worldPos, 1.0);
+  gl_Position = outPosition = uboPerView.viewProjMatrix * vec4(worldPos, 1.0);
 
   outColor = inColor.xyz;
-  outNormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inNormal, 0.0)).xyz;
-  outTangent =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inTangent, 0.0)).xyz;
-  outBinormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
+  outNormal = normalize(worldViewMatrix * vec4(inNormal, 0.0)).xyz;
+  outTangent = normalize(worldViewMatrix * vec4(inTangent, 0.0)).xyz;
+  outBinormal = normalize(worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
   outUV0 = inUV0;
 }
@@ -27,6 +27,7 @@ out gl_PerVertex { vec4 gl_Position; };
 
 // Ubos
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 
 // Input
 INPUT();
@@ -41,13 +42,16 @@ layout(location = 5) out vec3 outWorldPosition;
 
 void main()
 {
+  const mat4 worldMatrix = WORLD_MATRIX;
+  const mat4 worldViewMatrix = uboPerView.viewMatrix * worldMatrix;
+  const mat4 worldViewProjMatrix = uboPerView.viewProjMatrix * worldMatrix;
+
   vec3 localPos = inPosition.xyz;
-  outWorldPosition =
-      (uboPerInstance.worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
+  outWorldPosition = (worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
   const vec3 worldNormal =
-      normalize((uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz);
+      normalize((worldMatrix * vec4(inNormal.xyz, 0.0)).xyz);
   const vec2 windStrength = calcWindStrength(uboPerInstance.data0.w);
-  const vec3 pivotWS = vec3(uboPerInstance.worldMatrix[3]);
+  const vec3 pivotWS = vec3(worldMatrix[3]);
 
 #if defined(GRASS)
   applyGrassWind(localPos, outWorldPosition, uboPerInstance.data0.w,
@@ -57,14 +61,11 @@ void main()
                 uboPerInstance.data0.w, windStrength);
 #endif // GRASS
 
-  gl_Position = uboPerInstance.worldViewProjMatrix * vec4(localPos, 1.0);
+  gl_Position = worldViewProjMatrix * vec4(localPos, 1.0);
 
   outColor = inColor.xyz;
-  outNormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inNormal, 0.0)).xyz;
-  outTangent =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inTangent, 0.0)).xyz;
-  outBinormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
+  outNormal = normalize(worldViewMatrix * vec4(inNormal, 0.0)).xyz;
+  outTangent = normalize(worldViewMatrix * vec4(inTangent, 0.0)).xyz;
+  outBinormal = normalize(worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
   outUV0 = inUV0;
 }
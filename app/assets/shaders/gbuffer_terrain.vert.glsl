@@ -23,6 +23,7 @@
 out gl_PerVertex { vec4 gl_Position; };
 
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 INPUT();
 
 layout(location = 0) out vec3 outNormal;
@@ -33,14 +34,15 @@ layout(location = 4) out vec2 outUV0;
 
 void main()
 {
-  gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
+  const mat4 worldMatrix = WORLD_MATRIX;
+  const mat4 worldViewMatrix = uboPerView.viewMatrix * worldMatrix;
+  const mat4 worldViewProjMatrix = uboPerView.viewProjMatrix * worldMatrix;
+
+  gl_Position = worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
 
   outColor = inColor.xyz;
-  outNormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inNormal, 0.0)).xyz;
-  outTangent =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inTangent, 0.0)).xyz;
-  outBinormal =
-      normalize(uboPerInstance.worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
+  outNormal = normalize(worldViewMatrix * vec4(inNormal, 0.0)).xyz;
+  outTangent = normalize(worldViewMatrix * vec4(inTangent, 0.0)).xyz;
+  outBinormal = normalize(worldViewMatrix * vec4(inBinormal, 0.0)).xyz;
   outUV0 = inUV0;
 }
@@ -1,15 +1,41 @@
+#if defined(INSTANCED)
+struct PerInstanceDataVertex
+{
+  mat3x4 worldMatrixRows;
+  vec4 data0;
+};
+
+// Stores the data of all instances of the draw call
+#define PER_INSTANCE_UBO                                                       \
+  layout(std430, binding = 0) readonly buffer PerInstance                      \
+                                                                               \
+  {                                                                            \
+    PerInstanceDataVertex perInstanceData[];                                   \
+  }
+#define uboPerInstance perInstanceData[gl_InstanceIndex]
+#else
 #define PER_INSTANCE_UBO                                                       \
   layout(binding = 0) uniform PerInstance                                      \
                                                                                \
   {                                                                            \
-    mat4 worldMatrix;                                                          \
-    mat4 worldViewProjMatrix;                                                  \
-    mat4 worldViewMatrix;                                                      \
-    mat4 viewProjMatrix;                                                       \
-    mat4 viewMatrix;                                                           \
+    mat3x4 worldMatrixRows;                                                    \
     vec4 data0;                                                                \
   }                                                                            \
   uboPerInstance
+#endif // INSTANCED
+
+// Shared by all draw calls rendered for the current view
+#define PER_VIEW_UBO                                                           \
+  layout(binding = 14) uniform PerView                                         \
+                                                                               \
+  {                                                                            \
+    mat4 viewProjMatrix;                                                       \
+    mat4 viewMatrix;                                                           \
+  }                                                                            \
+  uboPerView
+
+// The world matrix is stored as three rows to save bandwidth
+#define WORLD_MATRIX mat4(transpose(uboPerInstance.worldMatrixRows))
 
 #define INPUT()                                                                \
   layout(location = 0) in vec3 inPosition;                                     \
@@ -56,6 +56,12 @@ const uint maxIrradProbeCountPerCluster = 8 + 2;
 const uint maxSpecProbeCountPerCluster = 8 + 2;
 const uint maxDecalCountPerCluster = 64 + 2;
 
+// +1 for the word count in front of the masks
+const uint maxLightMaskWordCountPerCluster = 16384 / 32 + 1;
+
+// Stores one bit per light and cluster instead of the light index lists
+//#define USE_LIGHT_BITMASKS
+
 const float gridDepth = 10000.0f;
 const uvec3 gridRes = uvec3(16u, 8u, 24u);
 const float gridDepthExp = 3.0;
@@ -247,6 +247,25 @@ void main()
 
   // Point lights
   {
+#if defined(USE_LIGHT_BITMASKS)
+    const uint clusterIdx =
+        calcClusterIndex(gridPos, maxLightMaskWordCountPerCluster);
+    const uint wordCount = lightIndices[clusterIdx];
+
+    for (uint wi = 0; wi < wordCount; ++wi)
+    {
+      uint lightMask = lightIndices[clusterIdx + wi + 1u];
+
+      while (lightMask != 0u)
+      {
+        const uint lightIdx = wi * 32u + uint(findLSB(lightMask));
+        lightMask &= lightMask - 1u;
+
+        Light light = lights[lightIdx];
+        calcPointLightLighting(light, d, matParams, outColor);
+      }
+    }
+#else
     const uint clusterIdx =
         calcClusterIndex(gridPos, maxLightCountPerCluster) / 2;
     const uint lightCount = lightIndices[clusterIdx];
@@ -262,5 +281,6 @@ void main()
       light.colorAndIntensity.w *= float(li + 1 < lightCount);
       calcPointLightLighting(light, d, matParams, outColor);
     }
+#endif // USE_LIGHT_BITMASKS
   }
 }
@@ -23,9 +23,13 @@
 out gl_PerVertex { vec4 gl_Position; };
 
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 INPUT();
 
 void main()
 {
-  gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
+  const mat4 worldMatrix = WORLD_MATRIX;
+  const mat4 worldViewProjMatrix = uboPerView.viewProjMatrix * worldMatrix;
+
+  gl_Position = worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
 }
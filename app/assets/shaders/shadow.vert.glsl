@@ -24,6 +24,7 @@ out gl_PerVertex { vec4 gl_Position; };
 
 // Ubos
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 
 // Input
 INPUT();
@@ -35,8 +36,10 @@ const float maxNormalLen = 200.0;
 
 void main()
 {
+  const mat4 worldMatrix = WORLD_MATRIX;
+
   const vec3 localPos = inPosition;
-  vec3 worldNormal = (uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
+  vec3 worldNormal = (worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
 
   const float worldNormalLen = length(worldNormal);
   if (worldNormalLen > maxNormalLen)
@@ -45,8 +48,8 @@ void main()
   }
 
   const vec3 worldPos =
-      (uboPerInstance.worldMatrix * vec4(localPos.xyz, 1.0)).xyz -
+      (worldMatrix * vec4(localPos.xyz, 1.0)).xyz -
       worldNormal * 0.07; // Shadow bias
-  gl_Position = uboPerInstance.viewProjMatrix * vec4(worldPos, 1.0);
+  gl_Position = uboPerView.viewProjMatrix * vec4(worldPos, 1.0);
   outUV0 = inUV0;
 }
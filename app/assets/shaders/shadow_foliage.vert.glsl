@@ -27,6 +27,7 @@ out gl_PerVertex { vec4 gl_Position; };
 
 // Ubos
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 
 // Input
 INPUT();
@@ -36,14 +37,14 @@ layout(location = 0) out vec2 outUV0;
 
 void main()
 {
+  const mat4 worldMatrix = WORLD_MATRIX;
+
   vec3 localPos = inPosition;
-  const vec3 initialWorldPos =
-      (uboPerInstance.worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
-  const vec3 worldNormalUnorm =
-      (uboPerInstance.worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
+  const vec3 initialWorldPos = (worldMatrix * vec4(inPosition.xyz, 1.0)).xyz;
+  const vec3 worldNormalUnorm = (worldMatrix * vec4(inNormal.xyz, 0.0)).xyz;
   const vec3 worldNormal = normalize(worldNormalUnorm);
   const vec2 windStrength = calcWindStrength(uboPerInstance.data0.w);
-  const vec3 pivotWS = vec3(uboPerInstance.worldMatrix[3]);
+  const vec3 pivotWS = vec3(worldMatrix[3]);
 
 #if defined(GRASS)
   applyGrassWind(localPos, initialWorldPos, uboPerInstance.data0.w,
@@ -54,9 +55,9 @@ void main()
 #endif // GRASS
 
   const vec3 worldPos =
-      (uboPerInstance.worldMatrix * vec4(localPos.xyz, 1.0)).xyz -
+      (worldMatrix * vec4(localPos.xyz, 1.0)).xyz -
       worldNormalUnorm.xyz * 0.03; // Shadow bias
-  gl_Position = uboPerInstance.viewProjMatrix * vec4(worldPos, 1.0);
+  gl_Position = uboPerView.viewProjMatrix * vec4(worldPos, 1.0);
 
   outUV0 = inUV0;
 }
@@ -24,6 +24,7 @@ out gl_PerVertex { vec4 gl_Position; };
 
 // Ubos
 PER_INSTANCE_UBO;
+PER_VIEW_UBO;
 
 // Input
 INPUT();
@@ -36,9 +37,13 @@ layout(location = 3) out vec3 outUpVS;
 
 void main()
 {
-  gl_Position = uboPerInstance.worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
-  outUpVS = (uboPerInstance.viewMatrix * vec4(vec3(0.0, 1.0, 0.0), 0.0)).xyz;
-  outPosVS = (uboPerInstance.worldViewMatrix * vec4(inPosition.xyz, 1.0)).xyz;
+  const mat4 worldMatrix = WORLD_MATRIX;
+  const mat4 worldViewMatrix = uboPerView.viewMatrix * worldMatrix;
+  const mat4 worldViewProjMatrix = uboPerView.viewProjMatrix * worldMatrix;
+
+  gl_Position = worldViewProjMatrix * vec4(inPosition.xyz, 1.0);
+  outUpVS = (uboPerView.viewMatrix * vec4(vec3(0.0, 1.0, 0.0), 0.0)).xyz;
+  outPosVS = (worldViewMatrix * vec4(inPosition.xyz, 1.0)).xyz;
   outUV0 = inUV0;
   outNormal = inNormal;
 }
@@ -193,6 +193,25 @@ void main()
 
   // Local lights
   {
+#if defined(USE_LIGHT_BITMASKS)
+    const uint clusterIdx =
+        calcClusterIndex(gridPos, maxLightMaskWordCountPerCluster);
+    const uint wordCount = lightIndices[clusterIdx];
+
+    for (uint wi = 0; wi < wordCount; ++wi)
+    {
+      uint lightMask = lightIndices[clusterIdx + wi + 1];
+
+      while (lightMask != 0)
+      {
+        const uint lightIdx = wi * 32 + uint(findLSB(lightMask));
+        lightMask &= lightMask - 1;
+
+        Light light = lights[lightIdx];
+        calcPointLight(light, posVS, lighting);
+      }
+    }
+#else
     const uint clusterIdx =
         calcClusterIndex(gridPos, maxLightCountPerCluster) / 2;
     uint lightCount = lightIndices[clusterIdx];
@@ -208,6 +227,7 @@ void main()
       light.colorAndIntensity.w *= float(li + 1 < lightCount);
       calcPointLight(light, posVS, lighting);
     }
+#endif // USE_LIGHT_BITMASKS
   }
 
   const vec4 fog = vec4(density * lighting, density);